@@ -239,6 +239,20 @@ public:
 
     void    EnableMultipleThreads(bool enable = true);
 
+    // Vector instruction sets used to fill the dynamic programming matrix
+    // of global alignments; results are identical at all levels.
+    enum ESimdLevel {
+        eSimd_None,
+        eSimd_SSE2,
+        eSimd_AVX2
+    };
+
+    // Level in use; by default the best one supported by the CPU
+    static ESimdLevel GetSimdLevel(void);
+    // Limit the level (e.g. eSimd_None for the scalar code); returns the
+    // level actually set, which is never above the CPU's
+    static ESimdLevel SetSimdLevel(ESimdLevel level);
+
     // A naive pattern generator-use cautiously.
     // Do not use on sequences with repeats or error.
     size_t MakePattern(const size_t hit_size = 100, 
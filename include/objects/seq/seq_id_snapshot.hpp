@@ -0,0 +1,217 @@
+#ifndef OBJECTS_SEQ___SEQ_ID_SNAPSHOT__HPP
+#define OBJECTS_SEQ___SEQ_ID_SNAPSHOT__HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Frozen Seq-id to integer key mapping in a memory mapped file
+*
+*/
+
+#include <corelib/ncbiobj.hpp>
+#include <corelib/ncbimtx.hpp>
+#include <objects/seq/seq_id_handle.hpp>
+
+#include <unordered_map>
+
+BEGIN_NCBI_SCOPE
+
+class CMemoryFile;
+
+BEGIN_SCOPE(objects)
+
+/** @addtogroup OBJECTS_Seqid
+ *
+ * @{
+ */
+
+
+/////////////////////////////////////////////////////////////////////
+///
+///  CSeq_id_Snapshot::
+///
+///    Maps Seq-ids to dense integer keys using a sorted read-only
+///    table written by CSeq_id_SnapshotWriter.  The file is memory
+///    mapped, so attaching it costs nothing and its pages are shared
+///    by all the processes using it; no CSeq_id_Handle is created
+///    until GetHandle() is called.
+///
+///    Gi ids are looked up by value, the others by their FASTA
+///    representation (accession in upper case with the version, the
+///    name and release of text ids being ignored).
+///
+///    A key identifies an id the way CSeq_id_Handle does, so the
+///    GenBank, EMBL and DDBJ ids with the same accession get different
+///    keys (gb|X, emb|X and dbj|X are different handles too).  These
+///    types share the accession space of CSeq_id_Mapper only for the
+///    matching of ids (CSeq_id_Handle::GetMatchingHandles()), which the
+///    snapshot does not do.
+///
+///    Ids which are not in the file can be given keys too (GetKey());
+///    those keys follow the frozen ones, are local to the process and
+///    refer to handles of the regular CSeq_id_Mapper trees.
+///
+
+class NCBI_SEQ_EXPORT CSeq_id_Snapshot : public CObject
+{
+public:
+    typedef Uint4 TKey;
+    static const TKey kInvalidKey = kMax_UI4;
+
+    /// Attach a snapshot file; throws CException if the file cannot
+    /// be mapped or is not a snapshot
+    explicit CSeq_id_Snapshot(const string& file_name);
+    ~CSeq_id_Snapshot(void);
+
+    /// Number of keys in the file, keys [0, GetFrozenCount())
+    size_t GetFrozenCount(void) const
+        {
+            return m_KeyCount;
+        }
+    /// Number of all keys including the ones assigned by GetKey()
+    size_t GetCount(void) const;
+
+    /// Key of the id or kInvalidKey, do not assign a new key
+    TKey FindKey(const CSeq_id& id) const;
+    TKey FindKey(const CSeq_id_Handle& idh) const;
+    TKey FindGiKey(TGi gi) const;
+
+    /// Key of the id, assign the next key if it is not known yet
+    TKey GetKey(const CSeq_id& id);
+    TKey GetKey(const CSeq_id_Handle& idh);
+
+    /// Handle of the id with the key, null handle for unknown keys
+    CSeq_id_Handle GetHandle(TKey key) const;
+
+    /// The string the id is looked up by (not for gi ids)
+    static bool GetLookupString(const CSeq_id& id, string& str);
+
+private:
+    friend class CSeq_id_SnapshotWriter;
+
+    // File layout: SHeader, SGiEntry[gi count] sorted by gi,
+    // SStrEntry[string count] sorted by string, SKeyEntry[key count],
+    // string data.  All integers are in the native byte order.
+    struct SHeader {
+        char  m_Magic[8];
+        Uint4 m_ByteOrder;
+        Uint4 m_KeyCount;
+        Uint4 m_GiCount;
+        Uint4 m_StrCount;
+        Uint8 m_DataSize;
+    };
+    struct SGiEntry {
+        Int8  m_Gi;
+        Uint4 m_Key;
+        Uint4 m_Reserved;
+    };
+    struct SStrEntry {
+        Uint8 m_Offset;
+        Uint4 m_Length;
+        Uint4 m_Key;
+    };
+    struct SKeyEntry {
+        Int8  m_Value; // gi or offset of the string
+        Uint4 m_Length;
+        Uint4 m_IsGi;
+    };
+
+    TKey x_FindFrozenGi(Int8 gi) const;
+    TKey x_FindFrozenStr(const CTempString& str) const;
+    TKey x_FindFrozen(const CSeq_id& id) const;
+    TKey x_FindDynamic(const CSeq_id_Handle& idh) const;
+    TKey x_AddDynamic(const CSeq_id_Handle& idh);
+
+    unique_ptr<CMemoryFile> m_File;
+    size_t                  m_KeyCount;
+    size_t                  m_GiCount;
+    size_t                  m_StrCount;
+    const SGiEntry*         m_Gis;
+    const SStrEntry*        m_Strs;
+    const SKeyEntry*        m_Keys;
+    const char*             m_Data;
+
+    // Ids added after the snapshot was written
+    typedef map<CSeq_id_Handle, TKey> TDynamicKeys;
+    mutable CFastMutex      m_DynamicMutex;
+    TDynamicKeys            m_DynamicKeys;
+    vector<CSeq_id_Handle>  m_DynamicHandles;
+
+    CSeq_id_Snapshot(const CSeq_id_Snapshot&);
+    CSeq_id_Snapshot& operator=(const CSeq_id_Snapshot&);
+};
+
+
+/////////////////////////////////////////////////////////////////////
+///
+///  CSeq_id_SnapshotWriter::
+///
+///    Collects Seq-ids and writes them to a file for CSeq_id_Snapshot.
+///    Keys are assigned in the order the ids are added, an id added
+///    more than once keeps its first key.
+///
+
+class NCBI_SEQ_EXPORT CSeq_id_SnapshotWriter
+{
+public:
+    typedef CSeq_id_Snapshot::TKey TKey;
+
+    CSeq_id_SnapshotWriter(void);
+    ~CSeq_id_SnapshotWriter(void);
+
+    TKey Add(const CSeq_id& id);
+    TKey Add(const CSeq_id_Handle& idh);
+    TKey AddGi(TGi gi);
+
+    size_t GetCount(void) const
+        {
+            return m_Keys.size();
+        }
+
+    /// Write the snapshot; throws CException on errors
+    void Write(const string& file_name) const;
+
+private:
+    TKey x_AddStr(const string& str);
+
+    struct SKey {
+        Int8   m_Gi;
+        string m_Str;
+        bool   m_IsGi;
+    };
+    vector<SKey>                m_Keys;
+    unordered_map<Int8, TKey>   m_Gis;
+    unordered_map<string, TKey> m_Strs;
+};
+
+
+/* @} */
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif  /* OBJECTS_SEQ___SEQ_ID_SNAPSHOT__HPP */
@@ -465,6 +465,9 @@ public:
 
     virtual Uint4 EstimateLoadBytes(const CTSE_Chunk_Info& chunk) const;
     virtual double EstimateLoadSeconds(const CTSE_Chunk_Info& chunk, Uint4 bytes) const;
+    /// Estimated time to load the TSE again after it's dropped from
+    /// the blob cache, bytes is its approximate memory footprint.
+    virtual double EstimateReloadSeconds(const CTSE_Info& tse, size_t bytes) const;
 
     virtual unsigned GetDefaultBlobCacheSizeLimit() const;
     virtual bool GetTrackSplitSeq() const;
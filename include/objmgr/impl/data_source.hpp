@@ -296,6 +296,10 @@ public:
     void SetDefaultPriority(TPriority priority);
 
     static unsigned GetDefaultBlobCacheSizeLimit();
+    /// Byte budget of unlocked TSE cache, 0 - limited by number of TSEs
+    static Uint8 GetDefaultBlobCacheByteLimit();
+
+    void GetBlobCacheStatistics(CObjectManager::SBlobCacheStatistics& stats) const;
 
     // get locks
     enum FLockFlags {
@@ -406,6 +410,10 @@ private:
                        CTSE_Info& tse, CRef<CTSE_Info::CLoadMutex> load_mutex);
     void x_ReleaseLastLoadLock(CTSE_LoadLock& lock);
     void x_ReleaseLastTSELock(CRef<CTSE_Info> info);
+    // unlocked blobs cache maintainance, m_DSCacheLock must be locked
+    void x_AddToCache(CTSE_Info& tse);
+    void x_RemoveFromCache(const CTSE_Info& tse) const;
+    TBlob_Cache::iterator x_GetCacheVictim(void);
 
     // attach, detach, index & unindex methods
     // TSE
@@ -541,6 +549,12 @@ private:
     mutable TBlob_Cache   m_Blob_Cache;     // unlocked blobs
     mutable unsigned      m_Blob_Cache_Size;// list<>::size() is slow
     unsigned              m_Blob_Cache_Size_Limit;
+    mutable Uint8         m_Blob_Cache_Bytes;// footprint of unlocked blobs
+    Uint8                 m_Blob_Cache_Bytes_Limit;// 0 - no byte budget
+    mutable Uint8         m_Blob_Cache_Hits;
+    Uint8                 m_Blob_Cache_Insertions;
+    Uint8                 m_Blob_Cache_Evictions;
+    Uint8                 m_Blob_Cache_Evicted_Bytes;
 
     // Prefetching thread and lock, used when initializing the thread
     CRef<CPrefetchThreadOld> m_PrefetchThread;
@@ -315,6 +315,10 @@ private:
     Uint4            m_LoadBytes;
     float            m_LoadSeconds;
 
+    // memory accounted by data loader, and estimated by loaded objects
+    size_t           m_UsedMemory;
+    size_t           m_EstimatedMemory;
+
     bool             m_ExplicitFeatIds;
 
     TDescInfos       m_DescInfos;
@@ -75,6 +75,10 @@ class CDataSource;
 class CHandleRange;
 class CAnnotTypes_CI;
 class CSeq_entry;
+class CBioseq;
+class CSeq_annot;
+class CSeq_descr;
+class CSeq_align;
 
 class CSeq_literal;
 class CObject_id;
@@ -283,6 +287,15 @@ public:
     void SetUsedMemory(size_t size);
     void AddUsedMemory(size_t size);
 
+    // approximate memory used by objects loaded into object manager,
+    // for the data loaders that do not account it themselves
+    static size_t EstimateUsedMemory(const CSeq_entry& entry);
+    static size_t EstimateUsedMemory(const CBioseq& seq);
+    static size_t EstimateUsedMemory(const CSeq_annot& annot);
+    static size_t EstimateUsedMemory(const CSeq_descr& descr);
+    static size_t EstimateUsedMemory(const CSeq_literal& literal);
+    static size_t EstimateUsedMemory(const CSeq_align& align);
+
     // Annot index access
     bool HasAnnot(const CAnnotName& name) const;
     bool HasUnnamedAnnot(void) const;
@@ -515,6 +528,9 @@ private:
 
     void x_Initialize(void);
     void x_Reset(void); // can be called after incomplete loading
+
+    // set estimation of used memory if data loader didn't set it
+    void x_SetEstimatedUsedMemory(void);
    
     void x_DSMapObject(CConstRef<TObject> obj, CDataSource& ds);
     void x_DSUnmapObject(CConstRef<TObject> obj, CDataSource& ds);
@@ -716,6 +732,9 @@ private:
     
     typedef list< CRef<CTSE_Info> > TTSE_Cache;
     mutable TTSE_Cache::iterator   m_CachePosition;
+    // memory and reload cost accounted while in cache
+    mutable size_t                 m_CacheBytes;
+    mutable double                 m_CacheReloadSeconds;
 
     // lock counter for garbage collector
     mutable CAtomicCounter_WithAutoInit m_LockCounter;
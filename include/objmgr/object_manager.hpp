@@ -185,6 +185,35 @@ public:
                           EIsDefault    is_default,
                           TPriority     priority = kPriority_Default);
 
+    /// Unlocked TSE cache of a data loader's data source.
+    /// Cache size is limited by OBJMGR_BLOB_CACHE (number of TSEs), or by
+    /// OBJMGR_BLOB_CACHE_BYTES (approximate memory footprint of TSEs)
+    /// if the latter is set.
+    struct SBlobCacheStatistics
+    {
+        SBlobCacheStatistics(void)
+            : m_Count(0), m_CountLimit(0),
+              m_Bytes(0), m_BytesLimit(0),
+              m_Hits(0), m_Insertions(0),
+              m_Evictions(0), m_EvictedBytes(0)
+            {
+            }
+
+        size_t m_Count;        ///< TSEs in the cache
+        size_t m_CountLimit;   ///< max number of TSEs in the cache
+        Uint8  m_Bytes;        ///< footprint of TSEs in the cache
+        Uint8  m_BytesLimit;   ///< max footprint, 0 if not limited by bytes
+        Uint8  m_Hits;         ///< TSEs locked again while in the cache
+        Uint8  m_Insertions;   ///< TSEs put into the cache
+        Uint8  m_Evictions;    ///< TSEs dropped to keep the cache limits
+        Uint8  m_EvictedBytes; ///< footprint of dropped TSEs
+    };
+    typedef map<string, SBlobCacheStatistics> TBlobCacheStatistics;
+    /// Get blob cache statistics of all registered data loaders.
+    /// @param stats
+    ///   A map to be filled with the statistics by loader name.
+    void GetBlobCacheStatistics(TBlobCacheStatistics& stats) const;
+
     /// Revoke previously registered data loader.
     /// Return FALSE if the loader is still in use (by some scope).
     /// Throw an exception if the loader is not registered with this ObjMgr.
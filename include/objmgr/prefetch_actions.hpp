@@ -110,6 +110,40 @@ private:
 };
 
 
+/// Resolves a batch of Seq-ids with a single CScope::GetBioseqHandles()
+/// call, so data loaders get the whole batch in one bulk request.
+class NCBI_XOBJMGR_EXPORT CPrefetchBioseqs
+    : public CObject, public IPrefetchAction, public CScopeSource
+{
+public:
+    typedef vector<CSeq_id_Handle> TIds;
+    typedef vector<CBioseq_Handle> TResult;
+
+    CPrefetchBioseqs(const CScopeSource& scope,
+                     const TIds& ids);
+
+    virtual bool Execute(CRef<CPrefetchRequest> token);
+
+    const TIds& GetSeq_ids(void) const
+        {
+            return m_Seq_ids;
+        }
+    /// Handles in the same order as Seq-ids, null for unresolved ones
+    const TResult& GetBioseqHandles(void) const
+        {
+            return m_Result;
+        }
+    const TResult& GetResult(void) const
+        {
+            return m_Result;
+        }
+
+private:
+    TIds            m_Seq_ids;
+    TResult         m_Result;
+};
+
+
 class NCBI_XOBJMGR_EXPORT CPrefetchFeat_CI
     : public CPrefetchBioseq
 {
@@ -310,6 +344,69 @@ private:
 };
 
 
+/// Resolves a long list of Seq-ids into Bioseq handles.
+/// The ids are split into batches (CPrefetchBioseqs), several batches are
+/// loaded at once, and they are returned in the order of their completion,
+/// so processing of the first results overlaps with loading of the rest.
+/// A new batch is started when a finished one is taken by the caller.
+///
+/// Example:
+/// @code
+///   CPrefetchBioseqBatches batches(*manager, CScopeSource::New(scope), ids);
+///   CPrefetchBioseqBatches::TIds batch_ids;
+///   CPrefetchBioseqBatches::TBioseqHandles handles;
+///   while ( batches.GetNext(batch_ids, handles) ) {
+///       ...
+///   }
+/// @endcode
+class NCBI_XOBJMGR_EXPORT CPrefetchBioseqBatches : public CObject
+{
+public:
+    typedef CPrefetchBioseqs::TIds TIds;
+    typedef CPrefetchBioseqs::TResult TBioseqHandles;
+
+    /// @param batch_size
+    ///   Number of Seq-ids resolved in one bulk request.
+    /// @param active_batches
+    ///   Max number of batches being loaded or waiting for the caller.
+    CPrefetchBioseqBatches(CPrefetchManager& manager,
+                           const CScopeSource& scope,
+                           const TIds& ids,
+                           size_t batch_size = 100,
+                           size_t active_batches = 4);
+    /// Cancels the batches not taken yet
+    ~CPrefetchBioseqBatches(void);
+
+    /// Returns next finished batch (completed, failed or canceled)
+    /// waiting for it if necessary, or null if all batches are returned.
+    CRef<CPrefetchRequest> GetNextToken(void);
+
+    /// Get Seq-ids and Bioseq handles of next finished batch.
+    /// Throws CPrefetchFailed or CPrefetchCanceled if the batch failed.
+    /// @return
+    ///   false if all batches are returned.
+    bool GetNext(TIds& ids, TBioseqHandles& handles);
+
+private:
+    class CQueue;
+
+    void x_EnqueueNextBatch(void);
+
+    CRef<CPrefetchManager>          m_Manager;
+    CScopeSource                    m_Scope;
+    TIds                            m_Ids;
+    size_t                          m_BatchSize;
+    size_t                          m_NextId;
+    CMutex                          m_Mutex;
+    CRef<CQueue>                    m_Queue;
+    list< CRef<CPrefetchRequest> >  m_ActiveTokens;
+
+private:
+    CPrefetchBioseqBatches(const CPrefetchBioseqBatches&);
+    void operator=(const CPrefetchBioseqBatches&);
+};
+
+
 class NCBI_XOBJMGR_EXPORT CStdPrefetch
 {
 public:
@@ -321,6 +418,12 @@ public:
                                                   const CSeq_id_Handle& id);
     static CBioseq_Handle GetBioseqHandle(CRef<CPrefetchRequest> token);
 
+    // GetBioseqHandles
+    static CRef<CPrefetchRequest> GetBioseqHandles(CPrefetchManager& manager,
+                                                   const CScopeSource& scope,
+                                                   const CPrefetchBioseqs::TIds& ids);
+    static CPrefetchBioseqs::TResult GetBioseqHandles(CRef<CPrefetchRequest> token);
+
     // GetFeat_CI
     static CRef<CPrefetchRequest> GetFeat_CI(CPrefetchManager& manager,
                                              const CBioseq_Handle& bioseq,
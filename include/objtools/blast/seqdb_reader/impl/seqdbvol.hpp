@@ -395,6 +395,35 @@ public:
                            CSeqDB::TSequenceRanges  * partial_ranges,
                            CSeqDB::TSequenceRanges  * masks) const;
 
+    /// Decode a whole sequence with ambiguities into a caller's buffer.
+    ///
+    /// This is like GetAmbigSeq() without a region or masks, but the
+    /// data is written to the given buffer, which must have room for
+    /// the whole sequence; no sentinel bytes are added for the
+    /// kSeqDBNuclBlastNA8 encoding.
+    ///
+    /// @param oid
+    ///   The OID of the sequence. [in]
+    /// @param buffer
+    ///   The destination of the sequence data. [out]
+    /// @param nucl_code
+    ///   The encoding of the returned sequence data. [in]
+    /// @return
+    ///   The length of this sequence in bases.
+    int GetAmbigSeqInto(int oid, char * buffer, int nucl_code) const;
+
+    /// Advise that the sequence data of an OID range will be needed soon.
+    ///
+    /// The pages of the sequence file holding the sequence and
+    /// ambiguity data of the OIDs are advised as needed soon; the OID
+    /// range is truncated to the volume.
+    ///
+    /// @param begin_oid
+    ///   The first OID of the range, relative to the volume. [in]
+    /// @param end_oid
+    ///   The OID after the end of the range, relative to the volume. [in]
+    void AdviseSequences(int begin_oid, int end_oid) const;
+
     /// Get the Seq-ids associated with a sequence.
     ///
     /// This method returns a list containing all the CSeq_id objects
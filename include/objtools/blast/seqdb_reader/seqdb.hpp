@@ -311,6 +311,64 @@ public:
             append(&element, 1);
         }
     };
+
+    /// Encodings of the data returned by GetSequenceBatch().
+    enum EBatchEncoding {
+        /// Data as stored in the database: ncbistdaa for proteins, packed
+        /// ncbi2na (4 bases per byte, ambiguities randomized) for
+        /// nucleotides.
+        eBatch_Raw,
+
+        /// One residue per byte with ambiguities restored: ncbistdaa for
+        /// proteins, ncbi8na (kSeqDBNuclNcbiNA8) for nucleotides.
+        eBatch_NcbiNA8,
+
+        /// Same as eBatch_NcbiNA8, but blastna (kSeqDBNuclBlastNA8) for
+        /// nucleotides.
+        eBatch_BlastNA8
+    };
+
+    /// Sequence data of several OIDs packed into one contiguous buffer.
+    ///
+    /// Sequence i occupies bytes [offsets[i], offsets[i+1]) of data and
+    /// is lengths[i] residues long; for eBatch_Raw nucleotide data the
+    /// number of bytes is (lengths[i] + 3) / 4.
+    struct SSequenceBatch {
+        /// OIDs of the sequences, in the order of retrieval.
+        vector<int>    oids;
+
+        /// Sequence lengths (in bases or residues).
+        vector<int>    lengths;
+
+        /// Start of each sequence in data, followed by the end of data.
+        vector<size_t> offsets;
+
+        /// Sequence data.
+        vector<char>   data;
+
+        /// Encoding of data.
+        EBatchEncoding encoding;
+
+        SSequenceBatch() : encoding(eBatch_Raw) {}
+
+        /// Number of sequences in the batch.
+        size_t size() const { return oids.size(); }
+
+        /// Pointer to the data of sequence i.
+        const char * GetSequence(size_t i) const
+        {
+            return data.data() + offsets[i];
+        }
+
+        /// Remove all sequences, keeping allocated memory.
+        void clear()
+        {
+            oids.clear();
+            lengths.clear();
+            offsets.clear();
+            data.clear();
+        }
+    };
     /// String containing the error message in exceptions thrown when a given
     /// OID cannot be found
     static const char* kOidNotFound;
@@ -801,6 +859,67 @@ public:
     ///   A pointer to the sequence data to release.
     void RetAmbigSeq(const char ** buffer) const;
 
+    /// Get the sequences of a range of OIDs packed into one buffer.
+    ///
+    /// All included OIDs in [begin_oid, end_oid) are retrieved (OIDs
+    /// excluded by GI lists or alias files are skipped) and copied or
+    /// decoded into one contiguous buffer, so no sequence has to be
+    /// returned with RetSequence() or RetAmbigSeq().  Before returning,
+    /// the sequence data of the following range of the same size is
+    /// advised to the OS as needed soon, so reading it from disk overlaps
+    /// with processing of the current batch.  This makes calling this
+    /// method with consecutive ranges an efficient way to scan the whole
+    /// database.
+    ///
+    /// @param begin_oid
+    ///   The first OID of the range. [in]
+    /// @param end_oid
+    ///   The OID after the end of the range. [in]
+    /// @param batch
+    ///   The retrieved sequences; previous contents are discarded. [out]
+    /// @param encoding
+    ///   The encoding of the returned sequence data. [in]
+    /// @param threads
+    ///   Number of threads used to copy or decode the sequences. [in]
+    void GetSequenceBatch(int              begin_oid,
+                          int              end_oid,
+                          SSequenceBatch & batch,
+                          EBatchEncoding   encoding = eBatch_NcbiNA8,
+                          int              threads  = 1) const;
+
+    /// Get the sequences of a list of OIDs packed into one buffer.
+    ///
+    /// This is like the OID range version of GetSequenceBatch(), but
+    /// retrieves exactly the given OIDs, in the given order, and does
+    /// not read ahead; use AdviseSequences() to prefetch the data of
+    /// the next batch.
+    ///
+    /// @param oids
+    ///   The OIDs of the sequences to retrieve. [in]
+    /// @param batch
+    ///   The retrieved sequences; previous contents are discarded. [out]
+    /// @param encoding
+    ///   The encoding of the returned sequence data. [in]
+    /// @param threads
+    ///   Number of threads used to copy or decode the sequences. [in]
+    void GetSequenceBatch(const vector<int> & oids,
+                          SSequenceBatch    & batch,
+                          EBatchEncoding      encoding = eBatch_NcbiNA8,
+                          int                 threads  = 1) const;
+
+    /// Advise that the sequence data of an OID range will be needed soon.
+    ///
+    /// The OS is asked to start reading the sequence data (and ambiguity
+    /// data) of the OIDs in [begin_oid, end_oid) into memory in the
+    /// background.  The method does not wait for the data and does
+    /// nothing where such advice is not supported.
+    ///
+    /// @param begin_oid
+    ///   The first OID of the range. [in]
+    /// @param end_oid
+    ///   The OID after the end of the range. [in]
+    void AdviseSequences(int begin_oid, int end_oid) const;
+
     /// Gets a list of sequence identifiers.
     ///
     /// This returns the list of CSeq_id identifiers associated with
@@ -676,6 +676,10 @@ public:
     int GetGapDepth(void) const { return m_GapDepth; }
     void SetGapDepth(const int gapDepth) { m_GapDepth = gapDepth; }
 
+    // -- Threads formatting the features and sequence of a record
+    unsigned int GetFormatThreads(void) const { return m_FormatThreads; }
+    void SetFormatThreads(unsigned int threads) { m_FormatThreads = threads; }
+
 
     void SetGenbankBlocks(const TGenbankBlocks& genbank_blocks)
     {
@@ -764,6 +768,7 @@ private:
     TCustom     m_Custom;
     int         m_FeatDepth;
     int         m_GapDepth;
+    unsigned int m_FormatThreads;
     string      m_SingleAccession;
     CRef<IHTMLFormatter> m_html_formatter;
 };
@@ -132,6 +132,9 @@ protected:
     CRef<CFlatFileContext>    m_Ctx;
     bool                      m_Failed;
 
+    // Formats into os, on several threads if the configuration says so
+    CFlatItemOStream* x_NewItemOStream(CNcbiOstream& os) const;
+
     /// Use this class to wrap CFlatItemOStream instances so that they
     /// check if canceled for every item added
     class CCancelableFlatItemOStreamWrapper : public CFlatItemOStream
@@ -111,6 +111,8 @@ class NCBI_FORMAT_EXPORT CFeatureItemBase:
 //  ============================================================================
 {
 public:
+    /// The formatted feature is built on the first call and kept, so
+    /// it can be prepared ahead of the item being written
     CConstRef<CFlatFeature> Format(void) const;
     void Format(IFormatter& formatter, IFlatTextOStream& text_os) const {
         formatter.FormatFeature(*this, text_os);
@@ -142,6 +144,9 @@ protected:
     CRef<feature::CFeatTree> m_Feat_Tree;
     CConstRef<CSeq_loc>      m_Loc;
     bool                     m_SuppressAccession;
+
+private:
+    mutable CConstRef<CFlatFeature> m_FlatFeature;
 };
 
 
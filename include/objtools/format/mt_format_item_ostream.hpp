@@ -0,0 +1,111 @@
+#ifndef OBJTOOLS_FORMAT___MT_FORMAT_ITEM_OSTREAM_HPP
+#define OBJTOOLS_FORMAT___MT_FORMAT_ITEM_OSTREAM_HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Item output stream formatting the items of a record on several threads
+*
+*/
+#include <corelib/ncbistd.hpp>
+
+#include <objtools/format/item_ostream.hpp>
+#include <objtools/format/text_ostream.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+
+class IFormatter;
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CMTFormatItemOStream
+//
+// Does the same as CFormatItemOStream, but the expensive part of formatting
+// is moved to worker threads while the gatherer goes on collecting items:
+// - feature items build their qualifiers and location text (the result is
+//   kept by the item, see CFeatureItemBase::Format());
+// - sequence (ORIGIN) chunks of the GenBank and EMBL formats are written to
+//   a buffer in full.
+// The items are written to the text stream strictly in the order they were
+// added, and all the formatter calls which depend on that order are made on
+// the calling thread, so the output is the same as in the serial mode.
+
+class NCBI_FORMAT_EXPORT CMTFormatItemOStream : public CFlatItemOStream
+{
+public:
+    // NB: formatter and text_os must be allocated on the heap!
+    CMTFormatItemOStream(IFlatTextOStream* text_os,
+                         unsigned int threads,
+                         IFormatter* formatter = nullptr);
+    ~CMTFormatItemOStream() override;
+
+    void SetFormatter(IFormatter* formatter) override;
+
+    // NB: item must be allocated on the heap!
+    void AddItem(CConstRef<IFlatItem> item) override;
+
+    /// Write all the items added so far
+    void Flush(void);
+
+private:
+    class CBufferTextOStream;
+    struct SSlot;
+
+    void x_Work(void);
+    void x_WriteReady(size_t max_pending);
+    void x_Write(SSlot& slot);
+
+    CRef<IFlatTextOStream>   m_TextOS;
+    bool                     m_RenderSequence;
+    size_t                   m_MaxPending;
+
+    // Items not written yet, in the order they were added
+    deque<unique_ptr<SSlot>> m_Pending;
+
+    // Guarded by m_Mutex
+    mutex                    m_Mutex;
+    condition_variable       m_QueueCond;
+    condition_variable       m_DoneCond;
+    deque<SSlot*>            m_Queue;
+    bool                     m_Stop;
+
+    vector<thread>           m_Threads;
+};
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif  /* OBJTOOLS_FORMAT___MT_FORMAT_ITEM_OSTREAM_HPP */
@@ -152,6 +152,16 @@ public:
     using TSeqIdTypes = ct::const_bitset<CSeq_id::e_MaxChoice, CSeq_id::E_Choice>;
     const TSeqIdTypes& GetSeqIdTypes() const { return m_seq_id_types; }
 
+    // Deserialize flattened entries on 'threads' worker threads, each with
+    // its own object stream over the same file; GetNextSeqEntry still returns
+    // them in file order. No more than 'depth' entries are kept ahead of the
+    // consumer, zero means twice the number of threads. 0 or 1 thread
+    // restores the default sequential loading, and so do the subclasses
+    // which do not opt in with x_CanLoadInParallel().
+    void SetLoadThreads(unsigned threads, size_t depth = 0);
+    // Number of worker threads GetNextSeqEntry() uses, 0 if it is sequential
+    unsigned GetLoadThreads() const;
+
 protected:
     // temporary structure for indexing
     struct TBioseqInfoRec
@@ -177,7 +187,14 @@ protected:
     using TStreamPos = streampos;
     TStreamPos GetCurrentPos() const;
 
+    // SetLoadThreads() calls LoadSeqEntry() on several threads at once. It is
+    // safe for this class; a subclass overriding LoadSeqEntry() loads
+    // sequentially unless it overrides this to return true as well.
+    virtual bool x_CanLoadInParallel() const;
+
 private:
+    class CParallelLoader;
+
     void x_ResetIndex();
     void x_IndexNextAsn1();
     void x_ThrowDuplicateId(
@@ -209,6 +226,11 @@ private:
     TBioseqSetList            m_FlattenedSets;
     TBioseqSetList::const_iterator  m_Current;
     const CBioseq_set::TClass* m_pTopLevelClass { nullptr };
+
+// parallel loading of flattened entries
+    unsigned                        m_load_threads = 0;
+    size_t                          m_load_depth   = 0;
+    unique_ptr<CParallelLoader>     m_loader;
 };
 
 END_SCOPE(edit)
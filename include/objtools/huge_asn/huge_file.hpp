@@ -90,6 +90,7 @@ public:
     {
         eDuplicateSeqIds,
         eDuplicateFeatureIds,
+        eLoadFailed,
     };
     //virtual const char* GetErrCodeString(void) const override;
     NCBI_EXCEPTION_DEFAULT(CHugeFileException,CException);
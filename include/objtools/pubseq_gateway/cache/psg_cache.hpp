@@ -120,6 +120,22 @@ public:
     static bool UnpackBlobPropKey(const char* key, size_t key_sz, int64_t& last_modified);
     static bool UnpackBlobPropKey(const char* key, size_t key_sz, int64_t& last_modified, int32_t& sat_key);
 
+    /// Flat (fixed-layout) values are read in place from memory map,
+    /// Open() prefers them to protobuf packed values if the file has them
+    static string PackBioseqInfoFlatValue(const CBioseqInfoRecord& record);
+    static bool UnpackBioseqInfoFlatValue(const char* value, size_t value_sz, CBioseqInfoRecord& record);
+    static string PackSiFlatValue(const CSI2CSIRecord& record);
+    static bool UnpackSiFlatValue(const char* value, size_t value_sz, CSI2CSIRecord& record);
+    static string PackBlobPropFlatValue(const CBlobRecord& record);
+    static bool UnpackBlobPropFlatValue(const char* value, size_t value_sz, CBlobRecord& record);
+
+    /// Adds flat copies of the data to cache files (empty file names are skipped).
+    /// Has to be run on a machine of the same architecture as the readers.
+    /// @return number of converted records
+    // @throws std::runtime_error
+    static size_t ConvertToFlat(
+        const string& bioseq_info_file_name, const string& si2csi_file_name, const string& blob_prop_file_name);
+
     void EnumerateBlobProp(int32_t sat, TBlobPropEnumerateFn fn);
 
     //@ForTesting
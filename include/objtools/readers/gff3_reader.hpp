@@ -41,6 +41,8 @@ BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects) // namespace ncbi::objects::
 
 class CGff3LocationMerger;
+class CGff3LocationRecord;
+class CGff3PrefetchReader;
 
 //  ============================================================================
 class CGff3ReadRecord
@@ -108,6 +110,24 @@ public:
         ILineReader& lr,
         ILineErrorListener* pErrors=nullptr) override;
 
+    using CGff2Reader::ReadSeqAnnots;
+
+    void
+    ReadSeqAnnots(
+        TAnnotList&,
+        ILineReader&,
+        ILineErrorListener* =nullptr) override;
+
+    /// Parse the feature lines on the given number of threads, blockLines
+    /// lines at a time, while the features are put together from the lines
+    /// read before, and merge the feature locations on as many threads.
+    /// Applies to ReadSeqAnnots() only: it reads ahead of the annot it is
+    /// working on, up to the ##FASTA directive. The annots are the same as
+    /// with the default of 0 threads.
+    void SetParseThreads(
+        unsigned int threads,
+        size_t blockLines = 4096);
+
     TSeqPos SequenceSize() const;
 
     TSeqPos GetSequenceSize(
@@ -125,7 +145,14 @@ protected:
         const TReaderData&,
         CSeq_annot&) override;
 
-    CGff3ReadRecord* x_CreateRecord() override { return new CGff3ReadRecord(); };
+    // Subclasses customize x_CreateRecordForLine() instead: with parse
+    // threads, the records are created ahead of m_uLineNumber.
+    CGff3ReadRecord* x_CreateRecord() final { return x_CreateRecordForLine(m_uLineNumber); };
+
+    // Record for the input line with the given number. May be called on
+    // the parse threads, so it must not use the reader state.
+    virtual CGff3ReadRecord* x_CreateRecordForLine(
+        unsigned int /*lineNumber*/) { return new CGff3ReadRecord(); };
 
     virtual bool xInitializeFeature(
         const CGff2Record&,
@@ -211,6 +238,11 @@ protected:
     void xPostProcessAnnot(
         CSeq_annot&) override;
 
+    void xMergeFeatureLocation(
+        const string&,
+        CSeq_feat&,
+        list<CGff3LocationRecord>);
+
     void xProcessAlignmentData(
         CSeq_annot& pAnnot);
 
@@ -219,6 +251,12 @@ protected:
         CSeq_annot&,
         ILineErrorListener*) override;
 
+    // Record of the given feature line, taken from the parse threads if it
+    // was parsed ahead. Null if the line is rejected, parse errors are
+    // thrown.
+    unique_ptr<CGff3ReadRecord> xParseRecord(
+        const string&);
+
     virtual bool xParseAlignment(
         const string& strLine);
 
@@ -234,6 +272,10 @@ protected:
 
     shared_ptr<CGff3LocationMerger> mpLocations;
     static unsigned int msGenericIdCounter;
+
+    unsigned int mParseThreads;
+    size_t mParseBlockLines;
+    CGff3PrefetchReader* mpPrefetch;
 };
 
 END_SCOPE(objects)
@@ -210,7 +210,8 @@ protected:
         const CGvfReadRecord&,
         CVariation_ref&);
 
-    CGff3ReadRecord* x_CreateRecord() override { return new CGvfReadRecord(m_uLineNumber); };
+    CGff3ReadRecord* x_CreateRecordForLine(
+        unsigned int lineNumber) override { return new CGvfReadRecord(lineNumber); };
 
     bool xIsDbvarCall(
         const string& nameAttr) const;
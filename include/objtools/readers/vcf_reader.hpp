@@ -39,12 +39,16 @@
 #include <objtools/readers/reader_base.hpp>
 #include <objtools/readers/message_listener.hpp>
 
+#include <deque>
+#include <future>
+
 
 BEGIN_NCBI_SCOPE
 
 BEGIN_SCOPE(objects) // namespace ncbi::objects::
 
 class CVcfData;
+class CVcfTableChunk;
 class CDbtag;
 class CReaderListener;
 
@@ -150,6 +154,10 @@ public:
     enum {
         fNormal = 0,
         fUseSetFormat = 1<<8,
+        /// Read the data lines into Seq-table annots, one per block of
+        /// lines of a chromosome, instead of a Variation feature per line;
+        /// see CVcfTable for the columns
+        fColumnar = 1<<9,
     };
 
     CVcfReader(
@@ -157,6 +165,13 @@ public:
         CReaderListener* = nullptr);
     virtual ~CVcfReader();
 
+    /// Columnar mode: at most rowsPerTable lines go into one Seq-table;
+    /// the blocks are parsed on up to 'threads' threads while the next
+    /// ones are read (0 - parse on the calling thread).
+    void SetColumnarOptions(
+        size_t rowsPerTable,
+        unsigned int threads);
+
     //
     //  object interface:
     //
@@ -314,6 +329,24 @@ protected:
         CVcfData&,
         ILineErrorListener* =nullptr);
 
+    CRef<CSeq_annot>
+    xReadSeqTableAnnot(
+        ILineReader&,
+        ILineErrorListener*);
+
+    void
+    xReadTableHeader(
+        ILineReader&);
+
+    unique_ptr<CVcfTableChunk>
+    xReadTableChunk(
+        ILineReader&);
+
+    CRef<CSeq_annot>
+    xMakeTableAnnot(
+        CVcfTableChunk&,
+        ILineErrorListener*);
+
     //
     //  data:
     //
@@ -334,6 +367,14 @@ protected:
     vector<string> m_GenotypeHeaders;
     CMessageListenerLenient m_ErrorsPrivate;
     bool m_MetaHandled;
+
+    // columnar mode
+    size_t m_TableRows;
+    unsigned int m_TableThreads;
+    bool m_TableHeaderDone;
+    string m_TablePendingLine;
+    unsigned int m_TablePendingLineNumber;
+    deque<future<unique_ptr<CVcfTableChunk>>> m_TableChunks;
 };
 
 END_SCOPE(objects)
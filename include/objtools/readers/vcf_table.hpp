@@ -0,0 +1,135 @@
+/*
+ * $Id$
+ *
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Access to the Seq-tables made by CVcfReader in columnar mode
+ *
+ */
+
+#ifndef OBJTOOLS_READERS___VCF_TABLE__HPP
+#define OBJTOOLS_READERS___VCF_TABLE__HPP
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/tempstr.hpp>
+#include <objects/seqtable/Seq_table.hpp>
+
+BEGIN_NCBI_SCOPE
+
+BEGIN_SCOPE(objects) // namespace ncbi::objects::
+
+class CSeqTable_column;
+
+//  ----------------------------------------------------------------------------
+/// Read access to a Seq-table made by CVcfReader with fColumnar.
+///
+/// Each row is one VCF data line of a single chromosome. The columns keep
+/// the VCF fields as they were written:
+///   location-id       chromosome (default value)
+///   location-from     POS-1
+///   location-to       POS-1 + length(REF) - 1
+///   E.ID, E.REF, E.ALT, E.FILTER, E.INFO, E.FORMAT  - strings
+///   E.QUAL            real, no value for '.'
+///   E.sample:<name>   one column per sample, the whole genotype field
+/// INFO and genotype fields are not parsed until asked for by GetInfo()
+/// and GetSampleValue().
+///
+class NCBI_XOBJREAD_EXPORT CVcfTable
+//  ----------------------------------------------------------------------------
+{
+public:
+    static const char* const kColumnId;
+    static const char* const kColumnRef;
+    static const char* const kColumnAlt;
+    static const char* const kColumnQual;
+    static const char* const kColumnFilter;
+    static const char* const kColumnInfo;
+    static const char* const kColumnFormat;
+    static const char* const kColumnSamplePrefix;
+
+    explicit CVcfTable(const CSeq_table& table);
+
+    const CSeq_table& GetTable() const
+    {
+        return *m_Table;
+    }
+    size_t GetNumRows() const
+    {
+        return size_t(m_Table->GetNum_rows());
+    }
+    size_t GetNumSamples() const
+    {
+        return m_Samples.size();
+    }
+    const string& GetSampleName(size_t sample) const
+    {
+        return m_SampleNames[sample];
+    }
+
+    /// 1-based VCF position
+    int GetPos(size_t row) const;
+    const string& GetId(size_t row) const;
+    const string& GetRef(size_t row) const;
+    const string& GetAlt(size_t row) const;
+    const string& GetFilter(size_t row) const;
+    const string& GetInfo(size_t row) const;
+    const string& GetFormat(size_t row) const;
+    /// false if QUAL is '.'
+    bool GetQual(size_t row, double& qual) const;
+
+    /// Value of the INFO key; flags have empty values.
+    /// Returns false if the key is not in the INFO field of the row.
+    bool GetInfo(size_t row, CTempString key, CTempString& value) const;
+
+    /// Whole genotype field of the sample
+    const string& GetSample(size_t row, size_t sample) const;
+    /// Value of the FORMAT key in the genotype field of the sample.
+    /// Returns false if the key is not listed in FORMAT or the value is
+    /// missing in the genotype field.
+    bool GetSampleValue(size_t row, size_t sample,
+                        CTempString key, CTempString& value) const;
+
+private:
+    const string& x_GetString(const CSeqTable_column* column,
+                              size_t row) const;
+
+    CConstRef<CSeq_table> m_Table;
+    const CSeqTable_column* m_From;
+    const CSeqTable_column* m_Id;
+    const CSeqTable_column* m_Ref;
+    const CSeqTable_column* m_Alt;
+    const CSeqTable_column* m_Qual;
+    const CSeqTable_column* m_Filter;
+    const CSeqTable_column* m_Info;
+    const CSeqTable_column* m_Format;
+    vector<const CSeqTable_column*> m_Samples;
+    vector<string> m_SampleNames;
+};
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif // OBJTOOLS_READERS___VCF_TABLE__HPP
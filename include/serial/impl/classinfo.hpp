@@ -104,6 +104,11 @@ public:
     CClassTypeInfo* SetImplicit(void);
     bool IsImplicitNonEmpty(void) const;
 
+    /// Generated (by datatool) reader of simple member values, used by
+    /// input streams instead of the generic member read functions.
+    TClassFastReadFunction GetFastReadFunction(void) const;
+    CClassTypeInfo* SetFastReadFunction(TClassFastReadFunction func);
+
     void AddSubClass(const CMemberId& id, const CTypeRef& type);
     void AddSubClass(const char* id, TTypeInfoGetter getter);
     void AddSubClassNull(const CMemberId& id);
@@ -141,6 +146,7 @@ private:
     unique_ptr<TSubClasses> m_SubClasses;
 
     TGetTypeIdFunction m_GetTypeIdFunction;
+    TClassFastReadFunction m_FastReadFunction;
 
     const CMemberInfo* GetImplicitMember(void) const;
 
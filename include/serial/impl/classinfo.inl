@@ -68,6 +68,19 @@ bool CClassTypeInfo::Implicit(void) const
     return m_ClassType == eImplicit;
 }
 
+inline
+TClassFastReadFunction CClassTypeInfo::GetFastReadFunction(void) const
+{
+    return m_FastReadFunction;
+}
+
+inline
+CClassTypeInfo* CClassTypeInfo::SetFastReadFunction(TClassFastReadFunction func)
+{
+    m_FastReadFunction = func;
+    return this;
+}
+
 inline
 const CClassTypeInfo::TSubClasses* CClassTypeInfo::SubClasses(void) const
 {
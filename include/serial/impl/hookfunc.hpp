@@ -72,6 +72,13 @@ typedef void (*TMemberCopyFunction)(CObjectStreamCopier& copier,
                                     const CMemberInfo* memberInfo);
 typedef void (*TMemberSkipFunction)(CObjectIStream& in,
                                     const CMemberInfo* memberInfo);
+
+/// Generated (by datatool) reader of class member values.
+/// Reads the value of member 'index' directly into the class object,
+/// returns false (without reading anything) if the member is not handled.
+typedef bool (*TClassFastReadFunction)(CObjectIStream& in,
+                                       TObjectPtr classPtr,
+                                       TMemberIndex index);
 /*
 struct SMemberReadFunctions
 {
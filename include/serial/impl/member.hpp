@@ -140,6 +140,10 @@ public:
     // I/O
     void ReadMember(CObjectIStream& in, TObjectPtr classPtr) const;
     void ReadMissingMember(CObjectIStream& in, TObjectPtr classPtr) const;
+    /// Read member using generated reader of the class (if any),
+    /// fall back to ReadMember() if the member cannot be read by it.
+    void ReadFastMember(CObjectIStream& in, TObjectPtr classPtr,
+                        TClassFastReadFunction fastRead) const;
     void WriteMember(CObjectOStream& out, TConstObjectPtr classPtr) const;
     void CopyMember(CObjectStreamCopier& copier) const;
     void CopyMissingMember(CObjectStreamCopier& copier) const;
@@ -70,9 +70,10 @@ BEGIN_NCBI_SCOPE
 }
 
 #define ReadClassRandomContentsBegin(classType) \
-    ClassRandomContentsBegin(classType)
+    ClassRandomContentsBegin(classType) \
+    TClassFastReadFunction fastRead = x_GetFastReadFunction(classType);
 #define ReadClassRandomContentsMember(classPtr) \
-    ClassRandomContentsMember(Read, (*this, classPtr))
+    ClassRandomContentsMember(ReadFast, (*this, classPtr, fastRead))
 #define ReadClassRandomContentsEnd() \
     ClassRandomContentsEnd(Read, (*this, classPtr))
 
@@ -111,9 +112,20 @@ BEGIN_NCBI_SCOPE
 }
 
 #define ReadClassSequentialContentsBegin(classType) \
-    ClassSequentialContentsBegin(classType)
+    ClassSequentialContentsBegin(classType) \
+    TClassFastReadFunction fastRead = x_GetFastReadFunction(classType);
 #define ReadClassSequentialContentsMember(classPtr) \
-    ClassSequentialContentsMember(Read, (*this, classPtr))
+    { \
+        const CMemberInfo* memberInfo = classType->GetMemberInfo(index); \
+        SetTopMemberId(memberInfo->GetId()); \
+        for ( TMemberIndex i = *pos; i < index; ++i ) { \
+            classType->GetMemberInfo(i)->ReadMissingMember(*this, classPtr); \
+        } \
+        { \
+            memberInfo->ReadFastMember(*this, classPtr, fastRead); \
+        } \
+        pos.SetIndex(index + 1); \
+    }
 #define ReadClassSequentialContentsEnd(classPtr) \
     ClassSequentialContentsEnd(Read, (*this, classPtr))
 
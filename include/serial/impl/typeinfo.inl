@@ -87,6 +87,12 @@ void CTypeInfo::SkipData(CObjectIStream& in) const
     m_SkipHookData.GetCurrentFunction()(in, this);
 }
 
+inline
+bool CTypeInfo::HaveReadHooks(void) const
+{
+    return m_ReadHookData.HaveHooks();
+}
+
 inline
 void CTypeInfo::DefaultReadData(CObjectIStream& in,
                                 TObjectPtr objectPtr) const
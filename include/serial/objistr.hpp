@@ -527,6 +527,14 @@ public:
     EDelayBufferParsing GetDelayBufferParsingPolicy(void) const;
     bool ShouldParseDelayBuffer(void) const;
 
+    /// Read simple class members by readers generated by datatool
+    /// (see "fast_read" code generation style) instead of the generic
+    /// per-member type info functions.  Members with hooks are always
+    /// read in the generic way.
+    /// The default is taken from SERIAL_FAST_READ parameter (enabled).
+    void SetFastRead(bool fast_read = true);
+    bool GetFastRead(void) const;
+
 //---------------------------------------------------------------------------
 // User interface
 
@@ -813,6 +821,16 @@ public:
         }
     // create and set new memory pool
     void UseMemoryPool(void);
+    // allocate objects of each root Read() from a separate memory pool
+    // (arena), so the object tree is placed in a few big chunks, which
+    // are freed when the last object allocated in them is deleted;
+    // chunk_size == 0 means default arena chunk size.
+    // The default is taken from SERIAL_ARENA_ALLOCATION parameter (off).
+    void SetArenaAllocation(bool arena = true, size_t chunk_size = 0);
+    bool GetArenaAllocation(void) const
+        {
+            return m_ArenaChunkSize != 0;
+        }
 
     // internal reader
     void ReadExternalObject(TObjectPtr object, TTypeInfo typeInfo);
@@ -869,6 +887,16 @@ public:
 
         size_t Read(void* dst, size_t length, bool forceLength = false);
 
+        /// Get the next part of the block directly from the input buffer
+        /// (e.g. memory mapped file), without an intermediate copy.
+        /// The data remain valid until the next read from the stream.
+        ///
+        /// @return
+        ///   Number of bytes available at 'data', 0 at the end of block.
+        ///   If the stream cannot provide its data in place, returns 0
+        ///   and sets 'data' to null; use Read() then.
+        size_t ReadInPlace(const char*& data, size_t length);
+
         bool KnownLength(void) const;
         size_t GetExpectedLength(void) const;
 
@@ -1004,6 +1032,8 @@ public:
     // byte block
     virtual void BeginBytes(ByteBlock& block) = 0;
     virtual size_t ReadBytes(ByteBlock& block, char* buffer, size_t count) = 0;
+    virtual size_t ReadBytesInPlace(ByteBlock& block,
+                                    const char*& data, size_t count);
     virtual void EndBytes(const ByteBlock& block);
 
     // char block
@@ -1050,6 +1080,10 @@ protected:
     ESerialDataFormat   m_DataFormat;
     EDelayBufferParsing  m_ParseDelayBuffers;
     TTypeInfo m_TypeAlias;
+    bool m_FastRead;
+
+    // generated reader of class members, if it is allowed for the stream
+    TClassFastReadFunction x_GetFastReadFunction(const CClassTypeInfo* classType) const;
     
 private:
     static CObjectIStream* CreateObjectIStreamAsn(void);
@@ -1084,6 +1118,10 @@ private:
     CStreamPathHook<CVariantInfo*,CSkipChoiceVariantHook*> m_PathSkipVariantHooks;
 
     CRef<CObjectMemoryPool> m_MemoryPool;
+    size_t m_ArenaChunkSize;
+    bool   m_InArenaRead;
+    // installs per Read() memory pool in arena allocation mode
+    class CArenaScope;
 
     TTypeInfo m_MonitorType;
     vector<TTypeInfo> m_ReqMonitorType;
@@ -208,6 +208,8 @@ protected:
 
     virtual void BeginBytes(ByteBlock& block) override;
     virtual size_t ReadBytes(ByteBlock& block, char* dst, size_t length) override;
+    virtual size_t ReadBytesInPlace(ByteBlock& block,
+                                    const char*& data, size_t length) override;
     virtual void EndBytes(const ByteBlock& block) override;
 
     virtual void BeginChars(CharBlock& block) override;
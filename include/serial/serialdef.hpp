@@ -130,7 +130,11 @@ enum ESerialOpenFlags {
     eSerial_StdWhenStd   = 1 << 2, ///< use std when filename is "stdin"/"stdout"
     eSerial_StdWhenMask  = 15,
     eSerial_StdWhenAny   = eSerial_StdWhenMask,
-    eSerial_UseFileForReread = 1 << 4
+    eSerial_UseFileForReread = 1 << 4,
+    /// read the file through a memory mapping: data are taken from the
+    /// mapped region directly instead of being copied into a stream buffer
+    /// (see also SERIAL_READ_MMAPBYTESOURCE)
+    eSerial_MemoryMap        = 1 << 5
 };
 typedef int TSerialOpenFlags;
 
@@ -174,6 +174,9 @@ public:
     void CopyData(CObjectStreamCopier& copier) const;
     void SkipData(CObjectIStream& in) const;
 
+    /// Check if read hooks (global, local or path ones) are set for the type
+    bool HaveReadHooks(void) const;
+
     virtual bool IsParentClassOf(const CClassTypeInfo* classInfo) const;
     virtual bool IsType(TTypeInfo type) const;
 
@@ -37,6 +37,10 @@
 #include <util/simple_buffer.hpp>
 #include <sra/readers/bam/vdbfile.hpp>
 #include <sra/readers/bam/cache_with_lock.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
@@ -104,6 +108,8 @@ public:
 
     // return page that contains the file position
     TPage GetPage(TFilePos pos);
+    // same, but return null page if the file ends exactly at the position
+    TPage GetPageOrEOF(TFilePos pos);
 
     pair<Uint8, double> GetReadStatistics() const;
     void SetPreviousReadStatistics(const pair<Uint8, double>& stats);
@@ -111,6 +117,7 @@ public:
     size_t GetNextPageSizePow2() const;
 
 private:
+    TPage x_GetPage(TFilePos pos);
     void x_AddReadStatistics(Uint8 bytes, double seconds);
     
     void x_ReadPage(CPagedFilePage& page, TFilePos file_pos, size_t size);
@@ -335,6 +342,22 @@ public:
 
     pair<Uint8, double> GetUncompressStatistics() const;
 
+    // Sequential readers (CBGZFStream) schedule decompression of up to
+    // prefetch_blocks blocks ahead of the current one on 'threads'
+    // background threads, so the blocks are ready when the reader gets
+    // to them. Zero threads or blocks disables the read-ahead.
+    // The defaults are taken from [BGZF] THREADS and PREFETCH_BLOCKS.
+    // Should be called before reading starts.
+    void SetPrefetch(unsigned threads, unsigned prefetch_blocks);
+    unsigned GetPrefetchThreads() const
+        {
+            return unsigned(m_PrefetchThreads.size());
+        }
+    unsigned GetPrefetchBlocks() const
+        {
+            return m_PrefetchThreads.empty()? 0: m_PrefetchBlocks;
+        }
+
 protected:
     friend class CBGZFStream;
 
@@ -352,14 +375,34 @@ protected:
                      TFileBlockPos file_pos,
                      CPagedFile::TPage& page,
                      CSimpleBufferT<char>& buffer);
+
+    // parse block header, return file size of the block or 0 at EOF
+    CBGZFBlock::TFileBlockSize x_ReadBlockHeader(TFileBlockPos file_pos,
+                                                 CPagedFile::TPage& page,
+                                                 CSimpleBufferT<char>& buffer,
+                                                 size_t& header_size);
+
+    // queue blocks for decompression by the prefetch threads
+    void x_Prefetch(const vector<TFileBlockPos>& file_positions);
     
 private:
+    void x_StopPrefetch();
+    void x_PrefetchThread();
+
     CRef<CPagedFile> m_File;
     CRef<TBlockCache> m_BlockCache;
 
     mutable CFastMutex m_StatMutex;
     Uint8 m_TotalUncompressBytes;
     double m_TotalUncompressSeconds;
+
+    unsigned m_PrefetchBlocks;
+    vector<thread> m_PrefetchThreads;
+    // Guarded by m_PrefetchMutex
+    mutex m_PrefetchMutex;
+    condition_variable m_PrefetchCond;
+    deque<TFileBlockPos> m_PrefetchQueue;
+    bool m_StopPrefetch;
 };
 
 
@@ -439,6 +482,8 @@ public:
     
 private:
     bool x_NextBlock();
+    void x_ResetPrefetch();
+    void x_Prefetch();
     
     const char* x_Read(CBGZFPos::TFileBlockPos file_pos, size_t size, char* buffer);
     
@@ -452,6 +497,14 @@ private:
     CSimpleBufferT<char> m_InReadBuffer;
     CSimpleBufferT<char> m_OutReadBuffer;
     CBGZFPos m_EndPos;
+
+    // read-ahead state: blocks already scheduled after the current one,
+    // and the position of the next block to schedule
+    // (0 - not known yet, -1 - EOF)
+    CPagedFile::TPage m_PrefetchPage;
+    CSimpleBufferT<char> m_PrefetchBuffer;
+    deque<CBGZFBlock::TFileBlockPos> m_PrefetchQueue;
+    CBGZFBlock::TFileBlockPos m_PrefetchPos;
 };
 
 
@@ -528,6 +528,22 @@ public:
     ///   SetFlags
     void Test(void);
 
+    /// Create a sidecar index of the archive for random access to its
+    /// members (see CTarIndex).
+    ///
+    /// Can be used only with archive files (not streams).  The archive can
+    /// be gzip-compressed, then the index also keeps deflate checkpoints
+    /// taken every "checkpoint_span" bytes of uncompressed data.  Masks
+    /// are ignored, all members are indexed.
+    /// @param index_file
+    ///   Name of the index file, CTarIndex::GetDefaultIndexName() if empty.
+    /// @param checkpoint_span
+    ///   Distance between deflate checkpoints, zero means default.
+    /// @sa
+    ///   CTarIndex
+    void CreateIndex(const string& index_file      = kEmptyStr,
+                     Uint8         checkpoint_span = 0);
+
 
     //------------------------------------------------------------------------
     // Utility functions
@@ -0,0 +1,188 @@
+#ifndef UTIL_COMPRESS__TAR_INDEX__HPP
+#define UTIL_COMPRESS__TAR_INDEX__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Sidecar index for random access to tar archive members
+ */
+
+///  @file
+///  Sidecar index for random access to tar archive members.
+///
+///  The index maps the names of archive members to their positions, so
+///  a single member can be extracted without walking through all the
+///  headers before it.  For gzip-compressed archives (.tar.gz, .tgz)
+///  the index also keeps deflate checkpoints (the state of decompressor
+///  at some block boundaries, every few megabytes of uncompressed data),
+///  so decompression can start at the nearest checkpoint before a member.
+
+#include <util/compress/tar.hpp>
+
+
+/** @addtogroup Compression
+ *
+ * @{
+ */
+
+
+BEGIN_NCBI_SCOPE
+
+
+class CMemoryFile;
+
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// CTarIndex class
+///
+/// Read-only index of a tar archive file, created by CTar::CreateIndex()
+/// (or CTarIndex::Create()).  The index file is memory-mapped on opening.
+/// The index contains only the last copy of each member (as the archive
+/// can contain several copies of the same entry after updates).
+///
+/// The index is bound to the archive by its size and modification time,
+/// so an index for an archive, that has been changed since, cannot be
+/// opened (and should be created again).
+/// (Throws exceptions on errors.)
+///
+/// Example:
+/// @code
+///   CTarIndex index("release.tar.gz");
+///   unique_ptr<IReader> reader(index.Extract("dir/file.asn"));
+///   if (reader) {
+///       CRStream rs(reader.release(), 0, 0, CRWStreambuf::fOwnReader);
+///       ...
+///   }
+/// @endcode
+/// @sa CTar::CreateIndex, CTar::Extract
+
+class NCBI_XUTIL_EXPORT CTarIndex
+{
+public:
+    /// Default distance between deflate checkpoints in uncompressed data.
+    static const Uint8 kDefaultCheckpointSpan;
+
+    /// Archive member, as stored in the index.
+    struct SEntry {
+        string               name;        ///< Member name
+        CTarEntryInfo::EType type;        ///< Member type
+        Uint8                header_pos;  ///< Position of the header(s)
+        Uint8                data_pos;    ///< Position of the data
+        Uint8                size;        ///< Size of the data
+    };
+
+    /// Default index file name for the archive ("<archive>.idx").
+    static string GetDefaultIndexName(const string& archive);
+
+    /// Read the archive and write its index.
+    ///
+    /// @param archive
+    ///   Name of the tar archive file, either uncompressed or gzip-compressed
+    ///   (compression is detected by the file contents).
+    /// @param index_file
+    ///   Name of the index file, GetDefaultIndexName() if empty.
+    /// @param checkpoint_span
+    ///   Distance between deflate checkpoints (in uncompressed data) for
+    ///   compressed archives;  each checkpoint takes 32KB in the index.
+    ///   Zero means kDefaultCheckpointSpan.
+    /// @param flags
+    ///   CTar flags used for reading the archive.
+    /// @sa CTar::CreateIndex
+    static void Create(const string& archive,
+                       const string& index_file      = kEmptyStr,
+                       Uint8         checkpoint_span = 0,
+                       CTar::TFlags  flags           = CTar::fDefault);
+
+    /// Open (memory-map) the index of the archive.
+    /// @param archive
+    ///   Name of the tar archive file.
+    /// @param index_file
+    ///   Name of the index file, GetDefaultIndexName() if empty.
+    CTarIndex(const string& archive, const string& index_file = kEmptyStr);
+
+    /// Destructor.
+    ~CTarIndex();
+
+    /// Return TRUE if the archive is gzip-compressed.
+    bool IsCompressed(void) const;
+
+    /// Number of (distinct) members in the archive.
+    size_t GetEntryCount(void) const;
+
+    /// Get member by its number, the members are sorted by name.
+    SEntry GetEntry(size_t n) const;
+
+    /// Find member by name (exact match).
+    /// @return
+    ///   FALSE if the archive has no such member.
+    bool Find(const string& name, SEntry* entry = 0) const;
+
+    /// Create and return an IReader, which can extract contents of one
+    /// named member, reading only that member from the archive (and for
+    /// compressed archives, the data from the nearest checkpoint before it).
+    /// The ownership of the pointer is passed to the caller.
+    /// @note fStreamPipeThrough will be ignored if passed in flags.
+    /// @return
+    ///   IReader interface to read the file contents with;  0 if the member
+    ///   is not found or is not a file.
+    /// @sa CTar::Extract
+    IReader* Extract(const string& name,
+                     CTar::TFlags  flags = CTar::fSkipUnsupported) const;
+
+private:
+    struct SHeader;
+    struct SIndexEntry;
+    struct SCheckpoint;
+
+    // Open archive stream positioned at "pos" of uncompressed data
+    CNcbiIstream* x_OpenArchive(Uint8 pos) const;
+
+private:
+    string                  m_Archive;      ///< Archive file name
+    unique_ptr<CMemoryFile> m_File;         ///< Index file mapping
+    const SHeader*          m_Header;       ///< Index header
+    const SIndexEntry*      m_Entries;      ///< Members sorted by name
+    const SCheckpoint*      m_Checkpoints;  ///< Checkpoints in archive order
+    const char*             m_Windows;      ///< Dictionaries for checkpoints
+    const char*             m_Names;        ///< Member names
+
+private:
+    // Prohibit assignment and copy
+    CTarIndex& operator=(const CTarIndex&);
+    CTarIndex(const CTarIndex&);
+
+    friend class CGzipCheckpointStreambuf;
+};
+
+
+END_NCBI_SCOPE
+
+
+/* @} */
+
+
+#endif  /* UTIL_COMPRESS__TAR_INDEX__HPP */
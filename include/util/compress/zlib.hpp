@@ -46,6 +46,11 @@
 ///                          (see util/compress/stream.hpp for details).
 /// CZipStreamDecompressor - zlib based decompression stream processor
 ///                          (see util/compress/stream.hpp for details).
+/// CZipBlockCompressor    - zlib based compressor, that compress blocks of
+///                          data in parallel into concatenated gzip members
+///                          (used in CZipBlockStreamCompressor).
+/// CZipBlockStreamCompressor - block-parallel gzip compression stream processor.
+/// CZipBlockIndex         - seek index for the data written by CZipBlockCompressor.
 ///
 /// The zlib documentation can be found here: 
 ///     http://zlib.org,   or
@@ -53,6 +58,8 @@
  
 
 #include <util/compress/stream.hpp>
+#include <deque>
+#include <future>
 
 /** @addtogroup Compression
  *
@@ -122,7 +129,14 @@ public:
         /// It allow to restore the original file name and/or time stamp stored
         /// in the file header, if present.
         /// @sa DecompressFile, DecompressFileIntoDir
-        fRestoreFileAttr       = (1<<5)
+        fRestoreFileAttr       = (1<<5),
+        /// This flag can be used only with CZipBlockCompressor.
+        /// Append a seek index after the compressed blocks, that allow to
+        /// find and decompress any block without reading preceding data.
+        /// The index is stored in empty gzip members, so it is ignored
+        /// by decompressors and gzip/gunzip utility.
+        /// @sa CZipBlockIndex
+        fWriteBlockIndex       = (1<<6)
     };
     typedef CZipCompression::TFlags TZipFlags; ///< Bitwise OR of EFlags
 
@@ -842,6 +856,223 @@ public:
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+///
+/// CZipBlockCompressor -- block-parallel zlib based compressor
+///
+/// Split input data into blocks of fixed size and compress each block into
+/// a separate gzip member on a thread, like "pigz" does. The members are
+/// written in the order of the input data, so the result is a concatenated
+/// gzip file, that can be read by CZipStreamDecompressor/CDecompressIStream
+/// with fGZip flags (fAllowConcatenatedGZip), or by gzip/gunzip utility.
+/// Compression ratio is a bit worse than for CZipCompressor, because each
+/// block starts with an empty dictionary.
+///
+/// With the fWriteBlockIndex flag, a seek index is added at the end
+/// of the data, see CZipBlockIndex.
+///
+/// Used in CZipBlockStreamCompressor.
+/// @note
+///   The gzip format is always used, the fWriteGZipFormat flag is implied.
+///   Dictionaries and file information are not supported.
+/// @sa CZipBlockStreamCompressor, CZipBlockIndex, CZipCompressor
+
+class NCBI_XUTIL_EXPORT CZipBlockCompressor : public CZipCompression,
+                                              public CCompressionProcessor
+{
+public:
+    /// Default size of the uncompressed data block.
+    static const size_t kDefaultBlockSize = 1024 * 1024;
+
+    /// Constructor.
+    /// @param level
+    ///   Compression level.
+    /// @param threads
+    ///   Number of blocks compressed simultaneously.
+    ///   Zero means to compress blocks in the current thread.
+    ///   Up to the same number of filled blocks more wait in a queue
+    ///   until a thread is free.
+    /// @param block_size
+    ///   Size of the uncompressed data block. Flush() ends the current
+    ///   block, so blocks can be smaller. Limited by 1GB.
+    /// @param flags
+    ///   Compression flags (fAllowEmptyData, fWriteBlockIndex).
+    CZipBlockCompressor(
+        ELevel       level      = eLevel_Default,
+        unsigned int threads    = 0,
+        size_t       block_size = kDefaultBlockSize,
+        TZipFlags    flags      = 0
+    );
+
+    /// Destructor.
+    virtual ~CZipBlockCompressor(void);
+
+    /// Return TRUE if fAllowEmptyData flag is set. 
+    virtual bool AllowEmptyData() const
+        { return (GetFlags() & fAllowEmptyData) == fAllowEmptyData; }
+
+protected:
+    virtual EStatus Init   (void);
+    virtual EStatus Process(const char* in_buf,  size_t  in_len,
+                            char*       out_buf, size_t  out_size,
+                            /* out */            size_t* in_avail,
+                            /* out */            size_t* out_avail);
+    virtual EStatus Flush  (char*       out_buf, size_t  out_size,
+                            /* out */            size_t* out_avail);
+    virtual EStatus Finish (char*       out_buf, size_t  out_size,
+                            /* out */            size_t* out_avail);
+    virtual EStatus End    (int abandon = 0);
+
+private:
+    /// Compressed block.
+    struct SBlock {
+        string data;      ///< gzip member
+        size_t size;      ///< size of uncompressed data
+        int    errcode;   ///< zlib error code if compression failed
+        string message;   ///< error description
+    };
+
+    // Queue the current block for compression
+    void   x_StartBlock(void);
+    // Start compression of queued blocks while there are free threads
+    void   x_LaunchBlocks(void);
+    // Move compressed blocks to the output, wait for them if 'wait' is TRUE
+    bool   x_CollectBlocks(bool wait);
+    // Copy ready output data to the buffer
+    size_t x_CopyOutput(char* out_buf, size_t out_size);
+    // Append index to the output
+    void   x_WriteIndex(void);
+
+private:
+    unsigned int          m_Threads;    ///< Number of compression threads
+    size_t                m_BlockSize;  ///< Size of uncompressed block
+    string                m_Block;      ///< Data for the current block
+    deque<future<SBlock>> m_Pending;    ///< Blocks in compression, in order
+    deque<string>         m_Queued;     ///< Blocks waiting for a thread
+    string                m_Output;     ///< Compressed data ready for output
+    size_t                m_OutputPos;  ///< Position of unread data in m_Output
+    vector<pair<Uint4, Uint4>> m_Index; ///< Compressed/uncompressed block sizes
+    Uint8                 m_RawSize;    ///< Total size of compressed data
+    bool                  m_Finished;   ///< TRUE if Finish() has ended all blocks
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/// CZipBlockStreamCompressor -- block-parallel gzip compression stream processor
+///
+/// See util/compress/stream.hpp for details of stream processing.
+/// Example:
+/// @code
+///   CCompressionOStream os(file,
+///       new CZipBlockStreamCompressor(CZipCompression::eLevel_Default, 8, CZipCompression::fWriteBlockIndex),
+///       CCompressionStream::fOwnWriter);
+/// @endcode
+/// @sa CZipBlockCompressor, CCompressionStreamProcessor
+
+class NCBI_XUTIL_EXPORT CZipBlockStreamCompressor
+    : public CCompressionStreamProcessor
+{
+public:
+    /// Full constructor
+    CZipBlockStreamCompressor(
+        CZipCompression::ELevel    level,
+        unsigned int               threads,
+        size_t                     block_size,
+        streamsize                 in_bufsize,
+        streamsize                 out_bufsize,
+        CZipCompression::TZipFlags flags = 0
+        ) 
+        : CCompressionStreamProcessor(
+              new CZipBlockCompressor(level, threads, block_size, flags),
+              eDelete, in_bufsize, out_bufsize)
+    {}
+
+    /// Conventional constructor.
+    /// Uses default block and buffer sizes.
+    CZipBlockStreamCompressor(
+        CZipCompression::ELevel    level,
+        unsigned int               threads,
+        CZipCompression::TZipFlags flags = 0
+        )
+        : CCompressionStreamProcessor(
+              new CZipBlockCompressor(level, threads,
+                                      CZipBlockCompressor::kDefaultBlockSize, flags),
+              eDelete, kCompressionDefaultBufSize, kCompressionDefaultBufSize)
+    {}
+
+    /// Return a pointer to compressor.
+    /// Can be used mostly for setting an advanced compression-specific parameters.
+    CZipBlockCompressor* GetCompressor(void) const {
+        return dynamic_cast<CZipBlockCompressor*>(GetProcessor());
+    }
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/// CZipBlockIndex -- seek index for the data written by CZipBlockCompressor
+///
+/// The index is written by CZipBlockCompressor with the fWriteBlockIndex flag.
+/// It is stored in the "extra field" of empty gzip members after the data,
+/// and the last member of fixed size points to them, so it can be found
+/// from the end of the stream. Each block is an independent gzip member,
+/// so it can be decompressed starting from its position, for example:
+/// @code
+///   CZipBlockIndex index;
+///   if (index.Read(file)) {
+///       const CZipBlockIndex::SBlock& block = index.GetBlock(index.FindBlock(pos));
+///       file.seekg(block.raw_pos);
+///       CDecompressIStream is(file, CCompressStream::eGZipFile);
+///       is.ignore(pos - block.data_pos);
+///       ...
+///   }
+/// @endcode
+/// @sa CZipBlockCompressor
+
+class NCBI_XUTIL_EXPORT CZipBlockIndex
+{
+public:
+    /// Block of compressed data.
+    struct SBlock {
+        Uint8  raw_pos;    ///< Position of the gzip member in the stream
+        size_t raw_size;   ///< Size of the gzip member
+        Uint8  data_pos;   ///< Position of the block in uncompressed data
+        size_t data_size;  ///< Size of uncompressed data
+    };
+
+    /// Read index from the end of the seekable stream.
+    /// The stream position is not restored.
+    /// @return
+    ///   FALSE if the stream has no index.
+    bool Read(CNcbiIstream& is);
+
+    /// Number of blocks.
+    size_t GetBlockCount(void) const { return m_Blocks.size(); }
+
+    /// Get block by number.
+    const SBlock& GetBlock(size_t n) const { return m_Blocks[n]; }
+
+    /// Total size of uncompressed data.
+    Uint8 GetDataSize(void) const;
+
+    /// Find block that contains given position in uncompressed data.
+    /// @return
+    ///   Block number, or GetBlockCount() if the position is out of data.
+    size_t FindBlock(Uint8 data_pos) const;
+
+    /// Read and decompress single block.
+    /// @return
+    ///   FALSE on read or decompression error.
+    bool ReadBlock(CNcbiIstream& is, size_t n, string& data) const;
+
+private:
+    vector<SBlock> m_Blocks;
+};
+
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // Global functions
@@ -381,6 +381,15 @@ public:
     static int GetWindowLogMin(void);
     static int GetWindowLogMax(void);
 
+    /// Number of worker threads used for compression.
+    /// With a non-zero value the input is split into jobs, compressed
+    /// in parallel by zstd and written as a single regular frame, so it
+    /// can be decompressed as usual. Zero (default) means to compress
+    /// in the calling thread. Ignored if the zstd library is built
+    /// without multithreading support.
+    void SetThreads(int value)  { m_c_Threads = value; }
+    int  GetThreads(void) const { return m_c_Threads; }
+
 protected:
     /// Format string with last error description.
     /// If pos == 0, that use internal m_Stream's position to report.
@@ -400,6 +409,7 @@ protected:
     // Advanced parametes
     int   m_c_Strategy;    ///< used for compression
     int   m_cd_WindowLog;  ///< used for compression & decompression
+    int   m_c_Threads;     ///< used for compression
 
     // Dictionary
     bool  m_c_DictLoaded;  ///< TRUE if compression dictionary has loaded
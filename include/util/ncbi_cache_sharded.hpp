@@ -0,0 +1,570 @@
+#ifndef UTIL___NCBI_CACHE_SHARDED__HPP
+#define UTIL___NCBI_CACHE_SHARDED__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *      Generic cache split into independently locked shards.
+ *
+ */
+
+#include <util/ncbi_cache.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+
+BEGIN_NCBI_SCOPE
+
+/** @addtogroup Cache
+ *
+ * @{
+ */
+
+
+/// @file ncbi_cache_sharded.hpp
+/// Cache for use by many threads at once
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///    Sharded cache.
+///
+/// The cache is split into a number of shards selected by the key hash,
+/// each with its own lock, capacity and optional limit on the total size
+/// of its elements, so threads working with different keys rarely wait
+/// for each other.
+///
+/// Within a shard elements are evicted in CLOCK order (approximate LRU):
+/// a hit only sets the element's "referenced" bit, so Get() needs just a
+/// read lock, and the eviction scan gives a second chance to every element
+/// referenced since it was last passed.
+///
+/// Unlike CCache there are no element weights, and Add() does not return
+/// element index. THandler has the same interface as for CCache (see
+/// CCacheElement_Handler), but is called from several threads at once
+/// for elements from different shards.
+/// THash is the hash function for TKey; TKey must also have operator==.
+/// TLock must define TReadLockGuard and TWriteLockGuard subtypes.
+/// @sa CCache
+template <class TKey,
+          class TValue,
+          class THandler = CCacheElement_Handler<TKey, TValue>,
+          class THash    = std::hash<TKey>,
+          class TLock    = CFastRWLock>
+class CShardedCache
+{
+public:
+    typedef TKey          TKeyType;
+    typedef TValue        TValueType;
+    typedef size_t        TSizeType;
+
+    /// Create cache object
+    /// @param capacity
+    ///   Maximum number of elements in the cache, must be > 0.
+    /// @param shards
+    ///   Number of shards. Zero selects a number based on the number
+    ///   of CPUs, but no more than capacity.
+    /// @param max_bytes
+    ///   Maximum total size of elements (as passed to Add()), zero means
+    ///   no limit.
+    /// @param handler
+    ///   Element handler, the cache takes ownership.
+    /// @note
+    ///   Both capacity and max_bytes are split evenly between shards.
+    CShardedCache(TSizeType capacity,
+                  TSizeType shards    = 0,
+                  TSizeType max_bytes = 0,
+                  THandler* handler   = NULL);
+
+    ~CShardedCache(void);
+
+    /// Get the number of shards
+    TSizeType GetShardCount(void) const { return m_Shards.size(); }
+
+    /// Get current number of elements in the cache
+    TSizeType GetSize(void) const;
+
+    /////////////////////////////////////////////////////
+
+    /// Flags to control the details of adding new elements to the cache
+    /// via Add().
+    /// @sa Add()
+    enum EAddFlags {
+        fAdd_NoReplace = (1 << 0) ///< Do not replace existing values if any
+    };
+    typedef int TAddFlags;        ///< bitwise OR of EAddFlags
+
+    /// Result of element insertion
+    enum EAddResult {
+        eAdd_Inserted,    ///< The element was added to the cache
+        eAdd_Replaced,    ///< The element existed and was replaced
+        eAdd_NotInserted  ///< The element was not added or replaced
+    };
+
+    /// Add new element to the cache or replace the existing value.
+    /// @param key
+    ///   Element key
+    /// @param value
+    ///   Element value
+    /// @param bytes
+    ///   Size of the element counted against the max_bytes limit.
+    /// @param add_flags
+    ///   Flags to control Add() behavior.
+    /// @return
+    ///   Operation result code.
+    EAddResult Add(const TKeyType&   key,
+                   const TValueType& value,
+                   TSizeType         bytes     = 0,
+                   TAddFlags         add_flags = 0);
+
+    /// Cache retrieval flags
+    enum EGetFlags {
+        fGet_NoTouch  = (1 << 0),  ///< Do not mark the object as used.
+        fGet_NoCreate = (1 << 1),  ///< Do not create value if not found, throw
+                                   ///< an exception instead.
+        fGet_NoInsert = (1 << 2)   ///< Do not insert created values.
+    };
+    typedef int TGetFlags;         ///< bitwise OR of EGetFlags
+
+    /// Get() result
+    enum EGetResult {
+        eGet_Found,            ///< The key was found in the cache
+        eGet_CreatedAndAdded,  ///< A new value was created and cached
+        eGet_CreatedNotAdded   ///< A new value was created but not cached
+    };
+
+    /// Get an object from the cache by its key. Depending on flags create
+    /// and cache a new value if the key is not found. If the flags do not
+    /// allow creating new elements, throws an exception.
+    /// @note
+    ///   A new value is created without holding any lock, so several
+    ///   threads missing the same key can create it concurrently; the value
+    ///   cached first is kept and returned to all of them (with eGet_Found).
+    ///   The other values are dropped like the ones not cached: they were
+    ///   never passed to the handler's InsertElement(), so RemoveElement()
+    ///   is not called for them either.
+    TValueType Get(const TKeyType& key,
+                   TGetFlags       get_flags = 0,
+                   EGetResult*     result = NULL);
+
+    /// Find cached value without creating a new one.
+    /// @return
+    ///   TRUE if the key was found
+    bool Find(const TKeyType& key, TValueType& value,
+              TGetFlags get_flags = 0);
+
+    /// Remove element from cache. Do nothing if the key is not cached.
+    bool Remove(const TKeyType& key);
+
+    /// Remove all elements
+    void Clear(void);
+
+    /// Cache statistics
+    /// @sa GetStatistics()
+    struct SStatistics
+    {
+        Uint8 m_Hits      = 0;  ///< Get() found the key
+        Uint8 m_Misses    = 0;  ///< Get() did not find the key
+        Uint8 m_Evictions = 0;  ///< Elements removed to make room for others
+        Uint8 m_Size      = 0;  ///< Number of elements in the cache
+        Uint8 m_Bytes     = 0;  ///< Total size of elements as given to Add()
+    };
+
+    /// Get hit, miss and eviction counters summed over all shards
+    SStatistics GetStatistics(void) const;
+
+private:
+    // Prohibit copy constructor and assignment.
+    CShardedCache(const CShardedCache&);
+    CShardedCache& operator=(const CShardedCache&);
+
+    typedef TLock                                TLockType;
+    typedef typename TLockType::TReadLockGuard   TReadGuard;
+    typedef typename TLockType::TWriteLockGuard  TWriteGuard;
+    typedef THandler                             THandlerType;
+
+    struct SSlot {
+        TKeyType          m_Key;
+        TValueType        m_Value;
+        TSizeType         m_Bytes = 0;
+        bool              m_Used  = false;
+        std::atomic<bool> m_Referenced{false};
+    };
+
+    typedef std::unordered_map<TKeyType, TSizeType, THash> TIndex;
+
+    // Each shard is allocated separately to keep their locks and
+    // counters in different cache lines.
+    struct SShard {
+        explicit SShard(TSizeType capacity) : m_Slots(capacity) {}
+
+        mutable TLockType   m_Lock;
+        std::vector<SSlot>  m_Slots;
+        std::vector<TSizeType> m_FreeSlots;
+        TIndex              m_Index;
+        TSizeType           m_Hand  = 0;
+        TSizeType           m_Bytes = 0;
+        std::atomic<Uint8>  m_Hits{0};
+        std::atomic<Uint8>  m_Misses{0};
+        Uint8               m_Evictions = 0;
+    };
+
+    SShard& x_GetShard(const TKeyType& key) const;
+    bool x_Find(SShard& shard, const TKeyType& key, TValueType& value,
+                TGetFlags get_flags);
+    void x_EraseSlot(SShard& shard, TSizeType index);
+    // Evict one element chosen by the CLOCK hand, false if the shard is empty
+    bool x_EvictOne(SShard& shard);
+
+    THash                    m_Hash;
+    std::vector<unique_ptr<SShard>> m_Shards;
+    TSizeType                m_MaxBytes;  // per shard
+    unique_ptr<THandlerType> m_Handler;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+//  CShardedCache<> implementation
+//
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+CShardedCache<TKey, TValue, THandler, THash, TLock>::CShardedCache(
+    TSizeType capacity,
+    TSizeType shards,
+    TSizeType max_bytes,
+    THandler* handler)
+{
+    if (capacity == 0) {
+        NCBI_THROW(CCacheException, eOtherError,
+                   "Cache capacity must be positive");
+    }
+    if (shards == 0) {
+        // a few shards per CPU keep collisions between threads rare
+        shards = 4 * TSizeType(CSystemInfo::GetCpuCount());
+    }
+    shards = std::min(shards, capacity);
+    if ( handler != NULL ) m_Handler.reset(handler);
+    else                   m_Handler.reset(new THandler());
+
+    m_MaxBytes = max_bytes ? (max_bytes + shards - 1) / shards : 0;
+    m_Shards.reserve(shards);
+    for (TSizeType i = 0;  i < shards;  ++i) {
+        // spread the remainder over the first shards
+        TSizeType shard_capacity = capacity / shards + (i < capacity % shards);
+        m_Shards.emplace_back(new SShard(shard_capacity));
+        SShard& shard = *m_Shards.back();
+        shard.m_FreeSlots.reserve(shard_capacity);
+        for (TSizeType slot = shard_capacity;  slot > 0;  --slot) {
+            shard.m_FreeSlots.push_back(slot - 1);
+        }
+        shard.m_Index.reserve(shard_capacity);
+    }
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+CShardedCache<TKey, TValue, THandler, THash, TLock>::~CShardedCache(void)
+{
+    Clear();
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+inline
+typename CShardedCache<TKey, TValue, THandler, THash, TLock>::SShard&
+CShardedCache<TKey, TValue, THandler, THash, TLock>::x_GetShard(
+    const TKeyType& key) const
+{
+    // std::hash is identity for integers, mix the bits before taking
+    // the remainder
+    Uint8 hash = Uint8(m_Hash(key)) * NCBI_CONST_UINT8(0x9E3779B97F4A7C15);
+    return *m_Shards[TSizeType(hash >> 32) % m_Shards.size()];
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+void CShardedCache<TKey, TValue, THandler, THash, TLock>::x_EraseSlot(
+    SShard&   shard,
+    TSizeType index)
+{
+    SSlot& slot = shard.m_Slots[index];
+    _ASSERT(slot.m_Used);
+    m_Handler->RemoveElement(slot.m_Key, slot.m_Value);
+    shard.m_Index.erase(slot.m_Key);
+    shard.m_Bytes -= slot.m_Bytes;
+    slot.m_Key = TKeyType();
+    slot.m_Value = TValueType();
+    slot.m_Bytes = 0;
+    slot.m_Used = false;
+    slot.m_Referenced.store(false, std::memory_order_relaxed);
+    shard.m_FreeSlots.push_back(index);
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+bool CShardedCache<TKey, TValue, THandler, THash, TLock>::x_EvictOne(
+    SShard& shard)
+{
+    if ( shard.m_Index.empty() ) {
+        return false;
+    }
+    // Terminates within two turns: the first one clears all bits
+    TSizeType size = shard.m_Slots.size();
+    for (;;) {
+        TSizeType index = shard.m_Hand;
+        shard.m_Hand = (index + 1) % size;
+        SSlot& slot = shard.m_Slots[index];
+        if ( !slot.m_Used ) {
+            continue;
+        }
+        if ( slot.m_Referenced.exchange(false, std::memory_order_relaxed) ) {
+            continue;
+        }
+        x_EraseSlot(shard, index);
+        ++shard.m_Evictions;
+        return true;
+    }
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+typename CShardedCache<TKey, TValue, THandler, THash, TLock>::EAddResult
+CShardedCache<TKey, TValue, THandler, THash, TLock>::Add(
+    const TKeyType&   key,
+    const TValueType& value,
+    TSizeType         bytes,
+    TAddFlags         add_flags)
+{
+    SShard& shard = x_GetShard(key);
+    if (m_MaxBytes  &&  bytes > m_MaxBytes) {
+        return eAdd_NotInserted;
+    }
+
+    TWriteGuard guard(shard.m_Lock);
+    EAddResult result = eAdd_Inserted;
+    auto it = shard.m_Index.find(key);
+    if (it != shard.m_Index.end()) {
+        if ((add_flags & fAdd_NoReplace) != 0) {
+            return eAdd_NotInserted;
+        }
+        x_EraseSlot(shard, it->second);
+        result = eAdd_Replaced;
+    }
+
+    for (ECache_InsertFlag ins_flag = m_Handler->CanInsertElement(key, value);;
+         ins_flag = m_Handler->CanInsertElement(key, value)) {
+        if (ins_flag == eCache_CheckSize) {
+            while (shard.m_FreeSlots.empty()
+                   ||  (m_MaxBytes  &&  shard.m_Bytes + bytes > m_MaxBytes)) {
+                x_EvictOne(shard);
+            }
+            break;
+        }
+        else if (ins_flag == eCache_CanInsert) {
+            if ( shard.m_FreeSlots.empty() ) {
+                x_EvictOne(shard);
+            }
+            break;
+        }
+        else if (ins_flag == eCache_DoNotCache) {
+            return eAdd_NotInserted;
+        }
+        else if (ins_flag == eCache_NeedCleanup) {
+            if ( !x_EvictOne(shard) ) {
+                // Can not cleanup
+                return eAdd_NotInserted;
+            }
+        }
+    }
+
+    m_Handler->InsertElement(key, value);
+
+    TSizeType index = shard.m_FreeSlots.back();
+    shard.m_FreeSlots.pop_back();
+    SSlot& slot = shard.m_Slots[index];
+    slot.m_Key = key;
+    slot.m_Value = value;
+    slot.m_Bytes = bytes;
+    slot.m_Used = true;
+    // A new element has to be used once to survive the next CLOCK turn
+    slot.m_Referenced.store(false, std::memory_order_relaxed);
+    shard.m_Index[key] = index;
+    shard.m_Bytes += bytes;
+    return result;
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+inline
+bool CShardedCache<TKey, TValue, THandler, THash, TLock>::x_Find(
+    SShard&         shard,
+    const TKeyType& key,
+    TValueType&     value,
+    TGetFlags       get_flags)
+{
+    TReadGuard guard(shard.m_Lock);
+    auto it = shard.m_Index.find(key);
+    if (it == shard.m_Index.end()) {
+        shard.m_Misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    SSlot& slot = shard.m_Slots[it->second];
+    if ((get_flags & fGet_NoTouch) == 0
+        &&  !slot.m_Referenced.load(std::memory_order_relaxed)) {
+        // Avoid writing the shared cache line if the bit is already set
+        slot.m_Referenced.store(true, std::memory_order_relaxed);
+    }
+    value = slot.m_Value;
+    shard.m_Hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+bool CShardedCache<TKey, TValue, THandler, THash, TLock>::Find(
+    const TKeyType& key,
+    TValueType&     value,
+    TGetFlags       get_flags)
+{
+    return x_Find(x_GetShard(key), key, value, get_flags);
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+typename CShardedCache<TKey, TValue, THandler, THash, TLock>::TValueType
+CShardedCache<TKey, TValue, THandler, THash, TLock>::Get(
+    const TKeyType& key,
+    TGetFlags       get_flags,
+    EGetResult*     result)
+{
+    SShard& shard = x_GetShard(key);
+    TValueType value;
+    if ( x_Find(shard, key, value, get_flags) ) {
+        if ( result ) {
+            *result = eGet_Found;
+        }
+        return value;
+    }
+
+    // Could not find the key - try to create a new element
+    if ((get_flags & fGet_NoCreate) != 0) {
+        NCBI_THROW(CCacheException, eNotFound,
+            "Can not find the requested key");
+    }
+
+    value = m_Handler->CreateValue(key);
+    EGetResult get_result = eGet_CreatedNotAdded;
+    if ((get_flags & fGet_NoInsert) == 0) {
+        if (Add(key, value, 0, fAdd_NoReplace) != eAdd_NotInserted) {
+            get_result = eGet_CreatedAndAdded;
+        }
+        else {
+            // Either another thread was faster - use its value, or the
+            // handler did not let the value in (e.g. eCache_DoNotCache)
+            TReadGuard guard(shard.m_Lock);
+            auto it = shard.m_Index.find(key);
+            if (it != shard.m_Index.end()) {
+                value = shard.m_Slots[it->second].m_Value;
+                get_result = eGet_Found;
+            }
+        }
+    }
+    if ( result ) {
+        *result = get_result;
+    }
+    return value;
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+bool CShardedCache<TKey, TValue, THandler, THash, TLock>::Remove(
+    const TKeyType& key)
+{
+    SShard& shard = x_GetShard(key);
+    TWriteGuard guard(shard.m_Lock);
+    auto it = shard.m_Index.find(key);
+    if (it == shard.m_Index.end()) {
+        return false;
+    }
+    x_EraseSlot(shard, it->second);
+    return true;
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+void CShardedCache<TKey, TValue, THandler, THash, TLock>::Clear(void)
+{
+    for (auto& shard : m_Shards) {
+        TWriteGuard guard(shard->m_Lock);
+        for (TSizeType i = 0;  i < shard->m_Slots.size();  ++i) {
+            if ( shard->m_Slots[i].m_Used ) {
+                x_EraseSlot(*shard, i);
+            }
+        }
+        _ASSERT(shard->m_Index.empty());
+    }
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+typename CShardedCache<TKey, TValue, THandler, THash, TLock>::TSizeType
+CShardedCache<TKey, TValue, THandler, THash, TLock>::GetSize(void) const
+{
+    TSizeType size = 0;
+    for (auto& shard : m_Shards) {
+        TReadGuard guard(shard->m_Lock);
+        size += shard->m_Index.size();
+    }
+    return size;
+}
+
+
+template <class TKey, class TValue, class THandler, class THash, class TLock>
+typename CShardedCache<TKey, TValue, THandler, THash, TLock>::SStatistics
+CShardedCache<TKey, TValue, THandler, THash, TLock>::GetStatistics(void) const
+{
+    SStatistics stat;
+    for (auto& shard : m_Shards) {
+        TReadGuard guard(shard->m_Lock);
+        stat.m_Hits      += shard->m_Hits.load(std::memory_order_relaxed);
+        stat.m_Misses    += shard->m_Misses.load(std::memory_order_relaxed);
+        stat.m_Evictions += shard->m_Evictions;
+        stat.m_Size      += shard->m_Index.size();
+        stat.m_Bytes     += shard->m_Bytes;
+    }
+    return stat;
+}
+
+
+/* @} */
+
+END_NCBI_SCOPE
+
+#endif  // UTIL___NCBI_CACHE_SHARDED__HPP
@@ -69,6 +69,25 @@ public:
     typedef ECodingType  TCodingType;
 
     static ECodingType GetCodingType(TCoding coding);
+
+    /// Vector instruction set used by CSeqConvert and CSeqManip for the
+    /// most common nucleotide conversions (IUPACna <-> NCBI2na/NCBI4na,
+    /// reverse complement).  Results do not depend on the level.
+    enum ESimdLevel {
+        eSimd_None,   ///< conversion tables only
+        eSimd_SSSE3,  ///< 128-bit kernels
+        eSimd_AVX2    ///< 256-bit kernels
+    };
+
+    /// Get the level in use; by default the best one supported by both
+    /// the build and the CPU, detected on first use.
+    static ESimdLevel GetSimdLevel(void);
+
+    /// Limit the level in use (e.g. for benchmarking or troubleshooting).
+    /// Levels not available are lowered to the best available one.
+    /// @return
+    ///   The level actually set.
+    static ESimdLevel SetSimdLevel(ESimdLevel level);
 };
 
 
@@ -101,6 +101,11 @@ public:
     // skip chars which may not be in buffer
     void GetChars(size_t count)
         THROWS1((CIOException));
+    // get up to 'count' chars directly from the buffer, without copying;
+    // the chars are skipped and remain valid until the next read.
+    // return: number of chars available at 'data' (0 if 'count' is 0)
+    size_t GetCharsInPlace(const char*& data, size_t count)
+        THROWS1((CIOException));
 
     // precondition: last char extracted was either '\r' or '\n'
     // action: increment line count and
@@ -62,6 +62,7 @@ class CThreadPool_Controller;
 class CThreadPool_Thread;
 class CThreadPool_ThreadImpl;
 class CThreadPoolException;
+class CStealingThreadPool_Impl;
 
 
 
@@ -166,6 +167,7 @@ protected:
 
 private:
     friend class CThreadPool_Impl;
+    friend class CStealingThreadPool_Impl;
 
     /// Init all members in constructor
     /// @param priority
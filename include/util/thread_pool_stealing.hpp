@@ -0,0 +1,149 @@
+#ifndef UTIL___THREAD_POOL_STEALING__HPP
+#define UTIL___THREAD_POOL_STEALING__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ */
+
+/// @file thread_pool_stealing.hpp
+/// Pool of threads with a work-stealing scheduler.
+///
+///  CStealingThreadPool -- executes CThreadPool_Task objects on a fixed
+///     number of threads without any pool-wide lock: every thread owns a
+///     double-ended queue of tasks, tasks added from outside of the pool go
+///     through a bounded lock-free queue, and idle threads steal tasks
+///     from the busy ones.
+
+
+#include <util/thread_pool.hpp>
+
+
+/** @addtogroup ThreadedPools
+ *
+ * @{
+ */
+
+
+BEGIN_NCBI_SCOPE
+
+
+class CStealingThreadPool_Impl;
+
+
+/// Pool of threads for large numbers of small tasks.
+///
+/// Unlike CThreadPool it has no controller (the number of threads is fixed
+/// for the whole life of the pool) and no exclusive execution. Tasks added
+/// by a task running in the pool go to the current thread's own queue and
+/// are executed in LIFO order, other threads can steal them in FIFO order.
+/// Tasks added from outside of the pool are executed in FIFO order.
+///
+/// @note
+///   Only tasks with the default priority 0 go through the lock-free
+///   queues. Tasks with a non-zero priority are kept in a common queue
+///   protected by a mutex; they are started only when no task with priority
+///   0 is found, in the order of their priorities (the smaller the sooner),
+///   and in the order of addition for equal priorities.
+/// @note
+///   CThreadPool_Task::GetPool() returns NULL for tasks added to this pool,
+///   and CThreadPool_Task::RequestToCancel() is equivalent to CancelTask().
+
+class NCBI_XUTIL_EXPORT CStealingThreadPool
+{
+public:
+    /// Constructor
+    /// @param queue_size
+    ///   Maximum number of tasks added from outside of the pool and waiting
+    ///   for execution, separately for tasks with priority 0 and with other
+    ///   priorities. If the limit is reached AddTask() waits for the
+    ///   given timeout. Tasks added by other tasks are not limited.
+    /// @param threads
+    ///   Number of threads in the pool, cannot be 0.
+    /// @param threads_mode
+    ///   Running mode of all threads in thread pool. Values fRunDetached and
+    ///   fRunAllowST are ignored.
+    CStealingThreadPool(unsigned int      queue_size,
+                        unsigned int      threads,
+                        CThread::TRunMode threads_mode = CThread::fRunDefault);
+
+    /// Destructor -- cancels all queued tasks and waits for all threads
+    /// to finish their current tasks.
+    /// If the pool is destroyed by a task running in it, the destructor
+    /// waits for all other threads only. The thread running the task cancels
+    /// the remaining tasks and releases the pool when the task returns.
+    /// @sa Abort()
+    virtual ~CStealingThreadPool(void);
+
+    /// Add task to the pool for execution.
+    /// The pool holds a CRef to the task until it is finished.
+    /// @param task
+    ///   Task to add
+    /// @param timeout
+    ///   Time to wait if the queue of tasks added from outside of the pool
+    ///   has reached its maximum length. If NULL, then wait indefinitely.
+    void AddTask(CThreadPool_Task* task, const CTimeSpan* timeout = NULL);
+
+    /// Request to cancel the task. A queued task will not be executed,
+    /// an executing one has to check IsCancelRequested() itself.
+    void CancelTask(CThreadPool_Task* task);
+
+    /// Cancel all queued tasks and wait for all threads to finish their
+    /// current tasks.
+    /// @attention
+    ///   You must not call any methods of the pool after that.
+    /// @attention
+    ///   Throws CThreadPoolException (eProhibited) if called by a task
+    ///   running in the pool, as the thread cannot wait for itself.
+    void Abort(void);
+
+    /// Check if the pool is already aborted
+    bool IsAborted(void) const;
+
+    /// Get total number of threads in the pool
+    unsigned int GetThreadsCount(void) const;
+
+    /// Get the number of tasks currently waiting in all queues.
+    /// The value is approximate while tasks are being added or executed.
+    unsigned int GetQueuedTasksCount(void) const;
+
+    /// Get the number of currently executing tasks
+    unsigned int GetExecutingTasksCount(void) const;
+
+private:
+    /// Prohibit copying and assigning
+    CStealingThreadPool(const CStealingThreadPool&);
+    CStealingThreadPool& operator= (const CStealingThreadPool&);
+
+    unique_ptr<CStealingThreadPool_Impl> m_Impl;
+};
+
+
+END_NCBI_SCOPE
+
+
+/* @} */
+
+#endif  /* UTIL___THREAD_POOL_STEALING__HPP */
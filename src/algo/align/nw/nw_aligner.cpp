@@ -35,6 +35,7 @@
 #include <ncbi_pch.hpp>
 
 #include "nw_aligner_threads.hpp"
+#include "nw_aligner_simd.hpp"
 #include "messages.hpp"
 
 #include <corelib/ncbi_system.hpp>
@@ -305,6 +306,32 @@ CNWAligner::TScore CNWAligner::x_Align(SAlignInOut* data)
 
     --k;
 
+    // Global alignments fill whole stripes of rows with the vectorized
+    // kernel; the remaining rows (at least the last one, which may have
+    // free end gaps) are done below.
+    if( !m_SmithWaterman ) {
+        CNWAlignerSimd simd (m_ScoreMatrix, m_Seq2 + data->m_offset2,
+                             data->m_len2, wg1, ws1, m_Wg, m_Ws,
+                             bFreeGapRight2, m_GapPreference == eLater);
+        const size_t lanes = simd.GetLanes();
+        vector<Uint1> trace (lanes * N2);
+        while(lanes > 0 && size_t(seq1_end - seq1) > lanes && !m_terminate) {
+
+            simd.AlignStripe(seq1, V0, wsleft2,
+                             &stl_rowV[0], &stl_rowF[0], &trace[0]);
+            for(size_t kk = 0; kk < lanes * N2; ++kk) {
+                backtrace_matrix.SetAt(++k, trace[kk]);
+            }
+            seq1 += lanes;
+            V0 += TScore(lanes) * wsleft2;
+
+            if(m_prg_callback) {
+                m_prg_info.m_iter_done = k;
+                m_terminate = m_prg_callback(&m_prg_info);
+            }
+        }
+    }
+
     for(;  seq1 != seq1_end && !m_terminate;  ++seq1) {
 
         backtrace_matrix.SetAt(++k, kMaskFc);
@@ -0,0 +1,455 @@
+/* $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:  Vectorized dynamic programming for CNWAligner
+*
+* One kernel template is instantiated for SSE2 (4 lanes of 32 bits) and
+* AVX2 (8 lanes); the level is selected at run time with CCpuFeatures.
+* Scores stay 32 bits wide so no saturation or rescaling is ever needed.
+*
+*/
+
+#include <ncbi_pch.hpp>
+
+#include "nw_aligner_simd.hpp"
+
+#include <corelib/ncbi_system.hpp>
+
+#include <atomic>
+
+#if defined(NCBI_SSE)  &&  NCBI_SSE >= 20
+#  define NCBI_NW_SSE2
+#  include <emmintrin.h>
+#  if (defined(__GNUC__)  ||  defined(__clang__))  &&  \
+      (defined(__x86_64__)  ||  defined(__i386__))
+#    define NCBI_NW_AVX2
+#    define NW_AVX2_TARGET __attribute__((target("avx2")))
+#    include <immintrin.h>
+// the kernel template passes AVX2 vectors by value, but only ever runs
+// inlined into the AVX2 entry point
+#    pragma GCC diagnostic ignored "-Wpsabi"
+#  endif
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Kernel level selection
+
+
+static std::atomic<int> s_SimdLevel(-1);
+
+
+static CNWAligner::ESimdLevel s_GetBestSimdLevel(void)
+{
+#ifdef NCBI_NW_AVX2
+    if ( CCpuFeatures::AVX2()  &&  CCpuFeatures::AVX()  &&
+         CCpuFeatures::OSXSAVE() ) {
+        return CNWAligner::eSimd_AVX2;
+    }
+#endif
+#ifdef NCBI_NW_SSE2
+    return CNWAligner::eSimd_SSE2;
+#else
+    return CNWAligner::eSimd_None;
+#endif
+}
+
+
+static inline int s_GetSimdLevel(void)
+{
+    int level = s_SimdLevel.load(std::memory_order_relaxed);
+    if ( level < 0 ) {
+        level = s_GetBestSimdLevel();
+        s_SimdLevel.store(level, std::memory_order_relaxed);
+    }
+    return level;
+}
+
+
+CNWAligner::ESimdLevel CNWAligner::GetSimdLevel(void)
+{
+    return ESimdLevel(s_GetSimdLevel());
+}
+
+
+CNWAligner::ESimdLevel CNWAligner::SetSimdLevel(ESimdLevel level)
+{
+    ESimdLevel best = s_GetBestSimdLevel();
+    if ( level > best ) {
+        level = best;
+    }
+    s_SimdLevel.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+
+// same bit coding as in nw_aligner.cpp
+const unsigned char kMaskFc  = 0x01;
+const unsigned char kMaskEc  = 0x02;
+const unsigned char kMaskE   = 0x04;
+const unsigned char kMaskD   = 0x08;
+
+
+#ifdef NCBI_NW_SSE2
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Kernel
+
+
+typedef CNWAligner::TScore TScore;
+
+// Everything the kernel needs for one stripe
+struct SNWStripe
+{
+    const TNCBIScore*    sm;           // score matrix, NCBI_FSM_DIM wide
+    int                  row_offs[8];  // per lane: seq1 residue * DIM
+    TScore               initV[8];     // per lane: V in column 0
+    const unsigned char* seq2;         // padded seq2, pointing at seq2[0]
+    int                  len2;
+    TScore               wg1, ws1, wg2, ws2;
+    bool                 free_right2;
+    bool                 gap_later;
+    TScore*              rowV;
+    TScore*              rowF;
+    Uint1*               diags;
+};
+
+
+struct SNWOpsSSE2
+{
+    typedef __m128i V;
+    enum { kLanes = 4 };
+
+    static V Set1(int x)            { return _mm_set1_epi32(x); }
+    static V Load(const int* p)
+        { return _mm_loadu_si128(reinterpret_cast<const V*>(p)); }
+    static V LaneIndex(void)        { return _mm_setr_epi32(0, 1, 2, 3); }
+    static V Add(V a, V b)          { return _mm_add_epi32(a, b); }
+    static V Sub(V a, V b)          { return _mm_sub_epi32(a, b); }
+    static V Gt(V a, V b)           { return _mm_cmpgt_epi32(a, b); }
+    static V Eq(V a, V b)           { return _mm_cmpeq_epi32(a, b); }
+    static V And(V a, V b)          { return _mm_and_si128(a, b); }
+    // ~a & b
+    static V AndNot(V a, V b)       { return _mm_andnot_si128(a, b); }
+    static V Or(V a, V b)           { return _mm_or_si128(a, b); }
+    static V Not(V a)
+        { return _mm_xor_si128(a, _mm_cmpeq_epi32(a, a)); }
+    // m ? a : b, m being all ones or all zeros in every lane
+    static V Select(V m, V a, V b)  { return Or(And(m, a), AndNot(m, b)); }
+
+    // lane l gets lane l - 1 of v, lane 0 gets x
+    static V ShiftIn(V v, int x)
+        { return _mm_or_si128(_mm_slli_si128(v, 4), _mm_cvtsi32_si128(x)); }
+
+    static int Last(V v)
+        { return _mm_cvtsi128_si32(_mm_srli_si128(v, 12)); }
+
+    // lane l gets sm[row_offs[l] + s2[-l]]
+    static V Scores(const SNWStripe& s, const V& /*offs*/,
+                    const unsigned char* s2)
+    {
+        return _mm_setr_epi32(s.sm[s.row_offs[0] + s2[ 0]],
+                              s.sm[s.row_offs[1] + s2[-1]],
+                              s.sm[s.row_offs[2] + s2[-2]],
+                              s.sm[s.row_offs[3] + s2[-3]]);
+    }
+
+    // low byte of every lane
+    static void StoreBytes(Uint1* dst, V v)
+    {
+        V b = _mm_packs_epi32(v, v);
+        b = _mm_packus_epi16(b, b);
+        int x = _mm_cvtsi128_si32(b);
+        memcpy(dst, &x, 4);
+    }
+};
+
+
+#ifdef NCBI_NW_AVX2
+
+struct SNWOpsAVX2
+{
+    typedef __m256i V;
+    enum { kLanes = 8 };
+
+    NW_AVX2_TARGET static V Set1(int x) { return _mm256_set1_epi32(x); }
+    NW_AVX2_TARGET static V Load(const int* p)
+        { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+    NW_AVX2_TARGET static V LaneIndex(void)
+        { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    NW_AVX2_TARGET static V Add(V a, V b) { return _mm256_add_epi32(a, b); }
+    NW_AVX2_TARGET static V Sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    NW_AVX2_TARGET static V Gt(V a, V b)
+        { return _mm256_cmpgt_epi32(a, b); }
+    NW_AVX2_TARGET static V Eq(V a, V b)
+        { return _mm256_cmpeq_epi32(a, b); }
+    NW_AVX2_TARGET static V And(V a, V b) { return _mm256_and_si256(a, b); }
+    NW_AVX2_TARGET static V AndNot(V a, V b)
+        { return _mm256_andnot_si256(a, b); }
+    NW_AVX2_TARGET static V Or(V a, V b) { return _mm256_or_si256(a, b); }
+    NW_AVX2_TARGET static V Not(V a)
+        { return _mm256_xor_si256(a, _mm256_cmpeq_epi32(a, a)); }
+    NW_AVX2_TARGET static V Select(V m, V a, V b)
+        { return _mm256_blendv_epi8(b, a, m); }
+
+    NW_AVX2_TARGET static V ShiftIn(V v, int x)
+    {
+        V p = _mm256_permutevar8x32_epi32
+            (v, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+        return _mm256_blend_epi32(p, _mm256_set1_epi32(x), 0x01);
+    }
+
+    NW_AVX2_TARGET static int Last(V v)
+        { return _mm256_extract_epi32(v, 7); }
+
+    NW_AVX2_TARGET static V Scores(const SNWStripe& s, const V& offs,
+                                   const unsigned char* s2)
+    {
+        // s2[-7 .. 0] reversed, so lane l gets s2[-l]
+        V c = _mm256_cvtepu8_epi32
+            (_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s2 - 7)));
+        c = _mm256_permutevar8x32_epi32
+            (c, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        return _mm256_i32gather_epi32(s.sm, _mm256_add_epi32(offs, c), 4);
+    }
+
+    NW_AVX2_TARGET static void StoreBytes(Uint1* dst, V v)
+    {
+        V b = _mm256_packs_epi32(v, v);
+        b = _mm256_packus_epi16(b, b);
+        int lo = _mm_cvtsi128_si32(_mm256_castsi256_si128(b));
+        int hi = _mm_cvtsi128_si32(_mm256_extracti128_si256(b, 1));
+        memcpy(dst, &lo, 4);
+        memcpy(dst + 4, &hi, 4);
+    }
+};
+
+#endif  /* NCBI_NW_AVX2 */
+
+
+// Lane l fills row l of the stripe, at step t working on column
+// j = t - l; see nw_aligner_simd.hpp.  Every step evaluates exactly the
+// scalar recurrences of CNWAligner::x_Align(); lanes outside of the
+// matrix compute values nobody reads.
+template<class TOps>
+static inline void s_AlignStripe(const SNWStripe& s)
+{
+    typedef typename TOps::V V;
+    const int kLanes = TOps::kLanes;
+
+    const V lane    = TOps::LaneIndex();
+    const V offs    = TOps::Load(s.row_offs);
+    const V initV   = TOps::Load(s.initV);
+    const V inf     = TOps::Set1(kInfMinus);
+    const V zero    = TOps::Set1(0);
+    const V wg1     = TOps::Set1(s.wg1);
+    const V ws1     = TOps::Set1(s.ws1);
+    const V wg2     = TOps::Set1(s.wg2);
+    const V ws2     = TOps::Set1(s.ws2);
+    const V lastcol = TOps::Set1(s.len2);
+    const V mFc     = TOps::Set1(kMaskFc);
+    const V mEc     = TOps::Set1(kMaskEc);
+    const V mE      = TOps::Set1(kMaskE);
+    const V mD      = TOps::Set1(kMaskD);
+
+    V Vout  = zero;  // V  of (i, j - 1)
+    V Fout  = zero;  // F  of (i, j - 1)
+    V E     = inf;   // E  of (i, j - 1)
+    V Vdiag = zero;  // V  of (i - 1, j - 1)
+
+    const int steps = s.len2 + kLanes;
+    for (int t = 0;  t < steps;  ++t) {
+
+        const V j = TOps::Sub(TOps::Set1(t), lane);
+
+        // the row above: lane 0 reads the buffer, others their neighbour
+        TScore Vbuf = t <= s.len2 ? s.rowV[t] : 0;
+        TScore Fbuf = t <= s.len2 ? s.rowF[t] : 0;
+        const V Vup = TOps::ShiftIn(Vout, Vbuf);
+        const V Fup = TOps::ShiftIn(Fout, Fbuf);
+
+        const V G = TOps::Add(Vdiag, TOps::Scores(s, offs, s.seq2 + t - 1));
+        Vdiag = Vup;
+
+        // gap in seq1
+        V n0  = TOps::Add(Vout, wg1);
+        V gtE = TOps::Gt(n0, E);
+        E = TOps::Add(TOps::Select(gtE, n0, E), ws1);
+        V tracer = TOps::AndNot(gtE, mEc);
+
+        // gap in seq2, free in the last column if requested
+        V wg2v = wg2, ws2v = ws2;
+        if (s.free_right2) {
+            V last = TOps::Eq(j, lastcol);
+            wg2v = TOps::AndNot(last, wg2);
+            ws2v = TOps::AndNot(last, ws2);
+        }
+        n0 = TOps::Add(Vup, wg2v);
+        V gtF = TOps::Gt(n0, Fup);
+        const V F = TOps::Add(TOps::Select(gtF, n0, Fup), ws2v);
+        tracer = TOps::Or(tracer, TOps::AndNot(gtF, mFc));
+
+        // best score, with the same tie-breaking as the scalar code
+        V c1, c2;
+        if (s.gap_later) {
+            c1 = TOps::Not(TOps::Gt(G, F));
+            c2 = TOps::Not(TOps::Gt(G, E));
+        }
+        else {
+            c1 = TOps::Gt(F, G);
+            c2 = TOps::Gt(E, G);
+        }
+        const V EleF = TOps::Not(TOps::Gt(E, F));
+        V Vnew = TOps::Select(c1, TOps::Select(EleF, F, E),
+                                  TOps::Select(c2, E, G));
+        V isE = TOps::Or(TOps::AndNot(EleF, c1), TOps::AndNot(c1, c2));
+        V isD = TOps::Not(TOps::Or(c1, c2));
+        tracer = TOps::Or(tracer, TOps::Or(TOps::And(isE, mE),
+                                           TOps::And(isD, mD)));
+
+        // column 0 holds the initial values of the row
+        const V first = TOps::Eq(j, zero);
+        Vout = TOps::Select(first, initV, Vnew);
+        E    = TOps::Select(first, inf, E);
+        Fout = F;
+
+        TOps::StoreBytes(s.diags + size_t(t) * kLanes, tracer);
+
+        // the last lane writes the last row of the stripe
+        int jl = t - (kLanes - 1);
+        if (jl >= 0  &&  jl <= s.len2) {
+            s.rowV[jl] = TOps::Last(Vout);
+            s.rowF[jl] = TOps::Last(Fout);
+        }
+    }
+}
+
+
+static void s_AlignStripe_SSE2(const SNWStripe& s)
+{
+    s_AlignStripe<SNWOpsSSE2>(s);
+}
+
+
+#ifdef NCBI_NW_AVX2
+NW_AVX2_TARGET __attribute__((flatten))
+static void s_AlignStripe_AVX2(const SNWStripe& s)
+{
+    s_AlignStripe<SNWOpsAVX2>(s);
+}
+#endif
+
+#endif  /* NCBI_NW_SSE2 */
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CNWAlignerSimd
+
+
+CNWAlignerSimd::CNWAlignerSimd(const SNCBIFullScoreMatrix& sm,
+                               const char* seq2, size_t len2,
+                               TScore wg1, TScore ws1,
+                               TScore wg2, TScore ws2,
+                               bool free_right2, bool gap_later)
+    : m_ScoreMatrix(sm),
+      m_Lanes(0),
+      m_Level(s_GetSimdLevel()),
+      m_Len2(len2),
+      m_Wg1(wg1), m_Ws1(ws1), m_Wg2(wg2), m_Ws2(ws2),
+      m_FreeRight2(free_right2),
+      m_GapLater(gap_later)
+{
+    switch (m_Level) {
+    case CNWAligner::eSimd_AVX2:  m_Lanes = 8;  break;
+    case CNWAligner::eSimd_SSE2:  m_Lanes = 4;  break;
+    default:                      return;
+    }
+
+    // the scores are looked up with 32-bit indices
+    if (len2 + 2 * m_Lanes >= size_t(kMax_Int)) {
+        m_Lanes = 0;
+        return;
+    }
+
+    m_Seq2.assign(len2 + 2 * m_Lanes, 0);
+    memcpy(&m_Seq2[m_Lanes], seq2, len2);
+    m_Diags.resize((len2 + m_Lanes) * m_Lanes);
+}
+
+
+void CNWAlignerSimd::AlignStripe(const char* seq1, TScore V0,
+                                 TScore wsleft2,
+                                 TScore* rowV, TScore* rowF, Uint1* trace)
+{
+#ifdef NCBI_NW_SSE2
+    SNWStripe s;
+    s.sm = &m_ScoreMatrix.s[0][0];
+    for (size_t l = 0;  l < m_Lanes;  ++l) {
+        s.row_offs[l] = int((unsigned char)seq1[l]) * NCBI_FSM_DIM;
+        V0 += wsleft2;
+        s.initV[l] = V0;
+    }
+    s.seq2 = reinterpret_cast<const unsigned char*>(&m_Seq2[m_Lanes]);
+    s.len2 = int(m_Len2);
+    s.wg1 = m_Wg1;
+    s.ws1 = m_Ws1;
+    s.wg2 = m_Wg2;
+    s.ws2 = m_Ws2;
+    s.free_right2 = m_FreeRight2;
+    s.gap_later = m_GapLater;
+    s.rowV = rowV;
+    s.rowF = rowF;
+    s.diags = &m_Diags[0];
+
+#ifdef NCBI_NW_AVX2
+    if (m_Lanes == 8) {
+        s_AlignStripe_AVX2(s);
+    } else
+#endif
+    {
+        s_AlignStripe_SSE2(s);
+    }
+
+    // anti-diagonals to rows
+    const size_t N2 = m_Len2 + 1;
+    for (size_t l = 0;  l < m_Lanes;  ++l) {
+        Uint1* row = trace + l * N2;
+        const Uint1* diag = &m_Diags[l * m_Lanes + l];
+        row[0] = kMaskFc;
+        for (size_t j = 1;  j < N2;  ++j) {
+            row[j] = diag[j * m_Lanes];
+        }
+    }
+#endif
+}
+
+
+END_NCBI_SCOPE
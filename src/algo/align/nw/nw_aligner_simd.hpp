@@ -0,0 +1,88 @@
+#ifndef ALGO___NW_ALIGNER_SIMD__HPP
+#define ALGO___NW_ALIGNER_SIMD__HPP
+
+/* $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:  Vectorized dynamic programming for CNWAligner
+*
+* The matrix is filled in stripes of as many rows as there are vector
+* lanes.  Within a stripe lane l works on row i0 + l and lags one column
+* behind lane l - 1, so at every step the lanes hold one anti-diagonal of
+* the stripe: everything a cell needs from the row above was computed by
+* the neighbouring lane at the previous step.  Each cell is evaluated with
+* exactly the same arithmetic and tie-breaking as the scalar loop in
+* CNWAligner::x_Align(), so scores and backtrace are identical.
+*
+*/
+
+#include <algo/align/nw/nw_aligner.hpp>
+
+
+BEGIN_NCBI_SCOPE
+
+
+class CNWAlignerSimd
+{
+public:
+    typedef CNWAligner::TScore TScore;
+
+    // seq2 and the gap costs are the same for all stripes of an alignment;
+    // wg1/ws1 are the costs of gaps in seq1 (along a row), wg2/ws2 of gaps
+    // in seq2 (along a column), the latter being free in the last column
+    // if free_right2 is set
+    CNWAlignerSimd(const SNCBIFullScoreMatrix& sm,
+                   const char* seq2, size_t len2,
+                   TScore wg1, TScore ws1, TScore wg2, TScore ws2,
+                   bool free_right2, bool gap_later);
+
+    // Rows per stripe; 0 if no vector code is available or enabled
+    size_t GetLanes(void) const { return m_Lanes; }
+
+    // Fill one stripe of GetLanes() rows starting with row seq1[0].
+    // rowV/rowF hold V and F of the row above the stripe and receive
+    // those of its last row (both len2 + 1 long, as in x_Align()).
+    // V0 is V in column 0 of the row above, wsleft2 the cost of
+    // extending the gap in column 0.  trace receives GetLanes() rows of
+    // len2 + 1 backtrace values (four bits used) each.
+    void AlignStripe(const char* seq1, TScore V0, TScore wsleft2,
+                     TScore* rowV, TScore* rowF, Uint1* trace);
+
+private:
+    const SNCBIFullScoreMatrix& m_ScoreMatrix;
+    size_t         m_Lanes;
+    int            m_Level;
+    vector<char>   m_Seq2;  // seq2 with m_Lanes zero bytes on each side
+    size_t         m_Len2;
+    TScore         m_Wg1, m_Ws1, m_Wg2, m_Ws2;
+    bool           m_FreeRight2;
+    bool           m_GapLater;
+    vector<Uint1>  m_Diags; // backtrace values of a stripe by anti-diagonal
+};
+
+
+END_NCBI_SCOPE
+
+#endif  /* ALGO___NW_ALIGNER_SIMD__HPP */
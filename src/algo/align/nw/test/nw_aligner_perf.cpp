@@ -0,0 +1,253 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   CNWAligner throughput with the scalar and the vectorized dynamic
+ *   programming, and check that all of them produce the same alignments.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/random_gen.hpp>
+#include <algo/align/nw/nw_aligner.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+/// A pair of sequences with the ends to treat as free
+struct SPair
+{
+    string seq1;
+    string seq2;
+    bool   esf[4];
+};
+
+
+/// Score and transcript of one alignment
+struct SResult
+{
+    CNWAligner::TScore score;
+    string             transcript;
+};
+
+
+class CNWAlignerPerfApp : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    // Related sequences: seq2 is a copy of seq1 with substitutions and
+    // short indels, in every other pair embedded into unrelated flanks
+    // (free end gaps in seq1), like a transcript and its genomic region
+    void x_MakePairs(void);
+
+    // Read consecutive FASTA records as pairs
+    void x_ReadPairs(CNcbiIstream& in);
+
+    // Align all pairs at the current level
+    double x_Run(vector<SResult>& results);
+
+    vector<SPair> m_Pairs;
+};
+
+
+void CNWAlignerPerfApp::Init(void)
+{
+    SetDiagPostLevel(eDiag_Error);
+
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+    d->SetUsageContext(GetArguments().GetProgramBasename(),
+                       "CNWAligner scalar vs vectorized throughput");
+    d->AddDefaultKey("pairs", "count", "number of generated pairs",
+                     CArgDescriptions::eInteger, "50");
+    d->AddDefaultKey("length", "bases", "length of generated sequences",
+                     CArgDescriptions::eInteger, "3000");
+    d->AddDefaultKey("divergence", "percent",
+                     "percent of substitutions and indels in generated pairs",
+                     CArgDescriptions::eDouble, "3");
+    d->AddDefaultKey("seed", "number", "random generator seed",
+                     CArgDescriptions::eInteger, "1");
+    d->AddOptionalKey("fasta", "file",
+                      "align consecutive records of a FASTA file instead",
+                      CArgDescriptions::eInputFile);
+    SetupArgDescriptions(d.release());
+}
+
+
+void CNWAlignerPerfApp::x_MakePairs(void)
+{
+    const CArgs& args = GetArgs();
+    size_t pairs  = size_t(args["pairs"].AsInteger());
+    size_t length = size_t(args["length"].AsInteger());
+    double divergence = args["divergence"].AsDouble() / 100;
+    CRandom rnd(CRandom::TValue(args["seed"].AsInteger()));
+
+    static const char kBases[] = "ACGT";
+    auto random_seq = [&rnd](size_t len) {
+        string seq(len, 'A');
+        for (char& c : seq) {
+            c = kBases[rnd.GetRand(0, 3)];
+        }
+        return seq;
+    };
+    const CRandom::TValue kDiverge =
+        CRandom::TValue(divergence * CRandom::GetMax());
+
+    for (size_t p = 0;  p < pairs;  ++p) {
+        SPair pair;
+        pair.seq1 = random_seq(length);
+        for (char c : pair.seq1) {
+            if (rnd.GetRand() >= kDiverge) {
+                pair.seq2 += c;
+                continue;
+            }
+            switch (rnd.GetRand(0, 2)) {
+            case 0:  // substitution
+                pair.seq2 += kBases[rnd.GetRand(0, 3)];
+                break;
+            case 1:  // deletion
+                break;
+            default: // insertion
+                pair.seq2 += c;
+                pair.seq2 += random_seq(rnd.GetRand(1, 5));
+            }
+        }
+        bool embedded = p % 2 != 0;
+        if (embedded) {
+            pair.seq2 = random_seq(length / 4) + pair.seq2
+                + random_seq(length / 4);
+        }
+        pair.esf[0] = pair.esf[1] = embedded;
+        pair.esf[2] = pair.esf[3] = false;
+        m_Pairs.push_back(pair);
+    }
+}
+
+
+void CNWAlignerPerfApp::x_ReadPairs(CNcbiIstream& in)
+{
+    vector<string> seqs;
+    string line;
+    while (NcbiGetlineEOL(in, line)) {
+        if (NStr::StartsWith(line, ">")) {
+            seqs.push_back(kEmptyStr);
+        }
+        else if ( !seqs.empty() ) {
+            line = NStr::TruncateSpaces(line);
+            seqs.back() += NStr::ToUpper(line);
+        }
+    }
+    for (size_t i = 0;  i + 1 < seqs.size();  i += 2) {
+        SPair pair;
+        pair.seq1 = seqs[i];
+        pair.seq2 = seqs[i + 1];
+        pair.esf[0] = pair.esf[1] = pair.esf[2] = pair.esf[3] = false;
+        m_Pairs.push_back(pair);
+    }
+}
+
+
+double CNWAlignerPerfApp::x_Run(vector<SResult>& results)
+{
+    results.clear();
+    CStopWatch sw(CStopWatch::eStart);
+    for (const SPair& pair : m_Pairs) {
+        CNWAligner aligner(pair.seq1, pair.seq2);
+        aligner.SetEndSpaceFree(pair.esf[0], pair.esf[1],
+                                pair.esf[2], pair.esf[3]);
+        SResult result;
+        result.score = aligner.Run();
+        result.transcript = aligner.GetTranscriptString();
+        results.push_back(result);
+    }
+    return sw.Elapsed();
+}
+
+
+int CNWAlignerPerfApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    if (args["fasta"]) {
+        x_ReadPairs(args["fasta"].AsInputFile());
+    }
+    else {
+        x_MakePairs();
+    }
+
+    double cells = 0;
+    for (const SPair& pair : m_Pairs) {
+        cells += double(pair.seq1.size() + 1) * (pair.seq2.size() + 1);
+    }
+    NcbiCout << "Pairs: " << m_Pairs.size()
+             << ", matrix cells: " << cells << NcbiEndl;
+
+    static const char* kLevelNames[] = { "scalar", "SSE2", "AVX2" };
+    CNWAligner::ESimdLevel initial = CNWAligner::GetSimdLevel();
+
+    bool ok = true;
+    vector<SResult> reference, results;
+    for (int level = CNWAligner::eSimd_None;
+         level <= CNWAligner::eSimd_AVX2;  ++level) {
+        if (CNWAligner::SetSimdLevel(CNWAligner::ESimdLevel(level))
+            != level) {
+            continue;
+        }
+        double elapsed = x_Run(level == 0 ? reference : results);
+        NcbiCout << setw(8) << left << kLevelNames[level]
+                 << fixed << setprecision(3) << right << setw(9) << elapsed
+                 << " s  " << setprecision(1) << setw(8)
+                 << (elapsed > 0 ? cells / elapsed / 1e6 : 0)
+                 << " Mcells/s" << NcbiEndl;
+
+        for (size_t i = 0;  level > 0  &&  i < results.size();  ++i) {
+            if (results[i].score != reference[i].score  ||
+                results[i].transcript != reference[i].transcript) {
+                NcbiCout << "  pair " << i << " differs from scalar"
+                         << NcbiEndl;
+                ok = false;
+            }
+        }
+    }
+    CNWAligner::SetSimdLevel(initial);
+
+    if ( !ok ) {
+        NcbiCout << "FAILED" << NcbiEndl;
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CNWAlignerPerfApp().AppMain(argc, argv);
+}
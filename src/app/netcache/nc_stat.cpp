@@ -234,6 +234,8 @@ CNCStat::x_ClearStats(void)
     m_PeerDataRead = 0;
     m_DiskDataWrite = 0;
     m_DiskDataRead = 0;
+    for (int i = 0; i < eReadTierCount; ++i)
+        m_TierReads[i] = 0;
     m_MaxBlobSize = 0;
     m_ClWrBlobs = 0;
     m_ClWrBlobSize = 0;
@@ -342,6 +344,8 @@ CNCStat::x_AddStats(CNCStat* src_stat)
     m_PeerDataRead += src_stat->m_PeerDataRead;
     m_DiskDataWrite += src_stat->m_DiskDataWrite;
     m_DiskDataRead += src_stat->m_DiskDataRead;
+    for (int i = 0; i < eReadTierCount; ++i)
+        m_TierReads[i] += src_stat->m_TierReads[i];
     m_MaxBlobSize = max(m_MaxBlobSize, src_stat->m_MaxBlobSize);
     m_ClWrBlobs += src_stat->m_ClWrBlobs;
     m_ClWrBlobSize += src_stat->m_ClWrBlobSize;
@@ -578,6 +582,12 @@ CNCStat::DiskDataRead(size_t data_size)
     AtomicAdd(s_Stat()->m_DiskDataRead, data_size);
 }
 
+void
+CNCStat::TierBlobRead(ENCReadTier tier)
+{
+    AtomicAdd(s_Stat()->m_TierReads[tier], 1);
+}
+
 void
 CNCStat::DiskBlobWrite(Uint8 blob_size)
 {
@@ -795,7 +805,10 @@ CNCStat::PrintToLogs(CTempString stat_name)
         .PrintParam("disk_write", m_DiskDataWrite)
         .PrintParam("avg_disk_write", m_DiskDataWrite / time_secs)
         .PrintParam("disk_read", m_DiskDataRead)
-        .PrintParam("avg_disk_read", m_DiskDataRead / time_secs);
+        .PrintParam("avg_disk_read", m_DiskDataRead / time_secs)
+        .PrintParam("mem_tier_reads", m_TierReads[eReadTierMemory])
+        .PrintParam("hot_tier_reads", m_TierReads[eReadTierHot])
+        .PrintParam("file_tier_reads", m_TierReads[eReadTierFile]);
     diag.PrintParam("cl_wr_blobs", m_ClWrBlobs)
         .PrintParam("cl_wr_avg_blobs", m_ClWrBlobs / time_secs)
         .PrintParam("cl_wr_size", m_ClWrBlobSize)
@@ -854,6 +867,10 @@ void CNCStat::PrintState(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("wb_releasing" ).WriteText(str).WriteText(iss)
                                       .WriteText(NStr::UInt8ToString_DataSize( m_EndState.wb_releasing)).WriteText("\"");
     task.WriteText(eol).WriteText("wb_releasing" ).WriteText(is ).WriteNumber( m_EndState.wb_releasing);
+    task.WriteText(eol).WriteText("hot_size"     ).WriteText(str).WriteText(iss)
+                                      .WriteText(NStr::UInt8ToString_DataSize( m_EndState.hot_size)).WriteText("\"");
+    task.WriteText(eol).WriteText("hot_size"     ).WriteText(is ).WriteNumber( m_EndState.hot_size);
+    task.WriteText(eol).WriteText("hot_blobs"    ).WriteText(is ).WriteNumber( m_EndState.hot_blobs);
     
     task.WriteText(eol).WriteText("cnt_another_server_main" ).WriteText(is ).WriteNumber( m_EndState.cnt_another_server_main);
     task.WriteText(eol).WriteText("avg_tdiff_blobcopy" ).WriteText(is ).WriteNumber( m_EndState.avg_tdiff_blobcopy);
@@ -1086,6 +1103,18 @@ CNCStat::PrintToSocket(CSrvSocketTask* sock)
     proxy << "Disk reads - "
                     << g_ToSizeStr(m_DiskDataRead) << ", "
                     << g_ToSizeStr(m_DiskDataRead / time_secs) << "/s" << endl;
+    Uint8 tier_reads = m_TierReads[eReadTierMemory] + m_TierReads[eReadTierHot]
+                       + m_TierReads[eReadTierFile];
+    proxy << "Tier reads - "
+                    << g_ToSmartStr(m_TierReads[eReadTierMemory]) << " memory ("
+                    << g_CalcStatPct(m_TierReads[eReadTierMemory], tier_reads) << "%), "
+                    << g_ToSmartStr(m_TierReads[eReadTierHot]) << " hot ("
+                    << g_CalcStatPct(m_TierReads[eReadTierHot], tier_reads) << "%), "
+                    << g_ToSmartStr(m_TierReads[eReadTierFile]) << " file ("
+                    << g_CalcStatPct(m_TierReads[eReadTierFile], tier_reads) << "%)" << endl;
+    proxy << "Hot tier - "
+                    << g_ToSizeStr(m_EndState.hot_size) << ", "
+                    << g_ToSmartStr(m_EndState.hot_blobs) << " blobs" << endl;
     proxy << "Shrink check - "
                     << g_ToSmartStr(m_CntCleanedFiles) << " files ("
                     << g_ToSmartStr(m_CntFailedFiles) << " failed), "
@@ -62,6 +62,8 @@ struct SNCStateStat
     size_t wb_size;
     size_t wb_releasable;
     size_t wb_releasing;
+    size_t hot_size;
+    Uint8  hot_blobs;
     Uint8  cnt_another_server_main;
     Uint8  avg_tdiff_blobcopy; // average time diff between blob creation time and the time it is sent to mirror
     Uint8  max_tdiff_blobcopy; // maximum time diff between blob creation time and the time it is sent to mirror
@@ -100,6 +102,14 @@ public:
     static void PeerSyncFinished(Uint8 srv_id, Uint2 slot, Uint8 cnt_ops, bool success);
     static void DiskDataWrite(size_t data_size);
     static void DiskDataRead(size_t data_size);
+    /// Where the chunk of blob data was read from
+    enum ENCReadTier {
+        eReadTierMemory,    ///< write-back memory
+        eReadTierHot,       ///< hot tier (in memory copy)
+        eReadTierFile,      ///< database file
+        eReadTierCount
+    };
+    static void TierBlobRead(ENCReadTier tier);
     static void DiskBlobWrite(Uint8 blob_size);
     static void DBFileCleaned(bool success, Uint4 seen_recs,
                               Uint4 moved_recs, Uint4 moved_size);
@@ -141,6 +151,7 @@ private:
     Uint8 m_PeerDataRead;
     Uint8 m_DiskDataWrite;
     Uint8 m_DiskDataRead;
+    Uint8 m_TierReads[eReadTierCount];
     Uint8 m_MaxBlobSize;
     Uint8 m_ClWrBlobs;
     Uint8 m_ClWrBlobSize;
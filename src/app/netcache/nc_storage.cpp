@@ -590,6 +590,11 @@ s_ReadVariableParams(const CNcbiRegistry& reg)
     SetWBFailedWriteDelay(reg.GetInt(kNCStorage_RegSection, "write_back_failed_delay", 2));
     s_TaskPriorityWbMemRelease = reg.GetInt(kNCStorage_RegSection, kNCStorage_WbMemRelease, 10);
 
+    SetHotTierSizeLimit(NStr::StringToUInt8_DataSize(reg.GetString(
+                        kNCStorage_RegSection, "hot_tier_size_limit", "0")));
+    SetHotTierMaxBlobSize(Uint4(NStr::StringToUInt8_DataSize(reg.GetString(
+                          kNCStorage_RegSection, "hot_tier_max_blob_size", "64 KB"))));
+
     int failed_write = reg.GetInt(kNCStorage_RegSection, kNCStorage_FailedWriteSize, 0);
     CNCBlobAccessor::SetFailedWriteCount((Uint4)failed_write);
     return true;
@@ -1394,6 +1399,10 @@ void CNCBlobStorage::WriteSetup(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("write_back_timeout"        ).WriteText(is ).WriteNumber( GetWBWriteTimeout());
     task.WriteText(eol).WriteText("write_back_failed_delay"   ).WriteText(is ).WriteNumber( GetWBFailedWriteDelay());
     task.WriteText(eol).WriteText(kNCStorage_WbMemRelease).WriteText(is).WriteNumber(s_TaskPriorityWbMemRelease);
+    task.WriteText(eol).WriteText("hot_tier_size_limit"       ).WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( GetHotTierSizeLimit())).WriteText(eos);
+    task.WriteText(eol).WriteText("hot_tier_size_limit"       ).WriteText(is ).WriteNumber( GetHotTierSizeLimit());
+    task.WriteText(eol).WriteText("hot_tier_max_blob_size"    ).WriteText(is ).WriteNumber( GetHotTierMaxBlobSize());
     task.WriteText(eol).WriteText(kNCStorage_FailedWriteSize  ).WriteText(is ).WriteNumber( CNCBlobAccessor::GetFailedWriteCount());
 }
 
@@ -4137,6 +4146,8 @@ CNCAlerts::Register(CNCAlerts::eDebugMoveRecord3,"eFileRecChunkData");
         }
     }
     else {
+        // Copy in the hot tier remembers old coordinates of the blob
+        ForgetHotBlob(m_CacheData->key);
         m_CacheData->lock.Unlock();
         s_MoveRecToGarbage(m_MaxFile, m_IndRec);
     }
@@ -36,6 +36,7 @@
 #include "storage_types.hpp"
 #include "nc_stat.hpp"
 #include <set>
+#include <unordered_map>
 
 BEGIN_NCBI_SCOPE
 
@@ -97,6 +98,65 @@ static Uint8 s_BlobNotify = 0;
 static Uint8 s_BlobNotifyTDiff = 0;
 static Uint8 s_BlobNotifyMaxTDiff = 0;
 
+/// Hot tier: copies of small frequently read blobs (their data and
+/// meta-information) kept in memory after the blobs were written to the
+/// database files and released from write-back memory. Reading such blob
+/// doesn't touch database files at all. Blobs are admitted using TinyLFU
+/// policy: new blob can replace the least recently used one only if it was
+/// read more often recently (by the estimate of count-min sketch).
+///
+/// Number of independently locked parts of the hot tier.
+static const Uint1 kHotTierShards = 16;
+/// Number of rows and counters in a row of the frequency sketch of each part.
+static const Uint1 kHotSketchDepth = 4;
+static const Uint4 kHotSketchWidth = 1 << 16;
+/// Maximum value of a counter in the sketch.
+static const Uint1 kHotSketchMaxFreq = 15;
+/// After this many reads counted in the sketch all counters are halved, so
+/// that blobs that were popular long ago don't stay in the tier forever.
+static const Uint4 kHotSketchSample = 10 * kHotSketchWidth;
+
+struct SNCHotBlob
+{
+    string  key;
+    SNCDataCoord coord;
+    SNCDataCoord data_coord;
+    Uint8   create_time;
+    Uint8   create_server;
+    Uint4   create_id;
+    unsigned int ttl;
+    int     expire;
+    int     dead_time;
+    int     blob_ver;
+    int     ver_ttl;
+    int     ver_expire;
+    Uint1   map_depth;
+    string  password;
+    string  data;
+};
+typedef list<SNCHotBlob> THotBlobList;
+
+struct SNCHotTierShard
+{
+    CMiniMutex lock;
+    /// Blobs in the order of last access, most recent first.
+    THotBlobList lru;
+    unordered_map<string, THotBlobList::iterator> blobs;
+    size_t size;
+    Uint4  cnt_counted;
+    Uint1  sketch[kHotSketchDepth][kHotSketchWidth];
+
+    SNCHotTierShard(void)
+        : size(0), cnt_counted(0)
+    {
+        memset(sketch, 0, sizeof(sketch));
+    }
+};
+
+static SNCHotTierShard* s_HotTier = NULL;
+static size_t s_HotTierSizeLimit = 0;
+static Uint4 s_HotTierMaxBlobSize = 64 * 1024;
+
 
 static const size_t kVerManagerSize = sizeof(CNCBlobVerManager)
                                       + sizeof(CCurVerReader);
@@ -174,6 +234,29 @@ SetWBFailedWriteDelay(int delay)
     s_WBFailedWriteDelay = Uint2(delay);
 }
 
+Uint8 GetHotTierSizeLimit(void) {
+    return s_HotTierSizeLimit;
+}
+Uint4 GetHotTierMaxBlobSize(void) {
+    return s_HotTierMaxBlobSize;
+}
+
+void
+SetHotTierSizeLimit(Uint8 limit)
+{
+    // Memory for the tier is never freed, so that readers don't need to
+    // check whether it's still there.
+    if (limit != 0  &&  !s_HotTier)
+        s_HotTier = new SNCHotTierShard[kHotTierShards];
+    s_HotTierSizeLimit = size_t(limit);
+}
+
+void
+SetHotTierMaxBlobSize(Uint4 size)
+{
+    s_HotTierMaxBlobSize = min(size, Uint4(kNCMaxBlobChunkSize));
+}
+
 static inline SWriteBackData*
 s_GetWBData(void)
 {
@@ -450,6 +533,200 @@ s_ProcessWBAddDel(Uint4 was_del_size)
 }
 
 
+static inline bool
+s_IsHotTierBlob(const SNCBlobVerData* ver_data)
+{
+    // Only blobs consisting of a single chunk can be in the tier.
+    return s_HotTierSizeLimit != 0
+           &&  ver_data->size != 0
+           &&  ver_data->size <= s_HotTierMaxBlobSize
+           &&  ver_data->size <= ver_data->chunk_size;
+}
+
+static inline size_t
+s_HashHotKey(const string& key)
+{
+    return std::hash<string>()(key);
+}
+
+static inline SNCHotTierShard*
+s_GetHotShard(size_t hash)
+{
+    return &s_HotTier[hash % kHotTierShards];
+}
+
+static inline Uint4
+s_GetSketchIndex(size_t hash, Uint1 row)
+{
+    Uint4 h1 = Uint4(hash >> 8);
+    Uint4 h2 = Uint4(Uint8(hash) >> 32) | 1;
+    return (h1 + row * h2) % kHotSketchWidth;
+}
+
+static Uint1
+s_EstimateHotFreq(SNCHotTierShard* shard, size_t hash)
+{
+    Uint1 freq = kHotSketchMaxFreq;
+    for (Uint1 row = 0; row < kHotSketchDepth; ++row)
+        freq = min(freq, shard->sketch[row][s_GetSketchIndex(hash, row)]);
+    return freq;
+}
+
+static void
+s_CountHotRead(SNCHotTierShard* shard, size_t hash)
+{
+    for (Uint1 row = 0; row < kHotSketchDepth; ++row) {
+        Uint1& counter = shard->sketch[row][s_GetSketchIndex(hash, row)];
+        if (counter < kHotSketchMaxFreq)
+            ++counter;
+    }
+    if (++shard->cnt_counted >= kHotSketchSample) {
+        for (Uint1 row = 0; row < kHotSketchDepth; ++row) {
+            for (Uint4 i = 0; i < kHotSketchWidth; ++i)
+                shard->sketch[row][i] >>= 1;
+        }
+        shard->cnt_counted /= 2;
+    }
+}
+
+static inline size_t
+s_CalcHotBlobSize(const SNCHotBlob& blob)
+{
+    return sizeof(blob) + blob.key.size() + blob.data.size();
+}
+
+static void
+s_EraseHotBlob(SNCHotTierShard* shard, THotBlobList::iterator it)
+{
+    shard->size -= s_CalcHotBlobSize(*it);
+    shard->blobs.erase(it->key);
+    shard->lru.erase(it);
+}
+
+static bool
+s_ReadHotBlobInfo(const string& key, SNCBlobVerData* ver_data)
+{
+    if (!s_IsHotTierBlob(ver_data))
+        return false;
+
+    size_t hash = s_HashHotKey(key);
+    SNCHotTierShard* shard = s_GetHotShard(hash);
+    CMiniMutexGuard guard(shard->lock);
+    auto it = shard->blobs.find(key);
+    if (it == shard->blobs.end())
+        return false;
+    const SNCHotBlob& blob = *it->second;
+    if (blob.coord != ver_data->coord  ||  blob.create_time != ver_data->create_time)
+        return false;
+
+    ver_data->ttl = blob.ttl;
+    ver_data->expire = blob.expire;
+    ver_data->dead_time = blob.dead_time;
+    ver_data->password = blob.password;
+    ver_data->blob_ver = blob.blob_ver;
+    ver_data->ver_ttl = blob.ver_ttl;
+    ver_data->ver_expire = blob.ver_expire;
+    ver_data->create_id = blob.create_id;
+    ver_data->create_server = blob.create_server;
+    ver_data->data_coord = blob.data_coord;
+    ver_data->map_depth = blob.map_depth;
+    return true;
+}
+
+static bool
+s_ReadHotBlobData(const string& key, const SNCBlobVerData* ver_data, string& data)
+{
+    size_t hash = s_HashHotKey(key);
+    SNCHotTierShard* shard = s_GetHotShard(hash);
+    CMiniMutexGuard guard(shard->lock);
+    s_CountHotRead(shard, hash);
+    auto it = shard->blobs.find(key);
+    if (it == shard->blobs.end())
+        return false;
+    THotBlobList::iterator blob = it->second;
+    if (blob->coord != ver_data->coord  ||  blob->create_time != ver_data->create_time
+        ||  blob->data.size() != ver_data->size)
+    {
+        s_EraseHotBlob(shard, blob);
+        return false;
+    }
+    shard->lru.splice(shard->lru.begin(), shard->lru, blob);
+    data = blob->data;
+    return true;
+}
+
+static bool
+s_AdmitHotBlob(const string& key, const SNCBlobVerData* ver_data,
+               const char* data, Uint4 size)
+{
+    size_t hash = s_HashHotKey(key);
+    SNCHotTierShard* shard = s_GetHotShard(hash);
+    size_t shard_limit = s_HotTierSizeLimit / kHotTierShards;
+
+    CMiniMutexGuard guard(shard->lock);
+    auto it = shard->blobs.find(key);
+    if (it != shard->blobs.end())
+        s_EraseHotBlob(shard, it->second);
+
+    size_t need_size = sizeof(SNCHotBlob) + key.size() + size;
+    if (need_size > shard_limit)
+        return false;
+    Uint1 freq = s_EstimateHotFreq(shard, hash);
+    while (shard->size + need_size > shard_limit) {
+        THotBlobList::iterator victim = --shard->lru.end();
+        if (s_EstimateHotFreq(shard, s_HashHotKey(victim->key)) >= freq)
+            return false;
+        s_EraseHotBlob(shard, victim);
+    }
+
+    shard->lru.push_front(SNCHotBlob());
+    SNCHotBlob& blob = shard->lru.front();
+    blob.key = key;
+    blob.coord = ver_data->coord;
+    blob.data_coord = ver_data->data_coord;
+    blob.create_time = ver_data->create_time;
+    blob.create_server = ver_data->create_server;
+    blob.create_id = ver_data->create_id;
+    blob.ttl = ver_data->ttl;
+    blob.expire = ver_data->expire;
+    blob.dead_time = ver_data->dead_time;
+    blob.blob_ver = ver_data->blob_ver;
+    blob.ver_ttl = ver_data->ver_ttl;
+    blob.ver_expire = ver_data->ver_expire;
+    blob.map_depth = ver_data->map_depth;
+    blob.password = ver_data->password;
+    blob.data.assign(data, size);
+    shard->blobs[key] = shard->lru.begin();
+    shard->size += s_CalcHotBlobSize(blob);
+    return true;
+}
+
+void
+ForgetHotBlob(const string& key)
+{
+    if (!s_HotTier)
+        return;
+    SNCHotTierShard* shard = s_GetHotShard(s_HashHotKey(key));
+    CMiniMutexGuard guard(shard->lock);
+    auto it = shard->blobs.find(key);
+    if (it != shard->blobs.end())
+        s_EraseHotBlob(shard, it->second);
+}
+
+static void
+s_ReadHotTierState(size_t& size, Uint8& cnt_blobs)
+{
+    size = 0;
+    cnt_blobs = 0;
+    if (!s_HotTier)
+        return;
+    for (Uint1 i = 0; i < kHotTierShards; ++i) {
+        CMiniMutexGuard guard(s_HotTier[i].lock);
+        size += s_HotTier[i].size;
+        cnt_blobs += s_HotTier[i].blobs.size();
+    }
+}
+
 
 SWriteBackData::SWriteBackData(void)
     : cur_size(0),
@@ -525,6 +802,7 @@ CWriteBackControl::ReadState(SNCStateStat& state)
     state.wb_size = (ssize_t(s_WBCurSize) > 0? s_WBCurSize: 0);
     state.wb_releasable = (ssize_t(s_WBReleasableSize) > 0? s_WBReleasableSize: 0);
     state.wb_releasing = (ssize_t(s_WBReleasingSize) > 0? s_WBReleasingSize: 0);
+    s_ReadHotTierState(state.hot_size, state.hot_blobs);
 
     state.cnt_another_server_main = s_AnotherServerMain;
     Uint8 prev = s_BlobSync;
@@ -611,6 +889,7 @@ CNCBlobVerManager::x_DeleteCurVersion(void)
         m_CurVersion->SetNotCurrent();
         m_CurVersion.Reset();
     }
+    ForgetHotBlob(m_Key);
 }
 
 void
@@ -949,6 +1228,7 @@ CNCBlobVerManager::FinalizeWriting(SNCBlobVerData* ver_data)
         if (old_ver)
             old_ver->SetNotCurrent();
         m_CurVersion->SetCurrent();
+        ForgetHotBlob(m_Key);
 
         SetRunnable();
     }
@@ -969,6 +1249,7 @@ CNCBlobVerManager::DeadTimeChanged(SNCBlobVerData* ver_data)
         m_CurVersion->need_write_time = m_CurVersion->last_access_time
                                         + s_WBWriteTimeout;
         m_CurVersion->meta_has_changed = true;
+        ForgetHotBlob(m_Key);
 
         SetRunnable();
     }
@@ -1019,7 +1300,9 @@ CCurVerReader::ExecuteSlice(TSrvThreadNum thr_num)
     s_AddCurrentMem(ver_data->meta_mem);
     ver_data->meta_mem += kVerManagerSize;
     m_VerMgr->m_CurVersion = ver_data;
-    if (!CNCBlobStorage::ReadBlobInfo(ver_data)) {
+    if (!s_ReadHotBlobInfo(m_VerMgr->m_Key, ver_data)
+        &&  !CNCBlobStorage::ReadBlobInfo(ver_data))
+    {
         SRV_LOG(Error, "Problem reading meta-information about blob "
                           << CNCBlobKeyLight(m_VerMgr->m_Key).KeyForLogs());
         CSrvRef<SNCBlobVerData> cur_ver(ver_data);
@@ -1533,6 +1816,7 @@ CNCBlobAccessor::Deinitialize(void)
             delete m_ChunkMaps;
             m_ChunkMaps = NULL;
         }
+        m_HotData.clear();
         break;
     case eNCCreate:
     case eNCCopyCreate:
@@ -1618,11 +1902,13 @@ CNCBlobAccessor::GetReadMemSize(void)
     }
     if (m_Buffer) {
         if (m_ChunkPos < m_ChunkSize) {
-            m_Buffer = m_CurData->chunks[m_CurChunk];
+            if (m_HotData.empty())
+                m_Buffer = m_CurData->chunks[m_CurChunk];
             return m_ChunkSize - m_ChunkPos;
         }
         ++m_CurChunk;
         m_ChunkPos = 0;
+        m_HotData.clear();
     }
 
     Uint8 need_size = m_CurData->size - GetPosition() + m_ChunkPos;
@@ -1630,27 +1916,45 @@ CNCBlobAccessor::GetReadMemSize(void)
         need_size = m_CurData->chunk_size;
 
     m_Buffer = ACCESS_ONCE(m_CurData->chunks[m_CurChunk]);
-    if (m_Buffer) {
+    if (m_Buffer  &&  m_CurData->cur_chunk_num <= m_CurChunk) {
+        // chunk is still in write-back memory
+        CNCStat::TierBlobRead(CNCStat::eReadTierMemory);
         m_ChunkSize = Uint4(need_size);
         return m_ChunkSize - m_ChunkPos;
     }
 
-    if (!m_ChunkMaps) {
-        m_ChunkMaps = new SNCChunkMaps(m_CurData->map_size);
-        s_AddCurrentMem(s_CalcChunkMapsSize(m_CurData->map_size));
-    }
-    if (!CNCBlobStorage::ReadChunkData(m_CurData, m_ChunkMaps, m_CurChunk,
-                                       m_Buffer, m_ChunkSize))
-    {
-        x_DelCorruptedVersion();
-        return 0;
+    bool is_hot = m_CurChunk == 0  &&  s_IsHotTierBlob(m_CurData);
+    if (is_hot  &&  s_ReadHotBlobData(m_BlobKey, m_CurData, m_HotData)) {
+        CNCStat::TierBlobRead(CNCStat::eReadTierHot);
+        m_Buffer = &m_HotData[0];
+        m_ChunkSize = Uint4(need_size);
+        return m_ChunkSize - m_ChunkPos;
     }
-    if (m_ChunkSize != need_size) {
-        x_DelCorruptedVersion();
-        return 0;
+
+    CNCStat::TierBlobRead(CNCStat::eReadTierFile);
+    if (m_Buffer) {
+        m_ChunkSize = Uint4(need_size);
     }
+    else {
+        if (!m_ChunkMaps) {
+            m_ChunkMaps = new SNCChunkMaps(m_CurData->map_size);
+            s_AddCurrentMem(s_CalcChunkMapsSize(m_CurData->map_size));
+        }
+        if (!CNCBlobStorage::ReadChunkData(m_CurData, m_ChunkMaps, m_CurChunk,
+                                           m_Buffer, m_ChunkSize))
+        {
+            x_DelCorruptedVersion();
+            return 0;
+        }
+        if (m_ChunkSize != need_size) {
+            x_DelCorruptedVersion();
+            return 0;
+        }
 
-    ACCESS_ONCE(m_CurData->chunks[m_CurChunk]) = m_Buffer;
+        ACCESS_ONCE(m_CurData->chunks[m_CurChunk]) = m_Buffer;
+    }
+    if (is_hot)
+        s_AdmitHotBlob(m_BlobKey, m_CurData, m_Buffer, m_ChunkSize);
     return m_ChunkSize - m_ChunkPos;
 }
 
@@ -248,6 +248,8 @@ private:
     Uint4       m_ChunkSize;
     Uint8       m_SizeRead;
     char*       m_Buffer;
+    /// Copy of the chunk data if it was read from the hot tier
+    string      m_HotData;
     CSrvTask*   m_Owner;
 };
 
@@ -297,6 +299,14 @@ void SetWBWriteTimeout(int timeout1, int timeout2);
 void SetWBFailedWriteDelay(int delay);
 void SetWBInitialSyncComplete(void);
 
+Uint8 GetHotTierSizeLimit(void);
+Uint4 GetHotTierMaxBlobSize(void);
+
+void SetHotTierSizeLimit(Uint8 limit);
+void SetHotTierMaxBlobSize(Uint4 size);
+/// Remove blob from the hot tier (when the blob is changed or deleted)
+void ForgetHotBlob(const string& key);
+
 
 class CWBMemDeleter : public CSrvRCUUser
 {
@@ -33,6 +33,7 @@
 
 #include "scheduler.hpp"
 #include "threads_man.hpp"
+#include "sockets_man.hpp"
 #include "timers.hpp"
 #include "srv_stat.hpp"
 
@@ -159,8 +160,10 @@ s_AddTaskToQueue(SSrvThread* thr, CSrvTask* task, bool boost = false)
     sched->cnt_signal.SetValueNonAtomic(signal_val + 1);
     sched->tasks_lock.Unlock();
 
-    if (signal_val == 0)
+    if (signal_val == 0) {
         sched->cnt_signal.WakeUpWaiters(1);
+        WakeUpThreadSocks(thr);
+    }
 }
 
 static CSrvTask*
@@ -529,8 +532,13 @@ SchedExecuteTask(SSrvThread* thr)
         // to the caller, check if jiffy number was changed (if yes then per-jiffy
         // tasks will be executed) and then re-enter this function to actually
         // execute tasks that were queued in this thread.
+        // With network_engine = thread_epoll thread sleeps in its own epoll
+        // descriptor instead, and is woken up from there by new tasks too.
         CSrvTime start_time = CSrvTime::Current();
-        sched->cnt_signal.WaitValueChange(0, s_JiffyTime);
+        if (IsThreadSocketWait(thr))
+            DoThreadSocketWait(thr, s_JiffyTime);
+        else
+            sched->cnt_signal.WaitValueChange(0, s_JiffyTime);
         CSrvTime end_time = CSrvTime::Current();
         end_time -= start_time;
         sched->wait_time += end_time.AsUSec();
@@ -560,6 +568,7 @@ SchedExecuteTask(SSrvThread* thr)
     sched->done_time += exec_time;
     ++sched->done_tasks;
     s_MarkTaskExecuted(task, thr);
+    CheckThreadSockets(thr);
 }
 
 void
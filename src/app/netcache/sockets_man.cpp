@@ -45,6 +45,7 @@
 # include <arpa/inet.h>
 # include <netdb.h>
 # include <sys/epoll.h>
+# include <sys/eventfd.h>
 # include <unistd.h>
 # include <fcntl.h>
 # include <errno.h>
@@ -56,6 +57,9 @@
 #     define EPOLLRDHUP 0x2000
 #   endif
 # endif
+# ifndef SO_REUSEPORT
+#   define SO_REUSEPORT 15
+# endif
 
 #else
 # define EPOLLIN      0x0001
@@ -100,6 +104,22 @@ typedef std::list<CSrvSocketTask*> TSockList;
 /// Per-thread structure containing information about sockets.
 struct SSocketsData
 {
+    /// Epoll descriptor of the thread when it waits for events on its sockets
+    /// by itself (network_engine = thread_epoll), -1 otherwise. All sockets
+    /// from sock_list are registered in it.
+    int epoll_fd;
+    /// Eventfd registered in epoll_fd to wake up the thread when new tasks are
+    /// queued to it.
+    int wake_fd;
+    /// Thread's own listening sockets bound with SO_REUSEPORT, indexed the same
+    /// way as s_ListenSocks. -1 if the socket is not open yet.
+    int listen_fds[kMaxCntListeningSocks];
+    /// Time (in seconds) before which failed listening sockets are not
+    /// re-opened again.
+    int listen_retry_secs;
+    /// Number of tasks executed since last check of epoll_fd.
+    Uint2 tasks_since_poll;
+
     /// List of all open and not yet deleted sockets which were opened in this
     /// thread.
     TSockList sock_list;
@@ -112,8 +132,14 @@ struct SSocketsData
     Int2 sock_cnt;
 
     SSocketsData(void)
-        : sock_cnt(0)
+        : epoll_fd(-1),
+          wake_fd(-1),
+          listen_retry_secs(0),
+          tasks_since_poll(0),
+          sock_cnt(0)
     {
+        for (Uint1 i = 0; i < kMaxCntListeningSocks; ++i)
+            listen_fds[i] = -1;
     }
 };
 
@@ -164,11 +190,20 @@ static Uint1 s_OldSocksDelBatch = 0;
 static Uint8 s_ConnTimeout = 10;
 static string s_HostName;
 static Uint8 s_AcceptDelay = 1000000;
+/// Whether each worker thread waits for events on its own epoll descriptor
+/// with its own listening sockets instead of single epoll descriptor polled
+/// by the main thread.
+static bool s_ThreadEpoll = false;
+/// Number of tasks executed by worker thread between checks of its epoll
+/// descriptor (when the thread has no time to sleep in it).
+static Uint2 s_SockPollBatch = 16;
+static bool s_ListeningStarted = false;
 
 
 extern Uint8 s_CurJiffies;
 extern CSrvTime s_JiffyTime;
 extern SSrvThread** s_Threads;
+extern TSrvThreadNum s_MaxRunningThreads;
 
 
 
@@ -185,6 +220,23 @@ ConfigureSockets(const CNcbiRegistry* reg, CTempString section)
     if (s_OldSocksDelBatch < 10)
         s_OldSocksDelBatch = 10;
     s_AcceptDelay = Uint8(reg->GetInt(section, "socket_accept_delay", 1000)) * kUSecsPerMSec;
+    s_SockPollBatch = Uint2(reg->GetInt(section, "socket_poll_batch", 16));
+    if (s_SockPollBatch == 0)
+        s_SockPollBatch = 1;
+
+    // Network engine cannot be changed in the running server.
+    if (!CTaskServer::IsRunning()) {
+        string engine = reg->GetString(section, "network_engine", "shared_epoll");
+        if (NStr::CompareNocase(engine, "thread_epoll") == 0)
+            s_ThreadEpoll = true;
+        else if (NStr::CompareNocase(engine, "shared_epoll") == 0)
+            s_ThreadEpoll = false;
+        else {
+            SRV_LOG(Error, "Unknown network_engine '" << engine
+                           << "', using shared_epoll");
+            s_ThreadEpoll = false;
+        }
+    }
 }
 
 bool ReConfig_Sockets(const CTempString& section, const CNcbiRegistry& new_reg, string&)
@@ -195,20 +247,15 @@ bool ReConfig_Sockets(const CTempString& section, const CNcbiRegistry& new_reg,
 
 void WriteSetup_Sockets(CSrvSocketTask& task)
 {
-    string is("\": "), eol(",\n\"");
+    string is("\": "), iss("\": \""), eol(",\n\"");
     task.WriteText(eol).WriteText("soft_sockets_limit").WriteText(is ).WriteNumber( s_SoftSocketLimit);
     task.WriteText(eol).WriteText("hard_sockets_limit").WriteText(is ).WriteNumber( s_HardSocketLimit);
     task.WriteText(eol).WriteText("connection_timeout").WriteText(is ).WriteNumber( s_ConnTimeout * s_JiffyTime.NSec() / kNSecsPerMSec);
     task.WriteText(eol).WriteText("min_socket_inactivity").WriteText(is ).WriteNumber( s_SocketTimeout);
     task.WriteText(eol).WriteText("sockets_cleaning_batch").WriteText(is ).WriteNumber( s_OldSocksDelBatch);
     task.WriteText(eol).WriteText("socket_accept_delay").WriteText(is ).WriteNumber( s_AcceptDelay / kUSecsPerMSec);
-}
-
-void
-AssignThreadSocks(SSrvThread* thr)
-{
-    SSocketsData* socks = new SSocketsData();
-    thr->socks = socks;
+    task.WriteText(eol).WriteText("network_engine").WriteText(iss).WriteText(s_ThreadEpoll? "thread_epoll": "shared_epoll").WriteText("\"");
+    task.WriteText(eol).WriteText("socket_poll_batch").WriteText(is ).WriteNumber( s_SockPollBatch);
 }
 
 void
@@ -310,69 +357,112 @@ s_SetSocketQuickAck(int sock)
 #endif
 }
 
-static bool
-s_CreateListeningSocket(Uint1 idx)
+static int
+s_OpenListeningSocket(Uint2 port, bool reuse_port, int epoll_fd, void* data)
 {
-    SListenSockInfo& sock_info = s_ListenSocks[idx];
+    int sock = -1;
 #ifdef NCBI_OS_LINUX
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    sock = socket(AF_INET, SOCK_STREAM, 0);
     if (sock == -1) {
         LOG_WITH_ERRNO(Critical, "Cannot create socket", errno);
-        return false;
+        return -1;
     }
     if (!s_SetSocketNonBlock(sock)) {
         close(sock);
-        return false;
+        return -1;
     }
 
     int value = 1;
     int res = setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
     if (res)
         LOG_WITH_ERRNO(Error, "Cannot set socket's reuse-address property", errno);
+    if (reuse_port) {
+        // Several threads listen on the same port, kernel distributes
+        // incoming connections between them.
+        res = setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value));
+        if (res) {
+            LOG_WITH_ERRNO(Critical, "Cannot set socket's reuse-port property", errno);
+            close(sock);
+            return -1;
+        }
+    }
 
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
     addr.sin_family = AF_INET;
     addr.sin_addr.s_addr = htonl(INADDR_ANY);
-    addr.sin_port = htons(sock_info.port);
+    addr.sin_port = htons(port);
     res = bind(sock, (struct sockaddr*)&addr, sizeof(addr));
     if (res) {
         string err_msg("Cannot bind socket to port ");
-        err_msg += NStr::NumericToString(sock_info.port);
+        err_msg += NStr::NumericToString(port);
         LOG_WITH_ERRNO(Critical, err_msg.c_str(), errno);
         close(sock);
-        return false;
+        return -1;
     }
     res = listen(sock, 128);
     if (res) {
         LOG_WITH_ERRNO(Critical, "Cannot listen on a socket", errno);
         close(sock);
-        return false;
+        return -1;
     }
 
-    struct epoll_event evt;
-    evt.events = EPOLLIN | EPOLLET;
-    evt.data.ptr = (void*)&sock_info;
-    res = epoll_ctl(s_EpollFD, EPOLL_CTL_ADD, sock, &evt);
-    if (res) {
-        LOG_WITH_ERRNO(Critical, "Cannot add listening socket to epoll", errno);
-        close(sock);
-        return false;
+    if (epoll_fd != -1) {
+        struct epoll_event evt;
+        evt.events = EPOLLIN | EPOLLET;
+        evt.data.ptr = data;
+        res = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &evt);
+        if (res) {
+            LOG_WITH_ERRNO(Critical, "Cannot add listening socket to epoll", errno);
+            close(sock);
+            return -1;
+        }
     }
+#endif
+    return sock;
+}
 
+static bool
+s_CreateListeningSocket(Uint1 idx)
+{
+    SListenSockInfo& sock_info = s_ListenSocks[idx];
+#ifdef NCBI_OS_LINUX
+    int sock = s_OpenListeningSocket(sock_info.port, false, s_EpollFD,
+                                     (void*)&sock_info);
+    if (sock == -1)
+        return false;
     sock_info.fd = sock;
 #endif
     AtomicAdd(s_TotalSockets, 1);
     return true;
 }
 
+static bool
+s_CheckListeningPort(Uint1 idx)
+{
+    // With per-thread listening sockets each worker thread opens them by
+    // itself, here we only check that the port can be listened to at all.
+    int sock = s_OpenListeningSocket(s_ListenSocks[idx].port, true, -1, NULL);
+    if (sock == -1)
+        return false;
+#ifdef NCBI_OS_LINUX
+    close(sock);
+#endif
+    return true;
+}
+
 static bool
 s_StartListening(void)
 {
     for (Uint1 i = 0; i < s_CntListeningSocks; ++i) {
-        if (!s_CreateListeningSocket(i))
+        if (s_ThreadEpoll) {
+            if (!s_CheckListeningPort(i))
+                return false;
+        }
+        else if (!s_CreateListeningSocket(i))
             return false;
     }
+    s_ListeningStarted = true;
     return true;
 }
 
@@ -566,17 +656,17 @@ s_ProcessListenError(Uint1 sock_idx)
     s_CreateListeningSocket(sock_idx);
 }
 
-static void
-s_ProcessListenEvent(Uint1 sock_idx, TSrvThreadNum thread_num)
+/// Accept all pending connections on the listening socket.
+/// Returns false if the listening socket got an error and should be re-opened.
+static bool
+s_AcceptConnections(int listen_fd, Uint1 sock_idx, TSrvThreadNum thread_num)
 {
-    s_Listener.m_SeenEvents[sock_idx] = s_ListenEvents[sock_idx];
-    SListenSockInfo& sock_info = s_ListenSocks[sock_idx];
     CSrvTime cmd_start = CSrvTime::Current();
     for (;;) {
 #ifdef NCBI_OS_LINUX
         struct sockaddr_in addr;
         socklen_t len = sizeof(addr);
-        int new_sock = accept(sock_info.fd, (struct sockaddr*)&addr, &len);
+        int new_sock = accept(listen_fd, (struct sockaddr*)&addr, &len);
         CSrvTime cmd_len = CSrvTime::Current();
         cmd_len -= cmd_start;
         Uint8 len_usec = cmd_len.AsUSec();
@@ -588,8 +678,7 @@ s_ProcessListenEvent(Uint1 sock_idx, TSrvThreadNum thread_num)
             int x_errno = errno;
             if (x_errno != EAGAIN  &&  x_errno != EWOULDBLOCK) {
                 LOG_WITH_ERRNO(Critical, "Error accepting new socket", x_errno);
-                s_CloseSocket(sock_info.fd, true);
-                s_CreateListeningSocket(sock_idx);
+                return false;
             }
             break;
         }
@@ -605,7 +694,7 @@ s_ProcessListenEvent(Uint1 sock_idx, TSrvThreadNum thread_num)
             continue;
         }
 
-        CSrvSocketTask* task = sock_info.factory->CreateSocketTask();
+        CSrvSocketTask* task = s_ListenSocks[sock_idx].factory->CreateSocketTask();
         task->m_Fd = new_sock;
         task->m_PeerAddr = addr.sin_addr.s_addr;
         task->m_PeerPort = addr.sin_port;
@@ -617,6 +706,18 @@ s_ProcessListenEvent(Uint1 sock_idx, TSrvThreadNum thread_num)
             task->Terminate();
 #endif
     }
+    return true;
+}
+
+static void
+s_ProcessListenEvent(Uint1 sock_idx, TSrvThreadNum thread_num)
+{
+    s_Listener.m_SeenEvents[sock_idx] = s_ListenEvents[sock_idx];
+    SListenSockInfo& sock_info = s_ListenSocks[sock_idx];
+    if (!s_AcceptConnections(sock_info.fd, sock_idx, thread_num)) {
+        s_CloseSocket(sock_info.fd, true);
+        s_CreateListeningSocket(sock_idx);
+    }
 }
 
 void
@@ -645,6 +746,167 @@ DoSocketWait(void)
 #endif
 }
 
+void
+AssignThreadSocks(SSrvThread* thr)
+{
+    SSocketsData* socks = new SSocketsData();
+    thr->socks = socks;
+
+    if (!s_ThreadEpoll  ||  thr->thread_num == 0
+        ||  thr->thread_num > s_MaxRunningThreads)
+    {
+        return;
+    }
+#ifdef NCBI_OS_LINUX
+    socks->epoll_fd = epoll_create(1);
+    if (socks->epoll_fd == -1) {
+        SRV_FATAL("Cannot create epoll descriptor, errno=" << errno);
+    }
+    socks->wake_fd = eventfd(0, EFD_NONBLOCK);
+    if (socks->wake_fd == -1) {
+        SRV_FATAL("Cannot create eventfd descriptor, errno=" << errno);
+    }
+    struct epoll_event evt;
+    evt.events = EPOLLIN;
+    evt.data.ptr = NULL;
+    if (epoll_ctl(socks->epoll_fd, EPOLL_CTL_ADD, socks->wake_fd, &evt)) {
+        SRV_FATAL("Cannot add eventfd to epoll, errno=" << errno);
+    }
+#endif
+}
+
+static inline int
+s_GetThreadEpollFD(SSrvThread* thr)
+{
+    int epoll_fd = thr->socks->epoll_fd;
+    return epoll_fd == -1? s_EpollFD: epoll_fd;
+}
+
+static void
+s_CloseThreadListeners(SSocketsData* socks)
+{
+    for (Uint1 i = 0; i < kMaxCntListeningSocks; ++i) {
+        if (socks->listen_fds[i] != -1) {
+            s_CloseSocket(socks->listen_fds[i], false);
+            socks->listen_fds[i] = -1;
+        }
+    }
+}
+
+static void
+s_OpenThreadListeners(SSocketsData* socks)
+{
+    if (CTaskServer::IsInShutdown()) {
+        s_CloseThreadListeners(socks);
+        return;
+    }
+    if (!s_ListeningStarted  ||  socks->listen_retry_secs > CSrvTime::CurSecs())
+        return;
+
+    Uint1 cnt_listen = ACCESS_ONCE(s_CntListeningSocks);
+    for (Uint1 i = 0; i < cnt_listen; ++i) {
+        if (socks->listen_fds[i] != -1)
+            continue;
+        SListenSockInfo& sock_info = s_ListenSocks[i];
+        int sock = s_OpenListeningSocket(sock_info.port, true, socks->epoll_fd,
+                                         (void*)&sock_info);
+        if (sock == -1) {
+            // Don't try it again too often.
+            socks->listen_retry_secs = CSrvTime::CurSecs() + 1;
+            return;
+        }
+        socks->listen_fds[i] = sock;
+        AtomicAdd(s_TotalSockets, 1);
+    }
+}
+
+static void
+s_PollThreadSockets(SSrvThread* thr, int wait_msec)
+{
+    SSocketsData* socks = thr->socks;
+    socks->tasks_since_poll = 0;
+    s_OpenThreadListeners(socks);
+
+#ifdef NCBI_OS_LINUX
+    struct epoll_event events[kEpollEventsArraySize];
+    int res = epoll_wait(socks->epoll_fd, events, kEpollEventsArraySize, wait_msec);
+    if (res < 0) {
+        int x_errno = errno;
+        if (x_errno != EINTR)
+            LOG_WITH_ERRNO(Critical, "Error in epoll_wait", x_errno);
+    }
+    for (int i = 0; i < res; ++i) {
+        struct epoll_event& evt = events[i];
+        SSrvSocketInfo* sock_info = (SSrvSocketInfo*)evt.data.ptr;
+        if (!sock_info) {
+            // Wake up from WakeUpThreadSocks(), new tasks will be executed
+            // after return from here.
+            eventfd_t value;
+            eventfd_read(socks->wake_fd, &value);
+        }
+        else if (sock_info->is_listening) {
+            // Listening sockets are processed right here, without separate
+            // task, and accepted sockets stay with this thread.
+            Uint1 idx = ((SListenSockInfo*)sock_info)->index;
+            int listen_fd = socks->listen_fds[idx];
+            if (listen_fd == -1)
+                continue;
+            bool is_ok = true;
+            if (evt.events & (EPOLLERR + EPOLLHUP)) {
+                LOG_SOCK_ERROR(Critical, listen_fd, "Error in listening socket");
+                is_ok = false;
+            }
+            else if (evt.events & EPOLLIN) {
+                is_ok = s_AcceptConnections(listen_fd, idx, thr->thread_num);
+            }
+            if (!is_ok) {
+                // It will be re-opened on the next call.
+                s_CloseSocket(listen_fd, true);
+                socks->listen_fds[idx] = -1;
+            }
+        }
+        else
+            s_RegisterClientEvent((CSrvSocketTask*)sock_info, evt.events);
+    }
+#endif
+}
+
+bool
+IsThreadSocketWait(SSrvThread* thr)
+{
+    return thr->socks->epoll_fd != -1;
+}
+
+void
+DoThreadSocketWait(SSrvThread* thr, const CSrvTime& wait_time)
+{
+    Uint4 wait_msec = wait_time.NSec() / 1000000;
+    if (wait_msec == 0)
+        wait_msec = 1;
+    s_PollThreadSockets(thr, int(wait_msec));
+}
+
+void
+CheckThreadSockets(SSrvThread* thr)
+{
+    // Busy thread never sleeps in epoll_wait, so events on its sockets are
+    // collected in batches after each s_SockPollBatch tasks executed.
+    SSocketsData* socks = thr->socks;
+    if (socks->epoll_fd != -1  &&  ++socks->tasks_since_poll >= s_SockPollBatch)
+        s_PollThreadSockets(thr, 0);
+}
+
+void
+WakeUpThreadSocks(SSrvThread* thr)
+{
+#ifdef NCBI_OS_LINUX
+    // Thread queueing tasks to itself is not sleeping.
+    int wake_fd = thr->socks->wake_fd;
+    if (wake_fd != -1  &&  thr != GetCurThread())
+        eventfd_write(wake_fd, 1);
+#endif
+}
+
 bool
 InitSocketsMan(void)
 {
@@ -680,6 +942,16 @@ FinalizeSocketsMan(void)
 {
 #ifdef NCBI_OS_LINUX
     close(s_EpollFD);
+    if (s_ThreadEpoll  &&  s_Threads) {
+        for (TSrvThreadNum i = 1; i <= s_MaxRunningThreads; ++i) {
+            SSocketsData* socks = s_Threads[i]->socks;
+            if (socks->epoll_fd != -1)
+                close(socks->epoll_fd);
+            if (socks->wake_fd != -1)
+                close(socks->wake_fd);
+            socks->epoll_fd = socks->wake_fd = -1;
+        }
+    }
 #endif
 }
 
@@ -767,6 +1039,30 @@ s_DeleteOldestSockets(TSockList& lst)
 void
 MoveAllSockets(SSocketsData* dst_socks, SSocketsData* src_socks)
 {
+    if (src_socks->epoll_fd != -1) {
+        // Thread that has stopped must not get new connections anymore, and
+        // its sockets should be watched by the thread taking them over.
+        s_CloseThreadListeners(src_socks);
+#ifdef NCBI_OS_LINUX
+        NON_CONST_ITERATE(TSockList, it, src_socks->sock_list) {
+#if NC_SOCKLIST_USE_TYPE == NC_SOCKLIST_USE_STD_LIST
+            CSrvSocketTask* task = *it;
+#else
+            CSrvSocketTask* task = &*it;
+#endif
+            if (task->m_Fd == -1)
+                continue;
+            struct epoll_event evt;
+            evt.events = EPOLLIN | EPOLLOUT | EPOLLET;
+            evt.data.ptr = (SSrvSocketInfo*)task;
+            epoll_ctl(src_socks->epoll_fd, EPOLL_CTL_DEL, task->m_Fd, &evt);
+            if (epoll_ctl(dst_socks->epoll_fd, EPOLL_CTL_ADD, task->m_Fd, &evt))
+                LOG_WITH_ERRNO(Critical, "Cannot move socket to another epoll", errno);
+            // Events could be lost while the socket was between descriptors.
+            task->SetRunnable();
+        }
+#endif
+    }
     // Move all sockets from src_socks to dst_socks.
     dst_socks->sock_list.splice(dst_socks->sock_list.begin(), src_socks->sock_list);
     dst_socks->sock_cnt += src_socks->sock_cnt;
@@ -1481,7 +1777,7 @@ CSrvSocketTask::StartProcessing(TSrvThreadNum thread_num /* = 0 */, bool boost /
     struct epoll_event evt;
     evt.events = EPOLLIN | EPOLLOUT | EPOLLET;
     evt.data.ptr = (SSrvSocketInfo*)this;
-    int res = epoll_ctl(s_EpollFD, EPOLL_CTL_ADD, m_Fd, &evt);
+    int res = epoll_ctl(s_GetThreadEpollFD(GetCurThread()), EPOLL_CTL_ADD, m_Fd, &evt);
     if (res) {
         LOG_WITH_ERRNO(Critical, "Cannot add socket to epoll", errno);
         return false;
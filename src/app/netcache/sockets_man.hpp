@@ -56,6 +56,10 @@ void CheckConnectsTimeout(SSocketsData* socks);
 void CleanSocketList(SSocketsData* socks);
 void SetAllSocksRunnable(SSocketsData* socks);
 void RequestStopListening(void);
+bool IsThreadSocketWait(SSrvThread* thr);
+void DoThreadSocketWait(SSrvThread* thr, const CSrvTime& wait_time);
+void CheckThreadSockets(SSrvThread* thr);
+void WakeUpThreadSocks(SSrvThread* thr);
 
 
 END_NCBI_SCOPE
@@ -0,0 +1,241 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  NetCache load generator
+ *
+ *   Runs a mix of PUT and GET requests from several threads for a given
+ *   time and reports throughput (ops/s) and latency percentiles.  To compare
+ *   network engines of the server (network_engine in [task_server] section)
+ *   run it against the server started with each of them; -engine only marks
+ *   the report.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/ncbi_system.hpp>
+
+#include <connect/services/netcache_api.hpp>
+
+#include <algorithm>
+
+
+USING_NCBI_SCOPE;
+
+
+static double   s_Duration;
+static size_t   s_BlobSize;
+static unsigned s_GetPercent;
+
+
+/// Latencies (in microseconds) of requests of one kind
+typedef vector<Uint4> TLatencies;
+
+
+class CTestNetCacheLoadThread : public CThread
+{
+public:
+    CTestNetCacheLoadThread(CNetCacheAPI::TInstance api)
+        : m_API(api), m_Errors(0)
+    {}
+
+    virtual void* Main(void);
+
+    const TLatencies& GetPutLatencies(void) const { return m_PutLatencies; }
+    const TLatencies& GetGetLatencies(void) const { return m_GetLatencies; }
+    Uint8 GetErrors(void) const { return m_Errors; }
+
+private:
+    CNetCacheAPI m_API;
+    TLatencies   m_PutLatencies;
+    TLatencies   m_GetLatencies;
+    Uint8        m_Errors;
+};
+
+
+void* CTestNetCacheLoadThread::Main(void)
+{
+    vector<char> blob(s_BlobSize, 'a');
+    vector<char> buf(s_BlobSize);
+    vector<string> keys;
+
+    CStopWatch total_sw(CStopWatch::eStart);
+    while (total_sw.Elapsed() < s_Duration) {
+        bool do_get = !keys.empty()  &&  unsigned(rand() % 100) < s_GetPercent;
+        CStopWatch sw(CStopWatch::eStart);
+        try {
+            if (do_get) {
+                size_t n_read, blob_size;
+                const string& key = keys[rand() % keys.size()];
+                if (m_API.GetData(key, buf.data(), buf.size(), &n_read, &blob_size)
+                        != CNetCacheAPI::eReadComplete) {
+                    ++m_Errors;
+                    continue;
+                }
+            }
+            else {
+                string key = m_API.PutData(blob.data(), blob.size());
+                if (keys.size() < 1000)
+                    keys.push_back(key);
+                else
+                    keys[rand() % keys.size()] = key;
+            }
+        }
+        catch (CException& ex) {
+            ERR_POST(ex);
+            ++m_Errors;
+            continue;
+        }
+        Uint4 usec = Uint4(sw.Elapsed() * kMicroSecondsPerSecond);
+        (do_get? m_GetLatencies: m_PutLatencies).push_back(usec);
+    }
+    return NULL;
+}
+
+
+class CTestNetCacheLoadApp : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    void x_Report(const string& engine, const string& op,
+                  TLatencies& lat, double elapsed);
+};
+
+
+void CTestNetCacheLoadApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "NetCache load generator");
+
+    arg_desc->AddPositional("service",
+        "NetCache service name or host:port",
+        CArgDescriptions::eString);
+
+    arg_desc->AddDefaultKey("engine", "name",
+                            "Network engine of the server (to mark the report)",
+                            CArgDescriptions::eString, "shared_epoll");
+
+    arg_desc->AddDefaultKey("threads", "threads",
+                            "Number of client threads",
+                            CArgDescriptions::eInteger, "16");
+
+    arg_desc->AddDefaultKey("duration", "seconds",
+                            "Duration of the test",
+                            CArgDescriptions::eDouble, "30");
+
+    arg_desc->AddDefaultKey("size", "size",
+                            "Size of blobs to submit",
+                            CArgDescriptions::eInteger, "1000");
+
+    arg_desc->AddDefaultKey("get_percent", "percent",
+                            "Percentage of GET requests in the mix",
+                            CArgDescriptions::eInteger, "80");
+    arg_desc->SetConstraint("get_percent",
+                            new CArgAllow_Integers(0, 100));
+
+    arg_desc->AddDefaultKey("timeout", "timeout",
+                            "Communication timeout in msec",
+                            CArgDescriptions::eInteger, "2000");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CTestNetCacheLoadApp::x_Report(const string& engine, const string& op,
+                                    TLatencies& lat, double elapsed)
+{
+    if (lat.empty())
+        return;
+
+    sort(lat.begin(), lat.end());
+    size_t cnt = lat.size();
+    cout << engine << " " << op
+         << ": ops=" << cnt
+         << " ops/s=" << Uint8(cnt / elapsed)
+         << " p50=" << lat[cnt / 2] << "us"
+         << " p99=" << lat[min(cnt - 1, cnt * 99 / 100)] << "us"
+         << " max=" << lat[cnt - 1] << "us" << NcbiEndl;
+}
+
+
+int CTestNetCacheLoadApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    string engine = args["engine"].AsString();
+    unsigned threads = unsigned(args["threads"].AsInteger());
+    s_Duration = args["duration"].AsDouble();
+    s_BlobSize = size_t(args["size"].AsInteger());
+    s_GetPercent = unsigned(args["get_percent"].AsInteger());
+    unsigned timeout = unsigned(args["timeout"].AsInteger());
+
+    CNetCacheAPI nc(args["service"].AsString(), "load_test");
+    STimeout to = {timeout/1000, (timeout%1000)*1000};
+    nc.SetCommunicationTimeout(to);
+
+    CStopWatch sw(CStopWatch::eStart);
+    vector<CRef<CTestNetCacheLoadThread> > thread_list;
+    thread_list.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        CRef<CTestNetCacheLoadThread> thread(new CTestNetCacheLoadThread(nc));
+        thread_list.push_back(thread);
+        thread->Run();
+    }
+
+    TLatencies put_lat, get_lat;
+    Uint8 errors = 0;
+    NON_CONST_ITERATE(vector<CRef<CTestNetCacheLoadThread> >, it, thread_list) {
+        (*it)->Join();
+        const TLatencies& put = (*it)->GetPutLatencies();
+        const TLatencies& get = (*it)->GetGetLatencies();
+        put_lat.insert(put_lat.end(), put.begin(), put.end());
+        get_lat.insert(get_lat.end(), get.begin(), get.end());
+        errors += (*it)->GetErrors();
+    }
+    double elapsed = sw.Elapsed();
+
+    TLatencies all_lat(put_lat);
+    all_lat.insert(all_lat.end(), get_lat.begin(), get_lat.end());
+    x_Report(engine, "PUT", put_lat, elapsed);
+    x_Report(engine, "GET", get_lat, elapsed);
+    x_Report(engine, "ALL", all_lat, elapsed);
+    cout << engine << " errors=" << errors << NcbiEndl;
+
+    return errors == 0? 0: 1;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestNetCacheLoadApp().AppMain(argc, argv);
+}
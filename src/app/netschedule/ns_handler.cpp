@@ -440,6 +440,15 @@ CNetScheduleHandler::SCommandMap CNetScheduleHandler::sm_CommandMap[] = {
           { "sid",               eNSPT_Str, eNSPA_Optional, ""  },
           { "ncbi_phid",         eNSPT_Str, eNSPA_Optional, ""  },
           { "prioritized_aff",   eNSPT_Int, eNSPA_Optional, "0" } } },
+    { "GETB",          { &CNetScheduleHandler::x_ProcessGetJobBatch,
+                         eNS_Queue | eNS_Worker | eNS_Program },
+        { { "count",             eNSPT_Int, eNSPA_Required      },
+          { "any_aff",           eNSPT_Int, eNSPA_Required, "0" },
+          { "aff",               eNSPT_Str, eNSPA_Optional, ""  },
+          { "group",             eNSPT_Str, eNSPA_Optional, ""  },
+          { "ip",                eNSPT_Str, eNSPA_Optional, ""  },
+          { "sid",               eNSPT_Str, eNSPA_Optional, ""  },
+          { "ncbi_phid",         eNSPT_Str, eNSPA_Optional, ""  } } },
     { "PUT",           { &CNetScheduleHandler::x_ProcessPut,
                          eNS_Queue | eNS_Worker | eNS_Program },
         { { "job_key",           eNSPT_Id,  eNSPA_Required      },
@@ -2240,6 +2249,87 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
 }
 
 
+void CNetScheduleHandler::x_ProcessGetJobBatch(CQueue* q)
+{
+    x_CheckNonAnonymousClient("use GETB command");
+    x_CheckGetParameters();
+
+    if (m_CommandArguments.count == 0)
+        NCBI_THROW(CNetScheduleException, eInvalidParameter,
+                   "The GETB count must be greater than 0");
+
+    // A worker node cannot hold more jobs than configured
+    unsigned int    max_count = m_Server->GetMaxGetbCount();
+    if (m_CommandArguments.count > max_count)
+        m_CommandArguments.count = max_count;
+
+    // Check if the queue is paused
+    CQueue::TPauseStatus    pause_status = q->GetPauseStatus();
+    if (pause_status != CQueue::eNoPause) {
+        string      pause_status_str;
+
+        if (pause_status == CQueue::ePauseWithPullback)
+            pause_status_str = "pullback";
+        else
+            pause_status_str = "nopullback";
+
+        x_WriteMessage("OK:pause=" + pause_status_str + kEndOfResponse +
+                       "OK:END" + kEndOfResponse);
+
+        if (x_NeedCmdLogging())
+            GetDiagContext().Extra().Print("job_count", 0)
+                                    .Print("reason",
+                                           "pause: " + pause_status_str);
+
+        x_PrintCmdRequestStop();
+        return;
+    }
+
+    list<string>    aff_list;
+    NStr::Split(m_CommandArguments.affinity_token,
+                "\t,", aff_list);
+    list<string>    group_list;
+    NStr::Split(m_CommandArguments.group,
+                "\t,", group_list);
+
+    vector<CJob>    jobs;
+    x_ClearRollbackAction();
+    q->GetJobBatch(m_ClientId,
+                   m_CommandArguments.count,
+                   aff_list,
+                   m_CommandArguments.any_affinity,
+                   group_list,
+                   jobs,
+                   m_RollbackAction);
+
+    // All the jobs are reported in one message so that a write error
+    // rolls back the whole batch
+    string      reply;
+    string      job_keys;
+    for (vector<CJob>::const_iterator  k = jobs.begin(); k != jobs.end(); ++k) {
+        string  job_key = q->MakeJobKey(k->GetId());
+        reply.append("OK:")
+             .append(x_MakeGetJobReply(q, *k, job_key))
+             .append(kEndOfResponse);
+        if (!job_keys.empty())
+            job_keys.append(",");
+        job_keys.append(job_key);
+    }
+
+    if (x_NeedCmdLogging()) {
+        if (jobs.empty())
+            GetDiagContext().Extra().Print("job_count", 0);
+        else
+            GetDiagContext().Extra().Print("job_count", jobs.size())
+                                    .Print("job_keys", job_keys);
+    }
+
+    x_WriteMessage(reply + "OK:END" + kEndOfResponse);
+    x_ClearRollbackAction();
+    x_PrintCmdRequestStop();
+}
+
+
 void CNetScheduleHandler::x_ProcessCancelWaitGet(CQueue* q)
 {
     x_CheckNonAnonymousClient("cancel waiting after WGET");
@@ -4329,44 +4419,8 @@ CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
     }
 
     if (cmdv2) {
-        string      submitter_notif_info;
-        if (job.GetSubmNotifPort() != 0) {
-            string  host = CSocketAPI::ntoa(job.GetSubmAddr());
-            if (host == "127.0.0.1") {
-                unsigned int    my_addr = CSocketAPI::GetLocalHostAddress();
-                host = CSocketAPI::ntoa(my_addr);
-                if (host == "127.0.0.1") {
-                    ERR_POST(Warning <<
-                             "Could not detect the self host address "
-                             "to provide it to a worker node");
-                }
-            }
-            submitter_notif_info.append("&submitter_notif_host=")
-                                .append(NStr::URLEncode(host))
-                                .append("&submitter_notif_port=")
-                                .append(to_string(job.GetSubmNotifPort()));
-        }
-        string      reply;
-        reply.reserve(1024);
-        reply.append("OK:job_key=")
-             .append(job_key)
-             .append("&input=")
-             .append(NStr::URLEncode(job.GetInput()))
-             .append("&affinity=")
-             .append(NStr::URLEncode(q->GetAffinityTokenByID(job.GetAffinityId())))
-             .append("&client_ip=")
-             .append(NStr::URLEncode(job.GetClientIP()))
-             .append("&client_sid=")
-             .append(NStr::URLEncode(job.GetClientSID()))
-             .append("&ncbi_phid=")
-             .append(NStr::URLEncode(job.GetNCBIPHID()))
-             .append("&mask=")
-             .append(to_string(job.GetMask()))
-             .append("&auth_token=")
-             .append(job.GetAuthToken())
-             .append(submitter_notif_info)
-             .append(kEndOfResponse);
-        x_WriteMessage(reply);
+        x_WriteMessage("OK:" + x_MakeGetJobReply(q, job, job_key) +
+                       kEndOfResponse);
     } else {
         x_WriteMessage(
                        "OK:" + job_key +
@@ -4382,6 +4436,51 @@ CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
 }
 
 
+string
+CNetScheduleHandler::x_MakeGetJobReply(const CQueue *  q,
+                                       const CJob &    job,
+                                       const string &  job_key)
+{
+    string      submitter_notif_info;
+    if (job.GetSubmNotifPort() != 0) {
+        string  host = CSocketAPI::ntoa(job.GetSubmAddr());
+        if (host == "127.0.0.1") {
+            unsigned int    my_addr = CSocketAPI::GetLocalHostAddress();
+            host = CSocketAPI::ntoa(my_addr);
+            if (host == "127.0.0.1") {
+                ERR_POST(Warning <<
+                         "Could not detect the self host address "
+                         "to provide it to a worker node");
+            }
+        }
+        submitter_notif_info.append("&submitter_notif_host=")
+                            .append(NStr::URLEncode(host))
+                            .append("&submitter_notif_port=")
+                            .append(to_string(job.GetSubmNotifPort()));
+    }
+    string      reply;
+    reply.reserve(1024);
+    reply.append("job_key=")
+         .append(job_key)
+         .append("&input=")
+         .append(NStr::URLEncode(job.GetInput()))
+         .append("&affinity=")
+         .append(NStr::URLEncode(q->GetAffinityTokenByID(job.GetAffinityId())))
+         .append("&client_ip=")
+         .append(NStr::URLEncode(job.GetClientIP()))
+         .append("&client_sid=")
+         .append(NStr::URLEncode(job.GetClientSID()))
+         .append("&ncbi_phid=")
+         .append(NStr::URLEncode(job.GetNCBIPHID()))
+         .append("&mask=")
+         .append(to_string(job.GetMask()))
+         .append("&auth_token=")
+         .append(job.GetAuthToken())
+         .append(submitter_notif_info);
+    return reply;
+}
+
+
 bool CNetScheduleHandler::x_CanBeWithoutQueue(FProcessor  processor) const
 {
     return // STATUS/STATUS2
@@ -4646,6 +4745,8 @@ string CNetScheduleHandler::x_GetServerSection(void) const
                 "\"\n"
            "max_client_data=\"" +
                 to_string(m_Server->GetMaxClientData()) + "\"\n"
+           "max_getb_count=\"" +
+                to_string(m_Server->GetMaxGetbCount()) + "\"\n"
            "admin_host=\"" +
                 m_Server->GetAdminHosts().GetAsFromConfig() + "\"\n"
            "admin_client_name=\"" +
@@ -167,6 +167,7 @@ private:
     void x_ProcessCancel(CQueue*);
     void x_ProcessStatus(CQueue*);
     void x_ProcessGetJob(CQueue*);
+    void x_ProcessGetJobBatch(CQueue*);
     void x_ProcessCancelWaitGet(CQueue*);
     void x_ProcessCancelWaitRead(CQueue*);
     void x_ProcessPut(CQueue*);
@@ -248,6 +249,9 @@ private:
     void x_PrintGetJobResponse(const CQueue * q,
                                const CJob &   job,
                                bool           add_security_token);
+    string x_MakeGetJobReply(const CQueue *  q,
+                             const CJob &    job,
+                             const string &  job_key);
     bool x_CanBeWithoutQueue(FProcessor  processor) const;
     bool x_NeedToGeneratePHIDAndSID(FProcessor  processor) const;
     bool x_WorkerNodeCommand(void) const;
@@ -902,6 +902,115 @@ CQueue::GetJobOrWait(const CNSClientId &       client,
 }
 
 
+void
+CQueue::GetJobBatch(const CNSClientId &       client,
+                    size_t                    max_jobs,
+                    const list<string> &      aff_list,
+                    bool                      any_affinity,
+                    const list<string> &      group_list,
+                    vector<CJob> &            jobs,
+                    CNSRollbackInterface * &  rollback_action)
+{
+    CFastMutexGuard     guard(m_OperationLock);
+    CNSPreciseTime      curr = CNSPreciseTime::Current();
+
+    // This is a worker node command, so mark the node type as a worker
+    // node
+    m_ClientsRegistry.AppendType(client, CNSClient::eWorkerNode);
+
+    vector<unsigned int>    aff_ids;
+    TNSBitVector            aff_ids_vector;
+    TNSBitVector            group_ids_vector;
+    bool                    has_groups = !group_list.empty();
+
+    if (has_groups)
+        m_GroupRegistry.ResolveGroups(group_list, group_ids_vector);
+    m_AffinityRegistry.ResolveAffinities(aff_list, aff_ids_vector, aff_ids);
+
+    x_UnregisterGetListener(client, 0);
+
+    // The candidates are formed with bit vector operations only. The
+    // virtual scope jobs are tried first (see CXX-5324) and within a scope
+    // the jobs with explicit affinities go before any other jobs.
+    list<TNSBitVector>      candidates;
+    vector<string>          scopes;
+    if (!client.GetVirtualScope().empty())
+        scopes.push_back(client.GetVirtualScope());
+    scopes.push_back(client.GetScope());
+
+    TNSBitVector            aff_jobs;
+    if (!aff_ids.empty())
+        aff_jobs = m_AffinityRegistry.GetJobsWithAffinities(aff_ids_vector);
+
+    for (const auto &  scope : scopes) {
+        TNSBitVector    vacant_jobs = x_GetVacantJobs(client, scope,
+                                                      group_ids_vector,
+                                                      has_groups);
+        if (!aff_ids.empty())
+            candidates.push_back(vacant_jobs & aff_jobs);
+        if (any_affinity) {
+            if (!aff_ids.empty())
+                vacant_jobs -= aff_jobs;
+            candidates.push_back(vacant_jobs);
+        }
+    }
+
+    // Jobs per client support: CXX-11138
+    map<string, size_t>     running_jobs_per_client;
+    if (m_MaxJobsPerClient > 0)
+        running_jobs_per_client = x_GetRunningJobsPerClientIP();
+
+    vector<unsigned int>    job_ids;
+    TNSBitVector            picked_jobs;
+    for (auto &  candidate_jobs : candidates) {
+        // The same job may be a candidate in both scopes
+        candidate_jobs -= picked_jobs;
+
+        TNSBitVector::enumerator    en(candidate_jobs.first());
+        for (; en.valid() && job_ids.size() < max_jobs; ++en) {
+            unsigned int    job_id = *en;
+            if (!x_ValidateMaxJobsPerClientIP(job_id, running_jobs_per_client))
+                continue;
+
+            jobs.push_back(CJob());
+            CJob &      job = jobs.back();
+            x_UpdateDB_ProvideJobNoLock(client, curr, job_id, eGet, job);
+            m_StatusTracker.SetStatus(job_id, CNetScheduleAPI::eRunning);
+
+            m_StatisticsCounters.CountTransition(CNetScheduleAPI::ePending,
+                                                 CNetScheduleAPI::eRunning);
+            g_DoPerfLogging(*this, job, 200);
+
+            m_GCRegistry.UpdateLifetime(job_id,
+                                        job.GetExpirationTime(m_Timeout,
+                                                              m_RunTimeout,
+                                                              m_ReadTimeout,
+                                                              m_PendingTimeout,
+                                                              curr));
+            TimeLineAdd(job_id, curr + m_RunTimeout);
+            m_ClientsRegistry.RegisterJob(client, job_id, eGet);
+
+            x_NotifyJobChanges(job, MakeJobKey(job_id), eStatusChanged, curr);
+
+            if (m_MaxJobsPerClient > 0)
+                ++running_jobs_per_client[job.GetClientIP()];
+            picked_jobs.set_bit(job_id);
+            job_ids.push_back(job_id);
+        }
+    }
+
+    if (job_ids.empty())
+        return;
+
+    // If there are no more pending jobs, let's clear the
+    // list of delayed exact notifications.
+    if (!m_StatusTracker.AnyPending())
+        m_NotificationsList.ClearExactGetNotifications();
+
+    rollback_action = new CNSGetJobBatchRollback(client, job_ids);
+}
+
+
 void  CQueue::CancelWaitGet(const CNSClientId &  client)
 {
     bool    result;
@@ -2817,6 +2926,34 @@ CQueue::x_FindVacantJob(const CNSClientId  &          client,
     return x_SJobPick();
 }
 
+// Provides the pending jobs which the client may get from the given scope
+TNSBitVector
+CQueue::x_GetVacantJobs(const CNSClientId &   client,
+                        const string &        scope,
+                        const TNSBitVector &  group_ids,
+                        bool                  has_groups)
+{
+    TNSBitVector    vacant_jobs;
+    m_StatusTracker.GetJobs(CNetScheduleAPI::ePending, vacant_jobs);
+
+    if (scope.empty() || scope == kNoScopeOnly) {
+        // Both these cases should consider only the non-scope jobs
+        vacant_jobs -= m_ScopeRegistry.GetAllJobsInScopes();
+    } else {
+        // Consider only the jobs in the particular scope
+        vacant_jobs &= m_ScopeRegistry.GetJobs(scope);
+    }
+
+    // Exclude blacklisted jobs
+    m_ClientsRegistry.SubtractBlacklistedJobs(client, eGet, vacant_jobs);
+
+    // Keep only the group jobs if the groups are provided
+    if (has_groups)
+        m_GroupRegistry.RestrictByGroup(group_ids, vacant_jobs);
+    return vacant_jobs;
+}
+
+
 // Provides a map between the client IP and the number of running jobs
 map<string, size_t> CQueue::x_GetRunningJobsPerClientIP(void)
 {
@@ -194,6 +194,17 @@ public:
                       CNSRollbackInterface * &  rollback_action,
                       string &                  added_pref_aff);
 
+    // Provides up to max_jobs pending jobs at once (GETB). Only explicit
+    // affinities and any_affinity are supported; the jobs with explicit
+    // affinities go first.
+    void GetJobBatch(const CNSClientId &       client,
+                     size_t                    max_jobs,
+                     const list<string> &      aff_list,
+                     bool                      any_affinity,
+                     const list<string> &      group_list,
+                     vector<CJob> &            jobs,
+                     CNSRollbackInterface * &  rollback_action);
+
     void CancelWaitGet(const CNSClientId &  client);
     void CancelWaitRead(const CNSClientId &  client);
 
@@ -519,6 +530,10 @@ private:
                     bool                          has_groups,
                     ECommandGroup                 cmd_group,
                     const string &                scope);
+    TNSBitVector x_GetVacantJobs(const CNSClientId &   client,
+                                 const string &        scope,
+                                 const TNSBitVector &  group_ids,
+                                 bool                  has_groups);
     map<string, size_t> x_GetRunningJobsPerClientIP(void);
     bool x_ValidateMaxJobsPerClientIP(unsigned int  job_id,
                                       const map<string, size_t> &  jobs_per_client_ip) const;
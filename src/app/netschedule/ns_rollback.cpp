@@ -109,6 +109,31 @@ void CNSGetJobRollback::Rollback(CQueue *  queue)
 }
 
 
+void CNSGetJobBatchRollback::Rollback(CQueue *  queue)
+{
+    ERR_POST(Warning << "Rolling back job batch request due to "
+                        "a network error while reporting the job keys.");
+
+    // The same as for a single job: return the jobs without putting them
+    // into a blacklist.
+    for (vector<unsigned int>::const_iterator  k = m_JobIds.begin();
+            k != m_JobIds.end(); ++k) {
+        try {
+            string      warning;    // not analyzed here
+            CJob        job;        // Not used here
+
+            queue->ReturnJob(m_Client, *k, queue->MakeJobKey(*k),
+                             job, "", warning, CQueue::eRollback);
+        } catch (const exception &  ex) {
+            ERR_POST("Error while rolling back requested job batch: "
+                     << ex.what());
+        } catch (...) {
+            ERR_POST("Unknown error while rolling back requested job batch");
+        }
+    }
+}
+
+
 void CNSReadJobRollback::Rollback(CQueue *  queue)
 {
     ERR_POST(Warning << "Rolling back reading job request due to "
@@ -120,6 +120,25 @@ class CNSGetJobRollback : public CNSRollbackInterface
 };
 
 
+class CNSGetJobBatchRollback : public CNSRollbackInterface
+{
+    public:
+        CNSGetJobBatchRollback(const CNSClientId &            client,
+                               const vector<unsigned int> &   job_ids) :
+            m_Client(client), m_JobIds(job_ids)
+        {}
+
+        virtual ~CNSGetJobBatchRollback() {}
+
+    public:
+        virtual void  Rollback(CQueue *  queue);
+
+    private:
+        CNSClientId             m_Client;
+        vector<unsigned int>    m_JobIds;
+};
+
+
 class CNSReadJobRollback : public CNSRollbackInterface
 {
     public:
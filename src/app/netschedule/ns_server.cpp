@@ -72,6 +72,7 @@ CNetScheduleServer::CNetScheduleServer(const string &  dbpath,
       m_StatInterval(default_stat_interval),
       m_JobCountersInterval(default_job_counters_interval),
       m_MaxClientData(default_max_client_data),
+      m_MaxGetbCount(default_max_getb_count),
       m_NodeID("not_initialized"),
       m_SessionID("s" + x_GenerateGUID()),
       m_StartIDs(dbpath, diskless),
@@ -182,6 +183,14 @@ CJsonNode CNetScheduleServer::SetNSParameters(const SNS_Parameters &  params,
     }
     m_MaxClientData = params.max_client_data;
 
+    if (m_MaxGetbCount != params.max_getb_count) {
+        CJsonNode       values = CJsonNode::NewArrayNode();
+        values.AppendInteger(m_MaxGetbCount);
+        values.AppendInteger(params.max_getb_count);
+        changes.SetByKey("max_getb_count", values);
+    }
+    m_MaxGetbCount = params.max_getb_count;
+
     CJsonNode   accepted_hosts = m_AdminHosts.SetHosts(params.admin_hosts);
     if (accepted_hosts.GetSize() > 0)
         changes.SetByKey("admin_host", accepted_hosts);
@@ -105,6 +105,8 @@ public:
     { return m_BackgroundHost; }
     unsigned int GetMaxClientData(void) const
     { return m_MaxClientData; }
+    unsigned int GetMaxGetbCount(void) const
+    { return m_MaxGetbCount; }
     string GetNodeID(void) const
     { return m_NodeID; }
     string GetSessionID(void) const
@@ -255,6 +257,7 @@ private:
     unsigned int                    m_JobCountersInterval;
 
     unsigned int                    m_MaxClientData;
+    unsigned int                    m_MaxGetbCount;     // Max jobs in GETB
 
     string                          m_NodeID;           // From the ini file
     string                          m_SessionID;        // Generated
@@ -247,6 +247,10 @@ void SNS_Parameters::Read(const IRegistry &  reg)
     if (max_client_data <= 0)
         max_client_data = default_max_client_data;
 
+    max_getb_count = GetIntNoErr("max_getb_count", default_max_getb_count);
+    if (max_getb_count <= 0)
+        max_getb_count = default_max_getb_count;
+
     admin_hosts = reg.GetString(sname, "admin_host", kEmptyStr);
     try {
         admin_client_names = reg.GetEncryptedString(sname, "admin_client_name",
@@ -148,6 +148,7 @@ struct SNS_Parameters : SServer_Parameters
     unsigned int    stat_interval;      // Interval between statistics output
     unsigned int    job_counters_interval;
     unsigned int    max_client_data;    // Max (transient) client data size
+    unsigned int    max_getb_count;     // Max number of jobs in one GETB
 
     string          admin_hosts;
     string          admin_client_names;
@@ -408,6 +408,16 @@ void NS_ValidateServerSection(const IRegistry &  reg,
                      " must be > 0");
     }
 
+    ok = NS_ValidateInt(reg, section, "max_getb_count", warnings);
+    if (ok) {
+        int     val = reg.GetInt(section, "max_getb_count",
+                                 default_max_getb_count);
+        if (val <= 0)
+            warnings.push_back(g_ValidPrefix + "value " +
+                     NS_RegValName(section, "max_getb_count") +
+                     " must be > 0");
+    }
+
 
     NS_ValidateRegistrySettings(reg, section, "affinity",
                                 default_max_affinities,
@@ -245,3 +245,92 @@ class Scenario2004(TestBase):
 
         return True
 
+
+
+class Scenario2005(TestBase):
+
+    """Scenario 2005"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Submit three jobs; GETB count=2 -> first two jobs; " \
+               "GETB count=5 -> the third job; GET2 -> no jobs"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch()
+        jobID1 = self.ns.submitJob('TEST', 'blah')
+        jobID2 = self.ns.submitJob('TEST', 'blah')
+        jobID3 = self.ns.submitJob('TEST', 'blah')
+
+        ns_client = self.getNetScheduleService('TEST', 'scenario2005')
+        ns_client.set_client_identification('node', 'session')
+
+        output = execAny(ns_client, 'GETB count=2 any_aff=1', 0, True)
+        if len(output) != 2:
+            raise Exception("Unexpected GETB output; expected two jobs, "
+                            "received: " + str(output))
+        keys = [parse_qs(line, True, True)['job_key'][0] for line in output]
+        if keys != [jobID1, jobID2]:
+            raise Exception("Unexpected GETB output; expected the first "
+                            "two jobs, received: " + str(keys))
+
+        output = execAny(ns_client, 'GETB count=5 any_aff=1', 0, True)
+        if len(output) != 1:
+            raise Exception("Unexpected GETB output; expected one job, "
+                            "received: " + str(output))
+        values = parse_qs(output[0], True, True)
+        if values['job_key'][0] != jobID3:
+            raise Exception("Unexpected GETB output; expected the third job")
+
+        output = execAny(ns_client, 'GET2 wnode_aff=0 any_aff=1')
+        if output.strip() != '':
+            raise Exception("Unexpected GET2 output; expected no jobs")
+        return True
+
+
+
+class Scenario2006(TestBase):
+
+    """Scenario 2006"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "max_getb_count=2; submit three jobs; GETB count=5 -> " \
+               "first two jobs; GETB count=5 -> the third job"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch(2006)
+        jobID1 = self.ns.submitJob('TEST', 'blah')
+        jobID2 = self.ns.submitJob('TEST', 'blah')
+        jobID3 = self.ns.submitJob('TEST', 'blah')
+
+        ns_client = self.getNetScheduleService('TEST', 'scenario2006')
+        ns_client.set_client_identification('node', 'session')
+
+        output = execAny(ns_client, 'GETB count=5 any_aff=1', 0, True)
+        if len(output) != 2:
+            raise Exception("Unexpected GETB output; expected two jobs "
+                            "(max_getb_count), received: " + str(output))
+        keys = [parse_qs(line, True, True)['job_key'][0] for line in output]
+        if keys != [jobID1, jobID2]:
+            raise Exception("Unexpected GETB output; expected the first "
+                            "two jobs, received: " + str(keys))
+
+        output = execAny(ns_client, 'GETB count=5 any_aff=1', 0, True)
+        if len(output) != 1:
+            raise Exception("Unexpected GETB output; expected one job, "
+                            "received: " + str(output))
+        values = parse_qs(output[0], True, True)
+        if values['job_key'][0] != jobID3:
+            raise Exception("Unexpected GETB output; expected the third job")
+        return True
@@ -74,7 +74,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.16.9":   READ2_tests +
                 [ 214, 215,
                   1000, 1100, 1101, 1102, 1103, 1104, 1105, 1106, 1107, 1108, 1109,
@@ -93,7 +93,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.16.10":  READ2_tests +
                 [ 1108, 1109,
                   1110, 1111, 1112, 1113, 1114, 1115, 1116, 1117,
@@ -111,7 +111,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.16.11":  READ2_tests +
                 [ 1108, 1109,
                   1110, 1111, 1112, 1113, 1114, 1115, 1116, 1117,
@@ -129,7 +129,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.17.0":   READ2_tests +
                 [ 801,
                   1200, 1201, 1202, 1203, 1204,
@@ -146,7 +146,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.17.1":   READ2_tests +
                 [ 801,
                   1202, 1203, 1204,
@@ -163,7 +163,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.18.0":   READ2_tests +
                 [ 801,
                   1202, 1203, 1204,
@@ -178,7 +178,7 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.19.0":   READ2_tests +
                 [ 801,
                   1202, 1203, 1204,
@@ -192,90 +192,90 @@ excludeTestsMap = \
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.20.0":   [ 801,
                   1202, 1203, 1204,
                   1600, 1601, 1602, 1603, 1604, 1605, 1606, 1607, 1608,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.20.1":   [ 801,
                   1202, 1203, 1204,
                   1600, 1601, 1602, 1603, 1604, 1605, 1606, 1607, 1608,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.20.2":   [ 801,
                   1202, 1203, 1204,
                   1600, 1601, 1602, 1603, 1604, 1605, 1606, 1607, 1608,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.21.0":   [ 801,
                   1202, 1203, 1204,
                   1600, 1601, 1602, 1603, 1604, 1605, 1606, 1607, 1608,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.21.1":   [ 801,
                   1600, 1601, 1602, 1603, 1604, 1605, 1606, 1607, 1608,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.21.2":   [ 801,
                   1600, 1601, 1602, 1603, 1604, 1605, 1606, 1607, 1608,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.22.0":   [ 801,
                   1700, 1701, 1702, 1703, 1704 ] +
                   ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.23.0":   [ 801, 1704 ] + ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.23.1":   [ 801, 1704 ] + ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.23.2":   [ 801, 1704 ] + ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.24.0":   [ 801 ] + ScopeTests +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.25.0":   [ 801 ] +
                 [ 1900, 1901, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.27.0":   [ 313, 801, 1603, 1606, 1902, 1903, 1904,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.28.0":   [ 313, 801, 1603, 1606,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.28.1":   [ 313, 801, 1603, 1606,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.28.2":   [ 313, 801, 1603, 1606,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.28.3":   [ 313, 801, 1603, 1606,
-                  2000, 2001, 2002, 2003, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
     "4.30.0":   [ 313, 801, 1603, 1606,
-                  2000, 2001, 2002, 2003, 2004 ],
-    "4.30.1":   [ 313, 801, 1603, 1606, 2004 ],
-    "4.31.0":   [ 313, 801, 1603, 1606, 2004 ],
-    "4.41.1":   [ 313, 801, 1603, 1606, 2004 ],
+                  2000, 2001, 2002, 2003, 2004, 2005, 2006 ],
+    "4.30.1":   [ 313, 801, 1603, 1606, 2004, 2005, 2006 ],
+    "4.31.0":   [ 313, 801, 1603, 1606, 2004, 2005, 2006 ],
+    "4.41.1":   [ 313, 801, 1603, 1606, 2004, 2005, 2006 ],
     "4.41.2":   [ 313, 801, 1603, 1606,
-                  1804, 1805 ],
+                  1804, 1805, 2005, 2006 ],
     "4.42.1":   [ 313, 801, 1603, 1606,
-                  1804, 1805 ],
+                  1804, 1805, 2005, 2006 ],
     "4.42.2":   [ 313, 801, 1603, 1606,
-                  1804, 1805, 141 ],
+                  1804, 1805, 141, 2005, 2006 ],
     "4.42.3":   [ 313, 801, 1603, 1606,
-                  1804, 1805, 141 ]
+                  1804, 1805, 141, 2005, 2006 ]
 }
 
 
@@ -821,7 +821,9 @@ def main():
               pack_4_30.Scenario2002( netschedule ),
               pack_4_30.Scenario2003( netschedule ),
 
-              pack_4_30.Scenario2004( netschedule )
+              pack_4_30.Scenario2004( netschedule ),
+              pack_4_30.Scenario2005( netschedule ),
+              pack_4_30.Scenario2006( netschedule )
             ]
 
     # Calculate the start test index
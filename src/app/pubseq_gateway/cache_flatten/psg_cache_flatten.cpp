@@ -0,0 +1,108 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  PSG LMDB cache snapshot converter
+ *
+ *   Adds flat (fixed-layout) copies of the protobuf packed values to the
+ *   bioseq_info, si2csi and blob_prop cache files.  The server reads flat
+ *   values in place from the memory map if the files have them, so the
+ *   conversion is done once after the cache files are built and before the
+ *   server is started.  Has to be run on the architecture of the server.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+
+#include <objtools/pubseq_gateway/cache/psg_cache.hpp>
+
+
+USING_NCBI_SCOPE;
+USING_IDBLOB_SCOPE;
+
+
+class CPsgCacheFlattenApp : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+};
+
+
+void CPsgCacheFlattenApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Add flat values to PSG LMDB cache files");
+
+    arg_desc->AddOptionalKey("bioseq_info", "file",
+                             "bioseq_info cache file",
+                             CArgDescriptions::eString);
+
+    arg_desc->AddOptionalKey("si2csi", "file",
+                             "si2csi cache file",
+                             CArgDescriptions::eString);
+
+    arg_desc->AddOptionalKey("blob_prop", "file",
+                             "blob_prop cache file",
+                             CArgDescriptions::eString);
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+int CPsgCacheFlattenApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    string bioseq_info = args["bioseq_info"]? args["bioseq_info"].AsString(): kEmptyStr;
+    string si2csi = args["si2csi"]? args["si2csi"].AsString(): kEmptyStr;
+    string blob_prop = args["blob_prop"]? args["blob_prop"].AsString(): kEmptyStr;
+    if (bioseq_info.empty()  &&  si2csi.empty()  &&  blob_prop.empty()) {
+        ERR_POST("No cache files given");
+        return 1;
+    }
+
+    CStopWatch sw(CStopWatch::eStart);
+    try {
+        size_t converted = CPubseqGatewayCache::ConvertToFlat(bioseq_info, si2csi, blob_prop);
+        cout << "Converted " << converted << " records in "
+             << sw.AsSmartString() << NcbiEndl;
+    }
+    catch (const std::exception& ex) {
+        ERR_POST("Conversion failed: " << ex.what());
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CPsgCacheFlattenApp().AppMain(argc, argv);
+}
@@ -0,0 +1,183 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: adaptive limit on the number of concurrently running
+ *                   processors of a processor group
+ *
+ */
+#include <ncbi_pch.hpp>
+
+#include <cmath>
+
+#include "adaptive_limit.hpp"
+
+
+// A window is closed when it is at least that long and has enough samples
+static const chrono::milliseconds   kWindowDuration(100);
+static const size_t                 kWindowMinSamples = 10;
+
+// Weight of a window in the long term latency; about 100 windows (10 seconds
+// under load) are remembered
+static const double                 kLongLatencyWeight = 0.01;
+
+// Weight of the newly calculated limit when it is lower than the current one
+static const double                 kSmoothing = 0.2;
+
+// The limit cannot be cut more than twice in one window by the latency
+static const double                 kMinGradient = 0.5;
+
+
+CPSGS_AdaptiveLimit::CPSGS_AdaptiveLimit() :
+    m_Enabled(false), m_MinLimit(1), m_MaxLimit(1),
+    m_Tolerance(1.5), m_Backoff(0.9),
+    m_Limit(1),
+    m_LimitValue(1.0), m_ShortLatency(0.0), m_LongLatency(0.0),
+    m_Decreases(0), m_Backoffs(0),
+    m_WindowStart(psg_clock_t::now()),
+    m_WindowSum(0.0), m_WindowSamples(0), m_WindowFailures(0),
+    m_WindowMaxInFlight(0)
+{}
+
+
+void CPSGS_AdaptiveLimit::Configure(bool  enabled, size_t  min_limit,
+                                    size_t  max_limit, double  tolerance,
+                                    double  backoff)
+{
+    lock_guard<mutex>   guard(m_Lock);
+
+    m_Enabled = enabled;
+    m_MaxLimit = max(max_limit, size_t(1));
+    m_MinLimit = min(max(min_limit, size_t(1)), m_MaxLimit);
+    m_Tolerance = tolerance;
+    m_Backoff = backoff;
+
+    m_LimitValue = static_cast<double>(m_MaxLimit);
+    m_Limit = m_MaxLimit;
+}
+
+
+void CPSGS_AdaptiveLimit::OnProcessorFinished(uint64_t  mks, bool  failed,
+                                              size_t  in_flight)
+{
+    if (!m_Enabled)
+        return;
+
+    auto                now = psg_clock_t::now();
+    lock_guard<mutex>   guard(m_Lock);
+
+    if (failed) {
+        ++m_WindowFailures;
+    } else {
+        m_WindowSum += static_cast<double>(mks);
+        ++m_WindowSamples;
+    }
+    m_WindowMaxInFlight = max(m_WindowMaxInFlight, in_flight);
+
+    if (m_WindowSamples + m_WindowFailures < kWindowMinSamples)
+        return;
+    if (now - m_WindowStart < kWindowDuration)
+        return;
+
+    x_UpdateLimit();
+
+    m_WindowStart = now;
+    m_WindowSum = 0.0;
+    m_WindowSamples = 0;
+    m_WindowFailures = 0;
+    m_WindowMaxInFlight = 0;
+}
+
+
+void CPSGS_AdaptiveLimit::x_UpdateLimit(void)
+{
+    double      limit = m_LimitValue;
+
+    if (m_WindowFailures * 10 > m_WindowSamples + m_WindowFailures) {
+        // The backend times out or fails: back off regardless of the latency
+        limit *= m_Backoff;
+        ++m_Backoffs;
+    } else if (m_WindowSamples > 0) {
+        m_ShortLatency = max(m_WindowSum / m_WindowSamples, 1.0);
+
+        if (m_LongLatency == 0.0) {
+            m_LongLatency = m_ShortLatency;
+        } else {
+            m_LongLatency = m_LongLatency * (1.0 - kLongLatencyWeight) +
+                            m_ShortLatency * kLongLatencyWeight;
+
+            // After a long slow period the long term latency is far above the
+            // current one; let it catch up faster so that the next slow down
+            // is noticed
+            if (m_LongLatency > 2.0 * m_ShortLatency)
+                m_LongLatency *= 0.95;
+        }
+
+        double  gradient = m_Tolerance * m_LongLatency / m_ShortLatency;
+        gradient = max(kMinGradient, min(1.0, gradient));
+
+        double  new_limit = limit * gradient + sqrt(limit);
+        if (new_limit > limit && m_WindowMaxInFlight * 2 < limit) {
+            // The limit is not what restricts the group at the moment; do not
+            // let it grow without a proof that it is safe
+            new_limit = limit;
+        }
+        if (new_limit < limit) {
+            // Decreases are smoothed so that a single slow window does not
+            // cut the limit; growth is slow enough as it is
+            limit = limit * (1.0 - kSmoothing) + new_limit * kSmoothing;
+            ++m_Decreases;
+        } else {
+            limit = new_limit;
+        }
+    }
+
+    limit = max(static_cast<double>(m_MinLimit),
+                min(static_cast<double>(m_MaxLimit), limit));
+    m_LimitValue = limit;
+    m_Limit = static_cast<size_t>(limit);
+}
+
+
+CPSGS_AdaptiveLimit::SStatus CPSGS_AdaptiveLimit::GetStatus(void) const
+{
+    SStatus             status;
+    lock_guard<mutex>   guard(m_Lock);
+
+    status.m_Limit = static_cast<size_t>(m_LimitValue);
+    status.m_ShortLatencyMks = static_cast<uint64_t>(m_ShortLatency);
+    status.m_LongLatencyMks = static_cast<uint64_t>(m_LongLatency);
+    status.m_Decreases = m_Decreases;
+    status.m_Backoffs = m_Backoffs;
+    return status;
+}
+
+
+string GetOverloadReplyMessage(const string &  msg,
+                               unsigned int  retry_after_sec)
+{
+    if (retry_after_sec == 0)
+        return msg;
+    return msg + ". Retry after " + to_string(retry_after_sec) + " second(s)";
+}
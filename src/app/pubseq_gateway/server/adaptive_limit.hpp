@@ -0,0 +1,120 @@
+#ifndef ADAPTIVE_LIMIT__HPP
+#define ADAPTIVE_LIMIT__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: adaptive limit on the number of concurrently running
+ *                   processors of a processor group
+ *
+ */
+
+#include <corelib/ncbistd.hpp>
+
+#include <atomic>
+#include <mutex>
+
+#include "pubseq_gateway_types.hpp"
+
+USING_NCBI_SCOPE;
+
+
+// The limit follows the latency of the processors (i.e. of the backend they
+// talk to). The processor run times are collected in windows; at the end of
+// each window the average latency of the window is compared with a long term
+// average:
+// - while the window latency stays within the tolerated growth the limit
+//   grows by about sqrt(limit)
+// - when the latency grows the limit is decreased proportionally (smoothed)
+// - when more than 10% of the window processors timed out or failed the limit
+//   is decreased multiplicatively (backoff)
+// The limit never exceeds the configured static processor group limit and is
+// not increased if less than a half of it was in use during the window.
+class CPSGS_AdaptiveLimit
+{
+public:
+    CPSGS_AdaptiveLimit();
+
+    // max_limit is the static limit of the processor group, the limit starts
+    // with it
+    void Configure(bool  enabled, size_t  min_limit, size_t  max_limit,
+                   double  tolerance, double  backoff);
+
+    bool IsEnabled(void) const
+    { return m_Enabled; }
+
+    size_t GetLimit(void) const
+    { return m_Limit.load(memory_order_relaxed); }
+
+    // A processor finished. mks is its run time as registered in the
+    // processor performance statistics; in_flight is the number of the
+    // group processors which were running when it finished (including it)
+    void OnProcessorFinished(uint64_t  mks, bool  failed, size_t  in_flight);
+
+    struct SStatus
+    {
+        size_t      m_Limit;
+        uint64_t    m_ShortLatencyMks;
+        uint64_t    m_LongLatencyMks;
+        size_t      m_Decreases;
+        size_t      m_Backoffs;
+    };
+    SStatus GetStatus(void) const;
+
+private:
+    void x_UpdateLimit(void);
+
+private:
+    bool                    m_Enabled;
+    size_t                  m_MinLimit;
+    size_t                  m_MaxLimit;
+    double                  m_Tolerance;
+    double                  m_Backoff;
+
+    atomic<size_t>          m_Limit;
+    mutable mutex           m_Lock;
+
+    // Guarded by m_Lock
+    double                  m_LimitValue;
+    double                  m_ShortLatency;
+    double                  m_LongLatency;
+    size_t                  m_Decreases;
+    size_t                  m_Backoffs;
+
+    psg_time_point_t        m_WindowStart;
+    double                  m_WindowSum;
+    size_t                  m_WindowSamples;
+    size_t                  m_WindowFailures;
+    size_t                  m_WindowMaxInFlight;
+};
+
+
+// The message of the reply to a request rejected because of the processor
+// concurrency limits. A positive retry_after_sec is also sent to the client
+// in the Retry-After header.
+string GetOverloadReplyMessage(const string &  msg,
+                               unsigned int  retry_after_sec);
+
+#endif
@@ -42,7 +42,9 @@
 using namespace std::placeholders;
 
 
-CPSGS_AsyncBioseqInfoBase::CPSGS_AsyncBioseqInfoBase()
+CPSGS_AsyncBioseqInfoBase::CPSGS_AsyncBioseqInfoBase() :
+    m_SingleFlightLeader(false),
+    m_SingleFlightWaiter(false)
 {}
 
 
@@ -56,12 +58,16 @@ CPSGS_AsyncBioseqInfoBase::CPSGS_AsyncBioseqInfoBase(
     m_NeedTrace(request->NeedTrace()),
     m_Fetch(nullptr),
     m_NoSeqIdTypeFetch(nullptr),
-    m_WithSeqIdType(true)
+    m_WithSeqIdType(true),
+    m_SingleFlightLeader(false),
+    m_SingleFlightWaiter(false)
 {}
 
 
 CPSGS_AsyncBioseqInfoBase::~CPSGS_AsyncBioseqInfoBase()
-{}
+{
+    x_LeaveSingleFlight();
+}
 
 
 void
@@ -96,6 +102,9 @@ CPSGS_AsyncBioseqInfoBase::x_MakeRequest(void)
     if (gi != -1)
         bioseq_info_request.SetGI(gi);
 
+    if (x_JoinSingleFlight(bioseq_info_request))
+        return;
+
     auto    sat_info_entry = CPubseqGatewayApp::GetInstance()->GetBioseqKeyspace();
     CCassBioseqInfoTaskFetch *  fetch_task =
             new CCassBioseqInfoTaskFetch(
@@ -146,14 +155,176 @@ CPSGS_AsyncBioseqInfoBase::x_MakeRequest(void)
 }
 
 
+void CPSGS_AsyncBioseqInfoBase::Cancel(void)
+{
+    CPSGS_CassProcessorBase::Cancel();
+
+    // A canceled leader does not receive the records so its waiters (if any)
+    // need to make their own requests. The single flight state is handled in
+    // the processor loop; it is safe even if Cancel() is done from another
+    // loop. If the processor is destroyed before that then the destructor
+    // abandons the lookup.
+    if (IsUVThreadAssigned()) {
+        try {
+            PostponeInvoke(
+                [](void *  user_data)
+                {
+                    ((CPSGS_AsyncBioseqInfoBase*)(user_data))->
+                                                x_OnCanceledSingleFlight();
+                },
+                (void*)(this));
+        } catch (...) {
+            // The error is logged by PostponeInvoke()
+        }
+    } else {
+        x_OnCanceledSingleFlight();
+    }
+}
+
+
+void CPSGS_AsyncBioseqInfoBase::x_OnCanceledSingleFlight(void)
+{
+    // A canceled waiter stays: the callback finishes its fetch
+    if (m_SingleFlightLeader)
+        x_LeaveSingleFlight();
+}
+
+
+bool
+CPSGS_AsyncBioseqInfoBase::x_JoinSingleFlight(
+                    const CBioseqInfoFetchRequest &  bioseq_info_request)
+{
+    // The previous lookup (if any; e.g. before the second INSDC try) is over
+    x_LeaveSingleFlight();
+
+    m_SingleFlightKey = bioseq_info_request.GetAccession() + "|" +
+        (bioseq_info_request.HasField(CBioseqInfoFetchRequest::EFields::eVersion) ?
+            to_string(bioseq_info_request.GetVersion()) : "") + "|" +
+        (bioseq_info_request.HasField(CBioseqInfoFetchRequest::EFields::eSeqIdType) ?
+            to_string(bioseq_info_request.GetSeqIdType()) : "") + "|" +
+        (bioseq_info_request.HasField(CBioseqInfoFetchRequest::EFields::eGI) ?
+            to_string(bioseq_info_request.GetGI()) : "");
+
+    auto &  single_flight = CPubseqGatewayApp::GetInstance()->
+                                GetProcessorDispatcher()->GetBioseqInfoSingleFlight();
+    auto    join_result = single_flight.Join(
+                m_SingleFlightKey, this,
+                [this](optional<vector<CBioseqInfoRecord>> &&  records)
+                {
+                    // If this processor is destroyed by the time its loop
+                    // gets to the callback then the uv loop binder drops the
+                    // callback (the processor group is not alive anymore).
+                    try {
+                        PostponeInvoke(
+                            [this, records](void *) mutable
+                            {
+                                x_OnSingleFlightBioseqInfo(std::move(records));
+                            },
+                            nullptr);
+                    } catch (...) {
+                        // The error is logged by PostponeInvoke()
+                    }
+                });
+
+    switch (join_result) {
+        case CPSGS_BioseqInfoSingleFlight::ePSGS_Leader:
+            m_SingleFlightLeader = true;
+            return false;
+        case CPSGS_BioseqInfoSingleFlight::ePSGS_Bypass:
+            return false;
+        default:
+            break;
+    }
+
+    // Here: the same lookup is in flight; wait for its results. The fetch
+    // without a loader keeps the processor unfinished till then.
+    m_SingleFlightWaiter = true;
+    CCassBioseqInfoFetch *  details = new CCassBioseqInfoFetch();
+    if (m_WithSeqIdType)
+        m_Fetch = details;
+    else
+        m_NoSeqIdTypeFetch = details;
+    m_FetchDetails.push_back(unique_ptr<CCassFetch>(details));
+    m_BioseqRequestStart = psg_clock_t::now();
+
+    if (m_NeedTrace) {
+        m_Reply->SendTrace(
+            "Cassandra request: " + ToJsonString(bioseq_info_request) +
+            " is in flight for another request; waiting for its results",
+            m_Request->GetStartTimestamp());
+    }
+    return true;
+}
+
+
+void
+CPSGS_AsyncBioseqInfoBase::x_LeaveSingleFlight(void)
+{
+    if (m_SingleFlightLeader || m_SingleFlightWaiter) {
+        auto *  dispatcher = CPubseqGatewayApp::GetInstance()->GetProcessorDispatcher();
+        if (dispatcher) {
+            auto &  single_flight = dispatcher->GetBioseqInfoSingleFlight();
+            if (m_SingleFlightLeader)
+                single_flight.Abandon(m_SingleFlightKey, this);
+            else
+                single_flight.Leave(m_SingleFlightKey, this);
+        }
+        m_SingleFlightLeader = false;
+        m_SingleFlightWaiter = false;
+    }
+}
+
+
+void
+CPSGS_AsyncBioseqInfoBase::x_OnSingleFlightBioseqInfo(
+                        optional<vector<CBioseqInfoRecord>> &&  records)
+{
+    m_SingleFlightWaiter = false;
+
+    CCassFetch *    details = m_WithSeqIdType ? m_Fetch : m_NoSeqIdTypeFetch;
+    if (m_Canceled) {
+        details->SetReadFinished();
+        return;
+    }
+
+    if (!records.has_value()) {
+        // The other request could not get the records; make an own request
+        if (m_NeedTrace) {
+            m_Reply->SendTrace("The coalesced Cassandra request did not "
+                               "provide results; sending an own request",
+                               m_Request->GetStartTimestamp());
+        }
+        details->SetReadFinished();
+        x_MakeRequest();
+        return;
+    }
+
+    if (m_WithSeqIdType)
+        x_OnBioseqInfo(std::move(records.value()));
+    else
+        x_OnBioseqInfoWithoutSeqIdType(std::move(records.value()));
+
+    // Let the processor check if everything is finished just like after the
+    // cassandra data are received
+    CallOnData();
+}
+
+
 void
 CPSGS_AsyncBioseqInfoBase::x_OnBioseqInfo(vector<CBioseqInfoRecord>&&  records)
 {
     auto    app = CPubseqGatewayApp::GetInstance();
 
-    m_Fetch->GetLoader()->ClearError();
+    if (m_Fetch->GetLoader())
+        m_Fetch->GetLoader()->ClearError();
     m_Fetch->SetReadFinished();
 
+    if (m_SingleFlightLeader) {
+        m_SingleFlightLeader = false;
+        app->GetProcessorDispatcher()->GetBioseqInfoSingleFlight().Complete(
+                                            m_SingleFlightKey, this, records);
+    }
+
     if (m_NeedTrace) {
         string  msg = to_string(records.size()) + " hit(s)";
         for (const auto &  item : records) {
@@ -252,10 +423,17 @@ void
 CPSGS_AsyncBioseqInfoBase::x_OnBioseqInfoWithoutSeqIdType(
                                         vector<CBioseqInfoRecord>&&  records)
 {
-    m_NoSeqIdTypeFetch->GetLoader()->ClearError();
+    if (m_NoSeqIdTypeFetch->GetLoader())
+        m_NoSeqIdTypeFetch->GetLoader()->ClearError();
     m_NoSeqIdTypeFetch->SetReadFinished();
 
     auto                app = CPubseqGatewayApp::GetInstance();
+
+    if (m_SingleFlightLeader) {
+        m_SingleFlightLeader = false;
+        app->GetProcessorDispatcher()->GetBioseqInfoSingleFlight().Complete(
+                                            m_SingleFlightKey, this, records);
+    }
     auto                request_version = m_BioseqResolution.GetBioseqInfo().GetVersion();
     SINSDCDecision      decision = DecideINSDC(records, request_version);
 
@@ -335,14 +513,19 @@ CPSGS_AsyncBioseqInfoBase::x_OnBioseqInfoError(CRequestStatus::ECode  status,
                                                const string &  message)
 {
     if (m_Fetch) {
-        m_Fetch->GetLoader()->ClearError();
+        if (m_Fetch->GetLoader())
+            m_Fetch->GetLoader()->ClearError();
         m_Fetch->SetReadFinished();
     }
     if (m_NoSeqIdTypeFetch) {
-        m_NoSeqIdTypeFetch->GetLoader()->ClearError();
+        if (m_NoSeqIdTypeFetch->GetLoader())
+            m_NoSeqIdTypeFetch->GetLoader()->ClearError();
         m_NoSeqIdTypeFetch->SetReadFinished();
     }
 
+    // The waiters (if any) make their own requests
+    x_LeaveSingleFlight();
+
     CPubseqGatewayApp::GetInstance()->GetCounters().Increment(
                                         this,
                                         CPSGSCounters::ePSGS_BioseqInfoError);
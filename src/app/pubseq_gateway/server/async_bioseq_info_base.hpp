@@ -33,6 +33,8 @@
  *
  */
 
+#include <optional>
+
 #include <corelib/request_status.hpp>
 #include <corelib/ncbidiag.hpp>
 #include <objtools/pubseq_gateway/impl/cassandra/bioseq_info/record.hpp>
@@ -56,12 +58,17 @@ public:
                               TSeqIdResolutionFinishedCB finished_cb,
                               TSeqIdResolutionErrorCB error_cb);
     virtual ~CPSGS_AsyncBioseqInfoBase();
+    virtual void Cancel(void) override;
 
 protected:
     void MakeRequest(SBioseqResolution &&  bioseq_resolution);
 
 private:
     void x_MakeRequest(void);
+    bool x_JoinSingleFlight(const CBioseqInfoFetchRequest &  bioseq_info_request);
+    void x_LeaveSingleFlight(void);
+    void x_OnCanceledSingleFlight(void);
+    void x_OnSingleFlightBioseqInfo(optional<vector<CBioseqInfoRecord>> &&  records);
     void x_OnBioseqInfo(vector<CBioseqInfoRecord>&&  records);
     void x_OnBioseqInfoWithoutSeqIdType(vector<CBioseqInfoRecord>&&  records);
     void x_OnBioseqInfoError(CRequestStatus::ECode  status, int  code,
@@ -80,6 +87,11 @@ private:
     psg_time_point_t                    m_BioseqRequestStart;
 
     bool                                m_WithSeqIdType;
+
+    // Coalescing with the identical lookups of the other processors
+    string                              m_SingleFlightKey;
+    bool                                m_SingleFlightLeader;
+    bool                                m_SingleFlightWaiter;
 };
 
 #endif  // PSGS_ASYNCBIOSEQINFOBASE__HPP
@@ -106,11 +106,12 @@ public:
 
     void Cancel(void)
     {
-        if (m_Loader) {
-            if (!m_Canceled) {
-                m_Canceled = true;
+        if (!m_Canceled) {
+            // A fetch without a loader waits for the results of the other
+            // processor fetch (see CPSGS_BioseqInfoSingleFlight)
+            m_Canceled = true;
+            if (m_Loader)
                 m_Loader->Cancel();
-            }
         }
     }
 
@@ -155,6 +155,13 @@ void CHttpConnection::x_RegisterPending(shared_ptr<CPSGS_Request>  request,
     if (m_RunningRequests.size() < m_HttpMaxRunning) {
         x_Start(request, reply, std::move(processor_names));
     } else if (m_BacklogRequests.size() < m_HttpMaxBacklog) {
+        // Do not let the request wait if its processors are overloaded
+        // anyway; the dispatcher completes the reply in this case
+        auto *  app = CPubseqGatewayApp::GetInstance();
+        if (!app->GetProcessorDispatcher()->AdmitToBacklog(request, reply,
+                                                           processor_names))
+            return;
+
         RegisterBackloggedRequest(request->GetRequestType());
         m_BacklogRequests.push_back(
                 SBacklogAttributes{request, reply,
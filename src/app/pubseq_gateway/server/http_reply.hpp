@@ -95,6 +95,7 @@ public:
         m_HttpConn(http_conn),
         m_DataReady(make_shared<CDataTrigger>(proto)),
         m_ReplyContentType(ePSGS_NotSet),
+        m_RetryAfterSec(0),
         m_CdUid(cd_uid)
     {}
 
@@ -145,6 +146,12 @@ public:
         m_ReplyContentType = mime_type;
     }
 
+    // 0 => no Retry-After header
+    void SetRetryAfter(unsigned int  retry_after_sec)
+    {
+        m_RetryAfterSec = retry_after_sec;
+    }
+
     size_t GetBytesSent(void) const
     {
         if (m_Req)
@@ -419,6 +426,7 @@ private:
                 if (!m_Canceled) {
                     x_SetContentType();
                     x_SetCdUid();
+                    x_SetRetryAfter();
                     m_State = eReplyStarted;
                     m_Req->res.status = status;
                     m_Req->res.reason = reason;
@@ -556,6 +564,18 @@ private:
         }
     }
 
+    void x_SetRetryAfter(void)
+    {
+        if (m_RetryAfterSec > 0) {
+            string      retry_after = to_string(m_RetryAfterSec);
+            h2o_iovec_t value = h2o_strdup(&m_Req->pool, retry_after.data(),
+                                           retry_after.size());
+            h2o_add_header_by_str(&m_Req->pool, &m_Req->res.headers,
+                                  H2O_STRLIT("Retry-After"), 0, NULL,
+                                  value.base, value.len);
+        }
+    }
+
     void x_Clear(void)
     {
         for (auto req: m_PendingReqs) {
@@ -573,6 +593,7 @@ private:
         m_HttpProto = nullptr;
         m_HttpConn = nullptr;
         m_ReplyContentType = ePSGS_NotSet;
+        m_RetryAfterSec = 0;
     }
 
     h2o_req_t *                             m_Req;
@@ -595,6 +616,7 @@ private:
 
     shared_ptr<CDataTrigger>                m_DataReady;
     EPSGS_ReplyMimeType                     m_ReplyContentType;
+    unsigned int                            m_RetryAfterSec;
     const char *                            m_CdUid;
 };
 
@@ -69,6 +69,23 @@ void erase_processor_group_cb(void *  user_data)
 }
 
 
+CPSGS_Dispatcher::CPSGS_Dispatcher(double  request_timeout)
+{
+    auto *      app = CPubseqGatewayApp::GetInstance();
+
+    m_RequestTimeoutMillisec = static_cast<uint64_t>(request_timeout * 1000);
+
+    for (size_t  k = 0; k <= CPSGS_Request::ePSGS_UnknownRequest; ++k) {
+        auto    request_type = static_cast<CPSGS_Request::EPSGS_Type>(k);
+        m_LowPriority[k] = app->IsLowPriorityRequest(
+                                CPSGS_Request::TypeToString(request_type));
+    }
+    m_LowPriorityShare = app->GetLowPriorityShare();
+    m_RetryAfterSec = app->GetRetryAfter();
+    m_BioseqInfoSingleFlight.SetMaxWaiters(app->GetSingleFlightMaxWaiters());
+}
+
+
 void CPSGS_Dispatcher::AddProcessor(unique_ptr<IPSGS_Processor> processor)
 {
     if (m_RegisteredProcessors.size() >= MAX_PROCESSOR_GROUPS) {
@@ -99,6 +116,11 @@ void CPSGS_Dispatcher::AddProcessor(unique_ptr<IPSGS_Processor> processor)
     size_t      limit = app->GetProcessorMaxConcurrency(processor_group_name);
 
     m_ProcessorConcurrency[index].m_Limit = limit;
+    m_AdaptiveLimits[index].Configure(
+                    app->GetAdaptiveConcurrency(processor_group_name),
+                    app->GetAdaptiveMinLimit(), limit,
+                    app->GetAdaptiveLatencyTolerance(),
+                    app->GetAdaptiveBackoff());
 
     m_RegisteredProcessorGroups.push_back(processor_group_name);
     m_RegisteredProcessors.push_back(std::move(processor));
@@ -200,19 +222,27 @@ CPSGS_Dispatcher::DispatchRequest(shared_ptr<CPSGS_Request> request,
 
         // Second check the limit for the number of processors
         size_t      proc_index = proc_count - priority;
-        size_t      limit = m_ProcessorConcurrency[proc_index].m_Limit;
+        size_t      limit = x_GetAdmissionLimit(proc_index,
+                                                request->GetRequestType());
 
         size_t      current_count = m_ProcessorConcurrency[proc_index].GetCurrentCount();
 
         if (current_count >= limit) {
+            bool    adaptive = limit < m_ProcessorConcurrency[proc_index].m_Limit;
+
             request->AddLimitedProcessor(proc->GetName(), limit);
-            m_ProcessorConcurrency[proc_index].IncrementLimitReachedCount();
+            if (adaptive)
+                m_ProcessorConcurrency[proc_index].IncrementShedCount();
+            else
+                m_ProcessorConcurrency[proc_index].IncrementLimitReachedCount();
 
             if (request->NeedTrace()) {
                 // false: no need to update the last activity
                 reply->SendTrace("Processor: " + proc->GetName() +
                                  " will not be tried to create because"
-                                 " the processor group limit has been exceeded."
+                                 " the processor group " +
+                                 string(adaptive ? "adaptive " : "") +
+                                 "limit has been exceeded."
                                  " Limit: " + to_string(limit) +
                                  " Current count: " + to_string(current_count),
                                  request->GetStartTimestamp(), false);
@@ -282,6 +312,14 @@ CPSGS_Dispatcher::DispatchRequest(shared_ptr<CPSGS_Request> request,
             msg = "No matching processors found";
             status_code = CRequestStatus::e404_NotFound;
             PSG_WARNING(msg);
+
+            reply->PrepareReplyMessage(msg, status_code,
+                                       ePSGS_NoProcessor, eDiag_Error);
+            reply->PrepareReplyCompletion(status_code,
+                                          request->GetStartTimestamp());
+
+            reply->Flush(CPSGS_Reply::ePSGS_SendAndFinish);
+            reply->SetCompleted();
         } else {
             msg = to_string(limited_processor_count) + " of " +
                   to_string(processor_names.size()) +
@@ -290,15 +328,9 @@ CPSGS_Dispatcher::DispatchRequest(shared_ptr<CPSGS_Request> request,
                   request->GetLimitedProcessorsMessage() + ")";
             status_code = CRequestStatus::e503_ServiceUnavailable;
             PSG_ERROR(msg);
-        }
 
-        reply->PrepareReplyMessage(msg, status_code,
-                                   ePSGS_NoProcessor, eDiag_Error);
-        reply->PrepareReplyCompletion(status_code,
-                                      request->GetStartTimestamp());
-
-        reply->Flush(CPSGS_Reply::ePSGS_SendAndFinish);
-        reply->SetCompleted();
+            x_PrepareOverloadReply(msg, request, reply);
+        }
 
         x_PrintRequestStop(request, status_code, reply->GetBytesSent());
     } else {
@@ -322,6 +354,73 @@ CPSGS_Dispatcher::DispatchRequest(shared_ptr<CPSGS_Request> request,
 }
 
 
+bool
+CPSGS_Dispatcher::AdmitToBacklog(shared_ptr<CPSGS_Request> request,
+                                 shared_ptr<CPSGS_Reply> reply,
+                                 const list<string> &  processor_names)
+{
+    size_t          proc_index = 0;
+    vector<size_t>  saturated;
+
+    for (auto const &  proc : m_RegisteredProcessors) {
+        if (find(processor_names.begin(), processor_names.end(),
+                 proc->GetName()) != processor_names.end()) {
+            // A group without an adaptive limit keeps the former behavior:
+            // the request waits in the backlog
+            if (!m_AdaptiveLimits[proc_index].IsEnabled())
+                return true;
+
+            size_t      limit = x_GetAdmissionLimit(proc_index,
+                                                    request->GetRequestType());
+            if (m_ProcessorConcurrency[proc_index].GetCurrentCount() < limit)
+                return true;
+
+            saturated.push_back(proc_index);
+        }
+        ++proc_index;
+    }
+
+    if (saturated.empty())
+        return true;
+
+    for (auto  index : saturated) {
+        m_ProcessorConcurrency[index].IncrementShedCount();
+    }
+
+    CRequestContextResetter     context_resetter;
+    request->SetRequestContext();
+
+    string      msg = "All " + to_string(saturated.size()) +
+                      " processor group(s) which could process the request "
+                      "reached their adaptive concurrency limits";
+    PSG_WARNING(msg);
+
+    x_PrepareOverloadReply(msg, request, reply);
+    x_PrintRequestStop(request, CRequestStatus::e503_ServiceUnavailable,
+                       reply->GetBytesSent());
+    return false;
+}
+
+
+void CPSGS_Dispatcher::x_PrepareOverloadReply(const string &  msg,
+                                              shared_ptr<CPSGS_Request> request,
+                                              shared_ptr<CPSGS_Reply> reply)
+{
+    // The client is expected to come back later, so tell it when
+    if (m_RetryAfterSec > 0)
+        reply->SetRetryAfter(m_RetryAfterSec);
+
+    reply->PrepareReplyMessage(GetOverloadReplyMessage(msg, m_RetryAfterSec),
+                               CRequestStatus::e503_ServiceUnavailable,
+                               ePSGS_NoProcessor, eDiag_Error);
+    reply->PrepareReplyCompletion(CRequestStatus::e503_ServiceUnavailable,
+                                  request->GetStartTimestamp());
+
+    reply->Flush(CPSGS_Reply::ePSGS_SendAndFinish);
+    reply->SetCompleted();
+}
+
+
 // Start of the timer is done at CHttpConnection::x_Start()
 // This guarantees that the timer is created in the same uv loop (i.e. working
 // thread) as the processors will use regardless of:
@@ -517,8 +616,10 @@ void CPSGS_Dispatcher::SignalFinishProcessing(IPSGS_Processor *  processor,
 
             if (source == ePSGS_Processor) {
                 if (proc.m_ProcPerformanceRegistered == false) {
-                    auto &  timing = CPubseqGatewayApp::GetInstance()->GetTiming();
-                    timing.RegisterProcessorPerformance(processor, processor_status);
+                    auto &      timing = CPubseqGatewayApp::GetInstance()->GetTiming();
+                    uint64_t    mks = timing.RegisterProcessorPerformance(processor,
+                                                                          processor_status);
+                    x_RegisterProcessorLatency(processor, processor_status, mks);
                     proc.m_ProcPerformanceRegistered = true;
                 }
             }
@@ -1403,6 +1504,59 @@ void CPSGS_Dispatcher::x_DecrementConcurrencyCounter(IPSGS_Processor *  processo
 }
 
 
+size_t
+CPSGS_Dispatcher::x_GetAdmissionLimit(size_t  proc_index,
+                                      CPSGS_Request::EPSGS_Type  request_type) const
+{
+    const CPSGS_AdaptiveLimit &     adaptive_limit = m_AdaptiveLimits[proc_index];
+
+    if (!adaptive_limit.IsEnabled())
+        return m_ProcessorConcurrency[proc_index].m_Limit;
+
+    size_t      limit = adaptive_limit.GetLimit();
+    if (m_LowPriority[request_type]) {
+        // Low priority requests leave some room for the others
+        limit = max(static_cast<size_t>(limit * m_LowPriorityShare), size_t(1));
+    }
+    return limit;
+}
+
+
+void
+CPSGS_Dispatcher::x_RegisterProcessorLatency(IPSGS_Processor *  processor,
+                                             IPSGS_Processor::EPSGS_Status  status,
+                                             uint64_t  mks)
+{
+    size_t      proc_count = m_RegisteredProcessors.size();
+    size_t      proc_index = proc_count - processor->GetPriority();
+
+    if (!m_AdaptiveLimits[proc_index].IsEnabled())
+        return;
+
+    bool        failed;
+    switch (status) {
+        case IPSGS_Processor::ePSGS_Done:
+        case IPSGS_Processor::ePSGS_NotFound:
+            if (mks == 0)
+                return;     // No timing available
+            failed = false;
+            break;
+        case IPSGS_Processor::ePSGS_Timeout:
+        case IPSGS_Processor::ePSGS_Error:
+            failed = true;
+            break;
+        default:
+            // Canceled and unauthorized processors tell nothing about the
+            // backend
+            return;
+    }
+
+    m_AdaptiveLimits[proc_index].OnProcessorFinished(
+                mks, failed,
+                m_ProcessorConcurrency[proc_index].GetCurrentCount());
+}
+
+
 map<string, size_t>  CPSGS_Dispatcher::GetConcurrentCounters(void)
 {
     map<string, size_t>     ret;    // name -> current counter
@@ -1420,6 +1574,35 @@ map<string, size_t>  CPSGS_Dispatcher::GetConcurrentCounters(void)
 }
 
 
+map<string, size_t>  CPSGS_Dispatcher::GetAdmissionControlCounters(void)
+{
+    map<string, size_t>     ret;
+
+    for (size_t  index = 0; index < m_RegisteredProcessorGroups.size(); ++index) {
+        const string &  name = m_RegisteredProcessorGroups[index];
+
+        ret[name + "-Shed"] = m_ProcessorConcurrency[index].GetShedCount();
+        if (!m_AdaptiveLimits[index].IsEnabled())
+            continue;
+
+        CPSGS_AdaptiveLimit::SStatus    status = m_AdaptiveLimits[index].GetStatus();
+        ret[name + "-AdaptiveLimit"] = status.m_Limit;
+        ret[name + "-ShortLatencyMks"] = status.m_ShortLatencyMks;
+        ret[name + "-LongLatencyMks"] = status.m_LongLatencyMks;
+        ret[name + "-Decreases"] = status.m_Decreases;
+        ret[name + "-Backoffs"] = status.m_Backoffs;
+    }
+
+    return ret;
+}
+
+
+map<string, size_t>  CPSGS_Dispatcher::GetSingleFlightCounters(void)
+{
+    return m_BioseqInfoSingleFlight.GetCounters();
+}
+
+
 bool CPSGS_Dispatcher::IsGroupAlive(size_t  request_id)
 {
     size_t              bucket_index = x_GetBucketIndex(request_id);
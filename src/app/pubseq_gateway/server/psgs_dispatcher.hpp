@@ -36,6 +36,8 @@
 #include <mutex>
 #include "ipsgs_processor.hpp"
 #include "pubseq_gateway_logging.hpp"
+#include "adaptive_limit.hpp"
+#include "single_flight.hpp"
 
 // Must be more than the processor groups registered via the AddProcessor()
 // call
@@ -222,10 +224,7 @@ public:
     }
 
 public:
-    CPSGS_Dispatcher(double  request_timeout)
-    {
-        m_RequestTimeoutMillisec = static_cast<uint64_t>(request_timeout * 1000);
-    }
+    CPSGS_Dispatcher(double  request_timeout);
 
     // Low level can have the pending request removed e.g. due to a canceled
     // connection. This method is used to notify the dispatcher that the
@@ -252,6 +251,14 @@ public:
                         shared_ptr<CPSGS_Reply> reply,
                         const list<string> &  processor_names);
 
+    /// Tells if a request which cannot be started right away should wait in
+    /// a backlog. It should not if all the processor groups which could
+    /// process it are at their adaptive limits; the reply is completed with
+    /// 503 and a retry-after hint in this case.
+    bool AdmitToBacklog(shared_ptr<CPSGS_Request> request,
+                        shared_ptr<CPSGS_Reply> reply,
+                        const list<string> &  processor_names);
+
     /// The processor signals that it is going to provide data to the client
     IPSGS_Processor::EPSGS_StartProcessing
         SignalStartProcessing(IPSGS_Processor *  processor);
@@ -275,10 +282,16 @@ public:
     void OnRequestTimerClose(size_t  request_id);
 
     map<string, size_t>  GetConcurrentCounters(void);
+    map<string, size_t>  GetAdmissionControlCounters(void);
+    map<string, size_t>  GetSingleFlightCounters(void);
     bool IsGroupAlive(size_t  request_id);
     void PopulateStatus(CJsonNode &  status);
     void RegisterProcessorsForMomentousCounters(void);
 
+    /// Coalescing of identical in-flight bioseq info lookups
+    CPSGS_BioseqInfoSingleFlight &  GetBioseqInfoSingleFlight(void)
+    { return m_BioseqInfoSingleFlight; }
+
 private:
     void x_PrintRequestStop(shared_ptr<CPSGS_Request> request,
                             CRequestStatus::ECode  status,
@@ -301,11 +314,18 @@ private:
                                IPSGS_Processor *  processor,
                                shared_ptr<CPSGS_Request> request,
                                shared_ptr<CPSGS_Reply> reply);
+    void x_PrepareOverloadReply(const string &  msg,
+                                shared_ptr<CPSGS_Request> request,
+                                shared_ptr<CPSGS_Reply> reply);
 
 private:
     // Registered processors
     list<unique_ptr<IPSGS_Processor>>   m_RegisteredProcessors;
 
+    // The processors leave it when they are destroyed so it must outlive the
+    // processor groups
+    CPSGS_BioseqInfoSingleFlight        m_BioseqInfoSingleFlight;
+
 private:
     // Note: the data are spread between buckets so that there is less
     // contention on the data protecting mutexes
@@ -344,16 +364,29 @@ private:
 
     void x_DecrementConcurrencyCounter(IPSGS_Processor *  processor);
 
+    // The limit the number of running group processors is checked against
+    // when a request of the given type comes: the static limit or, if it is
+    // enabled for the group, the adaptive one (reduced for low priority
+    // requests)
+    size_t x_GetAdmissionLimit(size_t  proc_index,
+                               CPSGS_Request::EPSGS_Type  request_type) const;
+
+    // Provides the adaptive limit with the run time of a finished processor
+    void x_RegisterProcessorLatency(IPSGS_Processor *  processor,
+                                    IPSGS_Processor::EPSGS_Status  status,
+                                    uint64_t  mks);
+
     struct SProcessorConcurrency
     {
         size_t                  m_Limit;
         size_t                  m_CurrentCount;
         size_t                  m_LimitReachedCount;
+        size_t                  m_ShedCount;
         mutable atomic<bool>    m_CountLock;
 
         SProcessorConcurrency() :
             m_Limit(0), m_CurrentCount(0), m_LimitReachedCount(0),
-            m_CountLock(false)
+            m_ShedCount(0), m_CountLock(false)
         {}
 
         size_t GetCurrentCount(void) const
@@ -368,6 +401,19 @@ private:
             ++m_LimitReachedCount;
         }
 
+        // The adaptive limit (lower than the static one) has been reached
+        void IncrementShedCount(void)
+        {
+            CSpinlockGuard      guard(&m_CountLock);
+            ++m_ShedCount;
+        }
+
+        size_t GetShedCount(void) const
+        {
+            CSpinlockGuard      guard(&m_CountLock);
+            return m_ShedCount;
+        }
+
         void GetCurrentAndLimitReachedCounts(size_t *  current,
                                              size_t *  limit_reached)
         {
@@ -390,7 +436,13 @@ private:
     };
 
     SProcessorConcurrency       m_ProcessorConcurrency[MAX_PROCESSOR_GROUPS];
+    CPSGS_AdaptiveLimit         m_AdaptiveLimits[MAX_PROCESSOR_GROUPS];
     vector<string>              m_RegisteredProcessorGroups;
+
+    // Admission control settings
+    bool                        m_LowPriority[CPSGS_Request::ePSGS_UnknownRequest + 1];
+    double                      m_LowPriorityShare;
+    unsigned int                m_RetryAfterSec;
 };
 
 
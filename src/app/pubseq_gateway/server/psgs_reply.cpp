@@ -156,6 +156,13 @@ void CPSGS_Reply::SetContentType(EPSGS_ReplyMimeType  mime_type)
 }
 
 
+void CPSGS_Reply::SetRetryAfter(unsigned int  retry_after_sec)
+{
+    // Similar to the content type: only memorized till the reply starts
+    m_Reply->SetRetryAfter(retry_after_sec);
+}
+
+
 void CPSGS_Reply::SetContentLength(uint64_t  content_length)
 {
     if (m_ConnectionCanceled || IsFinished())
@@ -109,6 +109,7 @@ public:
 
     void Clear(void);
     void SetContentType(EPSGS_ReplyMimeType  mime_type);
+    void SetRetryAfter(unsigned int  retry_after_sec);
     void SetContentLength(uint64_t  content_length);
     size_t GetBytesSent(void) const;
 
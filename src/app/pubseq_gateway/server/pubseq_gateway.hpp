@@ -206,6 +206,30 @@ public:
     size_t GetProcessorMaxConcurrency(const string &  processor_id)
     { return m_Settings.GetProcessorMaxConcurrency(GetConfig(), processor_id); }
 
+    bool GetAdaptiveConcurrency(const string &  processor_id)
+    { return m_Settings.GetAdaptiveConcurrency(GetConfig(), processor_id); }
+
+    size_t GetAdaptiveMinLimit(void) const
+    { return m_Settings.m_AdaptiveMinLimit; }
+
+    double GetAdaptiveLatencyTolerance(void) const
+    { return m_Settings.m_AdaptiveLatencyTolerance; }
+
+    double GetAdaptiveBackoff(void) const
+    { return m_Settings.m_AdaptiveBackoff; }
+
+    double GetLowPriorityShare(void) const
+    { return m_Settings.m_LowPriorityShare; }
+
+    bool IsLowPriorityRequest(const string &  request_type) const
+    { return m_Settings.IsLowPriorityRequest(request_type); }
+
+    unsigned int GetRetryAfter(void) const
+    { return m_Settings.m_RetryAfterSec; }
+
+    size_t GetSingleFlightMaxWaiters(void) const
+    { return m_Settings.m_SingleFlightMaxWaiters; }
+
     void SignalFinishProcessing(IPSGS_Processor *  processor,
                                 CPSGS_Dispatcher::EPSGS_SignalSource  signal_source)
     { m_RequestDispatcher->SignalFinishProcessing(processor, signal_source); }
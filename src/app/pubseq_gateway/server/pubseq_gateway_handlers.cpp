@@ -1254,6 +1254,8 @@ static string   kBuildDate = "BuildDate";
 static string   kStartedAt = "StartedAt";
 static string   kExcludeBlobCacheUserCount = "ExcludeBlobCacheUserCount";
 static string   kConcurrentPrefix = "ConcurrentProcCount_";
+static string   kAdmissionControlPrefix = "AdmissionControl_";
+static string   kSingleFlightPrefix = "SingleFlight_";
 
 int CPubseqGatewayApp::OnInfo(CHttpRequest &  http_req,
                               shared_ptr<CPSGS_Reply>  reply)
@@ -1410,6 +1412,18 @@ int CPubseqGatewayApp::OnInfo(CHttpRequest &  http_req,
             info.SetInteger(kConcurrentPrefix + item.first,
                             item.second);
         }
+        map<string, size_t>     admission_control =
+                                    m_RequestDispatcher->GetAdmissionControlCounters();
+        for (auto item: admission_control) {
+            info.SetInteger(kAdmissionControlPrefix + item.first,
+                            item.second);
+        }
+        map<string, size_t>     single_flight =
+                                    m_RequestDispatcher->GetSingleFlightCounters();
+        for (auto item: single_flight) {
+            info.SetInteger(kSingleFlightPrefix + item.first,
+                            item.second);
+        }
         PopulatePerRequestMomentousDictionary(info);
 
         string      content = info.Repr(CJsonNode::fStandardJson);
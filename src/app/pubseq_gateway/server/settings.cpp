@@ -57,6 +57,7 @@ const string            kAdminSection = "ADMIN";
 const string            kMyNCBISection = "MY_NCBI";
 const string            kCountersSection = "COUNTERS";
 const string            kLogSection = "LOG";
+const string            kAdmissionControlSection = "ADMISSION_CONTROL";
 
 
 const unsigned short    kWorkersDefault = 64;
@@ -87,6 +88,7 @@ const double            kDefaultResendTimeoutSec = 0.2;
 const double            kDefaultRequestTimeoutSec = 30.0;
 const size_t            kDefaultProcessorMaxConcurrency = 1200;
 const size_t            kDefaultSplitInfoBlobCacheSize = 1000;
+const size_t            kDefaultSingleFlightMaxWaiters = 100;
 const size_t            kDefaultIPGPageSize = 1024;
 const bool              kDefaultEnableHugeIPG = true;
 const string            kDefaultAuthToken = "";
@@ -130,6 +132,13 @@ const string            kDefaultMyNCBITestWebCubbyUser = "MVWNUIMYDR41F2XRDBT8JT
 const size_t            kDefaultMyNCBITestOkPeriodSec = 180;
 const size_t            kDefaultMyNCBITestFailPeriodSec = 20;
 const bool              kDefaultLogPeerIPAlways = false;
+const bool              kDefaultAdaptiveConcurrency = false;
+const size_t            kDefaultAdaptiveMinLimit = 16;
+const double            kDefaultAdaptiveLatencyTolerance = 1.5;
+const double            kDefaultAdaptiveBackoff = 0.9;
+const double            kDefaultLowPriorityShare = 0.8;
+const string            kDefaultLowPriorityRequests = "AnnotationRequest AccessionVersionHistoryRequest IPGResolveRequest";
+const unsigned int      kDefaultRetryAfterSec = 1;
 
 SPubseqGatewaySettings::SPubseqGatewaySettings() :
     m_HttpPort(0),
@@ -153,6 +162,7 @@ SPubseqGatewaySettings::SPubseqGatewaySettings() :
     m_HttpMaxRunning(kDefaultHttpMaxRunning),
     m_LogSamplingRatio(kDefaultLogSamplingRatio),
     m_LogTimingThreshold(kDefaultLogTimingThreshold),
+    m_SingleFlightMaxWaiters(kDefaultSingleFlightMaxWaiters),
     m_SmallBlobSize(kDefaultSmallBlobSize),
     m_MinStatValue(kMinStatValue),
     m_MaxStatValue(kMaxStatValue),
@@ -198,7 +208,13 @@ SPubseqGatewaySettings::SPubseqGatewaySettings() :
     m_MyNCBITestWebCubbyUser(kDefaultMyNCBITestWebCubbyUser),
     m_MyNCBITestOkPeriodSec(kDefaultMyNCBITestOkPeriodSec),
     m_MyNCBITestFailPeriodSec(kDefaultMyNCBITestFailPeriodSec),
-    m_LogPeerIPAlways(kDefaultLogPeerIPAlways)
+    m_LogPeerIPAlways(kDefaultLogPeerIPAlways),
+    m_AdaptiveConcurrency(kDefaultAdaptiveConcurrency),
+    m_AdaptiveMinLimit(kDefaultAdaptiveMinLimit),
+    m_AdaptiveLatencyTolerance(kDefaultAdaptiveLatencyTolerance),
+    m_AdaptiveBackoff(kDefaultAdaptiveBackoff),
+    m_LowPriorityShare(kDefaultLowPriorityShare),
+    m_RetryAfterSec(kDefaultRetryAfterSec)
 {}
 
 
@@ -232,6 +248,7 @@ void SPubseqGatewaySettings::Read(const CNcbiRegistry &   registry,
     x_ReadCountersSection(registry);
 
     x_ReadLogSection(registry);
+    x_ReadAdmissionControlSection(registry);
 }
 
 
@@ -286,6 +303,19 @@ void SPubseqGatewaySettings::x_ReadServerSection(const CNcbiRegistry &   registr
     m_SplitInfoBlobCacheSize = registry.GetInt(kServerSection,
                                                "split_info_blob_cache_size",
                                                kDefaultSplitInfoBlobCacheSize);
+    int     single_flight_max_waiters =
+                registry.GetInt(kServerSection, "single_flight_max_waiters",
+                                kDefaultSingleFlightMaxWaiters);
+    if (single_flight_max_waiters < 0) {
+        PSG_WARNING("Invalid [" + kServerSection + "]/single_flight_max_waiters "
+                    "value (" + to_string(single_flight_max_waiters) + "). "
+                    "The max number of waiters must be greater than or equal "
+                    "to 0. The max number of waiters is reset to the default "
+                    "value (" + to_string(kDefaultSingleFlightMaxWaiters) + ").");
+        m_SingleFlightMaxWaiters = kDefaultSingleFlightMaxWaiters;
+    } else {
+        m_SingleFlightMaxWaiters = single_flight_max_waiters;
+    }
 
     if (m_SSLEnable) {
         m_ShutdownIfTooManyOpenFD =
@@ -727,6 +757,56 @@ void SPubseqGatewaySettings::x_ReadLogSection(const CNcbiRegistry &   registry)
 }
 
 
+void SPubseqGatewaySettings::x_ReadAdmissionControlSection(const CNcbiRegistry &   registry)
+{
+    m_AdaptiveConcurrency = registry.GetBool(kAdmissionControlSection,
+                                             "adaptive_concurrency",
+                                             kDefaultAdaptiveConcurrency);
+    int     min_limit = registry.GetInt(kAdmissionControlSection,
+                                        "min_limit",
+                                        kDefaultAdaptiveMinLimit);
+    if (min_limit <= 0) {
+        PSG_WARNING("Invalid [" + kAdmissionControlSection + "]/min_limit "
+                    "value (" + to_string(min_limit) + "). The minimum "
+                    "adaptive limit must be greater than 0. The minimum "
+                    "adaptive limit is reset to the default value (" +
+                    to_string(kDefaultAdaptiveMinLimit) + ").");
+        m_AdaptiveMinLimit = kDefaultAdaptiveMinLimit;
+    } else {
+        m_AdaptiveMinLimit = min_limit;
+    }
+    m_AdaptiveLatencyTolerance = registry.GetDouble(kAdmissionControlSection,
+                                                    "latency_tolerance",
+                                                    kDefaultAdaptiveLatencyTolerance);
+    m_AdaptiveBackoff = registry.GetDouble(kAdmissionControlSection,
+                                           "backoff",
+                                           kDefaultAdaptiveBackoff);
+    m_LowPriorityShare = registry.GetDouble(kAdmissionControlSection,
+                                            "low_priority_share",
+                                            kDefaultLowPriorityShare);
+    int     retry_after = registry.GetInt(kAdmissionControlSection,
+                                          "retry_after",
+                                          kDefaultRetryAfterSec);
+    if (retry_after < 0) {
+        PSG_WARNING("Invalid [" + kAdmissionControlSection + "]/retry_after "
+                    "value (" + to_string(retry_after) + "). The retry after "
+                    "value must be greater than or equal to 0. The retry "
+                    "after value is reset to the default value (" +
+                    to_string(kDefaultRetryAfterSec) + ").");
+        m_RetryAfterSec = kDefaultRetryAfterSec;
+    } else {
+        m_RetryAfterSec = retry_after;
+    }
+
+    string      low_priority_requests =
+                    registry.GetString(kAdmissionControlSection,
+                                       "low_priority_requests",
+                                       kDefaultLowPriorityRequests);
+    NStr::Split(low_priority_requests, " ", m_LowPriorityRequests,
+                NStr::fSplit_Tokenize);
+}
+
+
 void SPubseqGatewaySettings::Validate(CPSGAlerts &  alerts)
 {
     const unsigned short    kHttpPortMin = 1;
@@ -1007,6 +1087,34 @@ void SPubseqGatewaySettings::Validate(CPSGAlerts &  alerts)
         m_RequestTimeoutSec = kDefaultProcessorMaxConcurrency;
     }
 
+    if (m_AdaptiveLatencyTolerance < 1.0) {
+        PSG_WARNING("Invalid [" + kAdmissionControlSection + "]/latency_tolerance "
+                    "value (" + to_string(m_AdaptiveLatencyTolerance) + "). "
+                    "The latency tolerance must be at least 1.0. The latency "
+                    "tolerance is reset to the default value (" +
+                    to_string(kDefaultAdaptiveLatencyTolerance) + ").");
+        m_AdaptiveLatencyTolerance = kDefaultAdaptiveLatencyTolerance;
+    }
+
+    if (m_AdaptiveBackoff <= 0.0 || m_AdaptiveBackoff >= 1.0) {
+        PSG_WARNING("Invalid [" + kAdmissionControlSection + "]/backoff "
+                    "value (" + to_string(m_AdaptiveBackoff) + "). "
+                    "The backoff must be between 0.0 and 1.0 exclusive. "
+                    "The backoff is reset to the default value (" +
+                    to_string(kDefaultAdaptiveBackoff) + ").");
+        m_AdaptiveBackoff = kDefaultAdaptiveBackoff;
+    }
+
+    if (m_LowPriorityShare <= 0.0 || m_LowPriorityShare > 1.0) {
+        PSG_WARNING("Invalid [" + kAdmissionControlSection + "]/low_priority_share "
+                    "value (" + to_string(m_LowPriorityShare) + "). "
+                    "The low priority share must be greater than 0.0 and "
+                    "not greater than 1.0. The low priority share is reset "
+                    "to the default value (" +
+                    to_string(kDefaultLowPriorityShare) + ").");
+        m_LowPriorityShare = kDefaultLowPriorityShare;
+    }
+
     if (m_IPGPageSize <= 0) {
         PSG_WARNING("The [" + kIPGSection + "]/page_size value must be > 0. "
                     "The [" + kIPGSection + "]/page_size is switched to the "
@@ -1111,6 +1219,32 @@ size_t SPubseqGatewaySettings::GetProcessorMaxConcurrency(
 }
 
 
+bool SPubseqGatewaySettings::GetAdaptiveConcurrency(
+                                            const CNcbiRegistry &   registry,
+                                            const string &  processor_id)
+{
+    string                  section = processor_id + "_PROCESSOR";
+
+    if (registry.HasEntry(section, "adaptive_concurrency"))
+        return registry.GetBool(section, "adaptive_concurrency",
+                                m_AdaptiveConcurrency);
+
+    // No processor specific value => server wide (or default)
+    return m_AdaptiveConcurrency;
+}
+
+
+bool SPubseqGatewaySettings::IsLowPriorityRequest(const string &  request_type) const
+{
+    for (const auto &  item: m_LowPriorityRequests) {
+        if (NStr::EqualNocase(item, request_type)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
 bool SPubseqGatewaySettings::IsAuthProtectedCommand(const string &  cmd) const
 {
     for (const auto &  item: m_AuthCommands) {
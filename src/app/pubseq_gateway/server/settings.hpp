@@ -49,6 +49,9 @@ struct SPubseqGatewaySettings
     void Validate(CPSGAlerts &  alerts);
     size_t GetProcessorMaxConcurrency(const CNcbiRegistry &   registry,
                                       const string &  processor_id);
+    bool GetAdaptiveConcurrency(const CNcbiRegistry &   registry,
+                                const string &  processor_id);
+    bool IsLowPriorityRequest(const string &  request_type) const;
     bool IsAuthProtectedCommand(const string &  cmd) const;
 
     // [SERVER]
@@ -73,6 +76,7 @@ struct SPubseqGatewaySettings
     size_t                              m_HttpMaxRunning;
     size_t                              m_LogSamplingRatio;
     size_t                              m_LogTimingThreshold;
+    size_t                              m_SingleFlightMaxWaiters;
 
     // [STATISTICS]
     unsigned long                       m_SmallBlobSize;
@@ -165,6 +169,15 @@ struct SPubseqGatewaySettings
     // [LOG]
     bool                                m_LogPeerIPAlways;
 
+    // [ADMISSION_CONTROL]
+    bool                                m_AdaptiveConcurrency;
+    size_t                              m_AdaptiveMinLimit;
+    double                              m_AdaptiveLatencyTolerance;
+    double                              m_AdaptiveBackoff;
+    double                              m_LowPriorityShare;
+    vector<string>                      m_LowPriorityRequests;
+    unsigned int                        m_RetryAfterSec;
+
 private:
     void x_ReadServerSection(const CNcbiRegistry &   registry,
                                    CPSGAlerts &  alerts);
@@ -191,6 +204,7 @@ private:
     void x_ReadMyNCBISection(const CNcbiRegistry &   registry);
     void x_ReadCountersSection(const CNcbiRegistry &   registry);
     void x_ReadLogSection(const CNcbiRegistry &   registry);
+    void x_ReadAdmissionControlSection(const CNcbiRegistry &   registry);
 
     unsigned long x_GetDataSize(const CNcbiRegistry &  registry,
                                 const string &  section,
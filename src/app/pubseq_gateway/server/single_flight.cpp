@@ -0,0 +1,150 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: coalescing of identical in-flight bioseq info lookups
+ *
+ */
+#include <ncbi_pch.hpp>
+
+#include "single_flight.hpp"
+
+
+CPSGS_BioseqInfoSingleFlight::CPSGS_BioseqInfoSingleFlight() :
+    m_MaxWaiters(0),
+    m_Leaders(0), m_Coalesced(0), m_WaiterLimitReached(0), m_Abandoned(0)
+{}
+
+
+CPSGS_BioseqInfoSingleFlight::EPSGS_JoinResult
+CPSGS_BioseqInfoSingleFlight::Join(const string &  key,
+                                   IPSGS_Processor *  processor,
+                                   TWaiterCB  waiter_cb)
+{
+    if (m_MaxWaiters == 0)
+        return ePSGS_Bypass;
+
+    lock_guard<mutex>   guard(m_Lock);
+
+    auto    it = m_Flights.find(key);
+    if (it == m_Flights.end()) {
+        m_Flights[key] = SFlight{processor, {}};
+        ++m_Leaders;
+        return ePSGS_Leader;
+    }
+
+    if (it->second.m_Waiters.size() >= m_MaxWaiters) {
+        ++m_WaiterLimitReached;
+        return ePSGS_Bypass;
+    }
+
+    it->second.m_Waiters.push_back(SWaiter{processor, waiter_cb});
+    return ePSGS_Waiter;
+}
+
+
+void
+CPSGS_BioseqInfoSingleFlight::Complete(const string &  key,
+                                       IPSGS_Processor *  leader,
+                                       const TRecords &  records)
+{
+    lock_guard<mutex>   guard(m_Lock);
+
+    auto    it = m_Flights.find(key);
+    if (it == m_Flights.end() || it->second.m_Leader != leader)
+        return;
+
+    m_Coalesced += it->second.m_Waiters.size();
+    x_Notify(it->second, records);
+    m_Flights.erase(it);
+}
+
+
+void
+CPSGS_BioseqInfoSingleFlight::Abandon(const string &  key,
+                                      IPSGS_Processor *  leader)
+{
+    lock_guard<mutex>   guard(m_Lock);
+
+    auto    it = m_Flights.find(key);
+    if (it == m_Flights.end() || it->second.m_Leader != leader)
+        return;
+
+    if (!it->second.m_Waiters.empty())
+        ++m_Abandoned;
+    x_Notify(it->second, nullopt);
+    m_Flights.erase(it);
+}
+
+
+void
+CPSGS_BioseqInfoSingleFlight::Leave(const string &  key,
+                                    IPSGS_Processor *  waiter)
+{
+    lock_guard<mutex>   guard(m_Lock);
+
+    auto    it = m_Flights.find(key);
+    if (it == m_Flights.end())
+        return;
+
+    auto &  waiters = it->second.m_Waiters;
+    for (auto  w = waiters.begin(); w != waiters.end(); ++w) {
+        if (w->m_Processor == waiter) {
+            waiters.erase(w);
+            return;
+        }
+    }
+}
+
+
+void
+CPSGS_BioseqInfoSingleFlight::x_Notify(SFlight &  flight,
+                                       optional<TRecords>  records)
+{
+    // The callbacks are invoked under the lock so that a waiter cannot be
+    // destroyed (see Leave()) while it is notified. They only schedule the
+    // processing in the waiters' uv loops.
+    for (auto &  waiter : flight.m_Waiters) {
+        try {
+            waiter.m_WaiterCB(optional<TRecords>(records));
+        } catch (...) {
+            // The other waiters still need to be notified
+        }
+    }
+}
+
+
+map<string, size_t>  CPSGS_BioseqInfoSingleFlight::GetCounters(void)
+{
+    map<string, size_t>     ret;
+    lock_guard<mutex>       guard(m_Lock);
+
+    ret["InFlight"] = m_Flights.size();
+    ret["Leaders"] = m_Leaders;
+    ret["Coalesced"] = m_Coalesced;
+    ret["WaiterLimitReached"] = m_WaiterLimitReached;
+    ret["LeaderAbandoned"] = m_Abandoned;
+    return ret;
+}
+
@@ -0,0 +1,127 @@
+#ifndef SINGLE_FLIGHT__HPP
+#define SINGLE_FLIGHT__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: coalescing of identical in-flight bioseq info lookups
+ *
+ */
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <objtools/pubseq_gateway/impl/cassandra/bioseq_info/record.hpp>
+
+USING_NCBI_SCOPE;
+USING_IDBLOB_SCOPE;
+
+
+class IPSGS_Processor;
+
+
+// When many requests resolve the same seq_id at once each of them would send
+// the same bioseq info query to Cassandra. Instead the first one (the leader)
+// sends the query and the others (the waiters) join it: the records received
+// by the leader are delivered to each waiter in the waiter's own uv loop.
+// If the leader cannot deliver the records (Cassandra error, the leader is
+// canceled or destroyed) the waiters are notified without records and send
+// their own queries.
+// The number of waiters per query is limited; the requests over the limit
+// send their own queries as if there was no coalescing.
+class CPSGS_BioseqInfoSingleFlight
+{
+public:
+    using TRecords = std::vector<CBioseqInfoRecord>;
+
+    // Invoked with the registry locked (in the leader's thread), so it must
+    // do no more than schedule the processing in the waiter's uv loop.
+    // No value means that the waiter needs to send its own query
+    using TWaiterCB = std::function<void(std::optional<TRecords> &&  records)>;
+
+    enum EPSGS_JoinResult {
+        ePSGS_Leader,       // the caller needs to send the query
+        ePSGS_Waiter,       // the caller waits for a callback
+        ePSGS_Bypass        // the caller needs to send the query; it is
+                            // not shared with anybody
+    };
+
+public:
+    CPSGS_BioseqInfoSingleFlight();
+
+    // 0 disables coalescing
+    void SetMaxWaiters(size_t  max_waiters)
+    { m_MaxWaiters = max_waiters; }
+
+    EPSGS_JoinResult Join(const std::string &  key,
+                          IPSGS_Processor *  processor,
+                          TWaiterCB  waiter_cb);
+
+    // The leader received the records
+    void Complete(const std::string &  key, IPSGS_Processor *  leader,
+                  const TRecords &  records);
+
+    // The leader is not going to receive the records
+    void Abandon(const std::string &  key, IPSGS_Processor *  leader);
+
+    // The waiter is not interested in the records anymore (e.g. it is being
+    // destroyed)
+    void Leave(const std::string &  key, IPSGS_Processor *  waiter);
+
+    std::map<std::string, size_t> GetCounters(void);
+
+private:
+    struct SWaiter
+    {
+        IPSGS_Processor *   m_Processor;
+        TWaiterCB           m_WaiterCB;
+    };
+
+    struct SFlight
+    {
+        IPSGS_Processor *   m_Leader;
+        std::vector<SWaiter>    m_Waiters;
+    };
+
+    void x_Notify(SFlight &  flight, std::optional<TRecords>  records);
+
+private:
+    size_t                              m_MaxWaiters;
+    std::unordered_map<std::string, SFlight>    m_Flights;
+    std::mutex                                  m_Lock;
+
+    // Guarded by m_Lock
+    size_t                              m_Leaders;
+    size_t                              m_Coalesced;
+    size_t                              m_WaiterLimitReached;
+    size_t                              m_Abandoned;
+};
+
+#endif
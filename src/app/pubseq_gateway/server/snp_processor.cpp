@@ -969,7 +969,7 @@ void CPSGS_SNPProcessor::x_SendChunkBlobData(const string& id2_info, int chunk_i
 
 void CPSGS_SNPProcessor::Cancel()
 {
-    CPSGS_CassProcessorBase::Cancel();
+    CPSGS_AsyncBioseqInfoBase::Cancel();
     m_Canceled = true;
     if (!IsUVThreadAssigned()) {
         m_Status = ePSGS_Canceled;
@@ -0,0 +1,174 @@
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+
+#include <thread>
+#include <string>
+
+#include "../../adaptive_limit.hpp"
+
+USING_SCOPE(ncbi);
+
+
+static size_t   errors = 0;
+
+static void check(bool  condition, const string &  what)
+{
+    if (!condition) {
+        cerr << "FAILED: " << what << endl;
+        ++errors;
+    }
+}
+
+
+// Feeds one complete window of processor run times: a window is closed by
+// the sample which makes it both long enough and big enough
+static void run_window(CPSGS_AdaptiveLimit &  limit, uint64_t  mks,
+                       size_t  failures, size_t  in_flight)
+{
+    const size_t    kSamples = 10;
+
+    this_thread::sleep_for(chrono::milliseconds(110));
+    for (size_t  k = 0; k < kSamples; ++k)
+        limit.OnProcessorFinished(mks, k < failures, in_flight);
+}
+
+
+static void test_disabled(void)
+{
+    CPSGS_AdaptiveLimit     limit;
+    limit.Configure(false, 4, 100, 1.5, 0.5);
+
+    check(!limit.IsEnabled(), "disabled limit");
+    run_window(limit, 1000, 10, 100);
+    check(limit.GetLimit() == 100, "disabled limit stays at the maximum");
+    check(limit.GetStatus().m_Backoffs == 0, "disabled limit does not back off");
+}
+
+
+static void test_bounds(void)
+{
+    CPSGS_AdaptiveLimit     limit;
+
+    limit.Configure(true, 0, 0, 1.5, 0.5);
+    check(limit.GetLimit() == 1, "zero maximum is raised to 1");
+
+    limit.Configure(true, 200, 100, 1.5, 0.5);
+    check(limit.GetLimit() == 100, "limit starts at the maximum");
+    run_window(limit, 1000, 10, 100);
+    check(limit.GetLimit() == 100, "minimum is capped by the maximum");
+}
+
+
+static void test_backoff(void)
+{
+    CPSGS_AdaptiveLimit     limit;
+    limit.Configure(true, 10, 100, 1.5, 0.5);
+
+    // More than 10% of failures backs off regardless of the latency
+    run_window(limit, 1000, 5, 100);
+    check(limit.GetLimit() == 50, "first backoff halves the limit");
+    run_window(limit, 1000, 5, 100);
+    check(limit.GetLimit() == 25, "second backoff halves the limit");
+    run_window(limit, 1000, 5, 100);
+    run_window(limit, 1000, 5, 100);
+    check(limit.GetLimit() == 10, "backoff stops at the minimum");
+    run_window(limit, 1000, 5, 100);
+    check(limit.GetLimit() == 10, "limit stays at the minimum");
+    check(limit.GetStatus().m_Backoffs == 5, "backoffs are counted");
+
+    // 10% of failures is tolerated
+    CPSGS_AdaptiveLimit     tolerant;
+    tolerant.Configure(true, 10, 100, 1.5, 0.5);
+    run_window(tolerant, 1000, 1, 100);
+    check(tolerant.GetLimit() == 100, "single failure does not back off");
+    check(tolerant.GetStatus().m_Backoffs == 0, "no backoffs");
+}
+
+
+static void test_latency(void)
+{
+    CPSGS_AdaptiveLimit     limit;
+    limit.Configure(true, 4, 100, 1.5, 0.9);
+
+    run_window(limit, 1000, 0, 100);
+    check(limit.GetLimit() == 100, "limit does not exceed the maximum");
+    check(limit.GetStatus().m_LongLatencyMks == 1000,
+          "long latency starts with the first window");
+
+    // Ten times slower backend: the limit goes down, but smoothly
+    run_window(limit, 10000, 0, 100);
+    auto    status = limit.GetStatus();
+    check(status.m_ShortLatencyMks == 10000, "short latency follows the window");
+    check(status.m_Decreases == 1, "latency growth decreases the limit");
+    check(limit.GetLimit() < 100 && limit.GetLimit() >= 90,
+          "single slow window cuts the limit smoothly (" +
+          to_string(limit.GetLimit()) + ")");
+}
+
+
+static void test_growth(void)
+{
+    CPSGS_AdaptiveLimit     limit;
+    limit.Configure(true, 4, 100, 1.5, 0.5);
+
+    run_window(limit, 1000, 5, 100);
+    check(limit.GetLimit() == 50, "backoff before the growth");
+
+    // Stable latency and the limit in use: grows by about sqrt(limit)
+    run_window(limit, 1000, 0, 50);
+    check(limit.GetLimit() == 57, "limit grows by sqrt(limit) (" +
+          to_string(limit.GetLimit()) + ")");
+
+    // Less than a half of the limit in use: no growth
+    run_window(limit, 1000, 0, 10);
+    check(limit.GetLimit() == 57, "unused limit does not grow (" +
+          to_string(limit.GetLimit()) + ")");
+}
+
+
+static void test_retry_after(void)
+{
+    check(GetOverloadReplyMessage("Overloaded", 0) == "Overloaded",
+          "no retry hint without Retry-After");
+    check(GetOverloadReplyMessage("Overloaded", 5) ==
+          "Overloaded. Retry after 5 second(s)",
+          "retry hint matches Retry-After");
+}
+
+
+class CAdaptiveLimitTestApplication : public CNcbiApplication
+{
+    virtual int  Run(void);
+    virtual void Init(void);
+};
+
+
+void CAdaptiveLimitTestApplication::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Adaptive concurrency limit test");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+int CAdaptiveLimitTestApplication::Run(void)
+{
+    cout << "Adaptive limit test" << endl;
+    test_disabled();
+    test_bounds();
+    test_backoff();
+    test_latency();
+    test_growth();
+    test_retry_after();
+    if (errors == 0)
+        cout << "OK" << endl;
+    return errors == 0 ? 0 : 1;
+}
+
+
+int NcbiSys_main(int argc, ncbi::TXChar* argv[])
+{
+    return CAdaptiveLimitTestApplication().AppMain(argc, argv);
+}
@@ -0,0 +1,218 @@
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+
+#include "../../single_flight.hpp"
+
+USING_SCOPE(ncbi);
+
+
+// The registry uses the processor pointers as identities only
+static IPSGS_Processor *  proc(size_t  index)
+{
+    static char     procs[64];
+    return reinterpret_cast<IPSGS_Processor *>(&procs[index]);
+}
+
+
+struct SWaiterResult
+{
+    size_t      m_Calls = 0;
+    bool        m_HasRecords = false;
+    size_t      m_RecordCount = 0;
+
+    CPSGS_BioseqInfoSingleFlight::TWaiterCB  Callback(void)
+    {
+        return [this](optional<CPSGS_BioseqInfoSingleFlight::TRecords> &&  records)
+        {
+            ++m_Calls;
+            m_HasRecords = records.has_value();
+            m_RecordCount = m_HasRecords ? records->size() : 0;
+        };
+    }
+};
+
+
+static size_t   errors = 0;
+
+static void check(bool  condition, const string &  what)
+{
+    if (!condition) {
+        cerr << "FAILED: " << what << endl;
+        ++errors;
+    }
+}
+
+
+static void test_coalescing(void)
+{
+    CPSGS_BioseqInfoSingleFlight    single_flight;
+    single_flight.SetMaxWaiters(10);
+
+    SWaiterResult   w1, w2;
+    check(single_flight.Join("acc", proc(0), SWaiterResult().Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Leader, "first join leads");
+    check(single_flight.Join("acc", proc(1), w1.Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Waiter, "second join waits");
+    check(single_flight.Join("acc", proc(2), w2.Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Waiter, "third join waits");
+    check(single_flight.Join("other", proc(3), SWaiterResult().Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Leader, "other key leads");
+
+    // Only the leader completes the lookup
+    single_flight.Complete("acc", proc(1), {});
+    check(w1.m_Calls == 0 && w2.m_Calls == 0, "complete by a waiter ignored");
+
+    single_flight.Complete("acc", proc(0),
+                           CPSGS_BioseqInfoSingleFlight::TRecords(2));
+    check(w1.m_Calls == 1 && w1.m_HasRecords && w1.m_RecordCount == 2,
+          "waiter 1 receives the records");
+    check(w2.m_Calls == 1 && w2.m_HasRecords && w2.m_RecordCount == 2,
+          "waiter 2 receives the records");
+
+    auto    counters = single_flight.GetCounters();
+    check(counters["InFlight"] == 1, "one lookup in flight");
+    check(counters["Leaders"] == 2, "two leaders");
+    check(counters["Coalesced"] == 2, "two coalesced");
+
+    // The next identical lookup starts a new flight
+    check(single_flight.Join("acc", proc(4), SWaiterResult().Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Leader, "join after complete leads");
+}
+
+
+static void test_abandon(void)
+{
+    CPSGS_BioseqInfoSingleFlight    single_flight;
+    single_flight.SetMaxWaiters(10);
+
+    SWaiterResult   w1, w2;
+    single_flight.Join("acc", proc(0), SWaiterResult().Callback());
+    single_flight.Join("acc", proc(1), w1.Callback());
+    single_flight.Join("acc", proc(2), w2.Callback());
+
+    // A waiter which left is not notified
+    single_flight.Leave("acc", proc(2));
+
+    // E.g. the leader is canceled
+    single_flight.Abandon("acc", proc(0));
+    check(w1.m_Calls == 1 && !w1.m_HasRecords,
+          "waiter is notified without records");
+    check(w2.m_Calls == 0, "left waiter is not notified");
+
+    // Late completion by the abandoned leader is ignored
+    single_flight.Complete("acc", proc(0), {});
+    check(w1.m_Calls == 1, "complete after abandon ignored");
+
+    auto    counters = single_flight.GetCounters();
+    check(counters["InFlight"] == 0, "nothing in flight after abandon");
+    check(counters["LeaderAbandoned"] == 1, "one abandoned");
+}
+
+
+static void test_limits(void)
+{
+    CPSGS_BioseqInfoSingleFlight    single_flight;
+    check(single_flight.Join("acc", proc(0), SWaiterResult().Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Bypass, "0 waiters disables");
+
+    single_flight.SetMaxWaiters(1);
+    single_flight.Join("acc", proc(0), SWaiterResult().Callback());
+    check(single_flight.Join("acc", proc(1), SWaiterResult().Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Waiter, "waiter within limit");
+    check(single_flight.Join("acc", proc(2), SWaiterResult().Callback()) ==
+          CPSGS_BioseqInfoSingleFlight::ePSGS_Bypass, "waiter over limit");
+    check(single_flight.GetCounters()["WaiterLimitReached"] == 1,
+          "limit reached counted");
+}
+
+
+static void test_threads(size_t  thread_count)
+{
+    // Identical lookups joining at once: exactly one leader, and all the
+    // waiters get the leader's records
+    CPSGS_BioseqInfoSingleFlight    single_flight;
+    single_flight.SetMaxWaiters(thread_count);
+
+    vector<SWaiterResult>   results(thread_count);
+    atomic<size_t>          leaders(0);
+    atomic<size_t>          waiters(0);
+    atomic<size_t>          leader_index(thread_count);
+    vector<thread>          threads;
+
+    for (size_t  k = 0; k < thread_count; ++k) {
+        threads.emplace_back([&, k]()
+        {
+            switch (single_flight.Join("acc", proc(k), results[k].Callback())) {
+                case CPSGS_BioseqInfoSingleFlight::ePSGS_Leader:
+                    ++leaders;
+                    leader_index = k;
+                    break;
+                case CPSGS_BioseqInfoSingleFlight::ePSGS_Waiter:
+                    ++waiters;
+                    break;
+                default:
+                    break;
+            }
+        });
+    }
+    for (auto &  t : threads)
+        t.join();
+
+    check(leaders == 1, "one leader among the threads");
+    check(waiters == thread_count - 1, "the other threads wait");
+
+    single_flight.Complete("acc", proc(leader_index),
+                           CPSGS_BioseqInfoSingleFlight::TRecords(1));
+    for (size_t  k = 0; k < thread_count; ++k) {
+        if (k == leader_index)
+            continue;
+        check(results[k].m_Calls == 1 && results[k].m_RecordCount == 1,
+              "thread waiter " + to_string(k) + " receives the records");
+    }
+}
+
+
+class CSingleFlightTestApplication : public CNcbiApplication
+{
+    virtual int  Run(void);
+    virtual void Init(void);
+};
+
+
+void CSingleFlightTestApplication::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->AddDefaultKey("threads", "threads",
+                            "number of threads joining the same lookup",
+                            CArgDescriptions::eInteger, "16");
+    arg_desc->SetConstraint("threads", new CArgAllow_Integers(1, 64));
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+int CSingleFlightTestApplication::Run(void)
+{
+    cout << "Single flight test" << endl;
+
+    test_coalescing();
+    test_abandon();
+    test_limits();
+    test_threads(GetArgs()["threads"].AsInteger());
+
+    if (errors == 0)
+        cout << "OK" << endl;
+    return errors == 0 ? 0 : 1;
+}
+
+
+int NcbiSys_main(int argc, ncbi::TXChar* argv[])
+{
+    return CSingleFlightTestApplication().AppMain(argc, argv);
+}
@@ -1329,14 +1329,15 @@ void COperationTiming::RegisterProcessorDone(CPSGS_Request::EPSGS_Type  request_
 }
 
 
-void COperationTiming::RegisterProcessorPerformance(IPSGS_Processor *  processor,
-                                                    IPSGS_Processor::EPSGS_Status  proc_finish_status)
+uint64_t
+COperationTiming::RegisterProcessorPerformance(IPSGS_Processor *  processor,
+                                               IPSGS_Processor::EPSGS_Status  proc_finish_status)
 {
     bool                valid;
     psg_time_point_t    start_timestamp = processor->GetProcessInvokeTimestamp(valid);
 
     if (!valid)
-        return;     // Should not really happened
+        return 0;   // Should not really happened
                     // the start timestamp is memorized unconditionally
 
     size_t  request_index = static_cast<size_t>(processor->GetRequest()->GetRequestType());
@@ -1372,6 +1373,7 @@ void COperationTiming::RegisterProcessorPerformance(IPSGS_Processor *  processor
         default:
             break;
     }
+    return mks;
 }
 
 
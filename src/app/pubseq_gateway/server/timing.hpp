@@ -353,8 +353,9 @@ class COperationTiming
                                    CRequestStatus::ECode  status);
         void RegisterProcessorDone(CPSGS_Request::EPSGS_Type  request_type,
                                    IPSGS_Processor *  processor);
-        void RegisterProcessorPerformance(IPSGS_Processor *  processor,
-                                          IPSGS_Processor::EPSGS_Status  proc_finish_status);
+        // Provides the processor run time in mks (0 if it is unknown)
+        uint64_t RegisterProcessorPerformance(IPSGS_Processor *  processor,
+                                              IPSGS_Processor::EPSGS_Status  proc_finish_status);
 
     public:
         void Rotate(void);
@@ -69,6 +69,11 @@ USING_SCOPE(objects::validator);
 
 namespace
 {
+    // Entries processed at once by the multi-threaded pipeline; the threads
+    // loading the entries ahead are taken out of this budget
+    constexpr size_t   kAsyncDepth   = 10;
+    constexpr unsigned kLoadThreads  = 2;
+
 
     bool s_AddUpdateDescriptor(const CHugeAsnReader& asn_reader)
     {
@@ -224,6 +229,12 @@ void CTbl2AsnApp::ProcessHugeFile(CHugeFile& hugeFile, CNcbiOstream* output)
         context.asn_reader.Open(&hugeFile, m_context.m_logger);
         context.source = &context.asn_reader;
 
+        // with the multi-threaded pipeline a single reader thread can't keep up
+        const size_t numThreads = m_context.m_use_threads.value_or(1);
+        if (numThreads >= 3) {
+            context.asn_reader.SetLoadThreads(kLoadThreads);
+        }
+
         if (m_context.m_t) {
             string msg(
                 "Template file descriptors are ignored if input is ASN.1");
@@ -356,7 +367,7 @@ void CTbl2AsnApp::ProcessHugeFile(CHugeFile& hugeFile, CNcbiOstream* output)
 
         using TWriter = CGenBankAsyncWriterEx<TAsyncToken>;
         TWriter async_writer(ostr.get());
-        async_writer.SetDepth(10);
+        async_writer.SetDepth(kAsyncDepth - context.asn_reader.GetLoadThreads());
 
         TWriter::TProcessFunction ff_chain_func;
 
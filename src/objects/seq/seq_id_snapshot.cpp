@@ -0,0 +1,435 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Frozen Seq-id to integer key mapping in a memory mapped file
+*
+*/
+
+#include <ncbi_pch.hpp>
+#include <objects/seq/seq_id_snapshot.hpp>
+#include <objects/seq/seq_id_mapper.hpp>
+#include <objects/seqloc/Textseq_id.hpp>
+#include <corelib/ncbifile.hpp>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+
+static const char  kSnapshotMagic[8] = { 'N','C','B','I','S','I','D','1' };
+static const Uint4 kSnapshotByteOrder = 0x01020304;
+
+
+////////////////////////////////////////////////////////////////////
+//
+//  CSeq_id_Snapshot::
+//
+
+
+const CSeq_id_Snapshot::TKey CSeq_id_Snapshot::kInvalidKey;
+
+
+bool CSeq_id_Snapshot::GetLookupString(const CSeq_id& id, string& str)
+{
+    if ( id.IsGi() ) {
+        return false;
+    }
+    const CTextseq_id* text_id = id.GetTextseq_Id();
+    if ( text_id  &&  text_id->IsSetAccession() ) {
+        // Accessions are case insensitive, name and release do not take
+        // part in the matching of versioned ids
+        string acc = text_id->GetAccession();
+        str = CSeq_id::WhichFastaTag(id.Which());
+        str += '|';
+        str += NStr::ToUpper(acc);
+        if ( text_id->IsSetVersion() ) {
+            str += '.';
+            str += NStr::IntToString(text_id->GetVersion());
+        }
+    }
+    else {
+        str = id.AsFastaString();
+    }
+    return true;
+}
+
+
+CSeq_id_Snapshot::CSeq_id_Snapshot(const string& file_name)
+    : m_File(new CMemoryFile(file_name)),
+      m_KeyCount(0),
+      m_GiCount(0),
+      m_StrCount(0),
+      m_Gis(0),
+      m_Strs(0),
+      m_Keys(0),
+      m_Data(0)
+{
+    const char* ptr = static_cast<const char*>(m_File->GetPtr());
+    size_t size = m_File->GetSize();
+    const SHeader* header = reinterpret_cast<const SHeader*>(ptr);
+    if ( !ptr  ||  size < sizeof(SHeader)  ||
+         memcmp(header->m_Magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ) {
+        NCBI_THROW(CSeq_id_MapperException, eOtherError,
+                   "Not a Seq-id snapshot file: "+file_name);
+    }
+    if ( header->m_ByteOrder != kSnapshotByteOrder ) {
+        NCBI_THROW(CSeq_id_MapperException, eOtherError,
+                   "Seq-id snapshot file was written with a different "
+                   "byte order: "+file_name);
+    }
+    m_KeyCount = header->m_KeyCount;
+    m_GiCount = header->m_GiCount;
+    m_StrCount = header->m_StrCount;
+    Uint8 expected = sizeof(SHeader) +
+        m_GiCount*sizeof(SGiEntry) +
+        m_StrCount*sizeof(SStrEntry) +
+        m_KeyCount*sizeof(SKeyEntry) +
+        header->m_DataSize;
+    if ( m_GiCount + m_StrCount != m_KeyCount  ||  expected != size ) {
+        NCBI_THROW(CSeq_id_MapperException, eOtherError,
+                   "Seq-id snapshot file is truncated or corrupted: "+
+                   file_name);
+    }
+    ptr += sizeof(SHeader);
+    m_Gis = reinterpret_cast<const SGiEntry*>(ptr);
+    ptr += m_GiCount*sizeof(SGiEntry);
+    m_Strs = reinterpret_cast<const SStrEntry*>(ptr);
+    ptr += m_StrCount*sizeof(SStrEntry);
+    m_Keys = reinterpret_cast<const SKeyEntry*>(ptr);
+    ptr += m_KeyCount*sizeof(SKeyEntry);
+    m_Data = ptr;
+}
+
+
+CSeq_id_Snapshot::~CSeq_id_Snapshot(void)
+{
+}
+
+
+size_t CSeq_id_Snapshot::GetCount(void) const
+{
+    CFastMutexGuard guard(m_DynamicMutex);
+    return m_KeyCount + m_DynamicHandles.size();
+}
+
+
+CSeq_id_Snapshot::TKey CSeq_id_Snapshot::x_FindFrozenGi(Int8 gi) const
+{
+    const SGiEntry* end = m_Gis + m_GiCount;
+    const SGiEntry* it =
+        lower_bound(m_Gis, end, gi,
+                    [](const SGiEntry& e, Int8 v) { return e.m_Gi < v; });
+    return it != end  &&  it->m_Gi == gi? it->m_Key: kInvalidKey;
+}
+
+
+CSeq_id_Snapshot::TKey
+CSeq_id_Snapshot::x_FindFrozenStr(const CTempString& str) const
+{
+    const char* data = m_Data;
+    const SStrEntry* end = m_Strs + m_StrCount;
+    const SStrEntry* it =
+        lower_bound(m_Strs, end, str,
+                    [data](const SStrEntry& e, const CTempString& v) {
+                        return CTempString(data + e.m_Offset, e.m_Length) < v;
+                    });
+    if ( it != end  &&
+         CTempString(data + it->m_Offset, it->m_Length) == str ) {
+        return it->m_Key;
+    }
+    return kInvalidKey;
+}
+
+
+CSeq_id_Snapshot::TKey CSeq_id_Snapshot::x_FindFrozen(const CSeq_id& id) const
+{
+    if ( id.IsGi() ) {
+        return x_FindFrozenGi(GI_TO(Int8, id.GetGi()));
+    }
+    string str;
+    GetLookupString(id, str);
+    return x_FindFrozenStr(str);
+}
+
+
+CSeq_id_Snapshot::TKey
+CSeq_id_Snapshot::x_FindDynamic(const CSeq_id_Handle& idh) const
+{
+    if ( !idh ) {
+        return kInvalidKey;
+    }
+    CFastMutexGuard guard(m_DynamicMutex);
+    TDynamicKeys::const_iterator it = m_DynamicKeys.find(idh);
+    return it != m_DynamicKeys.end()? it->second: kInvalidKey;
+}
+
+
+CSeq_id_Snapshot::TKey
+CSeq_id_Snapshot::x_AddDynamic(const CSeq_id_Handle& idh)
+{
+    CFastMutexGuard guard(m_DynamicMutex);
+    pair<TDynamicKeys::iterator, bool> ins =
+        m_DynamicKeys.insert(TDynamicKeys::value_type(idh, kInvalidKey));
+    if ( ins.second ) {
+        size_t key = m_KeyCount + m_DynamicHandles.size();
+        if ( key >= kInvalidKey ) {
+            m_DynamicKeys.erase(ins.first);
+            NCBI_THROW(CSeq_id_MapperException, eOtherError,
+                       "Too many Seq-id snapshot keys");
+        }
+        ins.first->second = TKey(key);
+        m_DynamicHandles.push_back(idh);
+    }
+    return ins.first->second;
+}
+
+
+CSeq_id_Snapshot::TKey CSeq_id_Snapshot::FindKey(const CSeq_id& id) const
+{
+    TKey key = x_FindFrozen(id);
+    if ( key == kInvalidKey ) {
+        // do not create handles just to find out they have no key
+        key = x_FindDynamic(CSeq_id_Mapper::GetInstance()->GetHandle(id, true));
+    }
+    return key;
+}
+
+
+CSeq_id_Snapshot::TKey
+CSeq_id_Snapshot::FindKey(const CSeq_id_Handle& idh) const
+{
+    if ( !idh ) {
+        return kInvalidKey;
+    }
+    TKey key = idh.IsGi()?
+        x_FindFrozenGi(GI_TO(Int8, idh.GetGi())): x_FindFrozen(*idh.GetSeqId());
+    if ( key == kInvalidKey ) {
+        key = x_FindDynamic(idh);
+    }
+    return key;
+}
+
+
+CSeq_id_Snapshot::TKey CSeq_id_Snapshot::FindGiKey(TGi gi) const
+{
+    TKey key = x_FindFrozenGi(GI_TO(Int8, gi));
+    if ( key == kInvalidKey ) {
+        key = x_FindDynamic(CSeq_id_Handle::GetGiHandle(gi));
+    }
+    return key;
+}
+
+
+CSeq_id_Snapshot::TKey CSeq_id_Snapshot::GetKey(const CSeq_id& id)
+{
+    TKey key = x_FindFrozen(id);
+    if ( key == kInvalidKey ) {
+        key = x_AddDynamic(CSeq_id_Handle::GetHandle(id));
+    }
+    return key;
+}
+
+
+CSeq_id_Snapshot::TKey CSeq_id_Snapshot::GetKey(const CSeq_id_Handle& idh)
+{
+    if ( !idh ) {
+        return kInvalidKey;
+    }
+    TKey key = idh.IsGi()?
+        x_FindFrozenGi(GI_TO(Int8, idh.GetGi())): x_FindFrozen(*idh.GetSeqId());
+    if ( key == kInvalidKey ) {
+        key = x_AddDynamic(idh);
+    }
+    return key;
+}
+
+
+CSeq_id_Handle CSeq_id_Snapshot::GetHandle(TKey key) const
+{
+    if ( key < m_KeyCount ) {
+        const SKeyEntry& entry = m_Keys[key];
+        if ( entry.m_IsGi ) {
+            return CSeq_id_Handle::GetGiHandle(GI_FROM(Int8, entry.m_Value));
+        }
+        return CSeq_id_Handle::GetHandle(string(m_Data + entry.m_Value,
+                                                entry.m_Length));
+    }
+    CFastMutexGuard guard(m_DynamicMutex);
+    if ( key - m_KeyCount < m_DynamicHandles.size() ) {
+        return m_DynamicHandles[key - m_KeyCount];
+    }
+    return CSeq_id_Handle();
+}
+
+
+////////////////////////////////////////////////////////////////////
+//
+//  CSeq_id_SnapshotWriter::
+//
+
+
+CSeq_id_SnapshotWriter::CSeq_id_SnapshotWriter(void)
+{
+}
+
+
+CSeq_id_SnapshotWriter::~CSeq_id_SnapshotWriter(void)
+{
+}
+
+
+CSeq_id_SnapshotWriter::TKey CSeq_id_SnapshotWriter::AddGi(TGi gi)
+{
+    Int8 value = GI_TO(Int8, gi);
+    auto ins = m_Gis.insert(make_pair(value, TKey(m_Keys.size())));
+    if ( ins.second ) {
+        SKey key;
+        key.m_Gi = value;
+        key.m_IsGi = true;
+        m_Keys.push_back(key);
+    }
+    return ins.first->second;
+}
+
+
+CSeq_id_SnapshotWriter::TKey
+CSeq_id_SnapshotWriter::x_AddStr(const string& str)
+{
+    auto ins = m_Strs.insert(make_pair(str, TKey(m_Keys.size())));
+    if ( ins.second ) {
+        SKey key;
+        key.m_Gi = 0;
+        key.m_Str = str;
+        key.m_IsGi = false;
+        m_Keys.push_back(key);
+    }
+    return ins.first->second;
+}
+
+
+CSeq_id_SnapshotWriter::TKey CSeq_id_SnapshotWriter::Add(const CSeq_id& id)
+{
+    if ( id.IsGi() ) {
+        return AddGi(id.GetGi());
+    }
+    string str;
+    CSeq_id_Snapshot::GetLookupString(id, str);
+    return x_AddStr(str);
+}
+
+
+CSeq_id_SnapshotWriter::TKey
+CSeq_id_SnapshotWriter::Add(const CSeq_id_Handle& idh)
+{
+    if ( idh.IsGi() ) {
+        return AddGi(idh.GetGi());
+    }
+    return Add(*idh.GetSeqId());
+}
+
+
+void CSeq_id_SnapshotWriter::Write(const string& file_name) const
+{
+    typedef CSeq_id_Snapshot TSnapshot;
+
+    if ( m_Keys.size() >= TSnapshot::kInvalidKey ) {
+        NCBI_THROW(CSeq_id_MapperException, eOtherError,
+                   "Too many ids for a Seq-id snapshot");
+    }
+
+    // string data in the key order, gi and string tables sorted
+    vector<TSnapshot::SKeyEntry> keys(m_Keys.size());
+    vector<TSnapshot::SGiEntry> gis;
+    vector<TSnapshot::SStrEntry> strs;
+    gis.reserve(m_Gis.size());
+    strs.reserve(m_Strs.size());
+    Uint8 data_size = 0;
+    for ( size_t i = 0; i < m_Keys.size(); ++i ) {
+        const SKey& key = m_Keys[i];
+        TSnapshot::SKeyEntry& entry = keys[i];
+        if ( key.m_IsGi ) {
+            entry.m_Value = key.m_Gi;
+            entry.m_Length = 0;
+            entry.m_IsGi = 1;
+            TSnapshot::SGiEntry gi = { key.m_Gi, TKey(i), 0 };
+            gis.push_back(gi);
+        }
+        else {
+            entry.m_Value = Int8(data_size);
+            entry.m_Length = Uint4(key.m_Str.size());
+            entry.m_IsGi = 0;
+            TSnapshot::SStrEntry str = { data_size, entry.m_Length, TKey(i) };
+            strs.push_back(str);
+            data_size += key.m_Str.size();
+        }
+    }
+    sort(gis.begin(), gis.end(),
+         [](const TSnapshot::SGiEntry& a, const TSnapshot::SGiEntry& b) {
+             return a.m_Gi < b.m_Gi;
+         });
+    const vector<SKey>& all_keys = m_Keys;
+    sort(strs.begin(), strs.end(),
+         [&all_keys](const TSnapshot::SStrEntry& a,
+                     const TSnapshot::SStrEntry& b) {
+             return all_keys[a.m_Key].m_Str < all_keys[b.m_Key].m_Str;
+         });
+
+    TSnapshot::SHeader header;
+    memcpy(header.m_Magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.m_ByteOrder = kSnapshotByteOrder;
+    header.m_KeyCount = Uint4(keys.size());
+    header.m_GiCount = Uint4(gis.size());
+    header.m_StrCount = Uint4(strs.size());
+    header.m_DataSize = data_size;
+
+    CNcbiOfstream out(file_name.c_str(), IOS_BASE::binary | IOS_BASE::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if ( !gis.empty() ) {
+        out.write(reinterpret_cast<const char*>(&gis[0]),
+                  gis.size()*sizeof(gis[0]));
+    }
+    if ( !strs.empty() ) {
+        out.write(reinterpret_cast<const char*>(&strs[0]),
+                  strs.size()*sizeof(strs[0]));
+    }
+    if ( !keys.empty() ) {
+        out.write(reinterpret_cast<const char*>(&keys[0]),
+                  keys.size()*sizeof(keys[0]));
+    }
+    for ( const SKey& key : m_Keys ) {
+        if ( !key.m_IsGi ) {
+            out.write(key.m_Str.data(), key.m_Str.size());
+        }
+    }
+    out.close();
+    if ( !out ) {
+        NCBI_THROW(CSeq_id_MapperException, eOtherError,
+                   "Cannot write Seq-id snapshot file: "+file_name);
+    }
+}
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
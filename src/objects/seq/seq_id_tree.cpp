@@ -49,6 +49,63 @@ BEGIN_SCOPE(objects)
 DEFINE_STATIC_FAST_MUTEX(sx_GetSeqIdMutex);
 #endif
 
+////////////////////////////////////////////////////////////////////
+//
+//  CSeq_id_ReadEpoch::
+//
+
+CSeq_id_ReadEpoch::CSeq_id_ReadEpoch(void)
+    : m_Epoch(0)
+{
+    for ( auto& counters : m_Counters ) {
+        for ( auto& counter : counters ) {
+            counter.m_Count.store(0, memory_order_relaxed);
+        }
+    }
+}
+
+
+CSeq_id_ReadEpoch::~CSeq_id_ReadEpoch(void)
+{
+}
+
+
+static atomic<unsigned> s_NextReadStripe(0);
+
+
+atomic<Uint4>& CSeq_id_ReadEpoch::x_Enter(void) const
+{
+    // each thread uses its own stripe of counters
+    static thread_local unsigned s_ReadStripe = s_NextReadStripe++ % kStripes;
+    for ( ;; ) {
+        Uint4 epoch = m_Epoch.load();
+        atomic<Uint4>& counter = m_Counters[epoch&1][s_ReadStripe].m_Count;
+        counter.fetch_add(1);
+        if ( m_Epoch.load() == epoch ) {
+            // the writer will wait for us
+            return counter;
+        }
+        // the epoch was switched after we've read it, the writer may have
+        // checked the counter already, so try again with the new epoch
+        counter.fetch_sub(1, memory_order_release);
+    }
+}
+
+
+void CSeq_id_ReadEpoch::Synchronize(void)
+{
+    // All readers of the previous epoch are finished by the previous call,
+    // so after the switch only the readers of the old epoch may see
+    // the removed objects.
+    Uint4 old_epoch = m_Epoch.fetch_add(1);
+    for ( auto& counter : m_Counters[old_epoch&1] ) {
+        while ( counter.m_Count.load() != 0 ) {
+            NCBI_SCHED_YIELD();
+        }
+    }
+}
+
+
 ////////////////////////////////////////////////////////////////////
 //
 //  CSeq_id_***_Tree::
@@ -597,49 +654,74 @@ TGi CSeq_id_Gi_Tree::x_Get(const CSeq_id& id) const
 
 void CSeq_id_Gi_Tree::x_Unindex(const CSeq_id_Info* info)
 {
-    if ( info == m_SharedInfo ) {
-        m_SharedInfo = 0;
+    CConstRef<CSeq_id_Info> ref;
+    if ( info == m_SharedInfo.load(memory_order_relaxed) ) {
+        m_SharedInfo.store(0, memory_order_relaxed);
+        ref.Swap(m_SharedInfoRef);
+    }
+    else if ( info == m_ZeroInfo.load(memory_order_relaxed) ) {
+        m_ZeroInfo.store(0, memory_order_relaxed);
+        ref.Swap(m_ZeroInfoRef);
     }
-    else if ( info == m_ZeroInfo ) {
-        m_ZeroInfo = 0;
+    else {
+        return;
     }
+    // the info can be released after lock-free readers are finished,
+    // the handle being destroyed still holds a reference to it
+    m_ReadEpoch.Synchronize();
 }
 
 
 CSeq_id_Handle CSeq_id_Gi_Tree::GetGiHandle(TGi gi)
 {
-    if ( gi != ZERO_GI ) {
-        TWriteLockGuard guard(m_TreeLock);
-        if ( !m_SharedInfo ) {
-            m_SharedInfo = new CSeq_id_Gi_Info(m_Mapper);
+    atomic<CSeq_id_Info*>& info_ptr = gi != ZERO_GI? m_SharedInfo: m_ZeroInfo;
+    TPacked packed = gi != ZERO_GI? GI_TO(TPacked, gi): 0;
+    {{
+        // fast path: the info exists and is used by other handles
+        TLockFreeReadGuard read_guard(m_ReadEpoch);
+        const CSeq_id_Info* info = info_ptr.load(memory_order_acquire);
+        if ( info && x_TryAddLock(info) ) {
+            return x_GetLockedHandle(info, packed);
         }
-        return CSeq_id_Handle(m_SharedInfo, GI_TO(TPacked, gi));
-    }
-    else {
-        TWriteLockGuard guard(m_TreeLock);
-        if ( !m_ZeroInfo ) {
+    }}
+    TWriteLockGuard guard(m_TreeLock);
+    CSeq_id_Info* info = info_ptr.load(memory_order_relaxed);
+    if ( !info ) {
+        if ( gi != ZERO_GI ) {
+            info = new CSeq_id_Gi_Info(m_Mapper);
+        }
+        else {
             CRef<CSeq_id> zero_id(new CSeq_id);
             zero_id->SetGi(ZERO_GI);
-            m_ZeroInfo = CreateInfo(*zero_id);
+            info = CreateInfo(*zero_id);
         }
-        return CSeq_id_Handle(m_ZeroInfo);
+        // keep the info alive while lock-free readers may see it
+        (gi != ZERO_GI? m_SharedInfoRef: m_ZeroInfoRef).Reset(info);
+        info_ptr.store(info, memory_order_release);
     }
+    return CSeq_id_Handle(info, packed);
 }
 
 
 CSeq_id_Handle CSeq_id_Gi_Tree::FindInfo(const CSeq_id& id) const
 {
-    CSeq_id_Handle ret;
     _ASSERT(x_Check(id));
     TPacked gi = GI_TO(TPacked, x_Get(id));
-    TReadLockGuard guard(m_TreeLock);
-    if ( gi ) {
-        if ( m_SharedInfo ) {
-            ret = CSeq_id_Handle(m_SharedInfo, gi);
+    const atomic<CSeq_id_Info*>& info_ptr = gi? m_SharedInfo: m_ZeroInfo;
+    {{
+        TLockFreeReadGuard read_guard(m_ReadEpoch);
+        const CSeq_id_Info* info = info_ptr.load(memory_order_acquire);
+        if ( !info ) {
+            return null;
         }
-    }
-    else if ( m_ZeroInfo ) {
-        ret = CSeq_id_Handle(m_ZeroInfo);
+        if ( x_TryAddLock(info) ) {
+            return x_GetLockedHandle(info, gi);
+        }
+    }}
+    CSeq_id_Handle ret;
+    TReadLockGuard guard(m_TreeLock);
+    if ( const CSeq_id_Info* info = info_ptr.load(memory_order_relaxed) ) {
+        ret = CSeq_id_Handle(info, gi);
     }
     return ret;
 }
@@ -664,10 +746,10 @@ void CSeq_id_Gi_Tree::FindMatchStr(const string& sid,
         return;
     }
     if (gi) {
-        id_list.insert(CSeq_id_Handle(m_SharedInfo, gi));
+        id_list.insert(CSeq_id_Handle(m_SharedInfo.load(memory_order_acquire), gi));
     }
-    else if ( m_ZeroInfo ) {
-        id_list.insert(CSeq_id_Handle(m_ZeroInfo));
+    else if ( const CSeq_id_Info* info = m_ZeroInfo.load(memory_order_acquire) ) {
+        id_list.insert(CSeq_id_Handle(info));
     }
 }
 
@@ -1033,13 +1115,128 @@ CConstRef<CSeq_id> CSeq_id_Textseq_PlainInfo::GetPackedSeqId(TPacked packed, TVa
 CSeq_id_Textseq_Tree::CSeq_id_Textseq_Tree(CSeq_id_Mapper* mapper,
                                            CSeq_id::E_Choice type)
     : CSeq_id_Which_Tree(mapper),
-      m_Type(type)
+      m_Type(type),
+      m_PackedTable(new SPackedTable(kInitialPackedTableSize))
 {
 }
 
 
 CSeq_id_Textseq_Tree::~CSeq_id_Textseq_Tree(void)
 {
+    delete m_PackedTable.load(memory_order_relaxed);
+}
+
+
+CSeq_id_Textseq_Tree::SPackedTable::SPackedTable(size_t size)
+    : m_Mask(size-1),
+      m_Used(0),
+      m_Slots(new TPackedSlot[size])
+{
+    _ASSERT((size & m_Mask) == 0);
+    for ( size_t i = 0; i < size; ++i ) {
+        m_Slots[i].store(0, memory_order_relaxed);
+    }
+}
+
+
+// placeholder of a removed info in the packed hash table
+static char s_RemovedPackedSlot;
+#define REMOVED_PACKED_SLOT \
+    reinterpret_cast<const CSeq_id_Textseq_Info*>(&s_RemovedPackedSlot)
+
+
+size_t CSeq_id_Textseq_Tree::x_GetPackedHash(const TPackedKey& key)
+{
+    // m_Hash includes first 3 letters of the prefix (case-insensitive)
+    size_t hash = key.m_Hash;
+    CTempString prefix = key.GetAccPrefix();
+    for ( size_t i = 3; i < prefix.size(); ++i ) {
+        hash = hash*17 + PHashNocase::get_hash(prefix[i]);
+    }
+    hash = hash*0x9E3779B1 + key.m_Version;
+    return hash ^ (hash >> 15);
+}
+
+
+const CSeq_id_Textseq_Info*
+CSeq_id_Textseq_Tree::x_FindPacked(const TPackedKey& key) const
+{
+    const SPackedTable* table = m_PackedTable.load(memory_order_acquire);
+    for ( size_t i = x_GetPackedHash(key); ; ++i ) {
+        const CSeq_id_Textseq_Info* info =
+            table->m_Slots[i & table->m_Mask].load(memory_order_acquire);
+        if ( !info ) {
+            return 0;
+        }
+        if ( info != REMOVED_PACKED_SLOT && info->GetKey() == key ) {
+            return info;
+        }
+    }
+}
+
+
+void CSeq_id_Textseq_Tree::x_RehashPacked(size_t size)
+{
+    SPackedTable* old_table = m_PackedTable.load(memory_order_relaxed);
+    unique_ptr<SPackedTable> table(new SPackedTable(size));
+    ITERATE ( TPackedMap, it, m_PackedMap ) {
+        size_t i = x_GetPackedHash(it->first);
+        while ( table->m_Slots[i & table->m_Mask].load(memory_order_relaxed) ) {
+            ++i;
+        }
+        table->m_Slots[i & table->m_Mask].store(it->second.GetPointer(),
+                                                memory_order_relaxed);
+        ++table->m_Used;
+    }
+    m_PackedTable.store(table.release(), memory_order_release);
+    // the old table can be deleted after lock-free readers are finished
+    m_ReadEpoch.Synchronize();
+    delete old_table;
+}
+
+
+void CSeq_id_Textseq_Tree::x_InsertPacked(const CSeq_id_Textseq_Info* info)
+{
+    // m_PackedMap already includes the info
+    SPackedTable* table = m_PackedTable.load(memory_order_relaxed);
+    if ( (table->m_Used+1)*2 > table->m_Mask+1 ) {
+        // too many used slots, rehash to a table with load below 1/4
+        size_t size = kInitialPackedTableSize;
+        while ( size < m_PackedMap.size()*4 ) {
+            size *= 2;
+        }
+        x_RehashPacked(size);
+        return;
+    }
+    for ( size_t i = x_GetPackedHash(info->GetKey()); ; ++i ) {
+        TPackedSlot& slot = table->m_Slots[i & table->m_Mask];
+        const CSeq_id_Textseq_Info* old_info = slot.load(memory_order_relaxed);
+        if ( !old_info || old_info == REMOVED_PACKED_SLOT ) {
+            if ( !old_info ) {
+                ++table->m_Used;
+            }
+            slot.store(info, memory_order_release);
+            return;
+        }
+        _ASSERT(old_info->GetKey() != info->GetKey());
+    }
+}
+
+
+void CSeq_id_Textseq_Tree::x_RemovePacked(const CSeq_id_Textseq_Info* info)
+{
+    SPackedTable* table = m_PackedTable.load(memory_order_relaxed);
+    for ( size_t i = x_GetPackedHash(info->GetKey()); ; ++i ) {
+        TPackedSlot& slot = table->m_Slots[i & table->m_Mask];
+        const CSeq_id_Textseq_Info* old_info = slot.load(memory_order_relaxed);
+        _ASSERT(old_info);
+        if ( old_info == info ) {
+            slot.store(REMOVED_PACKED_SLOT, memory_order_release);
+            break;
+        }
+    }
+    // the info can be released after lock-free readers are finished
+    m_ReadEpoch.Synchronize();
 }
 
 
@@ -1144,6 +1341,17 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindInfo(const CSeq_id& id) const
         TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, tid);
         if ( key ) {
             TPacked packed = CSeq_id_Textseq_Info::Pack(key, tid);
+            {{
+                TLockFreeReadGuard read_guard(m_ReadEpoch);
+                const CSeq_id_Textseq_Info* info = x_FindPacked(key);
+                if ( !info ) {
+                    return null;
+                }
+                if ( x_TryAddLock(info) ) {
+                    return x_GetLockedHandle(info, packed,
+                                             info->GetKey().ParseCaseVariant(acc));
+                }
+            }}
             TReadLockGuard guard(m_TreeLock);
             TPackedMap_CI it = m_PackedMap.find(key);
             if ( it == m_PackedMap.end() ) {
@@ -1168,6 +1376,15 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreate(const CSeq_id& id)
         TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, tid);
         if ( key ) {
             TPacked packed = CSeq_id_Textseq_Info::Pack(key, tid);
+            {{
+                // fast path: the info exists and is used by other handles
+                TLockFreeReadGuard read_guard(m_ReadEpoch);
+                const CSeq_id_Textseq_Info* info = x_FindPacked(key);
+                if ( info && x_TryAddLock(info) ) {
+                    return x_GetLockedHandle(info, packed,
+                                             info->GetKey().ParseCaseVariant(acc));
+                }
+            }}
             CSeq_id_Handle::TVariant variant = 0;
             TWriteLockGuard guard(m_TreeLock);
             TPackedMap_I it = m_PackedMap.lower_bound(key);
@@ -1176,6 +1393,7 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreate(const CSeq_id& id)
                 CConstRef<CSeq_id_Textseq_Info> info
                     (new CSeq_id_Textseq_Info(id.Which(), m_Mapper, key));
                 it = m_PackedMap.insert(it, TPackedMapValue(key, info));
+                x_InsertPacked(info.GetPointer());
             }
             else {
                 variant = it->first.ParseCaseVariant(acc);
@@ -1226,6 +1444,7 @@ void CSeq_id_Textseq_Tree::x_Unindex(const CSeq_id_Info* info)
             dynamic_cast<const CSeq_id_Textseq_Info*>(info);
         if ( sinfo ) {
             m_PackedMap.erase(sinfo->GetKey());
+            x_RemovePacked(sinfo);
             return;
         }
     }
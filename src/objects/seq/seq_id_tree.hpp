@@ -114,6 +114,70 @@ struct PEqualNocase {
         }
 };
 
+////////////////////////////////////////////////////////////////////
+//
+//  CSeq_id_ReadEpoch::
+//
+//    Support for lookups of Seq-id infos without the tree lock.
+//    Lock-free readers register themselves with CReadGuard for the time
+//    they access published info pointers.  The writer, after removing
+//    a pointer from the lock-free index (under the tree lock), calls
+//    Synchronize() to wait for the readers that could have seen it,
+//    and only then the info can be released.
+//    Readers are counted in cacheline-separated stripes of two sets,
+//    selected by the parity of the current epoch.
+//
+
+class CSeq_id_ReadEpoch
+{
+public:
+    CSeq_id_ReadEpoch(void);
+    ~CSeq_id_ReadEpoch(void);
+
+    class CReadGuard
+    {
+    public:
+        explicit CReadGuard(const CSeq_id_ReadEpoch& epoch)
+            : m_Counter(epoch.x_Enter())
+            {
+            }
+        ~CReadGuard(void)
+            {
+                m_Counter.fetch_sub(1, memory_order_release);
+            }
+
+    private:
+        atomic<Uint4>& m_Counter;
+
+        CReadGuard(const CReadGuard&);
+        void operator=(const CReadGuard&);
+    };
+
+    // Wait for all readers that have started before the call.
+    // Must be called under the tree lock.
+    void Synchronize(void);
+
+private:
+    atomic<Uint4>& x_Enter(void) const;
+
+    enum {
+        kStripes = 16,
+        kCacheLineSize = 64
+    };
+    struct SCounter {
+        atomic<Uint4> m_Count;
+        char m_Padding[kCacheLineSize - sizeof(atomic<Uint4>)];
+    };
+
+    mutable atomic<Uint4> m_Epoch;
+    mutable SCounter m_Counters[2][kStripes];
+
+private:
+    CSeq_id_ReadEpoch(const CSeq_id_ReadEpoch&);
+    void operator=(const CSeq_id_ReadEpoch&);
+};
+
+
 ////////////////////////////////////////////////////////////////////
 //
 //  CSeq_id_***_Tree::
@@ -185,11 +249,36 @@ protected:
         }
     virtual void x_Unindex(const CSeq_id_Info* info) = 0;
 
+    // Lock-free lookup: add lock to the info found without the tree lock.
+    // Fails if the info is not locked by anyone, as it may be dropped;
+    // then the lookup should be repeated under the tree lock.
+    static bool x_TryAddLock(const CSeq_id_Info* info)
+        {
+            Uint8 count = info->m_LockCounter.load(memory_order_relaxed);
+            while ( count > 0 ) {
+                if ( info->m_LockCounter.compare_exchange_weak(count, count+1) ) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    // Make handle of the info locked by successful x_TryAddLock()
+    static CSeq_id_Handle x_GetLockedHandle(const CSeq_id_Info* info,
+                                            TPacked packed = 0,
+                                            CSeq_id_Info::TVariant variant = 0)
+        {
+            CSeq_id_Handle ret(info, packed, variant);
+            info->RemoveLock(); // the handle holds another lock
+            return ret;
+        }
+
     typedef CFastMutex TTreeLock;
     typedef TTreeLock::TReadLockGuard TReadLockGuard;
     typedef TTreeLock::TWriteLockGuard TWriteLockGuard;
+    typedef CSeq_id_ReadEpoch::CReadGuard TLockFreeReadGuard;
 
     mutable TTreeLock m_TreeLock;
+    CSeq_id_ReadEpoch m_ReadEpoch;
     CSeq_id_Mapper* m_Mapper;
 
 private:
@@ -331,8 +420,14 @@ protected:
     bool x_Check(const CSeq_id& id) const;
     TGi x_Get(const CSeq_id& id) const;
 
-    CSeq_id_Info* m_ZeroInfo;
-    CSeq_id_Info* m_SharedInfo;
+    // the infos are read without the tree lock
+    atomic<CSeq_id_Info*> m_ZeroInfo;
+    atomic<CSeq_id_Info*> m_SharedInfo;
+    // A lock-free reader may add a lock to the info while its last
+    // handle is being destroyed, so the tree holds references to the
+    // published infos until they are unindexed and the readers finish.
+    CConstRef<CSeq_id_Info> m_ZeroInfoRef;
+    CConstRef<CSeq_id_Info> m_SharedInfoRef;
 };
 
 
@@ -586,10 +681,33 @@ private:
                               const string& name,
                               const CTextseq_id* tid = 0) const;
 
+    // Open-addressing hash table of packed infos for lookups without
+    // the tree lock, it's modified under the tree lock along with
+    // m_PackedMap.  Removed infos leave a placeholder in their slot
+    // until the table is rehashed.
+    typedef atomic<const CSeq_id_Textseq_Info*> TPackedSlot;
+    enum {
+        kInitialPackedTableSize = 16
+    };
+    struct SPackedTable {
+        explicit SPackedTable(size_t size);
+
+        size_t m_Mask;
+        size_t m_Used; // number of occupied or removed slots
+        unique_ptr<TPackedSlot[]> m_Slots;
+    };
+    static size_t x_GetPackedHash(const TPackedKey& key);
+    // must be called within TLockFreeReadGuard or under the tree lock
+    const CSeq_id_Textseq_Info* x_FindPacked(const TPackedKey& key) const;
+    void x_InsertPacked(const CSeq_id_Textseq_Info* info);
+    void x_RemovePacked(const CSeq_id_Textseq_Info* info);
+    void x_RehashPacked(size_t size);
+
     CSeq_id::E_Choice m_Type;
     TStringMap m_ByAcc;
     TStringMap m_ByName; // Used for searching by string
     TPackedMap m_PackedMap;
+    atomic<SPackedTable*> m_PackedTable;
 };
 
 
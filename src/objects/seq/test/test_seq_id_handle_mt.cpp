@@ -0,0 +1,252 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  Multithreaded CSeq_id_Handle lookup benchmark
+ *
+ *   Several threads get handles of the same set of accessions and gis
+ *   for a given time and the total throughput (lookups/s) is reported.
+ *   With -keep the handles are held by the main thread all the time, so
+ *   the lookups find existing Seq-id infos, otherwise the infos may be
+ *   dropped and created again.  Without -keep the test then makes all
+ *   threads look up a single gi, so its shared info is dropped and created
+ *   again all the time.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seq/seq_id_handle.hpp>
+#include <objects/seq/seq_id_mapper.hpp>
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static double s_Duration;
+
+typedef vector<CRef<CSeq_id> > TIds;
+typedef vector<CSeq_id_Handle> THandles;
+
+
+class CTestSeqIdHandleThread : public CThread
+{
+public:
+    CTestSeqIdHandleThread(const TIds& ids, const THandles& kept,
+                           bool find_only)
+        : m_Mapper(CSeq_id_Mapper::GetInstance()),
+          m_Ids(ids), m_Kept(kept), m_FindOnly(find_only),
+          m_Lookups(0), m_Errors(0)
+    {}
+
+    virtual void* Main(void);
+
+    Uint8 GetLookups(void) const { return m_Lookups; }
+    Uint8 GetErrors(void) const { return m_Errors; }
+
+private:
+    CRef<CSeq_id_Mapper> m_Mapper;
+    const TIds& m_Ids;
+    const THandles& m_Kept; // empty unless -keep, else parallel to m_Ids
+    bool        m_FindOnly;
+    Uint8       m_Lookups;
+    Uint8       m_Errors;
+};
+
+
+void* CTestSeqIdHandleThread::Main(void)
+{
+    size_t count = m_Ids.size();
+    size_t pos = size_t(rand()) % count;
+    CStopWatch sw(CStopWatch::eStart);
+    while ( sw.Elapsed() < s_Duration ) {
+        // check time once per batch of lookups
+        for ( size_t i = 0; i < 1000; ++i ) {
+            size_t index = pos;
+            if ( ++pos == count ) {
+                pos = 0;
+            }
+            const CSeq_id& id = *m_Ids[index];
+            CSeq_id_Handle idh = m_Mapper->GetHandle(id, m_FindOnly);
+            if ( !idh  ||  !idh.GetSeqId()->Equals(id) ) {
+                ++m_Errors;
+            }
+            else if ( !m_Kept.empty()  &&  idh != m_Kept[index] ) {
+                // a kept Seq-id must always resolve to the same handle
+                ++m_Errors;
+            }
+        }
+        m_Lookups += 1000;
+    }
+    return NULL;
+}
+
+
+class CTestSeqIdHandleApp : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    typedef vector<CRef<CTestSeqIdHandleThread> > TThreads;
+
+    // join the threads and print their statistics, return number of errors
+    Uint8 x_Report(const char* name,
+                   unsigned threads,
+                   const TThreads& thread_list,
+                   const CStopWatch& sw);
+};
+
+
+void CTestSeqIdHandleApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Multithreaded CSeq_id_Handle lookup benchmark");
+
+    arg_desc->AddDefaultKey("threads", "threads",
+                            "Number of lookup threads",
+                            CArgDescriptions::eInteger, "8");
+
+    arg_desc->AddDefaultKey("duration", "seconds",
+                            "Duration of the test",
+                            CArgDescriptions::eDouble, "5");
+
+    arg_desc->AddDefaultKey("ids", "count",
+                            "Number of distinct Seq-ids",
+                            CArgDescriptions::eInteger, "10000");
+
+    arg_desc->AddFlag("keep",
+                      "Keep handles of all Seq-ids during the test");
+
+    arg_desc->AddFlag("find",
+                      "Only find existing handles (requires -keep)");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+int CTestSeqIdHandleApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    unsigned threads = unsigned(args["threads"].AsInteger());
+    s_Duration = args["duration"].AsDouble();
+    size_t count = size_t(args["ids"].AsInteger());
+    bool keep = args["keep"];
+    bool find_only = args["find"];
+    if ( find_only  &&  !keep ) {
+        ERR_POST("-find requires -keep");
+        return 1;
+    }
+
+    // a mix of packed accessions (with and without version) and gis
+    TIds ids;
+    static const char* const kPrefixes[] = { "NM_", "NC_", "AB", "CAAA" };
+    for ( size_t i = 0; i < count; ++i ) {
+        CRef<CSeq_id> id;
+        if ( i % 4 == 3 ) {
+            id.Reset(new CSeq_id(CSeq_id::e_Gi, TIntId(1000000+i)));
+        }
+        else {
+            string acc = kPrefixes[i % 4];
+            acc += NStr::NumericToString(100000+i);
+            if ( i % 2 ) {
+                acc += ".1";
+            }
+            id.Reset(new CSeq_id(acc));
+        }
+        ids.push_back(id);
+    }
+    THandles kept;
+    if ( keep ) {
+        ITERATE ( TIds, it, ids ) {
+            kept.push_back(CSeq_id_Handle::GetHandle(**it));
+        }
+    }
+
+    CStopWatch sw(CStopWatch::eStart);
+    TThreads thread_list;
+    thread_list.reserve(threads);
+    for ( unsigned i = 0; i < threads; ++i ) {
+        CRef<CTestSeqIdHandleThread> thread
+            (new CTestSeqIdHandleThread(ids, kept, find_only));
+        thread_list.push_back(thread);
+        thread->Run();
+    }
+
+    Uint8 errors = x_Report("lookups", threads, thread_list, sw);
+
+    if ( !keep ) {
+        // all threads create and drop the handle of the same gi
+        TIds churn_ids(1, CRef<CSeq_id>(new CSeq_id(CSeq_id::e_Gi, TIntId(2))));
+        sw.Restart();
+        thread_list.clear();
+        for ( unsigned i = 0; i < threads; ++i ) {
+            CRef<CTestSeqIdHandleThread> thread
+                (new CTestSeqIdHandleThread(churn_ids, kept, false));
+            thread_list.push_back(thread);
+            thread->Run();
+        }
+        errors += x_Report("single gi lookups", threads, thread_list, sw);
+    }
+
+    return errors == 0? 0: 1;
+}
+
+
+Uint8 CTestSeqIdHandleApp::x_Report(const char* name,
+                                    unsigned threads,
+                                    const TThreads& thread_list,
+                                    const CStopWatch& sw)
+{
+    Uint8 lookups = 0, errors = 0;
+    ITERATE ( TThreads, it, thread_list ) {
+        (*it)->Join();
+        lookups += (*it)->GetLookups();
+        errors += (*it)->GetErrors();
+    }
+    double elapsed = sw.Elapsed();
+
+    cout << "threads=" << threads
+         << " " << name << "=" << lookups
+         << " " << name << "/s=" << Uint8(lookups / elapsed)
+         << " per thread/s=" << Uint8(lookups / elapsed / threads)
+         << " errors=" << errors << NcbiEndl;
+    return errors;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestSeqIdHandleApp().AppMain(argc, argv);
+}
@@ -43,9 +43,11 @@
 #include <objects/seqloc/seqloc__.hpp>
 #include <objects/seqfeat/Seq_feat.hpp>
 #include <objects/seqfeat/SeqFeatData.hpp>
+#include <objects/seq/seq_id_snapshot.hpp>
 
 #include <corelib/ncbiapp.hpp>
 #include <corelib/test_boost.hpp>
+#include <corelib/ncbifile.hpp>
 
 #include <boost/test/parameterized_test.hpp>
 #include <util/util_exception.hpp>
@@ -2474,3 +2476,68 @@ BOOST_AUTO_TEST_CASE(TestPDB)
         BOOST_CHECK_EQUAL(idh_set_ne.size(), size(idh_ne));
     }}
 }
+
+
+BOOST_AUTO_TEST_CASE(s_TestSeq_id_Snapshot)
+{
+    CSeq_id_SnapshotWriter writer;
+    BOOST_CHECK_EQUAL(writer.Add(CSeq_id("NM_000170.1")), 0u);
+    BOOST_CHECK_EQUAL(writer.AddGi(GI_CONST(12345)), 1u);
+    BOOST_CHECK_EQUAL(writer.Add(CSeq_id("lcl|contig1")), 2u);
+    BOOST_CHECK_EQUAL(writer.Add(CSeq_id("AC123456")), 3u);
+    // duplicates keep their keys
+    BOOST_CHECK_EQUAL(writer.Add(CSeq_id("nm_000170.1")), 0u);
+    BOOST_CHECK_EQUAL(writer.Add(CSeq_id_Handle::GetGiHandle(GI_CONST(12345))),
+                      1u);
+    BOOST_CHECK_EQUAL(writer.GetCount(), 4u);
+
+    string file_name = CDirEntry::GetTmpName();
+    writer.Write(file_name);
+    {{
+        CRef<CSeq_id_Snapshot> snapshot(new CSeq_id_Snapshot(file_name));
+        BOOST_CHECK_EQUAL(snapshot->GetFrozenCount(), 4u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("NM_000170.1")), 0u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("ref|nm_000170.1|")), 0u);
+        BOOST_CHECK_EQUAL(snapshot->FindGiKey(GI_CONST(12345)), 1u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("gi|12345")), 1u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("lcl|contig1")), 2u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(
+                              CSeq_id_Handle::GetHandle("AC123456")), 3u);
+        // like handles, keys of GenBank, EMBL and DDBJ ids are different
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("gb|AC123456|")), 3u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("emb|AC123456|")),
+                          CSeq_id_Snapshot::kInvalidKey);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("dbj|AC123456|")),
+                          CSeq_id_Snapshot::kInvalidKey);
+        BOOST_CHECK(CSeq_id_Handle::GetHandle("gb|AC123456|") !=
+                    CSeq_id_Handle::GetHandle("emb|AC123456|"));
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("NM_000170.2")),
+                          CSeq_id_Snapshot::kInvalidKey);
+        BOOST_CHECK_EQUAL(snapshot->FindGiKey(GI_CONST(54321)),
+                          CSeq_id_Snapshot::kInvalidKey);
+
+        BOOST_CHECK_EQUAL(snapshot->GetHandle(0),
+                          CSeq_id_Handle::GetHandle("NM_000170.1"));
+        BOOST_CHECK_EQUAL(snapshot->GetHandle(1),
+                          CSeq_id_Handle::GetGiHandle(GI_CONST(12345)));
+        BOOST_CHECK_EQUAL(snapshot->GetHandle(2),
+                          CSeq_id_Handle::GetHandle("lcl|contig1"));
+        BOOST_CHECK(!snapshot->GetHandle(4));
+
+        // ids missing in the file get process local keys
+        CSeq_id_Handle idh = CSeq_id_Handle::GetHandle("NM_000170.2");
+        BOOST_CHECK_EQUAL(snapshot->GetKey(idh), 4u);
+        BOOST_CHECK_EQUAL(snapshot->GetKey(CSeq_id("NM_000170.2")), 4u);
+        BOOST_CHECK_EQUAL(snapshot->FindKey(CSeq_id("NM_000170.2")), 4u);
+        BOOST_CHECK_EQUAL(snapshot->GetKey(CSeq_id("gi|54321")), 5u);
+        BOOST_CHECK_EQUAL(snapshot->FindGiKey(GI_CONST(54321)), 5u);
+        BOOST_CHECK_EQUAL(snapshot->GetKey(CSeq_id("NM_000170.1")), 0u);
+        BOOST_CHECK_EQUAL(snapshot->GetHandle(4), idh);
+        BOOST_CHECK_EQUAL(snapshot->GetCount(), 6u);
+    }}
+    CDirEntry(file_name).Remove();
+
+    CNcbiOfstream(file_name.c_str()) << "not a snapshot";
+    BOOST_CHECK_THROW(CSeq_id_Snapshot snapshot(file_name), CException);
+    CDirEntry(file_name).Remove();
+}
@@ -0,0 +1,244 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  Benchmark of reading GenBank release files
+ *
+ *   Reads a release file (Bioseq-set) one Seq-entry at a time with
+ *   CGBReleaseFile, with and without the readers of simple class members
+ *   generated by datatool (CObjectIStream::SetFastRead()), and reports
+ *   the throughput (Seq-entries/s).  Without -i a synthetic release of
+ *   -entries Seq-entries is written in memory in the given format and read.
+ *   Fails if the Seq-entries read in the two modes are not equal.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+
+#include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <serial/serial.hpp>
+
+#include <objects/seqset/gb_release_file.hpp>
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seq/Seqdesc.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/SeqFeatData.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objects/seqloc/Seq_interval.hpp>
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+class CTestGBReleaseReadApp : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    CObjectIStream* x_OpenInput(void) const;
+    void x_CreateRelease(size_t entries);
+
+    ESerialDataFormat m_Format;
+    string            m_FileName;
+    string            m_Data;
+};
+
+
+void CTestGBReleaseReadApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "GenBank release file reading benchmark");
+
+    arg_desc->AddOptionalKey("i", "file",
+                             "Release file (Bioseq-set) to read",
+                             CArgDescriptions::eInputFile);
+
+    arg_desc->AddDefaultKey("format", "format",
+                            "Format of the release file",
+                            CArgDescriptions::eString, "asnb");
+    arg_desc->SetConstraint("format",
+                            &(*new CArgAllow_Strings, "asn", "asnb", "json", "xml"));
+
+    arg_desc->AddDefaultKey("entries", "count",
+                            "Number of Seq-entries in synthetic release",
+                            CArgDescriptions::eInteger, "20000");
+
+    arg_desc->AddDefaultKey("repeat", "count",
+                            "Number of reads in each mode (the best is reported)",
+                            CArgDescriptions::eInteger, "3");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CTestGBReleaseReadApp::x_CreateRelease(size_t entries)
+{
+    CBioseq_set release;
+    release.SetClass(CBioseq_set::eClass_genbank);
+    for ( size_t i = 0; i < entries; ++i ) {
+        CRef<CSeq_id> id(new CSeq_id("gb|AB"+NStr::NumericToString(100000+i)+".1|"));
+
+        CRef<CBioseq> seq(new CBioseq);
+        seq->SetId().push_back(id);
+        CRef<CSeqdesc> title(new CSeqdesc);
+        title->SetTitle("Synthetic sequence "+NStr::NumericToString(i));
+        seq->SetDescr().Set().push_back(title);
+        CSeq_inst& inst = seq->SetInst();
+        inst.SetRepr(CSeq_inst::eRepr_raw);
+        inst.SetMol(CSeq_inst::eMol_dna);
+        inst.SetLength(240);
+        inst.SetSeq_data().SetIupacna().Set(string(240, "ACGT"[i%4]));
+
+        CRef<CSeq_annot> annot(new CSeq_annot);
+        for ( TSeqPos from = 0; from < 240; from += 60 ) {
+            CRef<CSeq_feat> feat(new CSeq_feat);
+            feat->SetData().SetRegion("region "+NStr::NumericToString(from));
+            CSeq_interval& interval = feat->SetLocation().SetInt();
+            interval.SetId(*id);
+            interval.SetFrom(from);
+            interval.SetTo(from + 49);
+            feat->SetComment("synthetic feature");
+            annot->SetData().SetFtable().push_back(feat);
+        }
+        seq->SetAnnot().push_back(annot);
+
+        CRef<CSeq_entry> entry(new CSeq_entry);
+        entry->SetSeq(*seq);
+        release.SetSeq_set().push_back(entry);
+    }
+
+    CNcbiOstrstream str;
+    {{
+        unique_ptr<CObjectOStream> out(CObjectOStream::Open(m_Format, str));
+        *out << release;
+    }}
+    m_Data = CNcbiOstrstreamToString(str);
+}
+
+
+CObjectIStream* CTestGBReleaseReadApp::x_OpenInput(void) const
+{
+    if ( !m_FileName.empty() ) {
+        return CObjectIStream::Open(m_Format, m_FileName);
+    }
+    return CObjectIStream::CreateFromBuffer(m_Format,
+                                            m_Data.data(), m_Data.size());
+}
+
+
+int CTestGBReleaseReadApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    string format = args["format"].AsString();
+    if ( format == "asn" ) {
+        m_Format = eSerial_AsnText;
+    }
+    else if ( format == "json" ) {
+        m_Format = eSerial_Json;
+    }
+    else if ( format == "xml" ) {
+        m_Format = eSerial_Xml;
+    }
+    else {
+        m_Format = eSerial_AsnBinary;
+    }
+    if ( args["i"] ) {
+        m_FileName = args["i"].AsString();
+    }
+    else {
+        x_CreateRelease(size_t(args["entries"].AsInteger()));
+    }
+    int repeat = args["repeat"].AsInteger();
+
+    // the entries of the first read in each mode, compared in the end
+    vector<CRef<CSeq_entry>> entries[2];
+    size_t counts[2] = { 0, 0 };
+    for ( int fast = 0; fast < 2; ++fast ) {
+        double best = 0;
+        for ( int r = 0; r < repeat; ++r ) {
+            CObjectIStream* in = x_OpenInput();
+            in->SetFastRead(fast != 0);
+            // the release file takes ownership of the stream
+            CGBReleaseFile release(*in);
+            size_t count = 0;
+            vector<CRef<CSeq_entry>>* keep = r == 0? &entries[fast]: nullptr;
+            release.RegisterHandler([&count, keep](CRef<CSeq_entry>& entry) -> bool
+                {
+                    ++count;
+                    if ( keep ) {
+                        keep->push_back(entry);
+                    }
+                    return true;
+                });
+            CStopWatch sw(CStopWatch::eStart);
+            release.Read();
+            double elapsed = sw.Elapsed();
+            if ( r == 0  ||  elapsed < best ) {
+                best = elapsed;
+            }
+            counts[fast] = count;
+        }
+        cout << format << (fast? " fast": " generic")
+             << ": entries=" << counts[fast]
+             << " time=" << best << "s"
+             << " entries/s=" << Uint8(counts[fast] / max(best, 1e-9))
+             << NcbiEndl;
+    }
+
+    if ( counts[0] != counts[1] ) {
+        ERR_POST("Different number of entries read in the generic and fast modes");
+        return 1;
+    }
+    for ( size_t i = 0; i < entries[0].size(); ++i ) {
+        if ( !SerialEquals(*entries[0][i], *entries[1][i]) ) {
+            ERR_POST("Seq-entry "<<i<<" read in the fast mode differs");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestGBReleaseReadApp().AppMain(argc, argv);
+}
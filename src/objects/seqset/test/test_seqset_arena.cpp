@@ -0,0 +1,207 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Test of arena allocation of deserialized objects
+ *   (CObjectIStream::SetArenaAllocation()).
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <serial/serial.hpp>
+#include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/test_boost.hpp>
+
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/SeqFeatData.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objects/seqloc/Seq_interval.hpp>
+
+/////////////////////////////////////////////////////////////////////////////
+// Test arena allocation of deserialized objects
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static const ESerialDataFormat s_Formats[] = {
+    eSerial_AsnBinary, eSerial_AsnText, eSerial_Json, eSerial_Xml
+};
+
+
+static CRef<CBioseq_set> s_MakeSet(size_t entries)
+{
+    CRef<CBioseq_set> seqset(new CBioseq_set);
+    seqset->SetClass(CBioseq_set::eClass_genbank);
+    for ( size_t i = 0; i < entries; ++i ) {
+        CRef<CSeq_entry> entry(new CSeq_entry);
+        CBioseq& seq = entry->SetSeq();
+        CRef<CSeq_id> id(new CSeq_id("gb|AB"+NStr::NumericToString(100000+i)+".1|"));
+        seq.SetId().push_back(id);
+        seq.SetInst().SetRepr(CSeq_inst::eRepr_raw);
+        seq.SetInst().SetMol(CSeq_inst::eMol_dna);
+        seq.SetInst().SetLength(100);
+        seq.SetInst().SetSeq_data().SetIupacna().Set(string(100, "ACGT"[i%4]));
+        CRef<CSeq_annot> annot(new CSeq_annot);
+        for ( TSeqPos from = 0; from < 100; from += 10 ) {
+            CRef<CSeq_feat> feat(new CSeq_feat);
+            feat->SetData().SetRegion("region "+NStr::NumericToString(from));
+            feat->SetLocation().SetInt().SetId(*id);
+            feat->SetLocation().SetInt().SetFrom(from);
+            feat->SetLocation().SetInt().SetTo(from+4);
+            annot->SetData().SetFtable().push_back(feat);
+        }
+        seq.SetAnnot().push_back(annot);
+        seqset->SetSeq_set().push_back(entry);
+    }
+    return seqset;
+}
+
+
+static string s_Write(const CBioseq_set& seqset, ESerialDataFormat format)
+{
+    CNcbiOstrstream str;
+    {{
+        unique_ptr<CObjectOStream> out(CObjectOStream::Open(format, str));
+        *out << seqset;
+    }}
+    return CNcbiOstrstreamToString(str);
+}
+
+
+static CRef<CBioseq_set> s_Read(const string& data,
+                                ESerialDataFormat format,
+                                bool arena)
+{
+    unique_ptr<CObjectIStream> in
+        (CObjectIStream::CreateFromBuffer(format, data.data(), data.size()));
+    in->SetArenaAllocation(arena);
+    BOOST_CHECK_EQUAL(in->GetArenaAllocation(), arena);
+    CRef<CBioseq_set> seqset(new CBioseq_set);
+    *in >> *seqset;
+    return seqset;
+}
+
+
+static CRef<CSeq_feat> s_GetFeat(const CBioseq_set& seqset,
+                                 size_t entry, size_t feat)
+{
+    auto entry_it = seqset.GetSeq_set().begin();
+    advance(entry_it, entry);
+    const CSeq_annot& annot = *(*entry_it)->GetSeq().GetAnnot().front();
+    auto feat_it = annot.GetData().GetFtable().begin();
+    advance(feat_it, feat);
+    return *feat_it;
+}
+
+
+BOOST_AUTO_TEST_CASE(s_TestArenaRead)
+{
+    CRef<CBioseq_set> orig = s_MakeSet(100);
+    for ( auto format : s_Formats ) {
+        string data = s_Write(*orig, format);
+        CRef<CBioseq_set> heap = s_Read(data, format, false);
+        CRef<CBioseq_set> arena = s_Read(data, format, true);
+        BOOST_CHECK(SerialEquals(*orig, *heap));
+        BOOST_CHECK(SerialEquals(*heap, *arena));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(s_TestArenaReadRoot)
+{
+    // the root object created by Read(TTypeInfo)
+    CRef<CBioseq_set> orig = s_MakeSet(10);
+    string data = s_Write(*orig, eSerial_AsnBinary);
+    for ( int arena = 0; arena < 2; ++arena ) {
+        unique_ptr<CObjectIStream> in
+            (CObjectIStream::CreateFromBuffer(eSerial_AsnBinary,
+                                              data.data(), data.size()));
+        in->SetArenaAllocation(arena != 0);
+        CObjectInfo info = in->Read(CBioseq_set::GetTypeInfo());
+        CRef<CBioseq_set> seqset
+            (CTypeConverter<CBioseq_set>::SafeCast(info.GetObjectPtr()));
+        BOOST_CHECK(SerialEquals(*orig, *seqset));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(s_TestArenaEscapingObject)
+{
+    CRef<CBioseq_set> orig = s_MakeSet(100);
+    for ( auto format : s_Formats ) {
+        string data = s_Write(*orig, format);
+        CRef<CSeq_feat> heap_feat =
+            s_GetFeat(*s_Read(data, format, false), 50, 5);
+
+        // the feature outlives the tree it was read in
+        CRef<CSeq_feat> arena_feat;
+        {{
+            CRef<CBioseq_set> seqset = s_Read(data, format, true);
+            arena_feat = s_GetFeat(*seqset, 50, 5);
+        }}
+        BOOST_CHECK(arena_feat->ReferencedOnlyOnce());
+        BOOST_CHECK(SerialEquals(*heap_feat, *arena_feat));
+
+        // the memory of the dropped tree is not reused for the feature
+        CRef<CBioseq_set> other = s_Read(data, format, true);
+        BOOST_CHECK_EQUAL(arena_feat->GetData().GetRegion(), "region 50");
+        BOOST_CHECK_EQUAL(arena_feat->GetLocation().GetInt().GetFrom(), 50u);
+        BOOST_CHECK(SerialEquals(*heap_feat, *arena_feat));
+        other.Reset();
+
+        // the feature can be modified and dropped on its own
+        arena_feat->SetComment("escaped");
+        BOOST_CHECK(!SerialEquals(*heap_feat, *arena_feat));
+        arena_feat.Reset();
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(s_TestArenaTiming)
+{
+    CRef<CBioseq_set> orig = s_MakeSet(5000);
+    string data = s_Write(*orig, eSerial_AsnBinary);
+    orig.Reset();
+    for ( int arena = 0; arena < 2; ++arena ) {
+        CStopWatch sw(CStopWatch::eStart);
+        CRef<CBioseq_set> seqset = s_Read(data, eSerial_AsnBinary, arena != 0);
+        double parse = sw.Restart();
+        seqset.Reset();
+        double del = sw.Elapsed();
+        LOG_POST((arena? "arena": "heap")
+                 << ": parse=" << parse << "s delete=" << del << "s");
+    }
+}
@@ -981,6 +981,12 @@ double CDataLoader::EstimateLoadSeconds(const CTSE_Chunk_Info& /*chunk*/, Uint4
 }
 
 
+double CDataLoader::EstimateReloadSeconds(const CTSE_Info& /*tse*/, size_t bytes) const
+{
+    return bytes*1e-7+0.001; // same as for chunks
+}
+
+
 unsigned CDataLoader::GetDefaultBlobCacheSizeLimit(void) const
 {
     return kMax_UInt;
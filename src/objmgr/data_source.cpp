@@ -101,6 +101,25 @@ unsigned CDataSource::GetDefaultBlobCacheSizeLimit(void)
 }
 
 
+// Approximate memory footprint of unlocked TSEs kept in cache.
+// If set, TSE cache is limited by this budget instead of OBJMGR_BLOB_CACHE,
+// and memory of loaded TSEs and chunks is estimated for accounting.
+NCBI_PARAM_DECL(Uint8, OBJMGR, BLOB_CACHE_BYTES);
+NCBI_PARAM_DEF_EX(Uint8, OBJMGR, BLOB_CACHE_BYTES, 0,
+                  eParam_NoThread, OBJMGR_BLOB_CACHE_BYTES);
+
+Uint8 CDataSource::GetDefaultBlobCacheByteLimit(void)
+{
+    // read by each new data source, so the budget may be changed at run time
+    return NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::GetDefault();
+}
+
+
+// Number of least recently used TSEs to choose the one to drop from,
+// when TSE cache is limited by bytes
+static const size_t kBlobCacheEvictionWindow = 8;
+
+
 NCBI_PARAM_DECL(bool, OBJMGR, BULK_CHUNKS);
 NCBI_PARAM_DEF_EX(bool, OBJMGR, BULK_CHUNKS, true,
                   eParam_NoThread, OBJMGR_BULK_CHUNKS);
@@ -116,6 +135,12 @@ CDataSource::CDataSource(void)
     : m_DefaultPriority(CObjectManager::kPriority_Entry),
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(GetDefaultBlobCacheSizeLimit()),
+      m_Blob_Cache_Bytes(0),
+      m_Blob_Cache_Bytes_Limit(GetDefaultBlobCacheByteLimit()),
+      m_Blob_Cache_Hits(0),
+      m_Blob_Cache_Insertions(0),
+      m_Blob_Cache_Evictions(0),
+      m_Blob_Cache_Evicted_Bytes(0),
       m_StaticBlobCounter(0),
       m_TrackSplitSeq(false)
 {
@@ -128,9 +153,19 @@ CDataSource::CDataSource(CDataLoader& loader)
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(min(GetDefaultBlobCacheSizeLimit(),
                                   loader.GetDefaultBlobCacheSizeLimit())),
+      m_Blob_Cache_Bytes(0),
+      m_Blob_Cache_Bytes_Limit(GetDefaultBlobCacheByteLimit()),
+      m_Blob_Cache_Hits(0),
+      m_Blob_Cache_Insertions(0),
+      m_Blob_Cache_Evictions(0),
+      m_Blob_Cache_Evicted_Bytes(0),
       m_StaticBlobCounter(0),
       m_TrackSplitSeq(loader.GetTrackSplitSeq())
 {
+    if ( m_Blob_Cache_Bytes_Limit ) {
+        // the byte budget replaces common limit on number of TSEs
+        m_Blob_Cache_Size_Limit = loader.GetDefaultBlobCacheSizeLimit();
+    }
     m_Loader->SetTargetDataSource(*this);
 }
 
@@ -140,6 +175,12 @@ CDataSource::CDataSource(const CObject& shared_object, const CSeq_entry& entry)
       m_DefaultPriority(CObjectManager::kPriority_Entry),
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(GetDefaultBlobCacheSizeLimit()),
+      m_Blob_Cache_Bytes(0),
+      m_Blob_Cache_Bytes_Limit(GetDefaultBlobCacheByteLimit()),
+      m_Blob_Cache_Hits(0),
+      m_Blob_Cache_Insertions(0),
+      m_Blob_Cache_Evictions(0),
+      m_Blob_Cache_Evicted_Bytes(0),
       m_StaticBlobCounter(0),
       m_TrackSplitSeq(false)
 {
@@ -208,6 +249,7 @@ void CDataSource::DropAllTSEs(void)
         m_Blob_Map.clear();
         m_Blob_Cache.clear();
         m_Blob_Cache_Size = 0;
+        m_Blob_Cache_Bytes = 0;
         m_StaticBlobCounter = 0;
     }}
 }
@@ -2324,6 +2366,9 @@ bool CDataSource::IsLoaded(const CTSE_Info& tse) const
 
 void CDataSource::SetLoaded(CTSE_LoadLock& lock)
 {
+    if ( m_Blob_Cache_Bytes_Limit ) {
+        lock->x_SetEstimatedUsedMemory();
+    }
     {{
         TMainLock::TWriteLockGuard guard(m_DSMainLock);
         _ASSERT(lock);
@@ -2368,22 +2413,20 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
         if ( tse->m_CacheState != CTSE_Info::eInCache ) {
             _ASSERT(find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse) ==
                     m_Blob_Cache.end());
-            tse->m_CachePosition = m_Blob_Cache.insert(m_Blob_Cache.end(),tse);
-            m_Blob_Cache_Size += 1;
-            _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
-            tse->m_CacheState = CTSE_Info::eInCache;
+            x_AddToCache(*tse);
         }
         _ASSERT(tse->m_CachePosition ==
                 find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse));
         _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
         
         unsigned cache_size = m_Blob_Cache_Size_Limit;
-        while ( m_Blob_Cache_Size > cache_size ) {
-            CRef<CTSE_Info> del_tse = m_Blob_Cache.front();
-            m_Blob_Cache.pop_front();
-            m_Blob_Cache_Size -= 1;
-            _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
-            del_tse->m_CacheState = CTSE_Info::eNotInCache;
+        while ( m_Blob_Cache_Size > cache_size ||
+                (m_Blob_Cache_Bytes_Limit &&
+                 m_Blob_Cache_Bytes > m_Blob_Cache_Bytes_Limit) ) {
+            CRef<CTSE_Info> del_tse = *x_GetCacheVictim();
+            m_Blob_Cache_Evictions += 1;
+            m_Blob_Cache_Evicted_Bytes += del_tse->m_CacheBytes;
+            x_RemoveFromCache(*del_tse);
             to_delete.push_back(del_tse);
             _VERIFY(DropTSE(*del_tse));
         }
@@ -2391,6 +2434,81 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
 }
 
 
+void CDataSource::x_AddToCache(CTSE_Info& tse)
+{
+    _ASSERT(tse.m_CacheState != CTSE_Info::eInCache);
+    tse.m_CachePosition = m_Blob_Cache.insert(m_Blob_Cache.end(), Ref(&tse));
+    m_Blob_Cache_Size += 1;
+    _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+    tse.m_CacheState = CTSE_Info::eInCache;
+    m_Blob_Cache_Insertions += 1;
+    if ( m_Blob_Cache_Bytes_Limit ) {
+        // TSE contents may change only while it's locked,
+        // so the footprint stays the same until it leaves the cache
+        tse.m_CacheBytes = max(tse.GetUsedMemory(), sizeof(CTSE_Info));
+        tse.m_CacheReloadSeconds =
+            m_Loader->EstimateReloadSeconds(tse, tse.m_CacheBytes);
+        m_Blob_Cache_Bytes += tse.m_CacheBytes;
+    }
+}
+
+
+void CDataSource::x_RemoveFromCache(const CTSE_Info& tse) const
+{
+    _ASSERT(tse.m_CacheState == CTSE_Info::eInCache);
+    _ASSERT(tse.m_CachePosition->GetPointer() == &tse);
+    tse.m_CacheState = CTSE_Info::eNotInCache;
+    m_Blob_Cache.erase(tse.m_CachePosition);
+    m_Blob_Cache_Size -= 1;
+    _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+    _ASSERT(m_Blob_Cache_Bytes >= tse.m_CacheBytes);
+    m_Blob_Cache_Bytes -= tse.m_CacheBytes;
+    tse.m_CacheBytes = 0;
+}
+
+
+CDataSource::TBlob_Cache::iterator CDataSource::x_GetCacheVictim(void)
+{
+    _ASSERT(!m_Blob_Cache.empty());
+    TBlob_Cache::iterator victim = m_Blob_Cache.begin();
+    if ( !m_Blob_Cache_Bytes_Limit ) {
+        // plain LRU
+        return victim;
+    }
+    // Among the least recently used TSEs select the one that is the cheapest
+    // to reload per byte of memory it occupies.  This way a big TSE goes
+    // before several small ones, which are slow to reload because of
+    // request overhead.
+    double victim_cost = (*victim)->m_CacheReloadSeconds/(*victim)->m_CacheBytes;
+    TBlob_Cache::iterator it = victim;
+    for ( size_t i = 1; i < kBlobCacheEvictionWindow; ++i ) {
+        if ( ++it == m_Blob_Cache.end() ) {
+            break;
+        }
+        double cost = (*it)->m_CacheReloadSeconds/(*it)->m_CacheBytes;
+        if ( cost < victim_cost ) {
+            victim = it;
+            victim_cost = cost;
+        }
+    }
+    return victim;
+}
+
+
+void CDataSource::GetBlobCacheStatistics(CObjectManager::SBlobCacheStatistics& stats) const
+{
+    TCacheLock::TWriteLockGuard guard(m_DSCacheLock);
+    stats.m_Count = m_Blob_Cache_Size;
+    stats.m_CountLimit = m_Blob_Cache_Size_Limit;
+    stats.m_Bytes = m_Blob_Cache_Bytes;
+    stats.m_BytesLimit = m_Blob_Cache_Bytes_Limit;
+    stats.m_Hits = m_Blob_Cache_Hits;
+    stats.m_Insertions = m_Blob_Cache_Insertions;
+    stats.m_Evictions = m_Blob_Cache_Evictions;
+    stats.m_EvictedBytes = m_Blob_Cache_Evicted_Bytes;
+}
+
+
 void CDataSource::x_SetLock(CTSE_Lock& lock, CConstRef<CTSE_Info> tse) const
 {
     _ASSERT(!lock);
@@ -2403,12 +2521,8 @@ void CDataSource::x_SetLock(CTSE_Lock& lock, CConstRef<CTSE_Info> tse) const
 
     TCacheLock::TWriteLockGuard guard(m_DSCacheLock);
     if ( tse->m_CacheState == CTSE_Info::eInCache ) {
-        _ASSERT(tse->m_CachePosition ==
-                find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse));
-        tse->m_CacheState = CTSE_Info::eNotInCache;
-        m_Blob_Cache.erase(tse->m_CachePosition);
-        m_Blob_Cache_Size -= 1;
-        _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+        m_Blob_Cache_Hits += 1;
+        x_RemoveFromCache(*tse);
     }
     
     _ASSERT(find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse) ==
@@ -307,6 +307,18 @@ void CObjectManager::GetRegisteredNames(TRegisteredNames& names)
 }
 
 
+void CObjectManager::GetBlobCacheStatistics(TBlobCacheStatistics& stats) const
+{
+    TReadLockGuard guard(m_OM_Lock);
+    ITERATE ( TMapNameToLoader, it, m_mapNameToLoader ) {
+        TMapToSource::const_iterator source = m_mapToSource.find(it->second);
+        if ( source != m_mapToSource.end() ) {
+            source->second->GetBlobCacheStatistics(stats[it->first]);
+        }
+    }
+}
+
+
 // Update loader's options
 void CObjectManager::SetLoaderOptions(const string& loader_name,
                                       EIsDefault    is_default,
@@ -96,6 +96,24 @@ bool CPrefetchBioseq::Execute(CRef<CPrefetchRequest> /*token*/)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CPrefetchBioseqs
+
+CPrefetchBioseqs::CPrefetchBioseqs(const CScopeSource& scope,
+                                   const TIds& ids)
+    : CScopeSource(scope),
+      m_Seq_ids(ids)
+{
+}
+
+
+bool CPrefetchBioseqs::Execute(CRef<CPrefetchRequest> /*token*/)
+{
+    m_Result = GetScope().GetBioseqHandles(GetSeq_ids());
+    return true;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CPrefetchFeat_CI
 
@@ -259,6 +277,32 @@ CBioseq_Handle CStdPrefetch::GetBioseqHandle(CRef<CPrefetchRequest> token)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CStdPrefetch::GetBioseqHandles
+
+CRef<CPrefetchRequest>
+CStdPrefetch::GetBioseqHandles(CPrefetchManager& manager,
+                               const CScopeSource& scope,
+                               const CPrefetchBioseqs::TIds& ids)
+{
+    return manager.AddAction(new CPrefetchBioseqs(scope, ids));
+}
+
+
+CPrefetchBioseqs::TResult
+CStdPrefetch::GetBioseqHandles(CRef<CPrefetchRequest> token)
+{
+    CPrefetchBioseqs* action =
+        dynamic_cast<CPrefetchBioseqs*>(token->GetAction());
+    if ( !action ) {
+        NCBI_THROW(CObjMgrException, eOtherError,
+                   "CStdPrefetch::GetBioseqHandles: wrong token");
+    }
+    Wait(token);
+    return action->GetResult();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CStdPrefetch::GetFeat_CI
 
@@ -379,5 +423,128 @@ CIRef<IPrefetchAction> CPrefetchFeat_CIActionSource::GetNextAction(void)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CPrefetchBioseqBatches
+
+// Queue of finished batches in the order of their completion
+class CPrefetchBioseqBatches::CQueue
+    : public CObject, public IPrefetchListener
+{
+public:
+    CQueue(void)
+        : m_Sema(0, kMax_Int),
+          m_Closed(false)
+        {
+        }
+
+    virtual void PrefetchNotify(CRef<CPrefetchRequest> token, EEvent /*event*/)
+        {
+            if ( !token->IsDone() ) {
+                return;
+            }
+            {{
+                CMutexGuard guard(m_Mutex);
+                if ( m_Closed ) {
+                    return;
+                }
+                m_Done.push_back(token);
+            }}
+            m_Sema.Post();
+        }
+
+    CRef<CPrefetchRequest> WaitNext(void)
+        {
+            m_Sema.Wait();
+            CMutexGuard guard(m_Mutex);
+            _ASSERT(!m_Done.empty());
+            CRef<CPrefetchRequest> ret = m_Done.front();
+            m_Done.pop_front();
+            return ret;
+        }
+
+    // the tokens refer to the queue as their listener,
+    // so the finished ones are released here to break the cycle
+    void Close(void)
+        {
+            CMutexGuard guard(m_Mutex);
+            m_Closed = true;
+            m_Done.clear();
+        }
+
+private:
+    CMutex                          m_Mutex;
+    CSemaphore                      m_Sema;
+    list< CRef<CPrefetchRequest> >  m_Done;
+    bool                            m_Closed;
+};
+
+
+CPrefetchBioseqBatches::CPrefetchBioseqBatches(CPrefetchManager& manager,
+                                               const CScopeSource& scope,
+                                               const TIds& ids,
+                                               size_t batch_size,
+                                               size_t active_batches)
+    : m_Manager(&manager),
+      m_Scope(scope),
+      m_Ids(ids),
+      m_BatchSize(max(batch_size, size_t(1))),
+      m_NextId(0),
+      m_Queue(new CQueue)
+{
+    for ( size_t i = 0; i < max(active_batches, size_t(1)); ++i ) {
+        x_EnqueueNextBatch();
+    }
+}
+
+
+CPrefetchBioseqBatches::~CPrefetchBioseqBatches(void)
+{
+    CMutexGuard guard(m_Mutex);
+    m_Queue->Close();
+    ITERATE ( list< CRef<CPrefetchRequest> >, it, m_ActiveTokens ) {
+        it->GetNCPointer()->RequestToCancel();
+    }
+}
+
+
+void CPrefetchBioseqBatches::x_EnqueueNextBatch(void)
+{
+    if ( m_NextId >= m_Ids.size() ) {
+        return;
+    }
+    size_t end = min(m_NextId + m_BatchSize, m_Ids.size());
+    TIds batch(m_Ids.begin() + m_NextId, m_Ids.begin() + end);
+    m_NextId = end;
+    m_ActiveTokens.push_back(
+        m_Manager->AddAction(new CPrefetchBioseqs(m_Scope, batch),
+                             m_Queue.GetNCPointer()));
+}
+
+
+CRef<CPrefetchRequest> CPrefetchBioseqBatches::GetNextToken(void)
+{
+    CRef<CPrefetchRequest> ret;
+    CMutexGuard guard(m_Mutex);
+    if ( !m_ActiveTokens.empty() ) {
+        ret = m_Queue->WaitNext();
+        m_ActiveTokens.remove(ret);
+        x_EnqueueNextBatch();
+    }
+    return ret;
+}
+
+
+bool CPrefetchBioseqBatches::GetNext(TIds& ids, TBioseqHandles& handles)
+{
+    CRef<CPrefetchRequest> token = GetNextToken();
+    if ( !token ) {
+        return false;
+    }
+    ids = dynamic_cast<CPrefetchBioseqs&>(*token->GetAction()).GetSeq_ids();
+    handles = CStdPrefetch::GetBioseqHandles(token);
+    return true;
+}
+
+
 END_SCOPE(objects)
 END_NCBI_SCOPE
@@ -45,7 +45,12 @@
 #include <objmgr/graph_ci.hpp>
 #include <objmgr/seq_table_ci.hpp>
 #include <objmgr/annot_ci.hpp>
+#include <objmgr/prefetch_actions.hpp>
 #include <objmgr/impl/synonyms.hpp>
+#include <objmgr/impl/data_source.hpp>
+#include <objmgr/impl/tse_info.hpp>
+#include <objmgr/impl/tse_loadlock.hpp>
+#include <objmgr/data_loader.hpp>
 
 #include <objects/general/general__.hpp>
 #include <objects/seqfeat/seqfeat__.hpp>
@@ -893,6 +898,42 @@ BOOST_AUTO_TEST_CASE(TestReResolveMT4)
         BOOST_REQUIRE_EQUAL(c, total_feats);
     }
 }
+
+
+BOOST_AUTO_TEST_CASE(PrefetchBioseqBatches)
+{
+    const size_t COUNT = 50;
+    const size_t MISSING = 10;
+    CScope scope(*CObjectManager::GetInstance());
+    vector<CSeq_id_Handle> ids;
+    for ( size_t i = 0; i < COUNT+MISSING; ++i ) {
+        if ( i < COUNT ) {
+            scope.AddTopLevelSeqEntry(*s_GetEntry(i));
+        }
+        ids.push_back(CSeq_id_Handle::GetHandle(*s_GetId(i)));
+    }
+    CRef<CPrefetchManager> manager(new CPrefetchManager(3));
+    CPrefetchBioseqBatches batches(*manager, CScopeSource::New(scope),
+                                   ids, 7, 3);
+    set<CSeq_id_Handle> seen;
+    size_t found = 0;
+    CPrefetchBioseqBatches::TIds batch_ids;
+    CPrefetchBioseqBatches::TBioseqHandles handles;
+    while ( batches.GetNext(batch_ids, handles) ) {
+        BOOST_REQUIRE_EQUAL(batch_ids.size(), handles.size());
+        BOOST_CHECK(batch_ids.size() <= 7);
+        for ( size_t i = 0; i < batch_ids.size(); ++i ) {
+            BOOST_CHECK(seen.insert(batch_ids[i]).second);
+            if ( handles[i] ) {
+                BOOST_CHECK(handles[i].IsSynonym(batch_ids[i]));
+                ++found;
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL(seen.size(), COUNT+MISSING);
+    BOOST_CHECK_EQUAL(found, COUNT);
+    BOOST_CHECK(!batches.GetNextToken());
+}
 #endif // NCBI_THREADS
 
 BOOST_AUTO_TEST_CASE(CppIterFeat)
@@ -1259,3 +1300,212 @@ BOOST_AUTO_TEST_CASE(AddSeqIdHistory)
     }}
     SetDiagPostLevel(old_level);
 }
+
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+NCBI_PARAM_DECL(Uint8, OBJMGR, BLOB_CACHE_BYTES);
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+
+// TSEs with index 100 and above are big, each next one is a bit smaller
+static const size_t kFirstBigBlob = 100;
+static const TSeqPos kSmallBlobLength = 100;
+static const TSeqPos kBigBlobLength = 1000000;
+
+
+static TSeqPos s_GetBlobCacheTestLength(size_t i)
+{
+    if ( i < kFirstBigBlob ) {
+        return kSmallBlobLength;
+    }
+    return kBigBlobLength - TSeqPos(i-kFirstBigBlob)*(kBigBlobLength/5);
+}
+
+
+// Loads TSE with entry s_GetEntry(i) by its gi, counting the loads
+class CBlobCacheTestLoader : public CDataLoader
+{
+public:
+    typedef SRegisterLoaderInfo<CBlobCacheTestLoader> TRegisterLoaderInfo;
+    static TRegisterLoaderInfo RegisterInObjectManager(CObjectManager& om,
+                                                       const string& loader_name)
+        {
+            CParamLoaderMaker<CBlobCacheTestLoader, string> maker(loader_name);
+            CDataLoader::RegisterInObjectManager(om, maker,
+                                                 CObjectManager::eNonDefault,
+                                                 CObjectManager::kPriority_Default);
+            return maker.GetRegisterInfo();
+        }
+    static string GetLoaderNameFromArgs(const string& loader_name)
+        {
+            return loader_name;
+        }
+
+    CBlobCacheTestLoader(const string& loader_name, const string& /*param*/)
+        : CDataLoader(loader_name),
+          m_LoadCount(0)
+        {
+        }
+
+    virtual TTSE_LockSet GetRecords(const CSeq_id_Handle& idh,
+                                    EChoice /*choice*/)
+        {
+            TTSE_LockSet locks;
+            if ( !idh.IsGi() ) {
+                return locks;
+            }
+            size_t i = size_t(GI_TO(TIntId, idh.GetGi())-1);
+            TBlobId blob_id(new CBlobIdSeq_id(idh));
+            CTSE_LoadLock lock = GetDataSource()->GetTSE_LoadLock(blob_id);
+            if ( !lock.IsLoaded() ) {
+                ++m_LoadCount;
+                lock->SetSeq_entry(*s_GetEntry(i, s_GetBlobCacheTestLength(i)));
+                lock.SetLoaded();
+            }
+            locks.insert(lock);
+            return locks;
+        }
+
+    size_t GetLoadCount(void) const
+        {
+            return m_LoadCount;
+        }
+
+private:
+    size_t m_LoadCount;
+};
+
+
+// lock TSE i in a temporary scope, it goes to the cache after that
+static void s_AccessBlob(const string& loader_name, size_t i)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    scope.AddDataLoader(loader_name);
+    BOOST_CHECK(scope.GetBioseqHandle(*s_GetId(i)));
+}
+
+
+static CObjectManager::SBlobCacheStatistics
+s_GetBlobCacheStatistics(const string& loader_name)
+{
+    CObjectManager::TBlobCacheStatistics stats;
+    CObjectManager::GetInstance()->GetBlobCacheStatistics(stats);
+    BOOST_REQUIRE(stats.count(loader_name));
+    const CObjectManager::SBlobCacheStatistics& ret = stats[loader_name];
+    if ( ret.m_BytesLimit ) {
+        BOOST_CHECK_LE(ret.m_Bytes, ret.m_BytesLimit);
+    }
+    BOOST_CHECK_LE(ret.m_Count, ret.m_CountLimit);
+    return ret;
+}
+
+
+BOOST_AUTO_TEST_CASE(BlobCacheBytes)
+{
+    const string kLoaderName = "BlobCacheBytesTestLoader";
+    const Uint8 kBudget = kBigBlobLength*3/2;
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    // the budget is applied when the data source is created
+    Uint8 saved_budget = NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::GetDefault();
+    NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::SetDefault(kBudget);
+    CBlobCacheTestLoader* loader =
+        CBlobCacheTestLoader::RegisterInObjectManager(*om, kLoaderName).GetLoader();
+    NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::SetDefault(saved_budget);
+    BOOST_REQUIRE(loader);
+
+    // three small TSEs and a big one fit in the budget
+    for ( size_t i = 0; i < 3; ++i ) {
+        s_AccessBlob(kLoaderName, i);
+    }
+    s_AccessBlob(kLoaderName, kFirstBigBlob);
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), 4u);
+    CObjectManager::SBlobCacheStatistics stats =
+        s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_BytesLimit, kBudget);
+    BOOST_CHECK_EQUAL(stats.m_Count, 4u);
+    BOOST_CHECK_GE(stats.m_Bytes, kBigBlobLength);
+    BOOST_CHECK_EQUAL(stats.m_Insertions, 4u);
+    BOOST_CHECK_EQUAL(stats.m_Evictions, 0u);
+    BOOST_CHECK_EQUAL(stats.m_Hits, 0u);
+
+    // the second big TSE exceeds the budget, and the first big one is
+    // dropped although the small ones were used before it
+    s_AccessBlob(kLoaderName, kFirstBigBlob+1);
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), 5u);
+    stats = s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_Count, 4u);
+    BOOST_CHECK_EQUAL(stats.m_Insertions, 5u);
+    BOOST_CHECK_EQUAL(stats.m_Evictions, 1u);
+    BOOST_CHECK_GE(stats.m_EvictedBytes, kBigBlobLength);
+    BOOST_CHECK_LT(stats.m_EvictedBytes, kBudget);
+    BOOST_CHECK_LT(stats.m_Bytes, kBigBlobLength);
+
+    // small TSEs are still in the cache
+    for ( size_t i = 0; i < 3; ++i ) {
+        s_AccessBlob(kLoaderName, i);
+    }
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), 5u);
+    stats = s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_Hits, 3u);
+    BOOST_CHECK_EQUAL(stats.m_Evictions, 1u);
+
+    // the dropped TSE is loaded again, one of the big TSEs goes again
+    s_AccessBlob(kLoaderName, kFirstBigBlob);
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), 6u);
+    stats = s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_Count, 4u);
+    BOOST_CHECK_EQUAL(stats.m_Insertions, 9u);
+    BOOST_CHECK_EQUAL(stats.m_Evictions, 2u);
+    BOOST_CHECK_GE(stats.m_EvictedBytes, 2*kBigBlobLength-kBigBlobLength/5);
+    for ( size_t i = 0; i < 3; ++i ) {
+        s_AccessBlob(kLoaderName, i);
+    }
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), 6u);
+
+    om->RevokeDataLoader(kLoaderName);
+}
+
+
+BOOST_AUTO_TEST_CASE(BlobCacheCount)
+{
+    const string kLoaderName = "BlobCacheCountTestLoader";
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    Uint8 saved_budget = NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::GetDefault();
+    NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::SetDefault(0);
+    CBlobCacheTestLoader* loader =
+        CBlobCacheTestLoader::RegisterInObjectManager(*om, kLoaderName).GetLoader();
+    NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)::SetDefault(saved_budget);
+    BOOST_REQUIRE(loader);
+
+    CObjectManager::SBlobCacheStatistics stats =
+        s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_BytesLimit, 0u);
+    BOOST_CHECK_EQUAL(stats.m_CountLimit, CDataSource::GetDefaultBlobCacheSizeLimit());
+    const size_t kLimit = stats.m_CountLimit;
+    BOOST_REQUIRE(kLimit > 0 && kLimit < kFirstBigBlob-2);
+
+    // plain LRU by number of TSEs, sizes are not accounted
+    s_AccessBlob(kLoaderName, kFirstBigBlob);
+    for ( size_t i = 0; i < kLimit+1; ++i ) {
+        s_AccessBlob(kLoaderName, i);
+    }
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), kLimit+2);
+    stats = s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_Count, kLimit);
+    BOOST_CHECK_EQUAL(stats.m_Bytes, 0u);
+    BOOST_CHECK_EQUAL(stats.m_Insertions, kLimit+2);
+    BOOST_CHECK_EQUAL(stats.m_Evictions, 2u);
+    BOOST_CHECK_EQUAL(stats.m_EvictedBytes, 0u);
+
+    // the least recently used TSEs were dropped
+    s_AccessBlob(kLoaderName, kLimit);
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), kLimit+2);
+    s_AccessBlob(kLoaderName, 0);
+    BOOST_CHECK_EQUAL(loader->GetLoadCount(), kLimit+3);
+    stats = s_GetBlobCacheStatistics(kLoaderName);
+    BOOST_CHECK_EQUAL(stats.m_Hits, 1u);
+
+    om->RevokeDataLoader(kLoaderName);
+}
@@ -44,6 +44,8 @@
 #include <objmgr/impl/annot_object.hpp>
 #include <objmgr/impl/annot_type_index.hpp>
 #include <objects/seq/Seq_literal.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seqalign/Seq_align.hpp>
 #include <objmgr/seq_map.hpp>
 #include <algorithm>
 #include <objmgr/error_codes.hpp>
@@ -68,6 +70,8 @@ CTSE_Chunk_Info::CTSE_Chunk_Info(TChunkId id)
       m_ChunkId(id),
       m_LoadBytes(0),
       m_LoadSeconds(0),
+      m_UsedMemory(0),
+      m_EstimatedMemory(0),
       m_ExplicitFeatIds(false)
 {
 }
@@ -283,6 +287,10 @@ void CTSE_Chunk_Info::SetLoaded(CObject* obj)
     if ( !obj ) {
         obj = new CObject;
     }
+    if ( !m_UsedMemory && m_EstimatedMemory && x_Attached() ) {
+        // data loader didn't account memory of the chunk
+        m_SplitInfo->x_AddUsedMemory(m_EstimatedMemory);
+    }
     {{
         CMutexGuard guard(m_ListenerMutex);
         if ( m_LoadListener ) {
@@ -725,6 +733,9 @@ void CTSE_Chunk_Info::x_LoadDescr(const TPlace& place,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    if ( CDataSource::GetDefaultBlobCacheByteLimit() ) {
+        m_EstimatedMemory += CTSE_Info::EstimateUsedMemory(descr);
+    }
     m_SplitInfo->x_LoadDescr(place, descr);
 }
 
@@ -734,6 +745,9 @@ void CTSE_Chunk_Info::x_LoadAnnot(const TPlace& place,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    if ( CDataSource::GetDefaultBlobCacheByteLimit() ) {
+        m_EstimatedMemory += CTSE_Info::EstimateUsedMemory(annot);
+    }
     m_SplitInfo->x_LoadAnnot(place, annot, GetChunkId());
 }
 
@@ -754,6 +768,11 @@ void CTSE_Chunk_Info::x_LoadBioseqs(const TPlace& place,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    if ( CDataSource::GetDefaultBlobCacheByteLimit() ) {
+        ITERATE ( list< CRef<CBioseq> >, it, bioseqs ) {
+            m_EstimatedMemory += CTSE_Info::EstimateUsedMemory(**it);
+        }
+    }
     m_SplitInfo->x_LoadBioseqs(place, bioseqs, GetChunkId());
 }
 
@@ -763,6 +782,11 @@ void CTSE_Chunk_Info::x_LoadSequence(const TPlace& place, TSeqPos pos,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    if ( CDataSource::GetDefaultBlobCacheByteLimit() ) {
+        ITERATE ( TSequence, it, sequence ) {
+            m_EstimatedMemory += CTSE_Info::EstimateUsedMemory(**it);
+        }
+    }
     m_SplitInfo->x_LoadSequence(place, pos, sequence);
 }
 
@@ -772,6 +796,11 @@ void CTSE_Chunk_Info::x_LoadAssembly(const TBioseqId& seq_id,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    if ( CDataSource::GetDefaultBlobCacheByteLimit() ) {
+        ITERATE ( TAssembly, it, assembly ) {
+            m_EstimatedMemory += CTSE_Info::EstimateUsedMemory(**it);
+        }
+    }
     m_SplitInfo->x_LoadAssembly(seq_id, assembly);
 }
 
@@ -781,6 +810,9 @@ void CTSE_Chunk_Info::x_LoadSeq_entry(CSeq_entry& entry,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    if ( CDataSource::GetDefaultBlobCacheByteLimit() ) {
+        m_EstimatedMemory += CTSE_Info::EstimateUsedMemory(entry);
+    }
     m_SplitInfo->x_LoadSeq_entry(entry, set_info);
 }
 
@@ -788,6 +820,7 @@ void CTSE_Chunk_Info::x_LoadSeq_entry(CSeq_entry& entry,
 void CTSE_Chunk_Info::x_AddUsedMemory(size_t size)
 {
     _ASSERT(x_Attached());
+    m_UsedMemory += size;
     m_SplitInfo->x_AddUsedMemory(size);
 }
 
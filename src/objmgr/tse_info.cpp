@@ -47,6 +47,24 @@
 #include <objmgr/impl/handle_range_map.hpp>
 
 #include <objects/seqset/Seq_entry.hpp>
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_ext.hpp>
+#include <objects/seq/Delta_ext.hpp>
+#include <objects/seq/Delta_seq.hpp>
+#include <objects/seq/Seq_literal.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seqres/Seq_graph.hpp>
+#include <objects/seqres/Real_graph.hpp>
+#include <objects/seqres/Int_graph.hpp>
+#include <objects/seqres/Byte_graph.hpp>
+#include <objects/seqtable/Seq_table.hpp>
+#include <objects/seqalign/Seq_align.hpp>
+#include <objects/seqalign/Seq_align_set.hpp>
+#include <objects/seqalign/Dense_seg.hpp>
 #include <objects/submit/Seq_submit.hpp>
 
 #include <objmgr/objmgr_exception.hpp>
@@ -295,6 +313,8 @@ void CTSE_Info::x_Initialize(void)
     m_UsedMemory = 0;
     m_LoadState = eNotLoaded;
     m_CacheState = eNotInCache;
+    m_CacheBytes = 0;
+    m_CacheReloadSeconds = 0;
     m_AnnotIdsFlags = 0;
 }
 
@@ -348,6 +368,184 @@ void CTSE_Info::AddUsedMemory(size_t size)
 }
 
 
+// Rough sizes of objects with their object manager infos and indexes
+static const size_t kEstimatedBioseqBytes  = 1000;
+static const size_t kEstimatedSetBytes     = 300;
+static const size_t kEstimatedDescBytes    = 200;
+static const size_t kEstimatedAnnotBytes   = 300;
+static const size_t kEstimatedFeatBytes    = 500;
+static const size_t kEstimatedAlignBytes   = 400;
+static const size_t kEstimatedGraphBytes   = 300;
+static const size_t kEstimatedLiteralBytes = 100;
+static const size_t kEstimatedCellBytes    = 16;
+
+
+static size_t s_EstimateUsedMemory(const CSeq_data& data)
+{
+    switch ( data.Which() ) {
+    case CSeq_data::e_Iupacna:
+        return data.GetIupacna().Get().size();
+    case CSeq_data::e_Iupacaa:
+        return data.GetIupacaa().Get().size();
+    case CSeq_data::e_Ncbi2na:
+        return data.GetNcbi2na().Get().size();
+    case CSeq_data::e_Ncbi4na:
+        return data.GetNcbi4na().Get().size();
+    case CSeq_data::e_Ncbi8na:
+        return data.GetNcbi8na().Get().size();
+    case CSeq_data::e_Ncbipna:
+        return data.GetNcbipna().Get().size();
+    case CSeq_data::e_Ncbi8aa:
+        return data.GetNcbi8aa().Get().size();
+    case CSeq_data::e_Ncbieaa:
+        return data.GetNcbieaa().Get().size();
+    case CSeq_data::e_Ncbipaa:
+        return data.GetNcbipaa().Get().size();
+    case CSeq_data::e_Ncbistdaa:
+        return data.GetNcbistdaa().Get().size();
+    default:
+        return 0;
+    }
+}
+
+
+size_t CTSE_Info::EstimateUsedMemory(const CSeq_literal& literal)
+{
+    size_t size = kEstimatedLiteralBytes;
+    if ( literal.IsSetSeq_data() ) {
+        size += s_EstimateUsedMemory(literal.GetSeq_data());
+    }
+    return size;
+}
+
+
+size_t CTSE_Info::EstimateUsedMemory(const CSeq_align& align)
+{
+    size_t size = kEstimatedAlignBytes;
+    const CSeq_align::TSegs& segs = align.GetSegs();
+    if ( segs.IsDenseg() ) {
+        const CDense_seg& denseg = segs.GetDenseg();
+        size += denseg.GetStarts().size()*sizeof(TSignedSeqPos) +
+            denseg.GetLens().size()*sizeof(TSeqPos);
+    }
+    else if ( segs.IsDisc() ) {
+        ITERATE ( CSeq_align_set::Tdata, it, segs.GetDisc().Get() ) {
+            size += EstimateUsedMemory(**it);
+        }
+    }
+    return size;
+}
+
+
+size_t CTSE_Info::EstimateUsedMemory(const CSeq_descr& descr)
+{
+    return descr.Get().size()*kEstimatedDescBytes;
+}
+
+
+size_t CTSE_Info::EstimateUsedMemory(const CSeq_annot& annot)
+{
+    size_t size = kEstimatedAnnotBytes;
+    if ( !annot.IsSetData() ) {
+        return size;
+    }
+    const CSeq_annot::TData& data = annot.GetData();
+    switch ( data.Which() ) {
+    case CSeq_annot::TData::e_Ftable:
+        size += data.GetFtable().size()*kEstimatedFeatBytes;
+        break;
+    case CSeq_annot::TData::e_Align:
+        ITERATE ( CSeq_annot::TData::TAlign, it, data.GetAlign() ) {
+            size += EstimateUsedMemory(**it);
+        }
+        break;
+    case CSeq_annot::TData::e_Graph:
+        ITERATE ( CSeq_annot::TData::TGraph, it, data.GetGraph() ) {
+            const CSeq_graph::TGraph& graph = (*it)->GetGraph();
+            size += kEstimatedGraphBytes;
+            if ( graph.IsReal() ) {
+                size += graph.GetReal().GetValues().size()*sizeof(double);
+            }
+            else if ( graph.IsInt() ) {
+                size += graph.GetInt().GetValues().size()*sizeof(int);
+            }
+            else if ( graph.IsByte() ) {
+                size += graph.GetByte().GetValues().size();
+            }
+        }
+        break;
+    case CSeq_annot::TData::e_Seq_table:
+    {
+        const CSeq_table& table = data.GetSeq_table();
+        size += table.GetColumns().size()*size_t(table.GetNum_rows())*
+            kEstimatedCellBytes;
+        break;
+    }
+    default:
+        break;
+    }
+    return size;
+}
+
+
+size_t CTSE_Info::EstimateUsedMemory(const CBioseq& seq)
+{
+    size_t size = kEstimatedBioseqBytes;
+    if ( seq.IsSetDescr() ) {
+        size += EstimateUsedMemory(seq.GetDescr());
+    }
+    ITERATE ( CBioseq::TAnnot, it, seq.GetAnnot() ) {
+        size += EstimateUsedMemory(**it);
+    }
+    const CSeq_inst& inst = seq.GetInst();
+    if ( inst.IsSetSeq_data() ) {
+        size += s_EstimateUsedMemory(inst.GetSeq_data());
+    }
+    if ( inst.IsSetExt() && inst.GetExt().IsDelta() ) {
+        ITERATE ( CDelta_ext::Tdata, it, inst.GetExt().GetDelta().Get() ) {
+            if ( (*it)->IsLiteral() ) {
+                size += EstimateUsedMemory((*it)->GetLiteral());
+            }
+            else {
+                size += kEstimatedLiteralBytes;
+            }
+        }
+    }
+    return size;
+}
+
+
+size_t CTSE_Info::EstimateUsedMemory(const CSeq_entry& entry)
+{
+    if ( entry.IsSeq() ) {
+        return EstimateUsedMemory(entry.GetSeq());
+    }
+    if ( !entry.IsSet() ) {
+        return 0;
+    }
+    const CBioseq_set& seq_set = entry.GetSet();
+    size_t size = kEstimatedSetBytes;
+    if ( seq_set.IsSetDescr() ) {
+        size += EstimateUsedMemory(seq_set.GetDescr());
+    }
+    ITERATE ( CBioseq_set::TAnnot, it, seq_set.GetAnnot() ) {
+        size += EstimateUsedMemory(**it);
+    }
+    ITERATE ( CBioseq_set::TSeq_set, it, seq_set.GetSeq_set() ) {
+        size += EstimateUsedMemory(**it);
+    }
+    return size;
+}
+
+
+void CTSE_Info::x_SetEstimatedUsedMemory(void)
+{
+    if ( !m_UsedMemory && m_Object ) {
+        m_UsedMemory = EstimateUsedMemory(*m_Object);
+    }
+}
+
+
 void CTSE_Info::SetSeq_entry(CSeq_entry& entry, CTSE_SetObjectInfo* set_info)
 {
     if ( m_Which != CSeq_entry::e_not_set ) {
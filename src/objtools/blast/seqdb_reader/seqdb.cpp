@@ -567,6 +567,42 @@ void CSeqDB::RetAmbigSeq(const char ** buffer) const
     //m_Impl->Verify();
 }
 
+void CSeqDB::GetSequenceBatch(int              begin_oid,
+                              int              end_oid,
+                              SSequenceBatch & batch,
+                              EBatchEncoding   encoding,
+                              int              threads) const
+{
+    // Ask for the next range together with this one: the pages of this
+    // range were normally advised by the previous call already, and the
+    // next range gets read while this batch is being processed.
+    int next_end = end_oid + min(end_oid - begin_oid,
+                                 m_Impl->GetNumOIDs() - end_oid);
+    m_Impl->AdviseSequences(begin_oid, next_end);
+
+    vector<int> oids;
+    for (int oid = begin_oid; oid < end_oid; oid++) {
+        if ( !m_Impl->CheckOrFindOID(oid)  ||  oid >= end_oid ) {
+            break;
+        }
+        oids.push_back(oid);
+    }
+    m_Impl->GetSequenceBatch(oids, batch, encoding, threads);
+}
+
+void CSeqDB::GetSequenceBatch(const vector<int> & oids,
+                              SSequenceBatch    & batch,
+                              EBatchEncoding      encoding,
+                              int                 threads) const
+{
+    m_Impl->GetSequenceBatch(oids, batch, encoding, threads);
+}
+
+void CSeqDB::AdviseSequences(int begin_oid, int end_oid) const
+{
+    m_Impl->AdviseSequences(begin_oid, end_oid);
+}
+
 int CSeqDB::GetAmbigSeq(int           oid,
                         const char ** buffer,
                         int           nucl_code,
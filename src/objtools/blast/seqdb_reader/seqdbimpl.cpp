@@ -35,6 +35,7 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <thread>
 #include <serial/enumvalues.hpp>
 #include <serial/objistr.hpp>
 #include <serial/objistrasnb.hpp>
@@ -653,6 +654,118 @@ void CSeqDBImpl::RetAmbigSeq(const char ** buffer) const
     *buffer = 0;
 }
 
+void CSeqDBImpl::GetSequenceBatch(const vector<int>        & oids,
+                                  CSeqDB::SSequenceBatch   & batch,
+                                  CSeqDB::EBatchEncoding     encoding,
+                                  int                        threads) const
+{
+    CHECK_MARKER();
+
+    size_t num_seqs = oids.size();
+    batch.clear();
+    batch.encoding = encoding;
+    batch.oids     = oids;
+    batch.lengths.resize(num_seqs);
+    batch.offsets.resize(num_seqs + 1);
+
+    // Locate all sequences first; the raw data is only a pointer into
+    // the memory mapped sequence file, so this is cheap and gives the
+    // layout of the packed buffer.
+
+    bool packed_nucl = (encoding == CSeqDB::eBatch_Raw && m_SeqType == 'n');
+    vector<const CSeqDBVol *> vols(num_seqs);
+    vector<int>               vol_oids(num_seqs);
+    vector<const char *>      raw(num_seqs);
+    size_t                    total = 0;
+
+    for (size_t i = 0; i < num_seqs; i++) {
+        vols[i] = m_VolSet.FindVol(oids[i], vol_oids[i]);
+        if ( !vols[i] ) {
+            NCBI_THROW(CSeqDBException, eArgErr, CSeqDB::kOidNotFound);
+        }
+        int length = vols[i]->GetSequence(vol_oids[i], &raw[i]);
+        if (length < 0) {
+            NCBI_THROW(CSeqDBException, eFileErr,
+                       "Error: could not get sequence.");
+        }
+        batch.lengths[i] = length;
+        batch.offsets[i] = total;
+        total += packed_nucl ? (length + 3) / 4 : length;
+    }
+    batch.offsets[num_seqs] = total;
+    batch.data.resize(total);
+
+    int nucl_code = (encoding == CSeqDB::eBatch_BlastNA8)
+        ? kSeqDBNuclBlastNA8 : kSeqDBNuclNcbiNA8;
+    bool copy_raw = (encoding == CSeqDB::eBatch_Raw || m_SeqType == 'p');
+
+    auto fill = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            char * dst = batch.data.data() + batch.offsets[i];
+            if (copy_raw) {
+                memcpy(dst, raw[i], batch.offsets[i+1] - batch.offsets[i]);
+            } else {
+                vols[i]->GetAmbigSeqInto(vol_oids[i], dst, nucl_code);
+            }
+        }
+    };
+
+    // Split the work by the amount of data rather than by the number of
+    // sequences, so one thread does not get all the long ones.
+
+    size_t num_threads = min(size_t(max(threads, 1)), num_seqs);
+    if (num_threads <= 1) {
+        fill(0, num_seqs);
+        return;
+    }
+
+    vector<thread>        workers;
+    vector<exception_ptr> errors(num_threads);
+    size_t first = 0;
+    for (size_t t = 0; t < num_threads; t++) {
+        size_t last = num_seqs;
+        if (t + 1 < num_threads) {
+            last = lower_bound(batch.offsets.begin() + first,
+                               batch.offsets.end() - 1,
+                               total * (t + 1) / num_threads)
+                - batch.offsets.begin();
+        }
+        workers.emplace_back([&fill, &errors, t, first, last]() {
+            try {
+                fill(first, last);
+            }
+            catch (...) {
+                errors[t] = current_exception();
+            }
+        });
+        first = last;
+    }
+    for (thread & worker : workers) {
+        worker.join();
+    }
+    for (exception_ptr & error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+}
+
+void CSeqDBImpl::AdviseSequences(int begin_oid, int end_oid) const
+{
+    CHECK_MARKER();
+
+    for (int i = 0; i < m_VolSet.GetNumVols(); i++) {
+        const CSeqDBVolEntry * entry = m_VolSet.GetVolEntry(i);
+        int begin = max(begin_oid, entry->OIDStart());
+        int end   = min(end_oid,   entry->OIDEnd());
+
+        if (begin < end) {
+            entry->Vol()->AdviseSequences(begin - entry->OIDStart(),
+                                          end   - entry->OIDStart());
+        }
+    }
+}
+
 void CSeqDBImpl::x_RetSeqBuffer(SSeqResBuffer * buffer) const
 {
     // client must return sequence before getting a new one
@@ -420,6 +420,32 @@ public:
     ///   A pointer to the sequence data to release.
     void RetAmbigSeq(const char ** buffer) const;
 
+    /// Get the sequences of a list of OIDs packed into one buffer.
+    ///
+    /// The sequences are located first, then copied or decoded into
+    /// the buffer, using up to the given number of threads.
+    ///
+    /// @param oids
+    ///   The OIDs of the sequences to retrieve.
+    /// @param batch
+    ///   The retrieved sequences.
+    /// @param encoding
+    ///   The encoding of the returned sequence data.
+    /// @param threads
+    ///   Number of threads used to copy or decode the sequences.
+    void GetSequenceBatch(const vector<int>        & oids,
+                          CSeqDB::SSequenceBatch   & batch,
+                          CSeqDB::EBatchEncoding     encoding,
+                          int                        threads) const;
+
+    /// Advise that the sequence data of an OID range will be needed soon.
+    ///
+    /// @param begin_oid
+    ///   The first OID of the range.
+    /// @param end_oid
+    ///   The OID after the end of the range.
+    void AdviseSequences(int begin_oid, int end_oid) const;
+
     /// Gets a list of sequence identifiers.
     ///
     /// This returns the list of CSeq_id identifiers associated with
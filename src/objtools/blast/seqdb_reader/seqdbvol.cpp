@@ -43,6 +43,7 @@
 #include <serial/objostrasnb.hpp>
 #include <serial/serial.hpp>
 #include <corelib/ncbimtx.hpp>
+#include <corelib/ncbi_system.hpp>
 #include <corelib/ncbi_safe_static.hpp>
 
 #include <sstream>
@@ -1596,6 +1597,54 @@ int CSeqDBVol::GetAmbigPartialSeq(int                oid,
     return base_length;
 }
 
+int CSeqDBVol::GetAmbigSeqInto(int oid, char * buffer, int nucl_code) const
+{
+    const char * tmp(0);
+    int base_length = x_GetSequence(oid, &tmp);
+
+    if (base_length < 0)
+        NCBI_THROW(CSeqDBException, eFileErr, "Error: could not get sequence.");
+
+    if (m_Idx->GetSeqType() == 'p') {
+        memcpy(buffer, tmp, base_length);
+    } else if (base_length > 0) {
+        SSeqDBSlice range(0, base_length);
+        vector<Int4> ambchars;
+        x_GetAmbChar(oid, ambchars);
+
+        s_SeqDBMapNA2ToNA8(tmp, buffer, range);
+        s_SeqDBRebuildDNA_NA8(buffer, ambchars, range);
+        if (nucl_code == kSeqDBNuclBlastNA8) {
+            s_SeqDBMapNcbiNA8ToBlastNA8(buffer, range);
+        }
+    }
+    return base_length;
+}
+
+void CSeqDBVol::AdviseSequences(int begin_oid, int end_oid) const
+{
+    if (!m_SeqFileOpened) x_OpenSeqFile();
+
+    end_oid = min(end_oid, m_Idx->GetNumOIDs());
+    if (begin_oid < 0 || begin_oid >= end_oid || m_Seq.Empty()) return;
+
+    // The sequence offsets array has an entry for the end of the last
+    // sequence, and the ambiguity data of a nucleotide sequence lies
+    // between its sequence data and the start of the next sequence.
+    TIndx start_offset = 0;
+    TIndx end_offset   = 0;
+    m_Idx->GetSeqStart(begin_oid, start_offset);
+    m_Idx->GetSeqStart(end_oid,   end_offset);
+    if (end_offset <= start_offset) return;
+
+    static const size_t kPageSize = CSystemInfo::GetVirtualMemoryPageSize();
+    const char * begin = m_Seq->GetFileDataPtr(start_offset);
+    const char * end   = begin + (end_offset - start_offset);
+    const char * page  = begin - (reinterpret_cast<size_t>(begin) % kPageSize);
+
+    MemoryAdvise(const_cast<char *>(page), end - page, eMADV_WillNeed);
+}
+
 
 
 
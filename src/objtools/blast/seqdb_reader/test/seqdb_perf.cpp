@@ -105,6 +105,11 @@ private:
     /// Processes all requests except printing the BLAST database information
     /// @return 0 on success; 1 if some sequences were not retrieved
     int x_ScanDatabase();
+
+    /// Scans the whole database in batches of OIDs with
+    /// CSeqDB::GetSequenceBatch
+    /// @return 0 on success; 1 if some sequences were not retrieved
+    int x_ScanDatabaseBatches();
 };
 
 void
@@ -184,6 +189,54 @@ CSeqDBPerfApp::x_ScanDatabase()
     return 0;
 }
 
+int
+CSeqDBPerfApp::x_ScanDatabaseBatches()
+{
+    CStopWatch sw;
+    sw.Start();
+    const CArgs& args = GetArgs();
+    const int kBatchSize = args["batch_size"].AsInteger();
+    const int kNumThreads = max(args["num_threads"].AsInteger(), 1);
+    const CSeqDB::EBatchEncoding kEncoding = args["scan_uncompressed"]
+        ? CSeqDB::eBatch_BlastNA8 : CSeqDB::eBatch_Raw;
+
+    CSeqDB::SSequenceBatch batch;
+    Uint8 num_seqs = 0;
+    Uint8 num_letters = 0;
+    Uint8 num_bytes = 0;
+    Uint8 checksum = 0;
+    const int kNumOids = m_BlastDb->GetNumOIDs();
+    for (int oid = 0; oid < kNumOids; oid += kBatchSize) {
+        m_BlastDb->GetSequenceBatch(oid, min(oid + kBatchSize, kNumOids),
+                                    batch, kEncoding, kNumThreads);
+        for (size_t i = 0; i < batch.size(); i++) {
+            num_letters += batch.lengths[i];
+        }
+        for (char c : batch.data) {
+            checksum += (unsigned char)c;
+        }
+        num_seqs += batch.size();
+        num_bytes += batch.data.size();
+    }
+    x_UpdateMemoryUsage();
+
+    sw.Stop();
+    double elapsed = max(sw.Elapsed(), 1e-9);
+    LOG_POST(Info << "Went over " << num_seqs << " sequences, checksum "
+             << checksum);
+    cout << "Scanning rate: "
+         << NStr::NumericToString(static_cast<Uint8>(num_letters / elapsed),
+                                  NStr::fWithCommas)
+         << " bases/second, "
+         << NStr::NumericToString(static_cast<Uint8>(num_bytes / elapsed),
+                                  NStr::fWithCommas)
+         << " bytes/second, "
+         << NStr::NumericToString(static_cast<Uint8>(num_seqs / elapsed),
+                                  NStr::fWithCommas)
+         << " sequences/second" << endl;
+    return num_seqs == static_cast<Uint8>(m_BlastDb->GetNumSeqs()) ? 0 : 1;
+}
+
 void
 CSeqDBPerfApp::x_InitApplicationData()
 {
@@ -304,7 +357,7 @@ void CSeqDBPerfApp::Init()
     arg_desc->AddFlag("multi_threaded_creation",
                       "Create multiple CSeqDB objects in a multi-threaded environment", true);
     arg_desc->SetDependency("multi_threaded_creation", CArgDescriptions::eRequires, "num_threads");
-    const char* exclusions[]  = { "scan_compressed", "scan_uncompressed", "get_metadata" };
+    const char* exclusions[]  = { "scan_compressed", "scan_uncompressed", "get_metadata", "scan_batches" };
     for (size_t i = 0; i < sizeof(exclusions)/sizeof(*exclusions); i++)
         arg_desc->SetDependency("multi_threaded_creation", CArgDescriptions::eExcludes, string(exclusions[i]));
 
@@ -315,6 +368,15 @@ void CSeqDBPerfApp::Init()
                       "Do a full database scan of compressed sequence data", true);
     arg_desc->AddFlag("get_metadata",
                       "Retrieve BLAST database metadata", true);
+    arg_desc->AddFlag("scan_batches",
+                      "Do the database scan with CSeqDB::GetSequenceBatch, "
+                      "decoding with -num_threads threads", true);
+    arg_desc->AddDefaultKey("batch_size", "number",
+                            "Number of OIDs per batch for -scan_batches",
+                            CArgDescriptions::eInteger, "10000");
+    arg_desc->SetConstraint("batch_size", new CArgAllow_Integers(1, kMax_Int));
+    arg_desc->SetDependency("scan_batches", CArgDescriptions::eExcludes,
+                            "get_metadata");
 
     arg_desc->SetDependency("scan_compressed", CArgDescriptions::eExcludes,
                             "scan_uncompressed");
@@ -348,6 +410,8 @@ int CSeqDBPerfApp::Run(void)
             return status;
         if (args["get_metadata"]) {
             status = x_PrintBlastDatabaseInformation();
+        } else if (args["scan_batches"]) {
+            status = x_ScanDatabaseBatches();
         } else {
             status = x_ScanDatabase();
         }
@@ -996,12 +996,16 @@ CFeatureItemBase::CFeatureItemBase
 
 CConstRef<CFlatFeature> CFeatureItemBase::Format(void) const
 {
+    if ( m_FlatFeature ) {
+        return m_FlatFeature;
+    }
     CRef<CFlatFeature> ff(new CFlatFeature(GetKey(),
                           *new CFlatSeqLoc(GetLoc(), *GetContext(), CFlatSeqLoc::eType_location, false, false, this->IsSuppressAccession()),
                           m_Feat));
     if ( ff ) {
         x_FormatQuals(*ff);
     }
+    m_FlatFeature = ff;
     return ff;
 }
 
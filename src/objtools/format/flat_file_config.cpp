@@ -321,6 +321,7 @@ CFlatFileConfig::CFlatFileConfig(
     m_RefSeqConventions = false;
     m_FeatDepth = 0;
     m_GapDepth = 0;
+    m_FormatThreads = 0;
     SetGenbankBlocks(fGenbankBlocks_All);
     SetGenbankBlockCallback(nullptr);
     SetCanceledCallback(nullptr);
@@ -639,6 +640,12 @@ void CFlatFileConfig::AddArgumentDescriptions(CArgDescriptions& args)
          arg_desc->AddOptionalKey("gap-depth", "GapDepth",
                                   "Gap exploration depth", CArgDescriptions::eInteger);
 
+         arg_desc->AddOptionalKey("format-threads", "Threads",
+                                  "Number of threads formatting the features and sequence of a record",
+                                  CArgDescriptions::eInteger);
+         arg_desc->SetConstraint("format-threads",
+                                 new CArgAllow_Integers(0, 256));
+
          arg_desc->AddOptionalKey("max_search_segments", "MaxSearchSegments",
                                   "Max number of empty segments to search", CArgDescriptions::eInteger);
 
@@ -1097,6 +1104,9 @@ void CFlatFileConfig::FromArguments(const CArgs& args)
         int gapDepth = args["gap-depth"].AsInteger();
         SetGapDepth(gapDepth);
     }
+    if( args["format-threads"] ) {
+        SetFormatThreads(args["format-threads"].AsInteger());
+    }
     if (args["accn"]) {
         string singleAccn = args["accn"].AsString();
         SetSingleAccession(singleAccn);
@@ -54,6 +54,7 @@
 #include <objtools/format/item_formatter.hpp>
 #include <objtools/format/ostream_text_ostream.hpp>
 #include <objtools/format/format_item_ostream.hpp>
+#include <objtools/format/mt_format_item_ostream.hpp>
 #include <objtools/format/gather_items.hpp>
 #include <objtools/format/context.hpp>
 #include <objtools/format/flat_expt.hpp>
@@ -684,6 +685,17 @@ void CFlatFileGenerator::Generate
 #endif
 
 
+CFlatItemOStream* CFlatFileGenerator::x_NewItemOStream(CNcbiOstream& os) const
+{
+    IFlatTextOStream* text_os = new COStreamTextOStream(os);
+    unsigned int threads = m_Ctx->GetConfig().GetFormatThreads();
+    if (threads > 1) {
+        return new CMTFormatItemOStream(text_os, threads);
+    }
+    return new CFormatItemOStream(text_os);
+}
+
+
 // This version iterates Bioseqs within the Bioseq_set
 void CFlatFileGenerator::Generate(
     const CSeq_entry_Handle& entry,
@@ -1028,7 +1040,7 @@ void CFlatFileGenerator::Generate(
             }
         } else {
             newitem_os.Reset(
-                new CFormatItemOStream(new COStreamTextOStream(*flatfile_os)));
+                x_NewItemOStream(*flatfile_os));
         }
         if (newitem_os.Empty()) continue;
 
@@ -1054,6 +1066,14 @@ void CFlatFileGenerator::Generate(
         }
     }
 
+    // the last items may still be formatted in the background, and they
+    // need the context
+    CMTFormatItemOStream* mt_item_os =
+        dynamic_cast<CMTFormatItemOStream*>(&item_os);
+    if (mt_item_os) {
+        mt_item_os->Flush();
+    }
+
     /*
     if ( m_Ctx->GetConfig().UseSeqEntryIndexer() ) {
         m_Ctx->ResetSeqEntryIndex();
@@ -1075,7 +1095,7 @@ void CFlatFileGenerator::Generate(
     const multiout& mo)
 {
     CRef<CFlatItemOStream>
-        item_os(new CFormatItemOStream(new COStreamTextOStream(os)));
+        item_os(x_NewItemOStream(os));
 
     Generate(entry, *item_os, mo);
 }
@@ -1087,7 +1107,7 @@ void CFlatFileGenerator::Generate(
     const multiout& mo)
 {
     CRef<CFlatItemOStream>
-        item_os(new CFormatItemOStream(new COStreamTextOStream(os)));
+        item_os(x_NewItemOStream(os));
 
     const CSeq_entry_Handle entry = bsh.GetSeq_entry_Handle();
     Generate(entry, *item_os, mo);
@@ -1123,7 +1143,7 @@ void CFlatFileGenerator::Generate(
         m_Ctx->SetSubmit(submit.GetSub());
 
         CRef<CFlatItemOStream>
-            item_os(new CFormatItemOStream(new COStreamTextOStream(os)));
+            item_os(x_NewItemOStream(os));
 
         Generate(entry, *item_os, mo);
     }
@@ -1137,7 +1157,7 @@ void CFlatFileGenerator::Generate(
     const multiout& mo)
 {
     CRef<CFlatItemOStream>
-        item_os(new CFormatItemOStream(new COStreamTextOStream(os)));
+        item_os(x_NewItemOStream(os));
 
     const CBioseq_Handle bsh = scope.GetBioseqHandle(bioseq);
     const CSeq_entry_Handle entry = bsh.GetSeq_entry_Handle();
@@ -0,0 +1,336 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Item output stream formatting the items of a record on several threads
+*
+*/
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+
+#include <objtools/format/formatter.hpp>
+#include <objtools/format/genbank_formatter.hpp>
+#include <objtools/format/embl_formatter.hpp>
+#include <objtools/format/items/feature_item.hpp>
+#include <objtools/format/context.hpp>
+#include <objtools/format/mt_format_item_ostream.hpp>
+
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+
+// Keeps the text of one item until it can be written
+class CMTFormatItemOStream::CBufferTextOStream : public IFlatTextOStream
+{
+public:
+    void AddParagraph(const list<string>& text,
+                      const CSerialObject* obj = nullptr) override
+    {
+        m_Chunks.emplace_back(eParagraph, obj);
+        m_Chunks.back().m_Paragraph = text;
+    }
+
+    void AddLine(const CTempString& line,
+                 const CSerialObject* obj = nullptr,
+                 EAddNewline add_newline = eAddNewline_Yes) override
+    {
+        m_Chunks.emplace_back(eLine, obj);
+        m_Chunks.back().m_Line = line;
+        m_Chunks.back().m_AddNewline = add_newline;
+    }
+
+    void Flush(void) override
+    {
+        m_Chunks.emplace_back(eFlush, nullptr);
+    }
+
+    void WriteTo(IFlatTextOStream& text_os) const
+    {
+        for (const SChunk& chunk : m_Chunks) {
+            switch (chunk.m_Kind) {
+            case eParagraph:
+                text_os.AddParagraph(chunk.m_Paragraph, chunk.m_Object);
+                break;
+            case eLine:
+                text_os.AddLine(chunk.m_Line, chunk.m_Object,
+                                chunk.m_AddNewline);
+                break;
+            case eFlush:
+                text_os.Flush();
+                break;
+            }
+        }
+    }
+
+private:
+    enum EKind {
+        eParagraph,
+        eLine,
+        eFlush
+    };
+    struct SChunk {
+        SChunk(EKind kind, const CSerialObject* obj)
+            : m_Kind(kind), m_Object(obj), m_AddNewline(eAddNewline_Yes)
+        {
+        }
+        EKind                m_Kind;
+        const CSerialObject* m_Object;
+        list<string>         m_Paragraph;
+        string               m_Line;
+        EAddNewline          m_AddNewline;
+    };
+    vector<SChunk> m_Chunks;
+};
+
+
+struct CMTFormatItemOStream::SSlot
+{
+    enum EState {
+        eReady,     // nothing to do in advance
+        eQueued,
+        eRunning,
+        eDone
+    };
+
+    explicit SSlot(CConstRef<IFlatItem> item)
+        : m_Item(item), m_State(eReady), m_Rendered(false)
+    {
+    }
+
+    CConstRef<IFlatItem>      m_Item;
+    EState                    m_State;    // guarded by m_Mutex
+    // Set for the items written to the buffer in full
+    CRef<CBufferTextOStream>  m_Text;
+    bool                      m_Rendered;
+};
+
+
+CMTFormatItemOStream::CMTFormatItemOStream
+(IFlatTextOStream* text_os,
+ unsigned int threads,
+ IFormatter* formatter)
+    : CFlatItemOStream(formatter),
+      m_TextOS(text_os),
+      m_RenderSequence(false),
+      m_Stop(false)
+{
+    threads = max(threads, 1u);
+    // enough items ahead to keep all the threads busy on a long run of
+    // short features, while the memory used stays small
+    m_MaxPending = threads * 256;
+    SetFormatter(formatter);
+    for (unsigned int i = 0; i < threads; ++i) {
+        m_Threads.emplace_back(&CMTFormatItemOStream::x_Work, this);
+    }
+}
+
+
+CMTFormatItemOStream::~CMTFormatItemOStream()
+{
+    try {
+        Flush();
+    }
+    NCBI_CATCH_ALL("CMTFormatItemOStream: cannot write the pending items");
+    {{
+        lock_guard<mutex> guard(m_Mutex);
+        m_Stop = true;
+    }}
+    m_QueueCond.notify_all();
+    for (thread& t : m_Threads) {
+        t.join();
+    }
+}
+
+
+void CMTFormatItemOStream::SetFormatter(IFormatter* formatter)
+{
+    // the pending items were prepared for the old formatter
+    Flush();
+    CFlatItemOStream::SetFormatter(formatter);
+
+    // GenBank and EMBL sequence blocks do not depend on the formatter state
+    m_RenderSequence =
+        dynamic_cast<CGenbankFormatter*>(formatter) != nullptr  ||
+        dynamic_cast<CEmblFormatter*>(formatter) != nullptr;
+}
+
+
+void CMTFormatItemOStream::AddItem(CConstRef<IFlatItem> item)
+{
+    unique_ptr<SSlot> slot(new SSlot(item));
+
+    switch (item->GetItemType()) {
+    case IFlatItem::eItem_Feature:
+    case IFlatItem::eItem_SourceFeat:
+        if (const CFeatureItemBase* feat =
+            dynamic_cast<const CFeatureItemBase*>(item.GetPointer())) {
+            // All the items of a record share one CBioseqContext; its lazy
+            // caches are not guarded, so the features are formatted on
+            // the threads only when they read nothing but immutable data.
+            // The HTML links of /db_xref call GetTaxname(), which refreshes
+            // the cached taxname on every call - keep these on this thread.
+            CBioseqContext* ctx = feat->GetContext();
+            if (ctx  &&  !ctx->Config().DoHTML()) {
+                // fill the lazy flag here rather than on a worker
+                ctx->ShowAnnotCommentAsCOMMENT();
+                slot->m_State = SSlot::eQueued;
+            }
+        }
+        break;
+    case IFlatItem::eItem_Sequence:
+        if (m_RenderSequence) {
+            // block callbacks must see the blocks in order
+            const CFlatItem* flat_item =
+                dynamic_cast<const CFlatItem*>(item.GetPointer());
+            if (flat_item  &&  flat_item->GetContext()  &&
+                !flat_item->GetContext()->Config().GetGenbankBlockCallback()) {
+                slot->m_Text.Reset(new CBufferTextOStream);
+                slot->m_State = SSlot::eQueued;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (slot->m_State == SSlot::eQueued) {
+        {{
+            lock_guard<mutex> guard(m_Mutex);
+            m_Queue.push_back(slot.get());
+        }}
+        m_QueueCond.notify_one();
+    }
+    m_Pending.push_back(std::move(slot));
+
+    x_WriteReady(m_MaxPending);
+}
+
+
+void CMTFormatItemOStream::Flush(void)
+{
+    x_WriteReady(0);
+}
+
+
+void CMTFormatItemOStream::x_Work(void)
+{
+    for (;;) {
+        SSlot* slot = nullptr;
+        {{
+            unique_lock<mutex> lock(m_Mutex);
+            m_QueueCond.wait(lock, [this] {
+                return m_Stop  ||  !m_Queue.empty();
+            });
+            if (m_Queue.empty()) {
+                return;
+            }
+            slot = m_Queue.front();
+            m_Queue.pop_front();
+            slot->m_State = SSlot::eRunning;
+        }}
+
+        // Failures are left to the calling thread: it formats the item
+        // again, so the error is reported where the serial mode reports it
+        try {
+            if (slot->m_Text) {
+                m_Formatter->Format(*slot->m_Item, *slot->m_Text);
+                slot->m_Rendered = true;
+            }
+            else {
+                static_cast<const CFeatureItemBase&>(*slot->m_Item).Format();
+            }
+        }
+        catch (exception&) {
+        }
+
+        {{
+            lock_guard<mutex> guard(m_Mutex);
+            slot->m_State = SSlot::eDone;
+        }}
+        m_DoneCond.notify_all();
+    }
+}
+
+
+// Write the leading items which are ready; wait for the unfinished ones
+// while more than max_pending items are waiting
+void CMTFormatItemOStream::x_WriteReady(size_t max_pending)
+{
+    while ( !m_Pending.empty() ) {
+        SSlot& slot = *m_Pending.front();
+        {{
+            unique_lock<mutex> lock(m_Mutex);
+            if (slot.m_State == SSlot::eQueued  ||
+                slot.m_State == SSlot::eRunning) {
+                if (m_Pending.size() <= max_pending) {
+                    return;
+                }
+                m_DoneCond.wait(lock, [&slot] {
+                    return slot.m_State == SSlot::eDone;
+                });
+            }
+        }}
+
+        try {
+            x_Write(slot);
+        }
+        catch (...) {
+            // In the serial mode nothing after the failed item is written;
+            // drop the rest once no worker refers to it any more
+            unique_lock<mutex> lock(m_Mutex);
+            for (SSlot* queued : m_Queue) {
+                queued->m_State = SSlot::eDone;
+            }
+            m_Queue.clear();
+            m_DoneCond.wait(lock, [this] {
+                for (const auto& pending : m_Pending) {
+                    if (pending->m_State == SSlot::eRunning) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+            m_Pending.clear();
+            throw;
+        }
+        m_Pending.pop_front();
+    }
+}
+
+
+void CMTFormatItemOStream::x_Write(SSlot& slot)
+{
+    if (slot.m_Rendered) {
+        slot.m_Text->WriteTo(*m_TextOS);
+    }
+    else {
+        m_Formatter->Format(*slot.m_Item, *m_TextOS);
+    }
+}
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
@@ -55,8 +55,12 @@
 #include <objtools/format/ostream_text_ostream.hpp>
 #include <objtools/format/format_item_ostream.hpp>
 #include <objtools/format/item_formatter.hpp>
+#include <objtools/format/flat_file_generator.hpp>
 #include <objmgr/scope.hpp>
 #include <objmgr/seq_entry_handle.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/general/Dbtag.hpp>
+#include <objects/general/Object_id.hpp>
 
 #include <objtools/unit_test_util/unit_test_util.hpp>
 
@@ -125,3 +129,53 @@ BOOST_AUTO_TEST_CASE(Test_FlatFileGatherer)
 }
 
 
+BOOST_AUTO_TEST_CASE(Test_FormatThreads)
+{
+    auto pEntry = BuildGoodNucProtSet();
+    auto pScope = Ref(new CScope(*CObjectManager::GetInstance()));
+    auto seh = pScope->AddTopLevelSeqEntry(*pEntry);
+
+    CFlatFileConfig config;
+    ostringstream serial;
+    CFlatFileGenerator(config).Generate(seh, serial);
+
+    config.SetFormatThreads(4);
+    for (int i = 0; i < 10; ++i) {
+        ostringstream mt;
+        CFlatFileGenerator(config).Generate(seh, mt);
+        BOOST_CHECK_EQUAL(mt.str(), serial.str());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Test_FormatThreadsHTML)
+{
+    // many features with /db_xref links, which need the taxname in HTML
+    auto pEntry = BuildGoodNucProtSet();
+    auto pNuc = GetNucleotideSequenceFromGoodNucProtSet(pEntry);
+    static const char* const kDbs[] = { "GeneID", "HGNC", "MGI", "GO" };
+    for (int i = 0; i < 200; ++i) {
+        auto pFeat = AddMiscFeature(pNuc, 5 + i % 20);
+        for (const char* db : kDbs) {
+            CRef<CDbtag> pDbtag(new CDbtag);
+            pDbtag->SetDb(db);
+            pDbtag->SetTag().SetId(i + 1);
+            pFeat->SetDbxref().push_back(pDbtag);
+        }
+    }
+    auto pScope = Ref(new CScope(*CObjectManager::GetInstance()));
+    auto seh = pScope->AddTopLevelSeqEntry(*pEntry);
+
+    CFlatFileConfig config;
+    config.SetDoHTML();
+    ostringstream serial;
+    CFlatFileGenerator(config).Generate(seh, serial);
+    BOOST_CHECK(NStr::Find(serial.str(), "<a href=") != NPOS);
+
+    config.SetFormatThreads(4);
+    for (int i = 0; i < 10; ++i) {
+        ostringstream mt;
+        CFlatFileGenerator(config).Generate(seh, mt);
+        BOOST_CHECK_EQUAL(mt.str(), serial.str());
+    }
+}
@@ -49,10 +49,114 @@
 #include <objects/general/Object_id.hpp>
 #include <objects/seq/Seq_annot.hpp>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <typeinfo>
+
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
 BEGIN_SCOPE(edit)
 
+// Loads flattened entries on several threads and hands them out in their
+// original order. Workers take the next entry index under the lock and
+// never run more than m_slots.size() entries ahead of the consumer.
+class CHugeAsnReader::CParallelLoader
+{
+public:
+    using TItems = std::vector<const TBioseqSetInfo*>;
+
+    CParallelLoader(const CHugeAsnReader& reader, TItems&& items, unsigned threads, size_t depth)
+        : m_reader(reader), m_items(std::move(items)), m_slots(std::max<size_t>(depth, 1))
+    {
+        m_workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            m_workers.emplace_back(&CParallelLoader::x_Worker, this);
+    }
+
+    ~CParallelLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    // returns false after the last entry
+    bool GetNext(CRef<CSeq_entry>& entry)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_consumed >= m_items.size())
+            return false;
+
+        const TBioseqSetInfo& info = *m_items[m_consumed];
+        auto& slot = m_slots[m_consumed % m_slots.size()];
+        m_cv.wait(lock, [&slot] { return slot.m_ready; });
+        TSlot result = std::move(slot);
+        slot = {};
+        ++m_consumed;
+        lock.unlock();
+        m_cv.notify_all();
+
+        if (result.m_error)
+            std::rethrow_exception(result.m_error);
+        // a missing entry must not look like the end of the blob
+        if (!result.m_entry)
+            NCBI_THROW(CHugeFileException, eLoadFailed,
+                "Failed to load Seq-entry at position " + NStr::NumericToString(info.m_pos));
+        entry = std::move(result.m_entry);
+        return true;
+    }
+
+private:
+    struct TSlot
+    {
+        CRef<CSeq_entry>   m_entry;
+        std::exception_ptr m_error;
+        bool               m_ready = false;
+    };
+
+    void x_Worker()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this] {
+                return m_stop || m_issued >= m_items.size() || m_issued < m_consumed + m_slots.size();
+            });
+            if (m_stop || m_issued >= m_items.size())
+                break;
+
+            size_t index = m_issued++;
+            lock.unlock();
+
+            TSlot result;
+            try {
+                result.m_entry = m_reader.LoadSeqEntry(*m_items[index], eAddTopEntry::no);
+            } catch (...) {
+                result.m_error = std::current_exception();
+            }
+            result.m_ready = true;
+
+            lock.lock();
+            m_slots[index % m_slots.size()] = std::move(result);
+            m_cv.notify_all();
+        }
+    }
+
+    const CHugeAsnReader&    m_reader;
+    const TItems             m_items;
+    std::vector<TSlot>       m_slots;
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_cv;
+    size_t                   m_issued   = 0;
+    size_t                   m_consumed = 0;
+    bool                     m_stop     = false;
+};
+
 
 CHugeAsnReader::~CHugeAsnReader()
 {
@@ -69,6 +173,7 @@ CHugeAsnReader::CHugeAsnReader(CHugeFile* file, ILineErrorListener * pMessageLis
 
 void CHugeAsnReader::x_ResetIndex()
 {
+    m_loader.reset();
     m_max_local_id = 0;
     m_bioseq_list.clear();
     m_bioseq_set_list.clear();
@@ -583,6 +688,7 @@ bool CHugeAsnReader::HasLoneProteins() const
 
 void CHugeAsnReader::FlattenGenbankSet()
 {
+    m_loader.reset();
     m_pTopLevelClass = nullptr;
     m_FlattenedSets.clear();
     m_top_ids.clear();
@@ -706,8 +812,43 @@ bool CHugeAsnReader::HasRefSeq() const
     return m_seq_id_types.test(CSeq_id::e_Other);
 }
 
+void CHugeAsnReader::SetLoadThreads(unsigned threads, size_t depth)
+{
+    m_loader.reset();
+    m_load_threads = threads;
+    m_load_depth   = depth;
+}
+
+unsigned CHugeAsnReader::GetLoadThreads() const
+{
+    return (m_load_threads > 1 && x_CanLoadInParallel()) ? m_load_threads : 0;
+}
+
+bool CHugeAsnReader::x_CanLoadInParallel() const
+{
+    return typeid(*this) == typeid(CHugeAsnReader);
+}
+
 CRef<CSeq_entry> CHugeAsnReader::GetNextSeqEntry()
 {
+    // a single flattened entry may need the top entry added, keep it sequential
+    if (!m_loader && GetLoadThreads() > 0 &&
+        m_FlattenedSets.size() > 1 && m_Current != end(m_FlattenedSets)) {
+        CParallelLoader::TItems items;
+        for (; m_Current != end(m_FlattenedSets); ++m_Current) {
+            items.push_back(&*m_Current);
+        }
+        m_loader.reset(new CParallelLoader(*this, std::move(items), m_load_threads,
+            m_load_depth ? m_load_depth : 2 * size_t(m_load_threads)));
+    }
+
+    if (m_loader) {
+        CRef<CSeq_entry> entry;
+        if (m_loader->GetNext(entry))
+            return entry;
+        m_loader.reset();
+    }
+
     if (m_Current == end(m_FlattenedSets)) {
         m_FlattenedSets.clear();
         m_Current = m_FlattenedSets.end();
@@ -91,6 +91,87 @@ BOOST_AUTO_TEST_CASE(Test_HugeFileProcess)
 }
 
 
+BOOST_AUTO_TEST_CASE(Test_ParallelLoad)
+{
+    string filename = "./huge_asn_test_files/rw-1974.asn";
+
+    auto load_all = [&filename](unsigned threads, size_t depth) {
+        list<CRef<CSeq_entry>> entries;
+        CHugeFileProcess process;
+        process.Open(filename);
+        auto& reader = process.GetReader();
+        reader.SetLoadThreads(threads, depth);
+        while (reader.GetNextBlob()) {
+            reader.FlattenGenbankSet();
+            while (auto entry = reader.GetNextSeqEntry()) {
+                entries.push_back(entry);
+            }
+        }
+        return entries;
+    };
+
+    auto expected = load_all(0, 0);
+    BOOST_CHECK_EQUAL(expected.size(), 3);
+    for (auto [threads, depth] : { pair{2u, 0}, pair{4u, 1}, pair{3u, 16} }) {
+        auto entries = load_all(threads, depth);
+        BOOST_REQUIRE_EQUAL(entries.size(), expected.size());
+        auto it = expected.begin();
+        for (auto& entry : entries) {
+            BOOST_CHECK(entry->Equals(**it++));
+        }
+    }
+}
+
+
+namespace
+{
+    // LoadSeqEntry() override which fails to load anything
+    class CEmptyAsnReader : public CHugeAsnReader
+    {
+    public:
+        CEmptyAsnReader(bool parallel) : m_parallel(parallel) {}
+
+        CRef<CSeq_entry> LoadSeqEntry(const TBioseqSetInfo&, eAddTopEntry) const override
+        {
+            return {};
+        }
+
+    protected:
+        bool x_CanLoadInParallel() const override { return m_parallel; }
+
+    private:
+        bool m_parallel;
+    };
+}
+
+
+BOOST_AUTO_TEST_CASE(Test_ParallelLoadOptIn)
+{
+    string filename = "./huge_asn_test_files/rw-1974.asn";
+
+    // LoadSeqEntry() overrides are sequential unless the subclass opts in
+    {
+        CHugeFileProcess process(new CHugeAsnReader);
+        process.GetReader().SetLoadThreads(4);
+        BOOST_CHECK_EQUAL(process.GetReader().GetLoadThreads(), 4u);
+    }
+    {
+        CHugeFileProcess process(new CEmptyAsnReader(false));
+        process.GetReader().SetLoadThreads(4);
+        BOOST_CHECK_EQUAL(process.GetReader().GetLoadThreads(), 0u);
+    }
+
+    // a null entry loaded on a worker is an error, not the end of the blob
+    CHugeFileProcess process(new CEmptyAsnReader(true));
+    process.Open(filename);
+    auto& reader = process.GetReader();
+    reader.SetLoadThreads(2);
+    BOOST_REQUIRE(reader.GetNextBlob());
+    reader.FlattenGenbankSet();
+    BOOST_CHECK_THROW(reader.GetNextSeqEntry(), CHugeFileException);
+}
+
+
 BOOST_AUTO_TEST_CASE(Test_RemoteSequences)
 {   // RW-2308 - This test demonstrates why huge mode differs from traditional mode
     // in an usual validator corner case
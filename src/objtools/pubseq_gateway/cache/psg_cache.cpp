@@ -306,4 +306,50 @@ bool CPubseqGatewayCache::UnpackBlobPropKey(const char* key, size_t key_sz, int6
     return CPubseqGatewayCacheBlobProp::UnpackKey(key, key_sz, last_modified, sat_key);
 }
 
+string CPubseqGatewayCache::PackBioseqInfoFlatValue(const CBioseqInfoRecord& record)
+{
+    return CPubseqGatewayCacheBioseqInfo::PackFlatValue(record);
+}
+
+bool CPubseqGatewayCache::UnpackBioseqInfoFlatValue(const char* value, size_t value_sz, CBioseqInfoRecord& record)
+{
+    return CPubseqGatewayCacheBioseqInfo::UnpackFlatValue(value, value_sz, record);
+}
+
+string CPubseqGatewayCache::PackSiFlatValue(const CSI2CSIRecord& record)
+{
+    return CPubseqGatewayCacheSi2Csi::PackFlatValue(record);
+}
+
+bool CPubseqGatewayCache::UnpackSiFlatValue(const char* value, size_t value_sz, CSI2CSIRecord& record)
+{
+    return CPubseqGatewayCacheSi2Csi::UnpackFlatValue(value, value_sz, record);
+}
+
+string CPubseqGatewayCache::PackBlobPropFlatValue(const CBlobRecord& record)
+{
+    return CPubseqGatewayCacheBlobProp::PackFlatValue(record);
+}
+
+bool CPubseqGatewayCache::UnpackBlobPropFlatValue(const char* value, size_t value_sz, CBlobRecord& record)
+{
+    return CPubseqGatewayCacheBlobProp::UnpackFlatValue(value, value_sz, record);
+}
+
+size_t CPubseqGatewayCache::ConvertToFlat(
+    const string& bioseq_info_file_name, const string& si2csi_file_name, const string& blob_prop_file_name)
+{
+    size_t converted{0};
+    if (!bioseq_info_file_name.empty()) {
+        converted += CPubseqGatewayCacheBioseqInfo::ConvertToFlat(bioseq_info_file_name);
+    }
+    if (!si2csi_file_name.empty()) {
+        converted += CPubseqGatewayCacheSi2Csi::ConvertToFlat(si2csi_file_name);
+    }
+    if (!blob_prop_file_name.empty()) {
+        converted += CPubseqGatewayCacheBlobProp::ConvertToFlat(blob_prop_file_name);
+    }
+    return converted;
+}
+
 END_IDBLOB_SCOPE
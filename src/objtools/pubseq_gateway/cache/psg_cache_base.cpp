@@ -31,6 +31,7 @@
 
 #include "psg_cache_base.hpp"
 
+#include <cstring>
 #include <string>
 
 #include <sys/stat.h>
@@ -41,6 +42,19 @@ BEGIN_SCOPE()
     static const size_t kMapSizeInit = 256UL * 1024 * 1024 * 1024;
     static const size_t kMapSizeDelta = 16UL * 1024 * 1024 * 1024;
     static const size_t kMaxReaders = 1024UL;
+    static const size_t kConvertBatchSize = 100000;
+
+    /// Completion markers of flat databases (keyed by the flat database name).
+    /// A flat database is used only if its marker was written by the last
+    /// transaction of the file, so an interrupted conversion or any change
+    /// of the file after the conversion makes readers use protobuf values.
+    static const char* const kFlatMarkerDbi = "#FLATINFO";
+
+    struct SFlatMarker
+    {
+        uint64_t    txn_id;
+        uint64_t    source_entries;
+    };
 END_SCOPE()
 
 BEGIN_IDBLOB_SCOPE
@@ -57,6 +71,20 @@ CLMDBReadOnlyTxn CPubseqGatewayCacheBase::BeginReadTxn()
 }
 
 void CPubseqGatewayCacheBase::Open()
+{
+    unsigned int flags = MDB_RDONLY | MDB_NOSUBDIR | MDB_NOSYNC | MDB_NOMETASYNC;
+    if (!m_UseReadAhead) {
+        flags |= MDB_NORDAHEAD;
+    }
+    x_Open(flags);
+}
+
+void CPubseqGatewayCacheBase::x_OpenForWriting()
+{
+    x_Open(MDB_NOSUBDIR);
+}
+
+void CPubseqGatewayCacheBase::x_Open(unsigned int flags)
 {
     struct stat st;
     int stat_rv = stat(m_FileName.c_str(), &st);
@@ -72,12 +100,147 @@ void CPubseqGatewayCacheBase::Open()
     m_Env->set_max_dbs(kLmdbMaxDbCount);
     m_Env->set_max_readers(kMaxReaders);
     m_Env->set_mapsize(mapsize);
+    m_Env->open(m_FileName.c_str(), flags, 0664);
+}
 
-    unsigned int flags = MDB_RDONLY | MDB_NOSUBDIR | MDB_NOSYNC | MDB_NOMETASYNC;
-    if (!m_UseReadAhead) {
-        flags |= MDB_NORDAHEAD;
+CPubseqGatewayCacheBase::TDbiPtr CPubseqGatewayCacheBase::x_OpenDataDbi(
+    CLMDBReadOnlyTxn& txn, const string& flat_name, const string& protobuf_name, bool& flat)
+{
+    auto deleter = [this](lmdb::dbi* dbi){
+        if (dbi && *dbi) {
+            dbi->close(*m_Env);
+        }
+        delete(dbi);
+    };
+    if (x_IsFlatDbiComplete(txn, flat_name, protobuf_name)) {
+        try {
+            TDbiPtr pdbi(new lmdb::dbi({lmdb::dbi::open(txn, flat_name.c_str(), 0)}), deleter);
+            flat = true;
+            return pdbi;
+        }
+        catch (const lmdb::error& e) {
+            if (e.code() != MDB_NOTFOUND) {
+                throw;
+            }
+        }
     }
-    m_Env->open(m_FileName.c_str(), flags, 0664);
+    flat = false;
+    return TDbiPtr(new lmdb::dbi({lmdb::dbi::open(txn, protobuf_name.c_str(), 0)}), deleter);
+}
+
+bool CPubseqGatewayCacheBase::x_IsFlatDbiComplete(
+    CLMDBReadOnlyTxn& txn, const string& flat_name, const string& protobuf_name)
+{
+    SFlatMarker marker;
+    try {
+        auto marker_dbi = lmdb::dbi::open(txn, kFlatMarkerDbi, 0);
+        lmdb::val value;
+        if (!marker_dbi.get(txn, lmdb::val(flat_name), value)) {
+            ERR_POST(Warning << "LMDB cache '" << m_FileName << "': " << flat_name
+                << " conversion was not completed, " << protobuf_name << " values will be used.");
+            return false;
+        }
+        if (value.size() != sizeof(marker)) {
+            ERR_POST(Warning << "LMDB cache '" << m_FileName << "': unexpected " << flat_name
+                << " completion marker, " << protobuf_name << " values will be used.");
+            return false;
+        }
+        memcpy(&marker, value.data(), sizeof(marker));
+    }
+    catch (const lmdb::error& e) {
+        if (e.code() != MDB_NOTFOUND) {
+            throw;
+        }
+        // the file was not converted
+        return false;
+    }
+    auto src = lmdb::dbi::open(txn, protobuf_name.c_str(), 0);
+    if (marker.txn_id != mdb_txn_id(txn) || marker.source_entries != src.size(txn)) {
+        ERR_POST(Warning << "LMDB cache '" << m_FileName << "' was changed after " << flat_name
+            << " conversion, " << protobuf_name << " values will be used.");
+        return false;
+    }
+    return true;
+}
+
+vector<string> CPubseqGatewayCacheBase::x_GetDbiNames()
+{
+    vector<string> names;
+    auto rdtxn = BeginReadTxn();
+    auto dbi = lmdb::dbi::open(rdtxn, nullptr, 0);
+    auto cursor = lmdb::cursor::open(rdtxn, dbi);
+    lmdb::val key, val;
+    bool has_current = cursor.get(key, val, MDB_FIRST);
+    while (has_current) {
+        names.emplace_back(key.data<const char>(), key.size());
+        has_current = cursor.get(key, val, MDB_NEXT);
+    }
+    return names;
+}
+
+size_t CPubseqGatewayCacheBase::x_ConvertDbi(const TConvertDbiNames& names, TFlatConvertFn fn)
+{
+    {
+        // Drop the old data along with the completion markers, so readers
+        // do not use the destination databases until the conversion is done
+        auto wrtxn = lmdb::txn::begin(*m_Env);
+        auto marker_dbi = lmdb::dbi::open(wrtxn, kFlatMarkerDbi, MDB_CREATE);
+        for (const auto & name : names) {
+            marker_dbi.del(wrtxn, lmdb::val(name.second));
+            auto dst = lmdb::dbi::open(wrtxn, name.second.c_str(), MDB_CREATE);
+            lmdb::dbi_drop(wrtxn, dst.handle(), false);
+        }
+        wrtxn.commit();
+    }
+
+    size_t converted{0};
+    for (const auto & name : names) {
+        string last_key, flat_value;
+        bool has_current{true};
+        while (has_current) {
+            auto wrtxn = lmdb::txn::begin(*m_Env);
+            auto src = lmdb::dbi::open(wrtxn, name.first.c_str(), 0);
+            auto dst = lmdb::dbi::open(wrtxn, name.second.c_str(), 0);
+            auto cursor = lmdb::cursor::open(wrtxn, src);
+            lmdb::val key, val;
+            if (last_key.empty()) {
+                has_current = cursor.get(key, val, MDB_FIRST);
+            }
+            else {
+                // Continue right after the last key of the previous batch
+                key = lmdb::val(last_key);
+                has_current = cursor.get(key, val, MDB_SET_RANGE) && cursor.get(key, val, MDB_NEXT);
+            }
+            size_t batch{0};
+            while (has_current && batch < kConvertBatchSize) {
+                if (fn(val, flat_value)) {
+                    dst.put(wrtxn, key, lmdb::val(flat_value));
+                    ++converted;
+                }
+                ++batch;
+                last_key.assign(key.data<const char>(), key.size());
+                has_current = cursor.get(key, val, MDB_NEXT);
+            }
+            cursor.close();
+            wrtxn.commit();
+        }
+    }
+
+    {
+        // All markers are written by the last transaction of the file,
+        // any later change of the file invalidates them
+        auto wrtxn = lmdb::txn::begin(*m_Env);
+        auto marker_dbi = lmdb::dbi::open(wrtxn, kFlatMarkerDbi, 0);
+        for (const auto & name : names) {
+            auto src = lmdb::dbi::open(wrtxn, name.first.c_str(), 0);
+            SFlatMarker marker;
+            marker.txn_id = mdb_txn_id(wrtxn);
+            marker.source_entries = src.size(wrtxn);
+            marker_dbi.put(wrtxn, lmdb::val(name.second), lmdb::val(&marker, sizeof(marker)));
+        }
+        wrtxn.commit();
+    }
+    return converted;
 }
 
 unsigned int CPubseqGatewayCacheBase::GetEnvFlags() const
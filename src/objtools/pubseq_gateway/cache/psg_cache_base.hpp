@@ -32,9 +32,11 @@
  *
  */
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <util/lmdbxx/lmdb++.h>
 
@@ -96,11 +98,43 @@ public:
     unsigned int GetEnvFlags() const;
 
 protected:
+    using TDbiPtr = unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>;
+    using TFlatConvertFn = function<bool(lmdb::val const& value, string& flat_value)>;
+    /// Pairs of source (protobuf) and destination (flat) database names
+    using TConvertDbiNames = vector<pair<string, string>>;
+
     CLMDBReadOnlyTxn BeginReadTxn();
+
+    /// Opens flat values database (flat_name) if the file has it and its
+    /// conversion from protobuf_name was completed after the last change
+    /// of the file, protobuf packed values database (protobuf_name) otherwise
+    /// @param flat - set to true if flat values database is opened
+    /// @throws lmdb::error
+    TDbiPtr x_OpenDataDbi(CLMDBReadOnlyTxn& txn, const string& flat_name, const string& protobuf_name, bool& flat);
+
+    /// Opens the file for writing (used by flat format converter only)
+    // @throws lmdb::error
+    void x_OpenForWriting();
+
+    /// Names of all named databases in the file
+    // @throws lmdb::error
+    vector<string> x_GetDbiNames();
+
+    /// Replaces content of each destination database with values of its
+    /// source database converted by fn (values fn cannot convert are skipped).
+    /// Changes are committed in batches so the file can be of any size,
+    /// the destination databases are marked complete by the last transaction.
+    /// @return number of converted values
+    // @throws lmdb::error
+    size_t x_ConvertDbi(const TConvertDbiNames& names, TFlatConvertFn fn);
+
     string m_FileName;
     unique_ptr<lmdb::env> m_Env;
 
 private:
+    void x_Open(unsigned int flags);
+    bool x_IsFlatDbiComplete(CLMDBReadOnlyTxn& txn, const string& flat_name, const string& protobuf_name);
+
     bool m_UseReadAhead{true};
 };
 
@@ -41,6 +41,7 @@
 #include <objtools/pubseq_gateway/protobuf/psg_protobuf.pb.h>
 
 #include "psg_cache_bytes_util.hpp"
+#include "psg_cache_flat.hpp"
 
 BEGIN_SCOPE()
 USING_IDBLOB_SCOPE;
@@ -91,18 +92,26 @@ void CPubseqGatewayCacheBioseqInfo::Open()
     CPubseqGatewayCacheBase::Open();
     {
         auto rdtxn = BeginReadTxn();
-        m_Dbi = unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>(
-            new lmdb::dbi({lmdb::dbi::open(rdtxn, "#DATA", 0)}),
-            [this](lmdb::dbi* dbi){
-                if (dbi && *dbi) {
-                    dbi->close(*m_Env);
-                }
-                delete(dbi);
-            }
-        );
+        m_Dbi = x_OpenDataDbi(rdtxn, kPsgCacheFlatDbi, kPsgCacheProtobufDbi, m_Flat);
     }
 }
 
+size_t CPubseqGatewayCacheBioseqInfo::ConvertToFlat(const string& file_name)
+{
+    CPubseqGatewayCacheBioseqInfo cache(file_name);
+    cache.x_OpenForWriting();
+    return cache.x_ConvertDbi({{kPsgCacheProtobufDbi, kPsgCacheFlatDbi}},
+        [](lmdb::val const& value, string& flat_value) {
+            CBioseqInfoRecord record;
+            if (!x_ExtractProtobufRecord(record, value)) {
+                return false;
+            }
+            flat_value = PackFlatValue(record);
+            return true;
+        }
+    );
+}
+
 string CPubseqGatewayCacheBioseqInfo::x_MakeLookupKey(CBioseqInfoFetchRequest const& request) const
 {
     string accession = request.GetAccession();
@@ -140,6 +149,14 @@ bool CPubseqGatewayCacheBioseqInfo::x_IsMatchingRecord(
 }
 
 bool CPubseqGatewayCacheBioseqInfo::x_ExtractRecord(CBioseqInfoRecord& record, lmdb::val const& value) const
+{
+    if (m_Flat) {
+        return UnpackFlatValue(value.data<const char>(), value.size(), record);
+    }
+    return x_ExtractProtobufRecord(record, value);
+}
+
+bool CPubseqGatewayCacheBioseqInfo::x_ExtractProtobufRecord(CBioseqInfoRecord& record, lmdb::val const& value)
 {
     ::psg::retrieval::BioseqInfoValue info;
     if (!info.ParseFromArray(value.data(), value.size())) {
@@ -244,6 +261,62 @@ vector<CBioseqInfoRecord> CPubseqGatewayCacheBioseqInfo::FetchLast(void)
     return response;
 }
 
+string CPubseqGatewayCacheBioseqInfo::PackFlatValue(const CBioseqInfoRecord& record)
+{
+    SPsgCacheFlatBioseqInfo fixed;
+    fixed.format_version = kPsgCacheFlatFormatVersion;
+    fixed.mol = record.GetMol();
+    fixed.state = record.GetState();
+    fixed.seq_state = record.GetSeqState();
+    fixed.sat = record.GetSat();
+    fixed.sat_key = record.GetSatKey();
+    fixed.hash = record.GetHash();
+    fixed.length = record.GetLength();
+    fixed.tax_id = record.GetTaxId();
+    fixed.date_changed = record.GetDateChanged();
+    fixed.seq_id_count = static_cast<uint32_t>(record.GetSeqIds().size());
+    CPubseqGatewayCacheFlatWriter writer(fixed);
+    writer.Append(record.GetName());
+    for (auto const & item : record.GetSeqIds()) {
+        writer
+            .Append(get<0>(item))
+            .Append(get<1>(item));
+    }
+    return std::move(writer.GetValue());
+}
+
+bool CPubseqGatewayCacheBioseqInfo::UnpackFlatValue(const char* value, size_t value_sz, CBioseqInfoRecord& record)
+{
+    CPubseqGatewayCacheFlatReader reader(value, value_sz);
+    const SPsgCacheFlatBioseqInfo* fixed{nullptr};
+    CTempString name;
+    if (!reader.GetFixed(fixed) || !reader.Get(name)) {
+        return false;
+    }
+    CBioseqInfoRecord::TSeqIds seq_ids;
+    for (uint32_t i = 0; i < fixed->seq_id_count; ++i) {
+        int16_t sec_seq_id_type{0};
+        CTempString sec_seq_id;
+        if (!reader.Get(sec_seq_id_type) || !reader.Get(sec_seq_id)) {
+            return false;
+        }
+        seq_ids.insert(make_tuple(sec_seq_id_type, string(sec_seq_id)));
+    }
+    record
+        .SetHash(fixed->hash)
+        .SetLength(fixed->length)
+        .SetMol(fixed->mol)
+        .SetName(string(name))
+        .SetSat(fixed->sat)
+        .SetSatKey(fixed->sat_key)
+        .SetState(fixed->state)
+        .SetSeqState(fixed->seq_state)
+        .SetTaxId(fixed->tax_id)
+        .SetDateChanged(fixed->date_changed)
+        .SetSeqIds(std::move(seq_ids));
+    return true;
+}
+
 string CPubseqGatewayCacheBioseqInfo::PackKey(const string& accession, int version)
 {
     string rv;
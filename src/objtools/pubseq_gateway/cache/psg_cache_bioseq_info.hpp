@@ -62,12 +62,28 @@ class CPubseqGatewayCacheBioseqInfo
     static bool UnpackKey(
         const char* key, size_t key_sz, string& accession, int& version, int& seq_id_type, int64_t& gi);
 
+    static string PackFlatValue(const CBioseqInfoRecord& record);
+    static bool UnpackFlatValue(const char* value, size_t value_sz, CBioseqInfoRecord& record);
+
+    /// Adds flat copy of the data (#FLAT database) to the cache file
+    /// @return number of converted records
+    // @throws lmdb::error
+    static size_t ConvertToFlat(const string& file_name);
+
+    /// True if the cache reads flat values
+    bool IsFlat() const
+    {
+        return m_Flat;
+    }
+
  private:
+    static bool x_ExtractProtobufRecord(CBioseqInfoRecord& record, lmdb::val const& value);
     bool x_ExtractRecord(CBioseqInfoRecord& record, lmdb::val const& value) const;
     string x_MakeLookupKey(CBioseqInfoFetchRequest const& request) const;
     bool x_IsMatchingRecord(CBioseqInfoFetchRequest const& request, int version, int seq_id_type, int64_t gi) const;
     void ResetDbi();
-    unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>> m_Dbi;
+    TDbiPtr m_Dbi;
+    bool m_Flat{false};
 };
 
 END_IDBLOB_SCOPE
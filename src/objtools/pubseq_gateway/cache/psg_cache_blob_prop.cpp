@@ -41,6 +41,7 @@
 #include <objtools/pubseq_gateway/protobuf/psg_protobuf.pb.h>
 
 #include "psg_cache_bytes_util.hpp"
+#include "psg_cache_flat.hpp"
 
 BEGIN_SCOPE()
 USING_IDBLOB_SCOPE;
@@ -73,19 +74,13 @@ void CPubseqGatewayCacheBlobProp::Open(const set<int>& sat_ids)
     CPubseqGatewayCacheBase::Open();
     auto rdtxn = BeginReadTxn();
     for (const auto & sat_id : sat_ids) {
-        unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>> pdbi{nullptr};
-        string sat_dbi = string("#DATA[") + to_string(sat_id) + "]";
+        TDbiPtr pdbi{nullptr};
+        bool flat{false};
+        string sat_dbi = string(kPsgCacheProtobufDbi) + "[" + to_string(sat_id) + "]";
         if (x_CanOpenSatDatabase(sat_id, rdtxn)) {
             try {
-                pdbi = unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>(
-                    new lmdb::dbi({lmdb::dbi::open(rdtxn, sat_dbi.c_str(), 0)}),
-                    [this](lmdb::dbi* dbi){
-                        if (dbi && *dbi) {
-                            dbi->close(*m_Env);
-                        }
-                        delete(dbi);
-                    }
-                );
+                string flat_dbi = string(kPsgCacheFlatDbi) + "[" + to_string(sat_id) + "]";
+                pdbi = x_OpenDataDbi(rdtxn, flat_dbi, sat_dbi, flat);
             }
             catch (const lmdb::error& e) {
                 ERR_POST(Warning << "BlobProp cache: failed to open " << sat_dbi << " dbi: " << e.what()
@@ -99,13 +94,47 @@ void CPubseqGatewayCacheBlobProp::Open(const set<int>& sat_ids)
         }
         if (static_cast<size_t>(sat_id) > m_Dbis.size()) {
             m_Dbis.resize(sat_id);
+            m_Flat.resize(sat_id);
         }
         m_Dbis.push_back(std::move(pdbi));
+        m_Flat.push_back(flat);
+
+    }
+}
 
+size_t CPubseqGatewayCacheBlobProp::ConvertToFlat(const string& file_name)
+{
+    CPubseqGatewayCacheBlobProp cache(file_name);
+    cache.x_OpenForWriting();
+    TConvertDbiNames names;
+    string prefix = string(kPsgCacheProtobufDbi) + "[";
+    for (const auto & dbi_name : cache.x_GetDbiNames()) {
+        if (NStr::StartsWith(dbi_name, prefix)) {
+            string flat_dbi = kPsgCacheFlatDbi + dbi_name.substr(strlen(kPsgCacheProtobufDbi));
+            names.emplace_back(dbi_name, flat_dbi);
+        }
     }
+    return cache.x_ConvertDbi(names,
+        [](lmdb::val const& value, string& flat_value) {
+            CBlobRecord record;
+            if (!x_ExtractProtobufRecord(record, value)) {
+                return false;
+            }
+            flat_value = PackFlatValue(record);
+            return true;
+        }
+    );
 }
 
-bool CPubseqGatewayCacheBlobProp::x_ExtractRecord(CBlobRecord& record, lmdb::val const& value) const
+bool CPubseqGatewayCacheBlobProp::x_ExtractRecord(int32_t sat, CBlobRecord& record, lmdb::val const& value) const
+{
+    if (m_Flat[sat]) {
+        return UnpackFlatValue(value.data<const char>(), value.size(), record);
+    }
+    return x_ExtractProtobufRecord(record, value);
+}
+
+bool CPubseqGatewayCacheBlobProp::x_ExtractProtobufRecord(CBlobRecord& record, lmdb::val const& value)
 {
     ::psg::retrieval::BlobPropValue info;
     if (!info.ParseFromArray(value.data(), value.size())) {
@@ -198,7 +227,7 @@ vector<CBlobRecord> CPubseqGatewayCacheBlobProp::Fetch(CBlobFetchRequest const&
                     last_record.SetKey(sat_key);
                     last_record.SetModified(last_modified);
                     // Skip record if we cannot parse protobuf data
-                    if (!x_ExtractRecord(last_record, val)) {
+                    if (!x_ExtractRecord(sat, last_record, val)) {
                         response.resize(response.size() - 1);
                     }
                 }
@@ -237,7 +266,7 @@ vector<CBlobRecord> CPubseqGatewayCacheBlobProp::FetchLast(CBlobFetchRequest con
                 last_record.SetKey(sat_key);
                 last_record.SetModified(last_modified);
                 // Skip record if we cannot parse protobuf data
-                if (!x_ExtractRecord(last_record, val)) {
+                if (!x_ExtractRecord(sat, last_record, val)) {
                     response.resize(response.size() - 1);
                 }
             }
@@ -271,6 +300,49 @@ void CPubseqGatewayCacheBlobProp::EnumerateBlobProp(int32_t sat, TBlobPropEnumer
     }
 }
 
+string CPubseqGatewayCacheBlobProp::PackFlatValue(const CBlobRecord& record)
+{
+    SPsgCacheFlatBlobProp fixed;
+    fixed.format_version = kPsgCacheFlatFormatVersion;
+    fixed.blob_class = record.GetClass();
+    fixed.n_chunks = record.GetNChunks();
+    fixed.owner = record.GetOwner();
+    fixed.flags = record.GetFlags();
+    fixed.date_asn1 = record.GetDateAsn1();
+    fixed.hup_date = record.GetHupDate();
+    fixed.size = record.GetSize();
+    fixed.size_unpacked = record.GetSizeUnpacked();
+    CPubseqGatewayCacheFlatWriter writer(fixed);
+    writer
+        .Append(record.GetDiv())
+        .Append(record.GetId2Info())
+        .Append(record.GetUserName());
+    return std::move(writer.GetValue());
+}
+
+bool CPubseqGatewayCacheBlobProp::UnpackFlatValue(const char* value, size_t value_sz, CBlobRecord& record)
+{
+    CPubseqGatewayCacheFlatReader reader(value, value_sz);
+    const SPsgCacheFlatBlobProp* fixed{nullptr};
+    CTempString div, id2_info, username;
+    if (!reader.GetFixed(fixed) || !reader.Get(div) || !reader.Get(id2_info) || !reader.Get(username)) {
+        return false;
+    }
+    record
+        .SetClass(fixed->blob_class)
+        .SetDateAsn1(fixed->date_asn1)
+        .SetHupDate(fixed->hup_date)
+        .SetDiv(string(div))
+        .SetFlags(fixed->flags)
+        .SetNChunks(fixed->n_chunks)
+        .SetId2Info(string(id2_info))
+        .SetOwner(fixed->owner)
+        .SetSize(fixed->size)
+        .SetSizeUnpacked(fixed->size_unpacked)
+        .SetUserName(string(username));
+    return true;
+}
+
 string CPubseqGatewayCacheBlobProp::PackKey(int32_t sat_key)
 {
     string rv;
@@ -66,15 +66,31 @@ class CPubseqGatewayCacheBlobProp
     static bool UnpackKey(const char* key, size_t key_sz, int64_t& last_modified);
     static bool UnpackKey(const char* key, size_t key_sz, int64_t& last_modified, int32_t& sat_key);
 
+    static string PackFlatValue(const CBlobRecord& record);
+    static bool UnpackFlatValue(const char* value, size_t value_sz, CBlobRecord& record);
+
+    /// Adds flat copies of the data (#FLAT[sat] databases) to the cache file
+    /// @return number of converted records
+    // @throws lmdb::error
+    static size_t ConvertToFlat(const string& file_name);
+
+    /// True if the cache reads flat values for the satellite
+    bool IsFlat(int32_t sat) const
+    {
+        return sat >= 0 && static_cast<size_t>(sat) < m_Flat.size() && m_Flat[sat];
+    }
+
  private:
-    bool x_ExtractRecord(CBlobRecord& record, lmdb::val const& value) const;
+    static bool x_ExtractProtobufRecord(CBlobRecord& record, lmdb::val const& value);
+    bool x_ExtractRecord(int32_t sat, CBlobRecord& record, lmdb::val const& value) const;
 
     // Checks #STATUS[sat] database for "DISABLED" key
     // returns False
     //   -- If #STATUS[sat] does not exist
     //   -- If "DISABLED" key exists and is equal string("yes")
     bool x_CanOpenSatDatabase(int32_t sat, CLMDBReadOnlyTxn& rtxn);
-    vector<unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>> m_Dbis;
+    vector<TDbiPtr> m_Dbis;
+    vector<bool> m_Flat;
 };
 
 END_IDBLOB_SCOPE
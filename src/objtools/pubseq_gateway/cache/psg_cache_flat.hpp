@@ -0,0 +1,190 @@
+#ifndef PSG_CACHE_FLAT__HPP_
+#define PSG_CACHE_FLAT__HPP_
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: fixed-layout ("flat") format of LMDB cache values
+ *
+ */
+
+#include <corelib/ncbistl.hpp>
+#include <corelib/tempstr.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <objtools/pubseq_gateway/impl/cassandra/IdCassScope.hpp>
+
+BEGIN_IDBLOB_SCOPE
+USING_NCBI_SCOPE;
+
+/// Flat values are stored next to the protobuf packed ones ("#DATA") in the
+/// "#FLAT" database (and "#FLAT[sat]" for blob properties) under the same keys.
+/// Each value is a packed struct with all fixed size fields (native byte order)
+/// followed by variable size fields: strings as <uint32 size><bytes>.
+/// Fixed parts are read in place from LMDB memory map without any decoding.
+/// Readers use a flat database only if the converter has marked it complete
+/// and the file has not been changed since then.
+static const uint8_t kPsgCacheFlatFormatVersion = 1;
+static const char* const kPsgCacheFlatDbi = "#FLAT";
+static const char* const kPsgCacheProtobufDbi = "#DATA";
+
+#pragma pack(push, 1)
+
+struct SPsgCacheFlatSi2Csi
+{
+    uint8_t     format_version;
+    int16_t     seq_id_type;
+    int16_t     version;
+    int64_t     gi;
+    // string   accession;
+};
+
+struct SPsgCacheFlatBioseqInfo
+{
+    uint8_t     format_version;
+    int8_t      mol;
+    int8_t      state;
+    int8_t      seq_state;
+    int16_t     sat;
+    int32_t     sat_key;
+    int32_t     hash;
+    int32_t     length;
+    int32_t     tax_id;
+    int64_t     date_changed;
+    uint32_t    seq_id_count;
+    // string   name;
+    // seq_id_count times: int16_t sec_seq_id_type, string sec_seq_id
+};
+
+struct SPsgCacheFlatBlobProp
+{
+    uint8_t     format_version;
+    int16_t     blob_class;
+    int32_t     n_chunks;
+    int32_t     owner;
+    int64_t     flags;
+    int64_t     date_asn1;
+    int64_t     hup_date;
+    int64_t     size;
+    int64_t     size_unpacked;
+    // string   div;
+    // string   id2_info;
+    // string   username;
+};
+
+#pragma pack(pop)
+
+
+/// Builds flat value: the fixed part first, then variable size fields
+class CPubseqGatewayCacheFlatWriter
+{
+ public:
+    template<typename TFixed>
+    explicit CPubseqGatewayCacheFlatWriter(const TFixed& fixed)
+    {
+        m_Value.assign(reinterpret_cast<const char*>(&fixed), sizeof(fixed));
+    }
+
+    template<typename TInt>
+    CPubseqGatewayCacheFlatWriter& Append(TInt value)
+    {
+        m_Value.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    CPubseqGatewayCacheFlatWriter& Append(const string& value)
+    {
+        Append(static_cast<uint32_t>(value.size()));
+        m_Value.append(value);
+        return *this;
+    }
+
+    string& GetValue()
+    {
+        return m_Value;
+    }
+
+ private:
+    string m_Value;
+};
+
+
+/// Reads flat value in place; all accessors return false if the value is
+/// shorter than its layout requires
+class CPubseqGatewayCacheFlatReader
+{
+ public:
+    CPubseqGatewayCacheFlatReader(const char* data, size_t size)
+        : m_Ptr(data)
+        , m_End(data + size)
+    {}
+
+    /// Fixed part of the value (points into the memory map)
+    template<typename TFixed>
+    bool GetFixed(const TFixed*& fixed)
+    {
+        if (static_cast<size_t>(m_End - m_Ptr) < sizeof(TFixed)) {
+            return false;
+        }
+        fixed = reinterpret_cast<const TFixed*>(m_Ptr);
+        if (fixed->format_version != kPsgCacheFlatFormatVersion) {
+            return false;
+        }
+        m_Ptr += sizeof(TFixed);
+        return true;
+    }
+
+    template<typename TInt>
+    bool Get(TInt& value)
+    {
+        if (static_cast<size_t>(m_End - m_Ptr) < sizeof(value)) {
+            return false;
+        }
+        memcpy(&value, m_Ptr, sizeof(value));
+        m_Ptr += sizeof(value);
+        return true;
+    }
+
+    bool Get(CTempString& value)
+    {
+        uint32_t size{0};
+        if (!Get(size) || static_cast<size_t>(m_End - m_Ptr) < size) {
+            return false;
+        }
+        value.assign(m_Ptr, size);
+        m_Ptr += size;
+        return true;
+    }
+
+ private:
+    const char* m_Ptr;
+    const char* m_End;
+};
+
+END_IDBLOB_SCOPE
+
+#endif  // PSG_CACHE_FLAT__HPP_
@@ -41,6 +41,7 @@
 #include <objtools/pubseq_gateway/protobuf/psg_protobuf.pb.h>
 
 #include "psg_cache_bytes_util.hpp"
+#include "psg_cache_flat.hpp"
 
 BEGIN_SCOPE()
 USING_IDBLOB_SCOPE;
@@ -73,19 +74,35 @@ void CPubseqGatewayCacheSi2Csi::Open()
     CPubseqGatewayCacheBase::Open();
     {
         auto rdtxn = BeginReadTxn();
-        m_Dbi = unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>(
-            new lmdb::dbi({lmdb::dbi::open(rdtxn, "#DATA", 0)}),
-            [this](lmdb::dbi* dbi){
-                if (dbi && *dbi) {
-                    dbi->close(*m_Env);
-                }
-                delete(dbi);
-            }
-        );
+        m_Dbi = x_OpenDataDbi(rdtxn, kPsgCacheFlatDbi, kPsgCacheProtobufDbi, m_Flat);
     }
 }
 
+size_t CPubseqGatewayCacheSi2Csi::ConvertToFlat(const string& file_name)
+{
+    CPubseqGatewayCacheSi2Csi cache(file_name);
+    cache.x_OpenForWriting();
+    return cache.x_ConvertDbi({{kPsgCacheProtobufDbi, kPsgCacheFlatDbi}},
+        [](lmdb::val const& value, string& flat_value) {
+            CSI2CSIRecord record;
+            if (!x_ExtractProtobufRecord(record, value)) {
+                return false;
+            }
+            flat_value = PackFlatValue(record);
+            return true;
+        }
+    );
+}
+
 bool CPubseqGatewayCacheSi2Csi::x_ExtractRecord(CSI2CSIRecord& record, lmdb::val const& value) const
+{
+    if (m_Flat) {
+        return UnpackFlatValue(value.data<const char>(), value.size(), record);
+    }
+    return x_ExtractProtobufRecord(record, value);
+}
+
+bool CPubseqGatewayCacheSi2Csi::x_ExtractProtobufRecord(CSI2CSIRecord& record, lmdb::val const& value)
 {
     ::psg::retrieval::BioseqInfoKey info;
     if (!info.ParseFromArray(value.data(), value.size())) {
@@ -202,4 +219,32 @@ bool CPubseqGatewayCacheSi2Csi::UnpackKey(const char* key, size_t key_sz, string
     return false;
 }
 
+string CPubseqGatewayCacheSi2Csi::PackFlatValue(const CSI2CSIRecord& record)
+{
+    SPsgCacheFlatSi2Csi fixed;
+    fixed.format_version = kPsgCacheFlatFormatVersion;
+    fixed.seq_id_type = record.GetSeqIdType();
+    fixed.version = record.GetVersion();
+    fixed.gi = record.GetGI();
+    CPubseqGatewayCacheFlatWriter writer(fixed);
+    writer.Append(record.GetAccession());
+    return std::move(writer.GetValue());
+}
+
+bool CPubseqGatewayCacheSi2Csi::UnpackFlatValue(const char* value, size_t value_sz, CSI2CSIRecord& record)
+{
+    CPubseqGatewayCacheFlatReader reader(value, value_sz);
+    const SPsgCacheFlatSi2Csi* fixed{nullptr};
+    CTempString accession;
+    if (!reader.GetFixed(fixed) || !reader.Get(accession)) {
+        return false;
+    }
+    record
+        .SetAccession(string(accession))
+        .SetVersion(fixed->version)
+        .SetSeqIdType(fixed->seq_id_type)
+        .SetGI(fixed->gi);
+    return true;
+}
+
 END_IDBLOB_SCOPE
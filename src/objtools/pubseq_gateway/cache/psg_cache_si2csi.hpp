@@ -60,9 +60,25 @@ class CPubseqGatewayCacheSi2Csi
     static bool UnpackKey(const char* key, size_t key_sz, int& sec_seq_id_type);
     static bool UnpackKey(const char* key, size_t key_sz, string& sec_seqid, int& sec_seq_id_type);
 
+    static string PackFlatValue(const CSI2CSIRecord& record);
+    static bool UnpackFlatValue(const char* value, size_t value_sz, CSI2CSIRecord& record);
+
+    /// Adds flat copy of the data (#FLAT database) to the cache file
+    /// @return number of converted records
+    // @throws lmdb::error
+    static size_t ConvertToFlat(const string& file_name);
+
+    /// True if the cache reads flat values
+    bool IsFlat() const
+    {
+        return m_Flat;
+    }
+
  private:
+    static bool x_ExtractProtobufRecord(CSI2CSIRecord& record, lmdb::val const& value);
     bool x_ExtractRecord(CSI2CSIRecord& record, lmdb::val const& value) const;
-    unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>> m_Dbi;
+    TDbiPtr m_Dbi;
+    bool m_Flat{false};
 };
 
 END_IDBLOB_SCOPE
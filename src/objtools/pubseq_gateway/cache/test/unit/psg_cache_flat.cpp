@@ -0,0 +1,219 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* Author:  Dmitrii Saprykin, NCBI
+*
+* File Description:
+*   Unit test suite to check conversion of cache files to flat values
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <corelib/ncbifile.hpp>
+#include <util/lmdbxx/lmdb++.h>
+
+#include <objtools/pubseq_gateway/protobuf/psg_protobuf.pb.h>
+
+#include "../../psg_cache_si2csi.hpp"
+
+BEGIN_SCOPE()
+
+USING_NCBI_SCOPE;
+USING_IDBLOB_SCOPE;
+
+const size_t kRecordCount = 1000;
+const int kSecSeqIdType = 12;
+
+class CPsgCacheFlatTest
+    : public testing::Test
+{
+ public:
+    CPsgCacheFlatTest() = default;
+
+ protected:
+    void SetUp() override
+    {
+        m_FileName = CDirEntry::GetTmpName();
+        auto env = x_OpenEnv();
+        auto wrtxn = lmdb::txn::begin(env);
+        auto dbi = lmdb::dbi::open(wrtxn, "#DATA", MDB_CREATE);
+        for (size_t i = 0; i < kRecordCount; ++i) {
+            dbi.put(wrtxn, lmdb::val(x_GetKey(i)), lmdb::val(x_GetValue(i, x_GetGi(i))));
+        }
+        wrtxn.commit();
+    }
+
+    void TearDown() override
+    {
+        CFile(m_FileName).Remove();
+        CFile(m_FileName + "-lock").Remove();
+    }
+
+    lmdb::env x_OpenEnv()
+    {
+        auto env = lmdb::env::create();
+        env.set_max_dbs(4);
+        env.open(m_FileName.c_str(), MDB_NOSUBDIR, 0664);
+        return env;
+    }
+
+    static string x_GetSecSeqId(size_t i)
+    {
+        return "SEC" + to_string(i);
+    }
+
+    static string x_GetKey(size_t i)
+    {
+        return CPubseqGatewayCache::PackSiKey(x_GetSecSeqId(i), kSecSeqIdType);
+    }
+
+    static int64_t x_GetGi(size_t i)
+    {
+        return 1000000 + i;
+    }
+
+    static string x_GetValue(size_t i, int64_t gi)
+    {
+        ::psg::retrieval::BioseqInfoKey value;
+        value.set_accession("AC" + to_string(100000 + i));
+        value.set_version(1);
+        value.set_seq_id_type(static_cast<::psg::retrieval::EnumSeqIdType>(5));
+        value.set_gi(gi);
+        return value.SerializeAsString();
+    }
+
+    /// Checks all records of the file, gi_changed record has gi 0
+    static void x_CheckLookups(CPubseqGatewayCacheSi2Csi& cache, size_t gi_changed = kRecordCount)
+    {
+        CSi2CsiFetchRequest request;
+        for (size_t i = 0; i < kRecordCount; ++i) {
+            request.Reset().SetSecSeqId(x_GetSecSeqId(i)).SetSecSeqIdType(kSecSeqIdType);
+            auto response = cache.Fetch(request);
+            ASSERT_EQ(1UL, response.size()) << "Record " << i;
+            EXPECT_EQ("AC" + to_string(100000 + i), response[0].GetAccession());
+            EXPECT_EQ(1, response[0].GetVersion());
+            EXPECT_EQ(5, response[0].GetSeqIdType());
+            EXPECT_EQ(i == gi_changed? 0: x_GetGi(i), response[0].GetGI());
+        }
+        request.Reset().SetSecSeqId("FAKE").SetSecSeqIdType(kSecSeqIdType);
+        EXPECT_TRUE(cache.Fetch(request).empty());
+    }
+
+    string m_FileName;
+};
+
+TEST_F(CPsgCacheFlatTest, NotConverted)
+{
+    CPubseqGatewayCacheSi2Csi cache(m_FileName);
+    cache.Open();
+    EXPECT_FALSE(cache.IsFlat());
+    x_CheckLookups(cache);
+}
+
+TEST_F(CPsgCacheFlatTest, Converted)
+{
+    EXPECT_EQ(kRecordCount, CPubseqGatewayCacheSi2Csi::ConvertToFlat(m_FileName));
+    CPubseqGatewayCacheSi2Csi cache(m_FileName);
+    cache.Open();
+    EXPECT_TRUE(cache.IsFlat());
+    x_CheckLookups(cache);
+}
+
+TEST_F(CPsgCacheFlatTest, Reconverted)
+{
+    EXPECT_EQ(kRecordCount, CPubseqGatewayCacheSi2Csi::ConvertToFlat(m_FileName));
+    EXPECT_EQ(kRecordCount, CPubseqGatewayCacheSi2Csi::ConvertToFlat(m_FileName));
+    CPubseqGatewayCacheSi2Csi cache(m_FileName);
+    cache.Open();
+    EXPECT_TRUE(cache.IsFlat());
+    x_CheckLookups(cache);
+}
+
+TEST_F(CPsgCacheFlatTest, Interrupted)
+{
+    // Conversion stopped after the first batch: partial #FLAT, no marker
+    {
+        auto env = x_OpenEnv();
+        auto wrtxn = lmdb::txn::begin(env);
+        auto dbi = lmdb::dbi::open(wrtxn, "#FLAT", MDB_CREATE);
+        for (size_t i = 0; i < kRecordCount / 2; ++i) {
+            CSI2CSIRecord record;
+            record
+                .SetAccession("AC" + to_string(100000 + i))
+                .SetVersion(1)
+                .SetSeqIdType(5)
+                .SetGI(x_GetGi(i));
+            dbi.put(wrtxn, lmdb::val(x_GetKey(i)), lmdb::val(CPubseqGatewayCacheSi2Csi::PackFlatValue(record)));
+        }
+        wrtxn.commit();
+    }
+    CPubseqGatewayCacheSi2Csi cache(m_FileName);
+    cache.Open();
+    EXPECT_FALSE(cache.IsFlat());
+    x_CheckLookups(cache);
+}
+
+TEST_F(CPsgCacheFlatTest, Stale)
+{
+    EXPECT_EQ(kRecordCount, CPubseqGatewayCacheSi2Csi::ConvertToFlat(m_FileName));
+    // #DATA is updated in place after the conversion
+    const size_t gi_changed = 10;
+    {
+        auto env = x_OpenEnv();
+        auto wrtxn = lmdb::txn::begin(env);
+        auto dbi = lmdb::dbi::open(wrtxn, "#DATA", 0);
+        dbi.put(wrtxn, lmdb::val(x_GetKey(gi_changed)), lmdb::val(x_GetValue(gi_changed, 0)));
+        wrtxn.commit();
+    }
+    CPubseqGatewayCacheSi2Csi cache(m_FileName);
+    cache.Open();
+    EXPECT_FALSE(cache.IsFlat());
+    x_CheckLookups(cache, gi_changed);
+}
+
+TEST_F(CPsgCacheFlatTest, RecordAdded)
+{
+    EXPECT_EQ(kRecordCount, CPubseqGatewayCacheSi2Csi::ConvertToFlat(m_FileName));
+    {
+        auto env = x_OpenEnv();
+        auto wrtxn = lmdb::txn::begin(env);
+        auto dbi = lmdb::dbi::open(wrtxn, "#DATA", 0);
+        dbi.put(wrtxn, lmdb::val(x_GetKey(kRecordCount)), lmdb::val(x_GetValue(kRecordCount, 1)));
+        wrtxn.commit();
+    }
+    CPubseqGatewayCacheSi2Csi cache(m_FileName);
+    cache.Open();
+    EXPECT_FALSE(cache.IsFlat());
+    x_CheckLookups(cache);
+}
+
+END_SCOPE()
@@ -174,4 +174,89 @@ TEST_F(CPsgCachePackUnpackTest, BioseqInfo)
     }
 }
 
+TEST_F(CPsgCachePackUnpackTest, FlatValues)
+{
+    {
+        CBioseqInfoRecord::TSeqIds seq_ids;
+        seq_ids.insert(make_tuple(static_cast<int16_t>(12), string("3643631")));
+        seq_ids.insert(make_tuple(static_cast<int16_t>(5), string("AC005299.1")));
+        CBioseqInfoRecord source, result;
+        source
+            .SetHash(-1254382465)
+            .SetLength(34305)
+            .SetMol(1)
+            .SetName("AC005299")
+            .SetSat(4)
+            .SetSatKey(12345)
+            .SetState(10)
+            .SetSeqState(0)
+            .SetTaxId(9606)
+            .SetDateChanged(1489534200000)
+            .SetSeqIds(seq_ids);
+        string value = m_Cache->PackBioseqInfoFlatValue(source);
+        EXPECT_TRUE(m_Cache->UnpackBioseqInfoFlatValue(value.c_str(), value.size(), result));
+        EXPECT_EQ(-1254382465, result.GetHash());
+        EXPECT_EQ(34305, result.GetLength());
+        EXPECT_EQ(1, result.GetMol());
+        EXPECT_EQ("AC005299", result.GetName());
+        EXPECT_EQ(4, result.GetSat());
+        EXPECT_EQ(12345, result.GetSatKey());
+        EXPECT_EQ(10, result.GetState());
+        EXPECT_EQ(0, result.GetSeqState());
+        EXPECT_EQ(9606, result.GetTaxId());
+        EXPECT_EQ(1489534200000, result.GetDateChanged());
+        EXPECT_EQ(seq_ids, result.GetSeqIds());
+        EXPECT_FALSE(m_Cache->UnpackBioseqInfoFlatValue(value.c_str(), value.size() - 1, result));
+    }
+
+    {
+        CSI2CSIRecord source, result;
+        source
+            .SetAccession("AC005299")
+            .SetVersion(1)
+            .SetSeqIdType(5)
+            .SetGI(3643631);
+        string value = m_Cache->PackSiFlatValue(source);
+        EXPECT_TRUE(m_Cache->UnpackSiFlatValue(value.c_str(), value.size(), result));
+        EXPECT_EQ("AC005299", result.GetAccession());
+        EXPECT_EQ(1, result.GetVersion());
+        EXPECT_EQ(5, result.GetSeqIdType());
+        EXPECT_EQ(3643631, result.GetGI());
+        EXPECT_FALSE(m_Cache->UnpackSiFlatValue(value.c_str(), 3, result));
+    }
+
+    {
+        CBlobRecord source, result;
+        source
+            .SetClass(9)
+            .SetDateAsn1(1489534200000)
+            .SetHupDate(0)
+            .SetDiv("PRI")
+            .SetFlags(4)
+            .SetNChunks(2)
+            .SetId2Info("")
+            .SetOwner(19)
+            .SetSize(7850)
+            .SetSizeUnpacked(34512)
+            .SetUserName("GENBANK");
+        string value = m_Cache->PackBlobPropFlatValue(source);
+        EXPECT_TRUE(m_Cache->UnpackBlobPropFlatValue(value.c_str(), value.size(), result));
+        EXPECT_EQ(9, result.GetClass());
+        EXPECT_EQ(1489534200000, result.GetDateAsn1());
+        EXPECT_EQ(0, result.GetHupDate());
+        EXPECT_EQ("PRI", result.GetDiv());
+        EXPECT_EQ(4, result.GetFlags());
+        EXPECT_EQ(2, result.GetNChunks());
+        EXPECT_EQ("", result.GetId2Info());
+        EXPECT_EQ(19, result.GetOwner());
+        EXPECT_EQ(7850, result.GetSize());
+        EXPECT_EQ(34512, result.GetSizeUnpacked());
+        EXPECT_EQ("GENBANK", result.GetUserName());
+
+        // Value of unknown format version
+        value[0] = 0;
+        EXPECT_FALSE(m_Cache->UnpackBlobPropFlatValue(value.c_str(), value.size(), result));
+    }
+}
+
 END_SCOPE()
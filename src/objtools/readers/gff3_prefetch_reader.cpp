@@ -0,0 +1,280 @@
+/*
+ * $Id$
+ *
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Line reader parsing GFF3 feature lines ahead on worker threads
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include "gff3_prefetch_reader.hpp"
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+//  ----------------------------------------------------------------------------
+CGff3PrefetchReader::CGff3PrefetchReader(
+    ILineReader& source,
+    TRecordFactory factory,
+    unsigned int threads,
+    size_t blockLines):
+//  ----------------------------------------------------------------------------
+    mSource(source),
+    mFactory(factory),
+    mThreads(max(threads, 1u)),
+    mBlockLines(max(blockLines, size_t(1))),
+    mSourceDone(false),
+    mIndex(0),
+    mUngot(false)
+{
+}
+
+//  ----------------------------------------------------------------------------
+CGff3PrefetchReader::~CGff3PrefetchReader()
+//  ----------------------------------------------------------------------------
+{
+    // the workers still use the blocks
+    for (auto& pending: mPending) {
+        if (pending.mParsed.valid()) {
+            pending.mParsed.wait();
+        }
+    }
+}
+
+//  ----------------------------------------------------------------------------
+bool
+CGff3PrefetchReader::AtEOF() const
+//  ----------------------------------------------------------------------------
+{
+    if (mUngot) {
+        return false;
+    }
+    if (mpCurrent  &&  mIndex + 1 < mpCurrent->mLines.size()) {
+        return false;
+    }
+    if (!mPending.empty()) {
+        return false;
+    }
+    return mSourceDone  ||  mSource.AtEOF();
+}
+
+//  ----------------------------------------------------------------------------
+char
+CGff3PrefetchReader::PeekChar() const
+//  ----------------------------------------------------------------------------
+{
+    const string* pNext = nullptr;
+    if (mUngot) {
+        pNext = &mpCurrent->mLines[mIndex];
+    }
+    else if (mpCurrent  &&  mIndex + 1 < mpCurrent->mLines.size()) {
+        pNext = &mpCurrent->mLines[mIndex + 1];
+    }
+    else if (!mPending.empty()) {
+        // the lines are not changed by the worker
+        pNext = &mPending.front().mpBlock->mLines.front();
+    }
+    else if (!mSourceDone) {
+        return mSource.PeekChar();
+    }
+    return (pNext  &&  !pNext->empty()) ? (*pNext)[0] : 0;
+}
+
+//  ----------------------------------------------------------------------------
+ILineReader&
+CGff3PrefetchReader::operator++()
+//  ----------------------------------------------------------------------------
+{
+    if (mUngot) {
+        mUngot = false;
+        return *this;
+    }
+    if (mpCurrent  &&  mIndex + 1 < mpCurrent->mLines.size()) {
+        ++mIndex;
+        return *this;
+    }
+    xFill();
+    mIndex = 0;
+    if (mPending.empty()) {
+        mpCurrent.reset();
+        return *this;
+    }
+    mPending.front().mParsed.get();
+    mpCurrent = std::move(mPending.front().mpBlock);
+    mPending.pop_front();
+    xFill();
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+void
+CGff3PrefetchReader::UngetLine()
+//  ----------------------------------------------------------------------------
+{
+    _ASSERT(mpCurrent  &&  !mUngot);
+    mUngot = true;
+}
+
+//  ----------------------------------------------------------------------------
+CTempString
+CGff3PrefetchReader::operator*() const
+//  ----------------------------------------------------------------------------
+{
+    if (mUngot  ||  !mpCurrent) {
+        return CTempString();
+    }
+    return mpCurrent->mLines[mIndex];
+}
+
+//  ----------------------------------------------------------------------------
+CT_POS_TYPE
+CGff3PrefetchReader::GetPosition() const
+//  ----------------------------------------------------------------------------
+{
+    if (!mpCurrent) {
+        return mSource.GetPosition();
+    }
+    return mpCurrent->mPositions[mIndex];
+}
+
+//  ----------------------------------------------------------------------------
+Uint8
+CGff3PrefetchReader::GetLineNumber() const
+//  ----------------------------------------------------------------------------
+{
+    if (!mpCurrent) {
+        return mSource.GetLineNumber();
+    }
+    return mpCurrent->mLineNumbers[mIndex];
+}
+
+//  ----------------------------------------------------------------------------
+bool
+CGff3PrefetchReader::TakeRecord(
+    const string& line,
+    unique_ptr<CGff3ReadRecord>& pRecord)
+//  ----------------------------------------------------------------------------
+{
+    if (mUngot  ||  !mpCurrent  ||  !mpCurrent->mParsed[mIndex]) {
+        return false;
+    }
+    SBlock& block = *mpCurrent;
+    // a pending line may have been handed out instead of the current one
+    if (NStr::TruncateSpaces_Unsafe(block.mLines[mIndex]) != line) {
+        return false;
+    }
+    block.mParsed[mIndex] = false;
+    if (block.mErrors[mIndex]) {
+        rethrow_exception(block.mErrors[mIndex]);
+    }
+    pRecord = std::move(block.mRecords[mIndex]);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+void
+CGff3PrefetchReader::xFill()
+//  ----------------------------------------------------------------------------
+{
+    // two blocks per thread keep the workers busy while one is handed out
+    while (mPending.size() < 2*mThreads  &&  xReadBlock())
+        ;
+}
+
+//  ----------------------------------------------------------------------------
+bool
+CGff3PrefetchReader::xReadBlock()
+//  ----------------------------------------------------------------------------
+{
+    if (mSourceDone) {
+        return false;
+    }
+    unique_ptr<SBlock> pBlock(new SBlock);
+    pBlock->mLines.reserve(mBlockLines);
+    while (pBlock->mLines.size() < mBlockLines) {
+        if (mSource.AtEOF()) {
+            mSourceDone = true;
+            break;
+        }
+        CTempString line = *++mSource;
+        pBlock->mLines.push_back(line);
+        pBlock->mPositions.push_back(mSource.GetPosition());
+        pBlock->mLineNumbers.push_back(mSource.GetLineNumber());
+        if (NStr::StartsWith(line, "##fasta", NStr::eNocase)) {
+            mSourceDone = true;
+            break;
+        }
+    }
+    if (pBlock->mLines.empty()) {
+        return false;
+    }
+    SBlock& block = *pBlock;
+    const TRecordFactory& factory = mFactory;
+    mPending.push_back(SPending{
+        std::move(pBlock),
+        async(launch::async, [&block, &factory]() {
+            xParseBlock(block, factory);
+        })});
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+void
+CGff3PrefetchReader::xParseBlock(
+    SBlock& block,
+    const TRecordFactory& factory)
+//  ----------------------------------------------------------------------------
+{
+    const size_t count = block.mLines.size();
+    block.mParsed.assign(count, false);
+    block.mRecords.resize(count);
+    block.mErrors.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        string line = NStr::TruncateSpaces(block.mLines[i]);
+        if (line.empty()  ||  line[0] == '#'  ||
+                NStr::StartsWith(line, "track")  ||
+                NStr::StartsWith(line, "browser")  ||
+                CGff2Reader::IsAlignmentData(line)) {
+            continue;
+        }
+        block.mParsed[i] = true;
+        try {
+            unique_ptr<CGff3ReadRecord> pRecord(
+                factory(block.mLineNumbers[i]));
+            if (pRecord->AssignFromGff(line)) {
+                block.mRecords[i] = std::move(pRecord);
+            }
+        }
+        catch (...) {
+            block.mErrors[i] = current_exception();
+        }
+    }
+}
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
@@ -0,0 +1,126 @@
+#ifndef _GFF3_PREFETCH_READER_HPP_
+#define _GFF3_PREFETCH_READER_HPP_
+/*
+ * $Id$
+ *
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Line reader parsing GFF3 feature lines ahead on worker threads
+ *
+ */
+
+#include <corelib/ncbistd.hpp>
+#include <util/line_reader.hpp>
+#include <objtools/readers/gff3_reader.hpp>
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects);
+
+//  ----------------------------------------------------------------------------
+//  Hands out the lines of the source reader unchanged, but reads them in
+//  blocks and runs CGff3ReadRecord::AssignFromGff() on the feature lines of
+//  each block on a worker thread while the reader builds the features of the
+//  previous ones. The reader picks up the result with TakeRecord(); anything
+//  that is not a feature line, or does not look like one here, is left for
+//  the reader to parse as before, so the annots do not change.
+//  Reading ahead stops after a ##FASTA directive, the sequence data is left
+//  in the source reader.
+class CGff3PrefetchReader
+//  ----------------------------------------------------------------------------
+    : public ILineReader
+{
+public:
+    /// Creates the record for the line with the given number of the source;
+    /// called on the worker threads.
+    using TRecordFactory = function<CGff3ReadRecord*(Uint8 lineNumber)>;
+
+    CGff3PrefetchReader(
+        ILineReader& source,
+        TRecordFactory factory,
+        unsigned int threads,
+        size_t blockLines);
+    ~CGff3PrefetchReader() override;
+
+    const ILineReader& Source() const { return mSource; };
+
+    // ILineReader:
+    bool AtEOF() const override;
+    char PeekChar() const override;
+    ILineReader& operator++() override;
+    void UngetLine() override;
+    CTempString operator*() const override;
+    CT_POS_TYPE GetPosition() const override;
+    Uint8 GetLineNumber() const override;
+
+    /// Record parsed from the current line if it is the given (trimmed)
+    /// line. Returns false if the line was not parsed ahead; otherwise the
+    /// record is null if it was rejected, and parse errors are rethrown.
+    bool TakeRecord(
+        const string& line,
+        unique_ptr<CGff3ReadRecord>& pRecord);
+
+private:
+    struct SBlock {
+        vector<string> mLines;
+        vector<CT_POS_TYPE> mPositions;
+        vector<Uint8> mLineNumbers;
+        // filled by the worker:
+        vector<bool> mParsed;
+        vector<unique_ptr<CGff3ReadRecord>> mRecords;
+        vector<exception_ptr> mErrors;
+    };
+    struct SPending {
+        unique_ptr<SBlock> mpBlock;
+        future<void> mParsed;
+    };
+
+    void xFill();
+    bool xReadBlock();
+    static void xParseBlock(
+        SBlock&,
+        const TRecordFactory&);
+
+    ILineReader& mSource;
+    TRecordFactory mFactory;
+    unsigned int mThreads;
+    size_t mBlockLines;
+    bool mSourceDone;
+
+    deque<SPending> mPending;
+    unique_ptr<SBlock> mpCurrent;
+    size_t mIndex;
+    bool mUngot;
+};
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif // _GFF3_PREFETCH_READER_HPP_
@@ -61,8 +61,10 @@
 #include <objtools/readers/gff3_location_merger.hpp>
 
 #include "reader_message_handler.hpp"
+#include "gff3_prefetch_reader.hpp"
 
 #include <algorithm>
+#include <future>
 
 BEGIN_NCBI_SCOPE
 BEGIN_objects_SCOPE
@@ -204,7 +206,10 @@ CGff3Reader::CGff3Reader(
     SeqIdResolver resolver,
     CReaderListener* pRL):
 //  ----------------------------------------------------------------------------
-    CGff2Reader( uFlags, name, title, resolver, pRL )
+    CGff2Reader( uFlags, name, title, resolver, pRL ),
+    mParseThreads(0),
+    mParseBlockLines(4096),
+    mpPrefetch(nullptr)
 {
     mpLocations.reset(new CGff3LocationMerger(uFlags, resolver, 0, pRL));
     CGff2Record::ResetId();
@@ -243,6 +248,51 @@ CGff3Reader::ReadSeqAnnot(
     return pAnnot;
 }
 
+//  ----------------------------------------------------------------------------
+void
+CGff3Reader::ReadSeqAnnots(
+    TAnnotList& annots,
+    ILineReader& lr,
+    ILineErrorListener* pEC)
+//  ----------------------------------------------------------------------------
+{
+    if (mParseThreads == 0) {
+        CGff2Reader::ReadSeqAnnots(annots, lr, pEC);
+        return;
+    }
+    // the records are created on the worker threads: they get the number of
+    // their own line, as counted by this reader, not m_uLineNumber
+    const Int8 lineOffset = Int8(m_uLineNumber) - Int8(lr.GetLineNumber());
+    CRef<CGff3PrefetchReader> pPrefetch(new CGff3PrefetchReader(
+        lr,
+        [this, lineOffset](Uint8 lineNumber) {
+            return x_CreateRecordForLine(
+                static_cast<unsigned int>(lineNumber + lineOffset));
+        },
+        mParseThreads,
+        mParseBlockLines));
+    mpPrefetch = pPrefetch.GetPointer();
+    try {
+        CGff2Reader::ReadSeqAnnots(annots, *pPrefetch, pEC);
+    }
+    catch (...) {
+        mpPrefetch = nullptr;
+        throw;
+    }
+    mpPrefetch = nullptr;
+}
+
+//  ----------------------------------------------------------------------------
+void
+CGff3Reader::SetParseThreads(
+    unsigned int threads,
+    size_t blockLines)
+//  ----------------------------------------------------------------------------
+{
+    mParseThreads = threads;
+    mParseBlockLines = blockLines;
+}
+
 //  ----------------------------------------------------------------------------
 void
 CGff3Reader::xProcessData(
@@ -301,10 +351,11 @@ CGff3Reader::xParseFeature(
         return xParseAlignment(line);
     }
 
-    //parse record:
-    shared_ptr<CGff3ReadRecord> pRecord(x_CreateRecord());
+    //parse record, unless done ahead:
+    shared_ptr<CGff3ReadRecord> pRecord;
     try {
-        if (!pRecord->AssignFromGff(line)) {
+        pRecord = xParseRecord(line);
+        if (!pRecord) {
             return false;
         }
     }
@@ -342,6 +393,24 @@ CGff3Reader::xParseFeature(
 }
 
 
+//  ----------------------------------------------------------------------------
+unique_ptr<CGff3ReadRecord>
+CGff3Reader::xParseRecord(
+    const string& line)
+//  ----------------------------------------------------------------------------
+{
+    unique_ptr<CGff3ReadRecord> pRecord;
+    if (mpPrefetch  &&  mpPrefetch->TakeRecord(line, pRecord)) {
+        return pRecord;
+    }
+    pRecord.reset(x_CreateRecord());
+    if (!pRecord->AssignFromGff(line)) {
+        pRecord.reset();
+    }
+    return pRecord;
+}
+
+
 //  ----------------------------------------------------------------------------
 bool CGff3Reader::xParseAlignment(
     const string& strLine)
@@ -1001,67 +1070,117 @@ void CGff3Reader::xPostProcessAnnot(
     }
 
     // location fixup:
-    for (auto itLocation : mpLocations->LocationMap()) {
-        auto id        = itLocation.first;
-        auto itFeature = m_MapIdToFeature.find(id);
+    // each feature is fixed up from its own copy of the locations, so
+    // with threads the features are split between them
+    struct SFixup {
+        const string* mpId;
+        CSeq_feat* mpFeature;
+        const list<CGff3LocationRecord>* mpLocations;
+    };
+    vector<SFixup> fixups;
+    set<const CSeq_feat*> features;
+    bool distinct = true;
+    for (const auto& itLocation : mpLocations->LocationMap()) {
+        auto itFeature = m_MapIdToFeature.find(itLocation.first);
         if (itFeature == m_MapIdToFeature.end()) {
             continue;
         }
-        CRef<CSeq_loc>    pNewLoc(new CSeq_loc);
-        CRef<CSeq_feat>   pFeature = itFeature->second;
-        CCdregion::EFrame frame;
-        const auto&       locs = itLocation.second;
-
-        if (pFeature->GetData().IsImp() &&
-            pFeature->GetData().GetImp().IsSetKey() &&
-            pFeature->GetData().GetImp().GetKey() == "misc_RNA") {
-            // RW-143: if this has a child (pseudogenic) CDS, convert to mRNA
-            if (xHasCdsChild(id)) {
-                pFeature->SetData().SetRna().SetType(CRNA_ref::eType_mRNA);
-            }
+        CSeq_feat* pFeature = itFeature->second.GetPointer();
+        fixups.push_back(SFixup{&itLocation.first, pFeature, &itLocation.second});
+        if (mParseThreads > 1  &&  distinct) {
+            distinct = features.insert(pFeature).second;
         }
-
-        if (s_TreatAsRna(pFeature->GetData())) {
-            // check for exons
-            list<CGff3LocationRecord> exonLocs;
-            for (auto record : locs) {
-                if (record.mType == "exon") {
-                    exonLocs.push_back(record);
+    }
+    const size_t kMinFixupsPerThread = 1000;
+    size_t threads = min(size_t(mParseThreads), fixups.size() / kMinFixupsPerThread);
+    if (threads > 1  &&  distinct) {
+        vector<future<void>> parts;
+        for (size_t t = 0; t < threads; ++t) {
+            size_t begin = fixups.size() * t / threads;
+            size_t end = fixups.size() * (t + 1) / threads;
+            parts.push_back(async(launch::async, [this, &fixups, begin, end]() {
+                for (size_t i = begin; i < end; ++i) {
+                    const auto& fixup = fixups[i];
+                    xMergeFeatureLocation(
+                        *fixup.mpId, *fixup.mpFeature, *fixup.mpLocations);
                 }
-            }
-            // prioritize exons over UTR and CDS child features
-            if (! exonLocs.empty()) {
-                mpLocations->MergeLocation(pNewLoc, frame, exonLocs);
-                pFeature->SetLocation(*pNewLoc);
-                continue;
-            }
-        } else if (pFeature->GetData().IsGene()) {
+            }));
+        }
+        for (auto& part : parts) {
+            part.wait();
+        }
+        for (auto& part : parts) {
+            part.get();
+        }
+    }
+    else {
+        for (const auto& fixup : fixups) {
+            xMergeFeatureLocation(
+                *fixup.mpId, *fixup.mpFeature, *fixup.mpLocations);
+        }
+    }
 
-            list<CGff3LocationRecord> geneLocs;
-            for (auto record : locs) {
-                if (record.mType == "gene") {
-                    geneLocs.push_back(record);
-                }
-            }
+    return CGff2Reader::xPostProcessAnnot(annot);
+}
+
+//  ----------------------------------------------------------------------------
+void CGff3Reader::xMergeFeatureLocation(
+    const string& id,
+    CSeq_feat& feature,
+    list<CGff3LocationRecord> locs)
+//  ----------------------------------------------------------------------------
+{
+    CRef<CSeq_loc>    pNewLoc(new CSeq_loc);
+    CSeq_feat*        pFeature = &feature;
+    CCdregion::EFrame frame;
+
+    if (pFeature->GetData().IsImp() &&
+        pFeature->GetData().GetImp().IsSetKey() &&
+        pFeature->GetData().GetImp().GetKey() == "misc_RNA") {
+        // RW-143: if this has a child (pseudogenic) CDS, convert to mRNA
+        if (xHasCdsChild(id)) {
+            pFeature->SetData().SetRna().SetType(CRNA_ref::eType_mRNA);
+        }
+    }
 
-            if (! geneLocs.empty()) { // should never be empty
-                mpLocations->MergeLocation(pNewLoc, frame, geneLocs);
-                pFeature->SetLocation(*pNewLoc);
-                continue;
+    if (s_TreatAsRna(pFeature->GetData())) {
+        // check for exons
+        list<CGff3LocationRecord> exonLocs;
+        for (auto record : locs) {
+            if (record.mType == "exon") {
+                exonLocs.push_back(record);
             }
         }
+        // prioritize exons over UTR and CDS child features
+        if (! exonLocs.empty()) {
+            mpLocations->MergeLocation(pNewLoc, frame, exonLocs);
+            pFeature->SetLocation(*pNewLoc);
+            return;
+        }
+    } else if (pFeature->GetData().IsGene()) {
 
+        list<CGff3LocationRecord> geneLocs;
+        for (auto record : locs) {
+            if (record.mType == "gene") {
+                geneLocs.push_back(record);
+            }
+        }
 
-        mpLocations->MergeLocation(pNewLoc, frame, itLocation.second);
-        pFeature->SetLocation(*pNewLoc);
-        if (pFeature->GetData().IsCdregion()) {
-            auto& cdrData = pFeature->SetData().SetCdregion();
-            cdrData.SetFrame(
-                frame == CCdregion::eFrame_not_set ? CCdregion::eFrame_one : frame);
+        if (! geneLocs.empty()) { // should never be empty
+            mpLocations->MergeLocation(pNewLoc, frame, geneLocs);
+            pFeature->SetLocation(*pNewLoc);
+            return;
         }
     }
 
-    return CGff2Reader::xPostProcessAnnot(annot);
+
+    mpLocations->MergeLocation(pNewLoc, frame, locs);
+    pFeature->SetLocation(*pNewLoc);
+    if (pFeature->GetData().IsCdregion()) {
+        auto& cdrData = pFeature->SetData().SetCdregion();
+        cdrData.SetFrame(
+            frame == CCdregion::eFrame_not_set ? CCdregion::eFrame_one : frame);
+    }
 }
 
 //  ----------------------------------------------------------------------------
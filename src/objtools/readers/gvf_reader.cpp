@@ -86,7 +86,7 @@ bool CGvfReadRecord::AssignFromGff(
     if (idIt == m_Attributes.end()) {
         CReaderMessage fatal(
             eDiag_Error,
-            0,
+            mLineNumber,
             "Mandatory attribute ID missing.");
         throw fatal;
     }
@@ -95,7 +95,7 @@ bool CGvfReadRecord::AssignFromGff(
     if (variantSeqIt == m_Attributes.end()  ||  referenceSeqIt == m_Attributes.end()) {
         CReaderMessage fatal(
             eDiag_Error,
-            0,
+            mLineNumber,
             "Mandatory attribute Reference_seq and/or Variant_seq missing.");
         throw fatal;
     }
@@ -213,10 +213,12 @@ CGvfReader::xParseFeature(
     ILineErrorListener* pEC)
 //  ----------------------------------------------------------------------------
 {
-    CGvfReadRecord record(m_uLineNumber);
-    if (!record.AssignFromGff(line)) {
+    // parsed ahead on the parse threads, if there are any
+    unique_ptr<CGff3ReadRecord> pRecord(xParseRecord(line));
+    if (!pRecord) {
         return false;
     }
+    const auto& record = static_cast<const CGvfReadRecord&>(*pRecord);
     if (!xMergeRecord(record, annot, pEC)) {
         return false;
     }
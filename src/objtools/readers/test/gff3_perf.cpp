@@ -0,0 +1,179 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *     Throughput of CGff3Reader with and without parallel parsing.
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/line_reader.hpp>
+
+#include <objects/seq/Seq_annot.hpp>
+#include <objtools/readers/gff3_reader.hpp>
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+class CGff3PerfApp : public CNcbiApplication
+{
+public:
+    void Init(void) override;
+    int Run(void) override;
+
+private:
+    string x_MakeData(size_t genes) const;
+    void x_Run(const string& data, unsigned int threads, size_t block_lines,
+               CGff3Reader::TAnnotList& annots);
+};
+
+
+void CGff3PerfApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CGff3Reader throughput");
+
+    arg_desc->AddOptionalKey("i", "InputFile",
+                             "GFF3 file, synthetic data if not given",
+                             CArgDescriptions::eInputFile);
+    arg_desc->AddDefaultKey("genes", "Genes",
+                            "Number of synthetic genes (7 records each)",
+                            CArgDescriptions::eInteger, "20000");
+    arg_desc->AddDefaultKey("threads", "Threads",
+                            "Comma separated thread counts",
+                            CArgDescriptions::eString, "0,2,4,8");
+    arg_desc->AddDefaultKey("block", "Lines",
+                            "Lines per parsing block",
+                            CArgDescriptions::eInteger, "4096");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+string CGff3PerfApp::x_MakeData(size_t genes) const
+{
+    CNcbiOstrstream out;
+    out << "##gff-version 3\n";
+    for (size_t g = 0; g < genes; ++g) {
+        string seq = "chr" + NStr::NumericToString(g % 4 + 1);
+        size_t start = g * 5000 + 1;
+        string gene = "gene" + NStr::NumericToString(g);
+        string rna = "rna" + NStr::NumericToString(g);
+        out << seq << "\tperf\tgene\t" << start << "\t" << start + 3999
+            << "\t.\t+\t.\tID=" << gene << ";Name=G" << g
+            << ";gene_biotype=protein_coding\n";
+        out << seq << "\tperf\tmRNA\t" << start << "\t" << start + 3999
+            << "\t.\t+\t.\tID=" << rna << ";Parent=" << gene
+            << ";product=protein " << g << "\n";
+        for (size_t e = 0; e < 3; ++e) {
+            out << seq << "\tperf\texon\t" << start + e * 1500
+                << "\t" << start + e * 1500 + 999
+                << "\t.\t+\t.\tParent=" << rna << "\n";
+        }
+        for (size_t e = 0; e < 2; ++e) {
+            out << seq << "\tperf\tCDS\t" << start + e * 1500 + 100
+                << "\t" << start + e * 1500 + 999
+                << "\t.\t+\t0\tID=cds" << g << ";Parent=" << rna << "\n";
+        }
+    }
+    return CNcbiOstrstreamToString(out);
+}
+
+
+void CGff3PerfApp::x_Run(const string& data, unsigned int threads,
+                         size_t block_lines, CGff3Reader::TAnnotList& annots)
+{
+    CStopWatch sw(CStopWatch::eStart);
+    CMemoryLineReader lr(data.data(), data.size());
+    CGff3Reader reader(0);
+    reader.SetParseThreads(threads, block_lines);
+    reader.ReadSeqAnnots(annots, lr);
+    double seconds = sw.Elapsed();
+
+    size_t records = 0;
+    for (const auto& annot : annots) {
+        if (annot->GetData().IsFtable()) {
+            records += annot->GetData().GetFtable().size();
+        }
+    }
+    cout << "threads: " << threads
+         << " features: " << records
+         << " time: " << seconds << " s"
+         << " " << size_t(lr.GetLineNumber() / seconds) << " records/s"
+         << " " << data.size() / seconds / (1024*1024) << " MB/s";
+}
+
+
+int CGff3PerfApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    string data;
+    if (args["i"]) {
+        CNcbiOstrstream buffer;
+        buffer << args["i"].AsInputFile().rdbuf();
+        data = CNcbiOstrstreamToString(buffer);
+    }
+    else {
+        data = x_MakeData(args["genes"].AsInteger());
+    }
+    size_t block_lines = args["block"].AsInteger();
+
+    vector<string> threads;
+    NStr::Split(args["threads"].AsString(), ",", threads,
+                NStr::fSplit_Tokenize);
+    CGff3Reader::TAnnotList serial;
+    x_Run(data, 0, block_lines, serial);
+    cout << endl;
+    int result = 0;
+    for (const auto& t : threads) {
+        unsigned int count = NStr::StringToUInt(t);
+        if (count == 0) {
+            continue;
+        }
+        CGff3Reader::TAnnotList annots;
+        x_Run(data, count, block_lines, annots);
+        bool same = annots.size() == serial.size()  &&
+            equal(annots.begin(), annots.end(), serial.begin(),
+                  [](const CRef<CSeq_annot>& a, const CRef<CSeq_annot>& b) {
+                      return a->Equals(*b);
+                  });
+        cout << (same ? " same" : " DIFFERENT") << endl;
+        if (!same) {
+            result = 1;
+        }
+    }
+    return result;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CGff3PerfApp().AppMain(argc, argv);
+}
@@ -0,0 +1,184 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *     Throughput of CVcfReader in the feature and the columnar modes.
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/line_reader.hpp>
+
+#include <objects/seq/Seq_annot.hpp>
+#include <objtools/readers/vcf_reader.hpp>
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+class CVcfPerfApp : public CNcbiApplication
+{
+public:
+    void Init(void) override;
+    int Run(void) override;
+
+private:
+    string x_MakeData(size_t lines, size_t samples, size_t chroms) const;
+    void x_Run(const string& data, int flags,
+               size_t rows, unsigned int threads);
+};
+
+
+void CVcfPerfApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CVcfReader throughput");
+
+    arg_desc->AddOptionalKey("i", "InputFile",
+                             "VCF file, synthetic data if not given",
+                             CArgDescriptions::eInputFile);
+    arg_desc->AddDefaultKey("lines", "Lines",
+                            "Number of synthetic data lines",
+                            CArgDescriptions::eInteger, "200000");
+    arg_desc->AddDefaultKey("samples", "Samples",
+                            "Number of synthetic samples",
+                            CArgDescriptions::eInteger, "20");
+    arg_desc->AddDefaultKey("chroms", "Chromosomes",
+                            "Number of synthetic chromosomes",
+                            CArgDescriptions::eInteger, "4");
+    arg_desc->AddDefaultKey("threads", "Threads",
+                            "Comma separated thread counts for columnar mode",
+                            CArgDescriptions::eString, "0,2,4,8");
+    arg_desc->AddDefaultKey("rows", "Rows",
+                            "Rows per Seq-table in columnar mode",
+                            CArgDescriptions::eInteger, "50000");
+    arg_desc->AddFlag("no_features", "Skip the feature mode run");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+string CVcfPerfApp::x_MakeData(size_t lines, size_t samples,
+                               size_t chroms) const
+{
+    static const char* const kBases[] = { "A", "C", "G", "T" };
+    static const char* const kGenotypes[] = { "0|0", "0|1", "1|0", "1|1" };
+
+    CNcbiOstrstream out;
+    out << "##fileformat=VCFv4.1\n"
+        << "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Depth\">\n"
+        << "##INFO=<ID=AF,Number=A,Type=Float,Description=\"Frequency\">\n"
+        << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+        << "##FORMAT=<ID=DP,Number=1,Type=Integer,Description=\"Depth\">\n"
+        << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO";
+    if (samples) {
+        out << "\tFORMAT";
+        for (size_t s = 0; s < samples; ++s) {
+            out << "\tS" << s;
+        }
+    }
+    out << "\n";
+    size_t per_chrom = max(lines / max(chroms, size_t(1)), size_t(1));
+    for (size_t i = 0; i < lines; ++i) {
+        out << (i / per_chrom + 1) << "\t" << (i % per_chrom) * 10 + 1
+            << "\trs" << i
+            << "\t" << kBases[i % 4] << "\t" << kBases[(i + 1) % 4]
+            << "\t" << (i % 7 ? NStr::IntToString(int(i % 90)) : ".")
+            << "\tPASS\tDP=" << i % 50 << ";AF=0." << i % 10;
+        if (samples) {
+            out << "\tGT:DP";
+            for (size_t s = 0; s < samples; ++s) {
+                out << "\t" << kGenotypes[(i + s) % 4] << ":" << (i + s) % 30;
+            }
+        }
+        out << "\n";
+    }
+    return CNcbiOstrstreamToString(out);
+}
+
+
+void CVcfPerfApp::x_Run(const string& data, int flags,
+                        size_t rows, unsigned int threads)
+{
+    CStopWatch sw(CStopWatch::eStart);
+    CMemoryLineReader lr(data.data(), data.size());
+    CVcfReader reader(flags);
+    if (flags & CVcfReader::fColumnar) {
+        reader.SetColumnarOptions(rows, threads);
+    }
+    CVcfReader::TAnnots annots;
+    reader.ReadSeqAnnots(annots, lr);
+    double seconds = sw.Elapsed();
+
+    size_t lines = lr.GetLineNumber();
+    cout << ((flags & CVcfReader::fColumnar) ? "columnar" : "features")
+         << " threads: " << threads
+         << " annots: " << annots.size()
+         << " time: " << seconds << " s"
+         << " " << data.size() / seconds / (1024*1024) << " MB/s"
+         << " " << size_t(lines / seconds) << " lines/s"
+         << endl;
+}
+
+
+int CVcfPerfApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    string data;
+    if (args["i"]) {
+        CNcbiIstream& in = args["i"].AsInputFile();
+        CNcbiOstrstream buffer;
+        buffer << in.rdbuf();
+        data = CNcbiOstrstreamToString(buffer);
+    }
+    else {
+        data = x_MakeData(args["lines"].AsInteger(),
+                          args["samples"].AsInteger(),
+                          args["chroms"].AsInteger());
+    }
+    size_t rows = args["rows"].AsInteger();
+
+    if (!args["no_features"]) {
+        x_Run(data, CVcfReader::fNormal, rows, 0);
+    }
+    vector<string> threads;
+    NStr::Split(args["threads"].AsString(), ",", threads,
+                NStr::fSplit_Tokenize);
+    for (const auto& t : threads) {
+        x_Run(data, CVcfReader::fColumnar, rows, NStr::StringToUInt(t));
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CVcfPerfApp().AppMain(argc, argv);
+}
@@ -190,7 +190,8 @@ void sUpdateAll(CDir& test_cases_dir) {
     }
 }
 
-void sRunTest(const string &sTestName, const STestInfo & testInfo, bool keep)
+void sRunTest(const string &sTestName, const STestInfo & testInfo, bool keep,
+    unsigned int threads = 0)
 {
     cerr << "Testing " << testInfo.mInFile.GetName() << " against " <<
         testInfo.mOutFile.GetName() << " and " <<
@@ -205,6 +206,8 @@ void sRunTest(const string &sTestName, const STestInfo & testInfo, bool keep)
     ANNOTS annots;
     try {
         CGff3Reader reader(0, &ml);
+        // tiny blocks, so that records span the block boundaries
+        reader.SetParseThreads(threads, 2);
         reader.ReadSeqAnnots(annots, ifstr);
     }
     catch (CReaderMessage&) {
@@ -326,3 +329,36 @@ BOOST_AUTO_TEST_CASE(RunTests)
         BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, args["keep-diffs"]));
     }
 }
+
+BOOST_AUTO_TEST_CASE(RunTestsThreaded)
+{
+    // the parallel mode must give the same annots and messages
+    const CArgs& args = CNcbiApplication::Instance()->GetArgs();
+
+    CDir test_cases_dir( args["test-dir"].AsDirectory() );
+    BOOST_REQUIRE_MESSAGE( test_cases_dir.IsDir(),
+        "Cannot find dir: " << test_cases_dir.GetPath() );
+    if (args["update-all"].AsBoolean()  ||  !args["update-case"].AsString().empty()) {
+        return;
+    }
+
+    const vector<string> kEmptyStringVec;
+    TTestNameToInfoMap testNameToInfoMap;
+    CTestNameToInfoMapLoader testInfoLoader(
+        &testNameToInfoMap, extInput, extOutput, extErrors);
+    FindFilesInDir(
+        test_cases_dir,
+        kEmptyStringVec,
+        kEmptyStringVec,
+        testInfoLoader,
+        fFF_Default | fFF_Recursive );
+
+    ITERATE(TTestNameToInfoMap, name_to_info_it, testNameToInfoMap) {
+        const string & sName = name_to_info_it->first;
+        const STestInfo & testInfo = name_to_info_it->second;
+
+        cout << "Running test with threads: " << sName << endl;
+
+        BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, false, 3));
+    }
+}
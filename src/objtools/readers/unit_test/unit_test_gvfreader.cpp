@@ -37,6 +37,8 @@
 #include <corelib/test_boost.hpp>
 
 #include <objtools/readers/gvf_reader.hpp>
+#include <objtools/readers/message_listener.hpp>
+#include <util/line_reader.hpp>
 #include "tc_message_listener.hpp"
 
 #include <cstdio>
@@ -185,7 +187,8 @@ void sUpdateAll(CDir& test_cases_dir) {
     }
 }
 
-void sRunTest(const string &sTestName, const STestInfo & testInfo, bool keep)
+void sRunTest(const string &sTestName, const STestInfo & testInfo, bool keep,
+    unsigned int threads = 0)
 {
     cerr << "Testing " << testInfo.mInFile.GetName() << " against " <<
         testInfo.mOutFile.GetName() << " and " <<
@@ -200,6 +203,8 @@ void sRunTest(const string &sTestName, const STestInfo & testInfo, bool keep)
     ANNOTS annots;
     try {
         CGvfReader reader(0, "", "", &ml);
+        // tiny blocks, so that records span the block boundaries
+        reader.SetParseThreads(threads, 2);
         reader.ReadSeqAnnots(annots, ifstr);
     }
     catch (...) {
@@ -318,3 +323,74 @@ BOOST_AUTO_TEST_CASE(RunTests)
         BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, args["keep-diffs"]));
     }
 }
+
+BOOST_AUTO_TEST_CASE(RunTestsThreaded)
+{
+    // the parallel mode must give the same annots and messages
+    const CArgs& args = CNcbiApplication::Instance()->GetArgs();
+
+    CDir test_cases_dir( args["test-dir"].AsDirectory() );
+    BOOST_REQUIRE_MESSAGE( test_cases_dir.IsDir(),
+        "Cannot find dir: " << test_cases_dir.GetPath() );
+    if (args["update-all"].AsBoolean()  ||  !args["update-case"].AsString().empty()) {
+        return;
+    }
+
+    const vector<string> kEmptyStringVec;
+    TTestNameToInfoMap testNameToInfoMap;
+    CTestNameToInfoMapLoader testInfoLoader(
+        &testNameToInfoMap, extInput, extOutput, extErrors);
+    FindFilesInDir(
+        test_cases_dir,
+        kEmptyStringVec,
+        kEmptyStringVec,
+        testInfoLoader,
+        fFF_Default | fFF_Recursive );
+
+    ITERATE(TTestNameToInfoMap, name_to_info_it, testNameToInfoMap) {
+        const string & sName = name_to_info_it->first;
+        const STestInfo & testInfo = name_to_info_it->second;
+
+        cout << "Running test with threads: " << sName << endl;
+
+        BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, false, 3));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ThreadedErrorLines)
+{
+    // the records without the mandatory attributes are on lines 3, 6 and 7;
+    // the parse threads must report them there, as the serial reader does
+    const string input =
+        "##gvf-version 1.10\n"
+        "chr1\tdbVar\tSNV\t10\t10\t.\t+\t.\tID=v1;Reference_seq=G;Variant_seq=A\n"
+        "chr1\tdbVar\tSNV\t20\t20\t.\t+\t.\tReference_seq=G;Variant_seq=A\n"
+        "# comment\n"
+        "chr1\tdbVar\tSNV\t30\t30\t.\t+\t.\tID=v3;Reference_seq=G;Variant_seq=A\n"
+        "chr1\tdbVar\tSNV\t40\t40\t.\t+\t.\tID=v4;Reference_seq=G\n"
+        "chr1\tdbVar\tSNV\t50\t50\t.\t+\t.\tVariant_seq=A\n"
+        "chr1\tdbVar\tSNV\t60\t60\t.\t+\t.\tID=v6;Reference_seq=G;Variant_seq=A\n";
+    const vector<unsigned int> expected{3, 6, 7};
+
+    for (unsigned int threads: {0, 1, 3}) {
+        for (size_t blockLines: {1, 2, 5}) {
+            CMessageListenerLenient listener;
+            CMemoryLineReader lr(input.data(), input.size());
+            CGff2Reader::TAnnotList annots;
+            CGvfReader reader(0);
+            reader.SetParseThreads(threads, blockLines);
+            reader.ReadSeqAnnots(annots, lr, &listener);
+
+            vector<unsigned int> lines;
+            for (size_t i = 0; i < listener.Count(); ++i) {
+                const ILineError& err = listener.GetError(i);
+                if (NStr::Find(err.Message(), "Mandatory attribute") != NPOS) {
+                    lines.push_back(err.Line());
+                }
+            }
+            BOOST_CHECK_MESSAGE(lines == expected,
+                "threads " << threads << ", block " << blockLines <<
+                ": wrong line numbers in the errors");
+        }
+    }
+}
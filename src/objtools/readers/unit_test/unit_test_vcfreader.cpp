@@ -36,7 +36,10 @@
 #include <corelib/ncbiapp.hpp>
 #include <corelib/test_boost.hpp>
 
+#include <util/line_reader.hpp>
+#include <objects/seq/Seq_annot.hpp>
 #include <objtools/readers/vcf_reader.hpp>
+#include <objtools/readers/vcf_table.hpp>
 #include "tc_message_listener.hpp"
 
 #include <cstdio>
@@ -315,3 +318,75 @@ BOOST_AUTO_TEST_CASE(RunTests)
         BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, args["keep-diffs"]));
     }
 }
+
+static const char* const kColumnarVcf =
+    "##fileformat=VCFv4.1\n"
+    "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Depth\">\n"
+    "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tNA1\tNA2\n"
+    "1\t100\trs1\tA\tG\t30\tPASS\tDP=10;DB\tGT:DP\t0|1:5\t1|1\n"
+    "1\t200\t.\tAC\tA\t.\tPASS\tDP=7\tGT:DP\t0|0:3\t0|1:4\n"
+    "1\t300\trs3\tT\tC\t12.5\tq10\t.\tGT:DP\t1|0:9\t0|0:2\n"
+    "2\t50\trs4\tG\tT\t40\tPASS\tDP=3\tGT:DP\t0|1:1\t0|1:2\n";
+
+static void sReadColumnar(
+    CVcfReader::TAnnots& annots,
+    size_t rowsPerTable,
+    unsigned int threads)
+{
+    CMemoryLineReader lr(kColumnarVcf, strlen(kColumnarVcf));
+    CVcfReader reader(CVcfReader::fColumnar);
+    reader.SetColumnarOptions(rowsPerTable, threads);
+    reader.ReadSeqAnnots(annots, lr);
+}
+
+BOOST_AUTO_TEST_CASE(ColumnarMode)
+{
+    CVcfReader::TAnnots annots;
+    sReadColumnar(annots, 100, 0);
+    // one table per chromosome
+    BOOST_REQUIRE_EQUAL(annots.size(), 2u);
+    BOOST_REQUIRE(annots.front()->GetData().IsSeq_table());
+
+    CVcfTable table(annots.front()->GetData().GetSeq_table());
+    BOOST_REQUIRE_EQUAL(table.GetNumRows(), 3u);
+    BOOST_REQUIRE_EQUAL(table.GetNumSamples(), 2u);
+    BOOST_CHECK_EQUAL(table.GetSampleName(1), "NA2");
+    BOOST_CHECK_EQUAL(table.GetPos(0), 100);
+    BOOST_CHECK_EQUAL(table.GetPos(2), 300);
+    BOOST_CHECK_EQUAL(table.GetId(0), "rs1");
+    BOOST_CHECK_EQUAL(table.GetRef(1), "AC");
+    BOOST_CHECK_EQUAL(table.GetFilter(2), "q10");
+
+    double qual = 0;
+    BOOST_CHECK(table.GetQual(0, qual));
+    BOOST_CHECK_EQUAL(qual, 30.0);
+    BOOST_CHECK(!table.GetQual(1, qual));
+    BOOST_CHECK(table.GetQual(2, qual));
+    BOOST_CHECK_EQUAL(qual, 12.5);
+
+    CTempString value;
+    BOOST_CHECK(table.GetInfo(0, "DP", value));
+    BOOST_CHECK_EQUAL(value, "10");
+    BOOST_CHECK(table.GetInfo(0, "DB", value));
+    BOOST_CHECK(value.empty());
+    BOOST_CHECK(!table.GetInfo(0, "D", value));
+    BOOST_CHECK(!table.GetInfo(2, "DP", value));
+
+    BOOST_CHECK_EQUAL(table.GetSample(0, 1), "1|1");
+    BOOST_CHECK(table.GetSampleValue(0, 0, "DP", value));
+    BOOST_CHECK_EQUAL(value, "5");
+    BOOST_CHECK(!table.GetSampleValue(0, 1, "DP", value));
+    BOOST_CHECK(table.GetSampleValue(1, 1, "GT", value));
+    BOOST_CHECK_EQUAL(value, "0|1");
+
+    // the tables do not depend on the threads parsing them
+    CVcfReader::TAnnots serial, threaded;
+    sReadColumnar(serial, 2, 0);
+    sReadColumnar(threaded, 2, 3);
+    BOOST_REQUIRE_EQUAL(serial.size(), 3u);
+    BOOST_REQUIRE_EQUAL(threaded.size(), serial.size());
+    auto it = threaded.begin();
+    for (const auto& annot: serial) {
+        BOOST_CHECK(annot->Equals(**it++));
+    }
+}
@@ -164,7 +164,11 @@ CVcfReader::CVcfReader(
     CReaderListener* pRL):
     CReaderBase(flags, "", "", CReadUtil::AsSeqId, pRL),
     mActualVersion(0.0),
-    m_MetaHandled(false)
+    m_MetaHandled(false),
+    m_TableRows(100000),
+    m_TableThreads(0),
+    m_TableHeaderDone(false),
+    m_TablePendingLineNumber(0)
 //  ----------------------------------------------------------------------------
 {
 }
@@ -174,6 +178,19 @@ CVcfReader::CVcfReader(
 CVcfReader::~CVcfReader()
 //  ----------------------------------------------------------------------------
 {
+    // the futures of the blocks still being parsed wait for them
+}
+
+
+//  ----------------------------------------------------------------------------
+void
+CVcfReader::SetColumnarOptions(
+    size_t rowsPerTable,
+    unsigned int threads)
+//  ----------------------------------------------------------------------------
+{
+    m_TableRows = max(rowsPerTable, size_t(1));
+    m_TableThreads = threads;
 }
 
 //  ----------------------------------------------------------------------------
@@ -187,7 +204,9 @@ CVcfReader::ReadSeqAnnot(
         m_Meta.Reset( new CAnnotdesc );
         m_Meta->SetUser().SetType().SetStr( "vcf-meta-info" );
     }
-    CRef<CSeq_annot> pAnnot = CReaderBase::ReadSeqAnnot(lr, pEC);
+    CRef<CSeq_annot> pAnnot = (m_iFlags & fColumnar) ?
+        xReadSeqTableAnnot(lr, pEC) :
+        CReaderBase::ReadSeqAnnot(lr, pEC);
     if (pAnnot) {
         xAssignTrackData(*pAnnot);
         xAssignVcfMeta(*pAnnot);
@@ -1679,6 +1698,150 @@ void CVcfReader::xAssignVariantSource(CVcfData& data,
 }
 
 
+//  ----------------------------------------------------------------------------
+CRef<CSeq_annot>
+CVcfReader::xReadSeqTableAnnot(
+    ILineReader& lr,
+    ILineErrorListener* pEC)
+//  ----------------------------------------------------------------------------
+{
+    xProgressInit(lr);
+    if (!m_TableHeaderDone) {
+        xReadTableHeader(lr);
+        m_TableHeaderDone = true;
+    }
+
+    // Each block is parsed independently of the reader state: with threads
+    // the next blocks are parsed while this one is returned, without them
+    // the parsing is deferred to get() on this thread.
+    const auto policy = m_TableThreads ? launch::async : launch::deferred;
+    const size_t blocksAhead = max(m_TableThreads, 1u);
+    for (;;) {
+        while (m_TableChunks.size() < blocksAhead) {
+            unique_ptr<CVcfTableChunk> pChunk = xReadTableChunk(lr);
+            if (!pChunk) {
+                break;
+            }
+            m_TableChunks.push_back(async(policy,
+                [](unique_ptr<CVcfTableChunk> pChunk) {
+                    pChunk->Parse();
+                    return pChunk;
+                },
+                std::move(pChunk)));
+        }
+        if (m_TableChunks.empty()) {
+            return CRef<CSeq_annot>();
+        }
+        unique_ptr<CVcfTableChunk> pChunk = m_TableChunks.front().get();
+        m_TableChunks.pop_front();
+        xReportProgress(pEC);
+        CRef<CSeq_annot> pAnnot = xMakeTableAnnot(*pChunk, pEC);
+        if (pAnnot) {
+            return pAnnot;
+        }
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void
+CVcfReader::xReadTableHeader(
+    ILineReader& lr)
+//  ----------------------------------------------------------------------------
+{
+    // browser and track lines have no annot of their own in this mode
+    CRef<CSeq_annot> pScratch = CReaderBase::xCreateSeqAnnot();
+    while (!lr.AtEOF()) {
+        CTempString line = NStr::TruncateSpaces_Unsafe(*++lr);
+        ++m_uLineNumber;
+        if (line.empty()  ||  xIsCommentLine(line)) {
+            continue;
+        }
+        if (line[0] != '#'  &&
+                !xIsTrackLine(line)  &&  !xIsBrowserLine(line)) {
+            m_TablePendingLine = line;
+            m_TablePendingLineNumber = m_uLineNumber;
+            return;
+        }
+        xProcessData(TReaderData{TReaderLine{m_uLineNumber, line}}, *pScratch);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+unique_ptr<CVcfTableChunk>
+CVcfReader::xReadTableChunk(
+    ILineReader& lr)
+//  ----------------------------------------------------------------------------
+{
+    unique_ptr<CVcfTableChunk> pChunk;
+    string pending;
+    pending.swap(m_TablePendingLine);
+    bool havePending = !pending.empty();
+    for (;;) {
+        CTempString line;
+        unsigned int lineNumber;
+        if (havePending) {
+            line = pending;
+            lineNumber = m_TablePendingLineNumber;
+            havePending = false;
+        }
+        else if (!lr.AtEOF()) {
+            line = *++lr;
+            lineNumber = ++m_uLineNumber;
+        }
+        else {
+            break;
+        }
+        if (line.empty()  ||  line[0] == '#') {
+            continue;
+        }
+        CTempString chrom = line.substr(0, line.find('\t'));
+        if (!pChunk) {
+            pChunk.reset(new CVcfTableChunk(chrom, m_GenotypeHeaders));
+        }
+        else if (chrom != pChunk->Chrom()  ||
+                pChunk->LineCount() >= m_TableRows) {
+            m_TablePendingLine = line;
+            m_TablePendingLineNumber = lineNumber;
+            break;
+        }
+        pChunk->AddLine(line, lineNumber);
+    }
+    return pChunk;
+}
+
+//  ----------------------------------------------------------------------------
+CRef<CSeq_annot>
+CVcfReader::xMakeTableAnnot(
+    CVcfTableChunk& chunk,
+    ILineErrorListener* pEC)
+//  ----------------------------------------------------------------------------
+{
+    // problems are reported with the lines they were found on
+    const unsigned int lineNumber = m_uLineNumber;
+    for (const auto& problem: chunk.Problems()) {
+        m_uLineNumber = problem.mLine;
+        CReaderMessage message(problem.mSeverity, problem.mLine,
+            "CVcfReader::ReadSeqAnnot: " + problem.mMessage);
+        xProcessReaderMessage(message, pEC);
+    }
+    m_uLineNumber = lineNumber;
+
+    CRef<CSeq_table> pTable = chunk.Table();
+    if (!pTable  ||  pTable->GetNum_rows() == 0) {
+        return CRef<CSeq_annot>();
+    }
+    CRef<CSeqTable_column> pIdColumn(new CSeqTable_column);
+    pIdColumn->SetHeader().SetField_id(
+        CSeqTable_column_info::eField_id_location_id);
+    pIdColumn->SetDefault().SetId(*CReadUtil::AsSeqId(chunk.Chrom(), m_iFlags));
+    pTable->SetColumns().insert(pTable->SetColumns().begin(), pIdColumn);
+
+    CRef<CSeq_annot> pAnnot = CReaderBase::xCreateSeqAnnot();
+    pAnnot->SetData().SetSeq_table(*pTable);
+    m_uDataCount += pTable->GetNum_rows();
+    return pAnnot;
+}
+
 //  ----------------------------------------------------------------------------
 bool CVcfReader::xIsCommentLine(
     const CTempString& strLine)
@@ -0,0 +1,464 @@
+/*
+ * $Id$
+ *
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   VCF data lines as Seq-table columns
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <objects/seqtable/SeqTable_column.hpp>
+#include <objects/seqtable/SeqTable_column_info.hpp>
+#include <objects/seqtable/SeqTable_multi_data.hpp>
+#include <objects/seqtable/SeqTable_sparse_index.hpp>
+#include <objects/seqtable/CommonString_table.hpp>
+#include <objects/seqfeat/SeqFeatData.hpp>
+#include <objtools/readers/vcf_table.hpp>
+#include "vcf_table_chunk.hpp"
+
+#include <cerrno>
+#include <string_view>
+#include <unordered_map>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+const char* const CVcfTable::kColumnId = "E.ID";
+const char* const CVcfTable::kColumnRef = "E.REF";
+const char* const CVcfTable::kColumnAlt = "E.ALT";
+const char* const CVcfTable::kColumnQual = "E.QUAL";
+const char* const CVcfTable::kColumnFilter = "E.FILTER";
+const char* const CVcfTable::kColumnInfo = "E.INFO";
+const char* const CVcfTable::kColumnFormat = "E.FORMAT";
+const char* const CVcfTable::kColumnSamplePrefix = "E.sample:";
+
+static const size_t kFixedColumns = 8;  // CHROM .. INFO
+
+//  ----------------------------------------------------------------------------
+//  Fields are separated by tabs, runs of tabs count as one separator like in
+//  the feature mode. memchr() is vectorized by the C library, which is where
+//  the time goes on wide multi-sample lines.
+static void
+sSplitFields(
+    const CTempString& line,
+    vector<CTempString>& fields)
+//  ----------------------------------------------------------------------------
+{
+    fields.clear();
+    const char* ptr = line.data();
+    const char* end = ptr + line.size();
+    while (ptr < end) {
+        const char* tab = static_cast<const char*>(memchr(ptr, '\t', end - ptr));
+        if (!tab) {
+            tab = end;
+        }
+        if (tab != ptr) {
+            fields.emplace_back(ptr, tab - ptr);
+        }
+        ptr = tab + 1;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+//  String column which keeps repeated values once (REF/ALT/FILTER, genotypes)
+//  and falls back to plain strings when most of the values are distinct
+//  (ID, INFO).
+class CVcfStringColumn
+//  ----------------------------------------------------------------------------
+{
+public:
+    CVcfStringColumn(
+        const string& name,
+        size_t rows): mName(name)
+    {
+        mIndexes.reserve(rows);
+    };
+
+    void Add(const CTempString& value)
+    {
+        // the keys point into the chunk data which outlives the column
+        string_view key(value.data(), value.size());
+        auto it = mIndex.find(key);
+        if (it == mIndex.end()) {
+            it = mIndex.emplace(key, int(mValues.size())).first;
+            mValues.push_back(key);
+        }
+        mIndexes.push_back(it->second);
+    };
+
+    CRef<CSeqTable_column> Column() const
+    {
+        CRef<CSeqTable_column> column(new CSeqTable_column);
+        column->SetHeader().SetField_name(mName);
+        if (mValues.size()*2 > mIndexes.size()) {
+            auto& strings = column->SetData().SetString();
+            strings.reserve(mIndexes.size());
+            for (int index: mIndexes) {
+                strings.emplace_back(mValues[index]);
+            }
+        }
+        else {
+            auto& common = column->SetData().SetCommon_string();
+            auto& strings = common.SetStrings();
+            strings.reserve(mValues.size());
+            for (const auto& value: mValues) {
+                strings.emplace_back(value);
+            }
+            common.SetIndexes() = mIndexes;
+        }
+        return column;
+    };
+
+private:
+    string mName;
+    unordered_map<string_view, int> mIndex;
+    vector<string_view> mValues;
+    vector<int> mIndexes;
+};
+
+//  ----------------------------------------------------------------------------
+CVcfTableChunk::CVcfTableChunk(
+    const CTempString& chrom,
+    const vector<string>& sampleNames):
+    mChrom(chrom),
+    mSampleNames(sampleNames)
+//  ----------------------------------------------------------------------------
+{
+}
+
+//  ----------------------------------------------------------------------------
+void
+CVcfTableChunk::AddLine(
+    const CTempString& line,
+    unsigned int lineNumber)
+//  ----------------------------------------------------------------------------
+{
+    CTempString data = NStr::TruncateSpaces_Unsafe(line, NStr::eTrunc_End);
+    mLines.push_back(SLine{mData.size(), data.size(), lineNumber});
+    mData.append(data.data(), data.size());
+}
+
+//  ----------------------------------------------------------------------------
+void
+CVcfTableChunk::xAddProblem(
+    const SLine& line,
+    EDiagSev severity,
+    const string& message)
+//  ----------------------------------------------------------------------------
+{
+    mProblems.push_back(SProblem{line.mNumber, severity, message});
+}
+
+//  ----------------------------------------------------------------------------
+void
+CVcfTableChunk::Parse()
+//  ----------------------------------------------------------------------------
+{
+    const size_t lineCount = mLines.size();
+    const size_t sampleCount = mSampleNames.size();
+
+    vector<int> from, to;
+    from.reserve(lineCount);
+    to.reserve(lineCount);
+    vector<double> qual;
+    vector<int> qualRows;
+    CVcfStringColumn id(CVcfTable::kColumnId, lineCount);
+    CVcfStringColumn ref(CVcfTable::kColumnRef, lineCount);
+    CVcfStringColumn alt(CVcfTable::kColumnAlt, lineCount);
+    CVcfStringColumn filter(CVcfTable::kColumnFilter, lineCount);
+    CVcfStringColumn info(CVcfTable::kColumnInfo, lineCount);
+    CVcfStringColumn format(CVcfTable::kColumnFormat, lineCount);
+    vector<CVcfStringColumn> samples;
+    samples.reserve(sampleCount);
+    for (const auto& name: mSampleNames) {
+        samples.emplace_back(CVcfTable::kColumnSamplePrefix + name, lineCount);
+    }
+
+    vector<CTempString> fields;
+    int rows = 0;
+    for (const auto& line: mLines) {
+        sSplitFields(CTempString(mData.data() + line.mOffset, line.mLength), fields);
+        if (fields.size() < kFixedColumns) {
+            xAddProblem(line, eDiag_Error,
+                "Unable to parse given VCF data (syntax error).");
+            continue;
+        }
+        int pos = NStr::StringToInt(fields[1], NStr::fConvErr_NoThrow);
+        if (!pos  &&  errno) {
+            xAddProblem(line, eDiag_Error,
+                "Unable to parse given VCF data (bad POS value).");
+            continue;
+        }
+        double score = 0;
+        bool haveScore = (fields[5] != ".");
+        if (haveScore) {
+            score = NStr::StringToDouble(fields[5], NStr::fConvErr_NoThrow);
+            if (!score  &&  errno) {
+                xAddProblem(line, eDiag_Error,
+                    "Unable to parse given VCF data (bad QUAL value).");
+                continue;
+            }
+        }
+        if (sampleCount  &&  fields.size() != kFixedColumns + 1 + sampleCount) {
+            xAddProblem(line, eDiag_Warning,
+                "Number of genotype fields does not match the header.");
+        }
+
+        from.push_back(pos - 1);
+        to.push_back(int(pos - 1 + fields[3].size() - 1));
+        id.Add(fields[2]);
+        ref.Add(fields[3]);
+        alt.Add(fields[4]);
+        if (haveScore) {
+            qualRows.push_back(rows);
+            qual.push_back(score);
+        }
+        filter.Add(fields[6]);
+        info.Add(fields[7]);
+        if (sampleCount) {
+            format.Add(fields.size() > kFixedColumns ?
+                fields[kFixedColumns] : CTempString());
+            for (size_t u = 0; u < sampleCount; ++u) {
+                size_t index = kFixedColumns + 1 + u;
+                samples[u].Add(index < fields.size() ? fields[index] : CTempString());
+            }
+        }
+        ++rows;
+    }
+
+    mTable.Reset(new CSeq_table);
+    CSeq_table& table = *mTable;
+    table.SetFeat_type(CSeqFeatData::e_Variation);
+    table.SetNum_rows(rows);
+    auto& columns = table.SetColumns();
+
+    // the location-id column is added by the reader, it owns id resolution
+    {{
+        CRef<CSeqTable_column> column(new CSeqTable_column);
+        column->SetHeader().SetField_id(CSeqTable_column_info::eField_id_location_from);
+        column->SetData().SetInt() = std::move(from);
+        columns.push_back(column);
+    }}
+    {{
+        CRef<CSeqTable_column> column(new CSeqTable_column);
+        column->SetHeader().SetField_id(CSeqTable_column_info::eField_id_location_to);
+        column->SetData().SetInt() = std::move(to);
+        columns.push_back(column);
+    }}
+    columns.push_back(id.Column());
+    columns.push_back(ref.Column());
+    columns.push_back(alt.Column());
+    {{
+        CRef<CSeqTable_column> column(new CSeqTable_column);
+        column->SetHeader().SetField_name(CVcfTable::kColumnQual);
+        if (qualRows.size() != size_t(rows)) {
+            column->SetSparse().SetIndexes() = std::move(qualRows);
+        }
+        if (!qual.empty()) {
+            column->SetData().SetReal() = std::move(qual);
+        }
+        columns.push_back(column);
+    }}
+    columns.push_back(filter.Column());
+    columns.push_back(info.Column());
+    if (sampleCount) {
+        columns.push_back(format.Column());
+        for (const auto& sample: samples) {
+            columns.push_back(sample.Column());
+        }
+    }
+}
+
+//  ----------------------------------------------------------------------------
+CVcfTable::CVcfTable(
+    const CSeq_table& table):
+    m_Table(&table)
+//  ----------------------------------------------------------------------------
+{
+    m_From = &table.GetColumn(CSeqTable_column_info::eField_id_location_from);
+    m_Id = &table.GetColumn(kColumnId);
+    m_Ref = &table.GetColumn(kColumnRef);
+    m_Alt = &table.GetColumn(kColumnAlt);
+    m_Qual = &table.GetColumn(kColumnQual);
+    m_Filter = &table.GetColumn(kColumnFilter);
+    m_Info = &table.GetColumn(kColumnInfo);
+    m_Format = nullptr;
+    for (const auto& column: table.GetColumns()) {
+        const CSeqTable_column_info& header = column->GetHeader();
+        if (!header.IsSetField_name()) {
+            continue;
+        }
+        const string& name = header.GetField_name();
+        if (name == kColumnFormat) {
+            m_Format = column.GetPointer();
+        }
+        else if (NStr::StartsWith(name, kColumnSamplePrefix)) {
+            m_Samples.push_back(column.GetPointer());
+            m_SampleNames.push_back(name.substr(strlen(kColumnSamplePrefix)));
+        }
+    }
+}
+
+//  ----------------------------------------------------------------------------
+const string&
+CVcfTable::x_GetString(
+    const CSeqTable_column* column,
+    size_t row) const
+//  ----------------------------------------------------------------------------
+{
+    const string* value = column ? column->GetStringPtr(row) : nullptr;
+    return value ? *value : kEmptyStr;
+}
+
+//  ----------------------------------------------------------------------------
+int
+CVcfTable::GetPos(
+    size_t row) const
+//  ----------------------------------------------------------------------------
+{
+    int from = 0;
+    m_From->TryGetInt(row, from);
+    return from + 1;
+}
+
+const string& CVcfTable::GetId(size_t row) const
+{
+    return x_GetString(m_Id, row);
+}
+
+const string& CVcfTable::GetRef(size_t row) const
+{
+    return x_GetString(m_Ref, row);
+}
+
+const string& CVcfTable::GetAlt(size_t row) const
+{
+    return x_GetString(m_Alt, row);
+}
+
+const string& CVcfTable::GetFilter(size_t row) const
+{
+    return x_GetString(m_Filter, row);
+}
+
+const string& CVcfTable::GetInfo(size_t row) const
+{
+    return x_GetString(m_Info, row);
+}
+
+const string& CVcfTable::GetFormat(size_t row) const
+{
+    return x_GetString(m_Format, row);
+}
+
+const string& CVcfTable::GetSample(size_t row, size_t sample) const
+{
+    return x_GetString(m_Samples[sample], row);
+}
+
+//  ----------------------------------------------------------------------------
+bool
+CVcfTable::GetQual(
+    size_t row,
+    double& qual) const
+//  ----------------------------------------------------------------------------
+{
+    return m_Qual->TryGetReal(row, qual);
+}
+
+//  ----------------------------------------------------------------------------
+bool
+CVcfTable::GetInfo(
+    size_t row,
+    CTempString key,
+    CTempString& value) const
+//  ----------------------------------------------------------------------------
+{
+    CTempString info = GetInfo(row);
+    if (info == ".") {
+        return false;
+    }
+    size_t start = 0;
+    while (start <= info.size()) {
+        size_t end = info.find(';', start);
+        if (end == NPOS) {
+            end = info.size();
+        }
+        CTempString item = info.substr(start, end - start);
+        if (NStr::StartsWith(item, key)) {
+            if (item.size() == key.size()) {
+                value.clear();
+                return true;
+            }
+            if (item[key.size()] == '=') {
+                value = item.substr(key.size() + 1);
+                return true;
+            }
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+//  ----------------------------------------------------------------------------
+bool
+CVcfTable::GetSampleValue(
+    size_t row,
+    size_t sample,
+    CTempString key,
+    CTempString& value) const
+//  ----------------------------------------------------------------------------
+{
+    CTempString format = GetFormat(row);
+    CTempString data = GetSample(row, sample);
+    size_t formatPos = 0, dataPos = 0;
+    while (formatPos <= format.size()) {
+        size_t formatEnd = format.find(':', formatPos);
+        if (formatEnd == NPOS) {
+            formatEnd = format.size();
+        }
+        size_t dataEnd = data.find(':', dataPos);
+        if (dataEnd == NPOS) {
+            dataEnd = data.size();
+        }
+        if (format.substr(formatPos, formatEnd - formatPos) == key) {
+            if (dataPos > data.size()) {
+                // trailing fields may be dropped
+                return false;
+            }
+            value = data.substr(dataPos, dataEnd - dataPos);
+            return true;
+        }
+        formatPos = formatEnd + 1;
+        dataPos = dataEnd + 1;
+    }
+    return false;
+}
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
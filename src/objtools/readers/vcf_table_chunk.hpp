@@ -0,0 +1,97 @@
+#ifndef _VCF_TABLE_CHUNK_HPP_
+#define _VCF_TABLE_CHUNK_HPP_
+/*
+ * $Id$
+ *
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Block of VCF data lines of one chromosome parsed into a Seq-table
+ *
+ */
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/tempstr.hpp>
+#include <objects/seqtable/Seq_table.hpp>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects);
+
+//  ----------------------------------------------------------------------------
+//  The lines are copied into one buffer as they are read; Parse() does not
+//  touch the reader and can run on any thread. Problems are collected and
+//  reported by the reader in the order of the blocks.
+class CVcfTableChunk
+//  ----------------------------------------------------------------------------
+{
+public:
+    struct SProblem {
+        unsigned int mLine;
+        EDiagSev mSeverity;
+        string mMessage;
+    };
+    using TProblems = vector<SProblem>;
+
+    CVcfTableChunk(
+        const CTempString& chrom,
+        const vector<string>& sampleNames);
+
+    void AddLine(
+        const CTempString& line,
+        unsigned int lineNumber);
+
+    const string& Chrom() const { return mChrom; };
+    size_t LineCount() const { return mLines.size(); };
+    size_t DataSize() const { return mData.size(); };
+
+    void Parse();
+
+    CRef<CSeq_table> Table() const { return mTable; };
+    const TProblems& Problems() const { return mProblems; };
+
+private:
+    struct SLine {
+        size_t mOffset;
+        size_t mLength;
+        unsigned int mNumber;
+    };
+
+    void xAddProblem(
+        const SLine&,
+        EDiagSev,
+        const string&);
+
+    string mChrom;
+    vector<string> mSampleNames;
+    string mData;
+    vector<SLine> mLines;
+    CRef<CSeq_table> mTable;
+    TProblems mProblems;
+};
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif // _VCF_TABLE_CHUNK_HPP_
@@ -84,6 +84,7 @@ void CClassTypeInfo::InitClassTypeInfo(void)
 {
     m_ClassType = eSequential;
     m_ParentClassInfo = 0;
+    m_FastReadFunction = 0;
 
     UpdateFunctions();
 }
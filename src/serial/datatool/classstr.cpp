@@ -109,6 +109,23 @@ bool CClassTypeStrings::x_IsUniSeq(TMembers::const_iterator i) const
     return i->dataType && i->dataType->IsUniSeq();
 }
 
+// member can be read by generated x_ReadFastMember() using ReadStd()
+bool CClassTypeStrings::x_IsFastReadMember(TMembers::const_iterator i) const
+{
+    if ( i->ref || i->delayed || !i->defaultValue.empty() ||
+         i->attlist || i->noTag ||
+         x_IsNullType(i) || x_IsAnyContentType(i) ) {
+        return false;
+    }
+    if ( i->dataType && i->dataType->GetDataMember() &&
+         i->dataType->GetDataMember()->Nillable() ) {
+        return false;
+    }
+    EKind kind = i->type->GetKind();
+    return (kind == eKindStd || kind == eKindString) &&
+        !i->type->HaveSpecialRef();
+}
+
 void CClassTypeStrings::AddMember(const string& external_name,
                                   const string& name,
                                   const AutoPtr<CTypeStrings>& type,
@@ -359,6 +376,15 @@ void CClassTypeStrings::GenerateClassCode(CClassCode& code,
         generateDoNotDeleteThisObject = false;
     if ( delayed )
         code.HPPIncludes().insert("serial/delaybuf");
+    // generated reader of simple members
+    bool fastRead = false;
+    if ( DataTool().IsSetCodeGenerationStyle(CDataTool::eFastRead) &&
+         HaveTypeInfo() && !wrapperClass ) {
+        for ( TMembers::const_iterator i = m_Members.begin();
+              !fastRead && i != m_Members.end(); ++i ) {
+            fastRead = x_IsFastReadMember(i);
+        }
+    }
 
     // generate member types
     {
@@ -1253,6 +1279,17 @@ mem_simple = false;
             "    " << code.GetClassNameDT() << "& operator=(const " <<
             code.GetClassNameDT() << "&);\n" <<
             "\n";
+        if ( fastRead ) {
+            code.AddForwardDeclaration("CObjectIStream",
+                                       CNamespace::KNCBINamespace);
+            code.ClassPrivate() <<
+                "    // generated reader of simple members\n"
+                "    static bool x_ReadFastMember(" << ncbiNamespace <<
+                "CObjectIStream& in, " << ncbiNamespace <<
+                "TObjectPtr classPtr, " << ncbiNamespace <<
+                "TMemberIndex index);\n"
+                "\n";
+        }
         code.ClassPrivate() <<
             "    // data\n";
         {
@@ -1372,6 +1409,36 @@ mem_simple = false;
         }
     }
 
+    // generate reader of simple members
+    if ( fastRead ) {
+        methods <<
+            "bool "<<methodPrefix<<"x_ReadFastMember(" << ncbiNamespace <<
+            "CObjectIStream& in, " << ncbiNamespace <<
+            "TObjectPtr classPtr, " << ncbiNamespace <<
+            "TMemberIndex index)\n"
+            "{\n"
+            "    "<<classPrefix<<GetClassNameDT()<<"* obj = static_cast<"<<
+            classPrefix<<GetClassNameDT()<<"*>(classPtr);\n"
+            "    switch ( index ) {\n";
+        // parent class is the first member of class type info
+        size_t index = m_ParentClassName.empty()? 1: 2;
+        for ( TMembers::const_iterator i = m_Members.begin();
+              i != m_Members.end(); ++i, ++index ) {
+            if ( x_IsFastReadMember(i) ) {
+                methods <<
+                    "    case "<<index<<":\n"
+                    "        in.ReadStd(obj->"<<i->mName<<");\n"
+                    "        return true;\n";
+            }
+        }
+        methods <<
+            "    default:\n"
+            "        return false;\n"
+            "    }\n"
+            "}\n"
+            "\n";
+    }
+
     // generate type info
     methods << "BEGIN_NAMED_";
     if ( haveUserClass )
@@ -1639,6 +1706,10 @@ mem_simple = false;
             methods << "    info->RandomOrder();\n";
         }
     }
+    if ( fastRead ) {
+        methods <<
+            "    info->SetFastReadFunction(&"<<methodPrefix<<"x_ReadFastMember);\n";
+    }
     methods <<  "    info->CodeVersion(" << DATATOOL_VERSION << ");\n";
     methods <<  "    info->DataSpec(" << CDataType::GetSourceDataSpecString() << ");\n";
     methods <<
@@ -164,6 +164,7 @@ protected:
     bool x_IsNullWithAttlist(TMembers::const_iterator i, string& name) const;
     bool x_IsAnyContentType(TMembers::const_iterator i) const;
     bool x_IsUniSeq(TMembers::const_iterator i) const;
+    bool x_IsFastReadMember(TMembers::const_iterator i) const;
 
 private:
     bool m_IsObject;
@@ -281,6 +281,8 @@ bool CDataTool::ProcessModules(void)
                 m_codestyle |= FCodeGenerationStyle(eXmlElementEnums);
             } else if (NStr::CompareNocase(v,"no_restrictions")==0) {
                 m_codestyle |= FCodeGenerationStyle(eNoRestrictions);
+            } else if (NStr::CompareNocase(v,"fast_read")==0) {
+                m_codestyle |= FCodeGenerationStyle(eFastRead);
             } else {
                 ERR_POST_X(1, Warning << "Unknown code generation value: " << v);
             }
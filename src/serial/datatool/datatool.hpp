@@ -64,7 +64,8 @@ public:
         eNoGlobalGroupClasses    = 1 << 1,
         ePreserveNestedElements  = 1 << 2,
         eXmlElementEnums         = 1 << 3,
-        eNoRestrictions          = 1 << 4
+        eNoRestrictions          = 1 << 4,
+        eFastRead                = 1 << 5
     };
     typedef Uint8 FCodeGenerationStyle;
     bool IsSetCodeGenerationStyle(ECodeGenerationStyle e) const {
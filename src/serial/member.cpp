@@ -75,6 +75,14 @@ public:
     static void ReadWithSetFlagMember(CObjectIStream& in,
                                         const CMemberInfo* memberInfo,
                                         TObjectPtr classPtr);
+    static bool ReadFastWithSetFlagMember(CObjectIStream& in,
+                                          const CMemberInfo* memberInfo,
+                                          TObjectPtr classPtr,
+                                          TClassFastReadFunction fastRead);
+    static void x_ReadWithSetFlagError(CObjectIStream& in,
+                                       const CMemberInfo* memberInfo,
+                                       TObjectPtr classPtr,
+                                       CSerialException& e);
     static void ReadWithDefaultMemberX(CObjectIStream& in,
                                         const CMemberInfo* memberInfo,
                                         TObjectPtr classPtr);
@@ -500,6 +508,28 @@ void CMemberInfo::UpdateDelayedBuffer(CObjectIStream& in,
     END_OBJECT_FRAME_OF(in);
 }
 
+void CMemberInfo::ReadFastMember(CObjectIStream& in,
+                                 TObjectPtr classPtr,
+                                 TClassFastReadFunction fastRead) const
+{
+    TMemberReadFunction func = m_ReadHookData.GetCurrentFunction1st();
+    // generated reader knows nothing about hooks, nillable values
+    // and default values - use it only for plain members
+    if ( fastRead  &&  !GetTypeInfo()->HaveReadHooks() ) {
+        if ( func == &TFunc::ReadSimpleMember ) {
+            if ( !Nillable()  &&  fastRead(in, classPtr, GetIndex()) ) {
+                return;
+            }
+        }
+        else if ( func == &TFunc::ReadWithSetFlagMember ) {
+            if ( TFunc::ReadFastWithSetFlagMember(in, this, classPtr, fastRead) ) {
+                return;
+            }
+        }
+    }
+    func(in, this, classPtr);
+}
+
 void CMemberInfo::SetReadFunction(TMemberReadFunction func)
 {
     m_ReadHookData.SetDefaultFunction1st(func);
@@ -727,31 +757,62 @@ void CMemberInfoFunctions::ReadWithSetFlagMember(CObjectIStream& in,
         }
     }
     catch (CSerialException& e) {
-        if (e.GetErrCode() == CSerialException::eNullValue) {
-            if ( memberInfo->HaveSetFlag() ) {
-                memberInfo->UpdateSetFlagNo(classPtr);
-            } else {
-                NCBI_RETHROW(e, CSerialException, eFormatError,
-                    "null value " + memberInfo->GetId().GetName());
-            }
-        } else if (e.GetErrCode() == CSerialException::eMissingValue) {
-            if ( memberInfo->Optional() && memberInfo->HaveSetFlag() ) {
-                in.SetFailFlags(CObjectIStream::fNoError);
-                if ( memberInfo->UpdateSetFlagNo(classPtr) ) {
-                    memberInfo->GetTypeInfo()->SetDefault(
-                        memberInfo->GetItemPtr(classPtr));
-                    if (memberInfo->GetDefault()) {
-                        memberInfo->GetTypeInfo()->Assign(memberInfo->GetItemPtr(classPtr),memberInfo->GetDefault());
-                    }
+        x_ReadWithSetFlagError(in, memberInfo, classPtr, e);
+    }
+}
+
+bool CMemberInfoFunctions::ReadFastWithSetFlagMember(CObjectIStream& in,
+                                                     const CMemberInfo* memberInfo,
+                                                     TObjectPtr classPtr,
+                                                     TClassFastReadFunction fastRead)
+{
+    _ASSERT(!memberInfo->CanBeDelayed());
+    _ASSERT(memberInfo->HaveSetFlag());
+    memberInfo->UpdateSetFlagYes(classPtr);
+    try {
+        if ( !fastRead(in, classPtr, memberInfo->GetIndex()) ) {
+            return false;
+        }
+        if (in.GetVerifyData() == eSerialVerifyData_Yes) {
+            memberInfo->Validate(classPtr, in);
+        }
+    }
+    catch (CSerialException& e) {
+        x_ReadWithSetFlagError(in, memberInfo, classPtr, e);
+    }
+    return true;
+}
+
+// called from catch block, rethrows the current exception if cannot recover
+void CMemberInfoFunctions::x_ReadWithSetFlagError(CObjectIStream& in,
+                                                  const CMemberInfo* memberInfo,
+                                                  TObjectPtr classPtr,
+                                                  CSerialException& e)
+{
+    if (e.GetErrCode() == CSerialException::eNullValue) {
+        if ( memberInfo->HaveSetFlag() ) {
+            memberInfo->UpdateSetFlagNo(classPtr);
+        } else {
+            NCBI_RETHROW(e, CSerialException, eFormatError,
+                "null value " + memberInfo->GetId().GetName());
+        }
+    } else if (e.GetErrCode() == CSerialException::eMissingValue) {
+        if ( memberInfo->Optional() && memberInfo->HaveSetFlag() ) {
+            in.SetFailFlags(CObjectIStream::fNoError);
+            if ( memberInfo->UpdateSetFlagNo(classPtr) ) {
+                memberInfo->GetTypeInfo()->SetDefault(
+                    memberInfo->GetItemPtr(classPtr));
+                if (memberInfo->GetDefault()) {
+                    memberInfo->GetTypeInfo()->Assign(memberInfo->GetItemPtr(classPtr),memberInfo->GetDefault());
                 }
-            } else {
-                NCBI_RETHROW(e, CSerialException, eFormatError,
-                    "missing value " + memberInfo->GetId().GetName());
             }
         } else {
-            NCBI_RETHROW_SAME(e,
-                "error while reading " + memberInfo->GetId().GetName());
+            NCBI_RETHROW(e, CSerialException, eFormatError,
+                "missing value " + memberInfo->GetId().GetName());
         }
+    } else {
+        NCBI_RETHROW_SAME(e,
+            "error while reading " + memberInfo->GetId().GetName());
     }
 }
 
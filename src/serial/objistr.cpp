@@ -85,6 +85,46 @@ NCBI_PARAM_DECL(bool, SERIAL, READ_MMAPBYTESOURCE);
 NCBI_PARAM_DEF_EX(bool, SERIAL, READ_MMAPBYTESOURCE, false,
                   eParam_NoThread, SERIAL_READ_MMAPBYTESOURCE);
 
+NCBI_PARAM_DECL(bool, SERIAL, FAST_READ);
+NCBI_PARAM_DEF_EX(bool, SERIAL, FAST_READ, true,
+                  eParam_NoThread, SERIAL_FAST_READ);
+
+NCBI_PARAM_DECL(bool, SERIAL, ARENA_ALLOCATION);
+NCBI_PARAM_DEF_EX(bool, SERIAL, ARENA_ALLOCATION, false,
+                  eParam_NoThread, SERIAL_ARENA_ALLOCATION);
+
+// big chunks, as the arena is used for whole object trees
+static const size_t kDefaultArenaChunkSize = 64*1024;
+
+
+class CObjectIStream::CArenaScope
+{
+public:
+    CArenaScope(CObjectIStream& in)
+        : m_In(in),
+          m_Active(in.m_ArenaChunkSize != 0  &&  !in.m_InArenaRead)
+        {
+            if ( m_Active ) {
+                m_SavedPool = in.m_MemoryPool;
+                in.m_MemoryPool = new CObjectMemoryPool(in.m_ArenaChunkSize);
+                in.m_InArenaRead = true;
+            }
+        }
+    ~CArenaScope(void)
+        {
+            if ( m_Active ) {
+                // the chunks stay alive while any object in them is alive
+                m_In.m_MemoryPool = m_SavedPool;
+                m_In.m_InArenaRead = false;
+            }
+        }
+
+private:
+    CObjectIStream&         m_In;
+    bool                    m_Active;
+    CRef<CObjectMemoryPool> m_SavedPool;
+};
+
 CRef<CByteSource> CObjectIStream::GetSource(ESerialDataFormat format,
                                             const string& fileName,
                                             TSerialOpenFlags openFlags)
@@ -119,13 +159,19 @@ CRef<CByteSource> CObjectIStream::GetSource(ESerialDataFormat format,
         }
         else {
             static CSafeStatic<NCBI_PARAM_TYPE(SERIAL, READ_MMAPBYTESOURCE)> s_MmapSrc;
-            if (s_MmapSrc->Get()) {
+            if ((openFlags & eSerial_MemoryMap) || s_MmapSrc->Get()) {
                 // open file as file mapping
-                return CRef<CByteSource>(new CMMapByteSource(fileName));
-            } else {
-                // open file as stream
-                return CRef<CByteSource>(new CFStreamByteSource(fileName, binary));
+                try {
+                    return CRef<CByteSource>(new CMMapByteSource(fileName));
+                }
+                catch (CFileException& e) {
+                    // not mappable (e.g. a pipe), fall back to a stream
+                    ERR_POST_X(8, Info << "CObjectIStream::Open: "
+                               "cannot map " << fileName << ": " << e.GetMsg());
+                }
             }
+            // open file as stream
+            return CRef<CByteSource>(new CFStreamByteSource(fileName, binary));
         }
     }
 }
@@ -460,6 +506,7 @@ CObjectIStream::CObjectIStream(ESerialDataFormat format)
       m_DataFormat(format),
       m_ParseDelayBuffers(eDelayBufferPolicyNotSet),
       m_TypeAlias(nullptr),
+      m_FastRead(NCBI_PARAM_TYPE(SERIAL, FAST_READ)::GetDefault()),
       m_NonPrintSubst('#'),
       m_FixMethod(x_GetFixCharsMethodDefault()),
       m_VerifyData(x_GetVerifyDataDefault()),
@@ -467,6 +514,9 @@ CObjectIStream::CObjectIStream(ESerialDataFormat format)
       m_SkipUnknownVariants(eSerialSkipUnknown_Default),
       m_Fail(fNotOpen),
       m_Flags(fFlagNone),
+      m_ArenaChunkSize(NCBI_PARAM_TYPE(SERIAL, ARENA_ALLOCATION)::GetDefault()?
+                       kDefaultArenaChunkSize: 0),
+      m_InArenaRead(false),
       m_MonitorType(0),
       m_MemberDefault(0), m_SpecialCaseToExpect(0), m_SpecialCaseUsed(eReadAsNormal)
 {
@@ -742,6 +792,22 @@ CObjectIStream::GetDelayBufferParsingPolicy(void) const
     return m_ParseDelayBuffers;
 }
 
+void CObjectIStream::SetFastRead(bool fast_read)
+{
+    m_FastRead = fast_read;
+}
+
+bool CObjectIStream::GetFastRead(void) const
+{
+    return m_FastRead;
+}
+
+TClassFastReadFunction
+CObjectIStream::x_GetFastReadFunction(const CClassTypeInfo* classType) const
+{
+    return m_FastRead? classType->GetFastReadFunction(): 0;
+}
+
 bool CObjectIStream::ShouldParseDelayBuffer(void) const
 {
     if (m_ParseDelayBuffers != eDelayBufferPolicyNotSet) {
@@ -777,6 +843,11 @@ void CObjectIStream::UseMemoryPool(void)
     SetMemoryPool(new CObjectMemoryPool);
 }
 
+void CObjectIStream::SetArenaAllocation(bool arena, size_t chunk_size)
+{
+    m_ArenaChunkSize = !arena? 0: chunk_size? chunk_size: kDefaultArenaChunkSize;
+}
+
 string CObjectIStream::GetStackTrace(void) const
 {
     return GetStackTraceASN();
@@ -940,6 +1011,7 @@ set<TTypeInfo> CObjectIStream::GuessDataType(const set<TTypeInfo>& known_types,
 void CObjectIStream::Read(const CObjectInfo& object, ENoFileHeader)
 {
     // root object
+    CArenaScope arena(*this);
     BEGIN_OBJECT_FRAME2(eFrameNamed, object.GetTypeInfo());
     
     ReadObject(object);
@@ -959,6 +1031,7 @@ void CObjectIStream::Read(const CObjectInfo& object)
 void CObjectIStream::Read(TObjectPtr object, TTypeInfo typeInfo, ENoFileHeader)
 {
     // root object
+    CArenaScope arena(*this);
     BEGIN_OBJECT_FRAME2(eFrameNamed, typeInfo);
 
     ReadObject(object, typeInfo);
@@ -979,7 +1052,12 @@ CObjectInfo CObjectIStream::Read(TTypeInfo typeInfo)
 {
     // root object
     SkipFileHeader(typeInfo);
-    CObjectInfo info(typeInfo->Create(), typeInfo);
+    CArenaScope arena(*this);
+    // in arena mode the root object is allocated in the same arena
+    // as its members, otherwise it is created on the heap as before
+    CObjectInfo info(GetArenaAllocation()?
+                     typeInfo->Create(GetMemoryPool()):
+                     typeInfo->Create(), typeInfo);
     Read(info, eNoFileHeader);
     return info;
 }
@@ -1604,6 +1682,30 @@ size_t CObjectIStream::ByteBlock::Read(void* dst, size_t needLength,
     return length;
 }
 
+size_t CObjectIStream::ByteBlock::ReadInPlace(const char*& data,
+                                              size_t needLength)
+{
+    size_t length = needLength;
+    if ( KnownLength() ) {
+        if ( m_Length < needLength )
+            length = m_Length;
+    }
+    else {
+        if ( m_Length == 0 )
+            length = 0;
+    }
+    
+    if ( length == 0 ) {
+        data = GetStream().m_Input.GetCurrentPos();
+        return 0;
+    }
+
+    length = GetStream().ReadBytesInPlace(*this, data, length);
+    if ( KnownLength() )
+        m_Length -= length;
+    return length;
+}
+
 ///////////////////////////////////////////////////////////////////////
 //
 // CObjectIStream::CharBlock
@@ -1668,6 +1770,14 @@ size_t CObjectIStream::CharBlock::Read(char* dst, size_t needLength,
 }
 
 
+size_t CObjectIStream::ReadBytesInPlace(ByteBlock& /*block*/,
+                                        const char*& data, size_t /*count*/)
+{
+    // not supported by default
+    data = 0;
+    return 0;
+}
+
 void CObjectIStream::EndBytes(const ByteBlock& /*b*/)
 {
 }
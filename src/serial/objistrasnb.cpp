@@ -1479,6 +1479,25 @@ size_t CObjectIStreamAsnBinary::ReadBytes(ByteBlock& ,
     return length;
 }
 
+size_t CObjectIStreamAsnBinary::ReadBytesInPlace(ByteBlock& ,
+                                                 const char*& data,
+                                                 size_t length)
+{
+#if CHECK_INSTREAM_STATE
+    if ( m_CurrentTagState != eData ) {
+        ThrowError(fIllegalCall, "illegal ReadBytesInPlace call");
+    }
+#endif
+#if CHECK_INSTREAM_LIMITS
+    Int8 cur_pos = m_Input.GetStreamPosAsInt8();
+    Int8 end_pos = cur_pos + length;
+    if ( end_pos < cur_pos ||
+        (m_CurrentTagLimit != 0 && end_pos > m_CurrentTagLimit) )
+        ThrowError(fOverflow, "tag size overflow");
+#endif
+    return m_Input.GetCharsInPlace(data, length);
+}
+
 void CObjectIStreamAsnBinary::EndBytes(const ByteBlock& )
 {
     EndOfTag();
@@ -1546,10 +1546,20 @@ public:
 #if 1
                 o.clear();
                 o.reserve(length);
-                Char buf[2048];
-                size_t count;
-                while ( (count = block.Read(ToChar(buf), sizeof(buf))) != 0 ) {
-                    o.insert(o.end(), buf, buf + count);
+                // take the data directly from the input buffer if possible
+                const char* data;
+                size_t count = block.ReadInPlace(data, length);
+                if ( data ) {
+                    for ( ; count; count = block.ReadInPlace(data, length) ) {
+                        const Char* src = reinterpret_cast<const Char*>(data);
+                        o.insert(o.end(), src, src + count);
+                    }
+                }
+                else {
+                    Char buf[2048];
+                    while ( (count = block.Read(ToChar(buf), sizeof(buf))) != 0 ) {
+                        o.insert(o.end(), buf, buf + count);
+                    }
                 }
 #else
                 o.resize(length);
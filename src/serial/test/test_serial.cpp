@@ -101,6 +101,23 @@ BOOST_AUTO_TEST_CASE(s_TestAsnSerialization)
         }
         BOOST_CHECK( CFile( bin_in).Compare( bin_out) );
     }
+    {
+        CRef<CWeb_Env> env(new CWeb_Env);
+        {
+            // read ASN binary
+            // read the file through a memory mapping
+            unique_ptr<CObjectIStream> in(
+                CObjectIStream::Open(eSerial_AsnBinary, bin_in,
+                                     eSerial_MemoryMap));
+            *in >> *env;
+        }
+        {
+            unique_ptr<CObjectOStream> out(
+                CObjectOStream::Open(bin_out,eSerial_AsnBinary));
+            *out << *env;
+        }
+        BOOST_CHECK( CFile( bin_in).Compare( bin_out) );
+    }
 }
 #endif
 
@@ -56,6 +56,18 @@ static int s_GetDebug(void)
 }
 
 
+NCBI_PARAM_DECL(int, BGZF, THREADS);
+NCBI_PARAM_DEF_EX(int, BGZF, THREADS, 0, eParam_NoThread, BGZF_THREADS);
+
+
+NCBI_PARAM_DECL(int, BGZF, PREFETCH_BLOCKS);
+NCBI_PARAM_DEF_EX(int, BGZF, PREFETCH_BLOCKS, 32, eParam_NoThread,
+                  BGZF_PREFETCH_BLOCKS);
+
+
+static const size_t kBlockCacheSize = 10;
+
+
 enum EFileMode {
     eUseFileIO,
     eUseMemFile,
@@ -145,7 +157,7 @@ CPagedFile::~CPagedFile()
 }
 
 
-CPagedFile::TPage CPagedFile::GetPage(TFilePos file_pos)
+CPagedFile::TPage CPagedFile::x_GetPage(TFilePos file_pos)
 {
 #ifdef USE_RANGE_CACHE
     size_t size_pow2 = GetNextPageSizePow2();
@@ -163,6 +175,13 @@ CPagedFile::TPage CPagedFile::GetPage(TFilePos file_pos)
             x_ReadPage(*page, page_pos, page_size);
         }
     }
+    return page;
+}
+
+
+CPagedFile::TPage CPagedFile::GetPage(TFilePos file_pos)
+{
+    TPage page = x_GetPage(file_pos);
     if ( !page->Contains(file_pos) ) {
         NCBI_THROW_FMT(CBGZFException, eFormatError,
                        "BGZF read @ "<<file_pos<<" is beyond file size");
@@ -171,6 +190,23 @@ CPagedFile::TPage CPagedFile::GetPage(TFilePos file_pos)
 }
 
 
+CPagedFile::TPage CPagedFile::GetPageOrEOF(TFilePos file_pos)
+{
+    TPage page = x_GetPage(file_pos);
+    if ( !page->Contains(file_pos) ) {
+        if ( page->GetFilePos()+page->GetPageSize() == file_pos ) {
+            // read past of the file
+            page.Reset();
+        }
+        else {
+            NCBI_THROW_FMT(CBGZFException, eFormatError,
+                           "BGZF read @ "<<file_pos<<" is beyond file size");
+        }
+    }
+    return page;
+}
+
+
 pair<Uint8, double> CPagedFile::GetReadStatistics() const
 {
     CFastMutexGuard guard(m_StatMutex);
@@ -362,15 +398,23 @@ CBGZFBlock::~CBGZFBlock()
 
 CBGZFFile::CBGZFFile(const string& file_name)
     : m_File(new CPagedFile(file_name)),
-      m_BlockCache(new TBlockCache(10)),
+      m_BlockCache(new TBlockCache(kBlockCacheSize)),
       m_TotalUncompressBytes(0),
-      m_TotalUncompressSeconds(0)
+      m_TotalUncompressSeconds(0),
+      m_PrefetchBlocks(0),
+      m_StopPrefetch(false)
 {
+    int threads = NCBI_PARAM_TYPE(BGZF, THREADS)::GetDefault();
+    int blocks = NCBI_PARAM_TYPE(BGZF, PREFETCH_BLOCKS)::GetDefault();
+    if ( threads > 0 && blocks > 0 ) {
+        SetPrefetch(threads, blocks);
+    }
 }
 
 
 CBGZFFile::~CBGZFFile()
 {
+    x_StopPrefetch();
     if ( s_GetDebug() >= 1 ) {
         auto stat = GetUncompressStatistics();
         if ( stat.first ) {
@@ -399,6 +443,95 @@ CBGZFFile::TBlock CBGZFFile::GetBlock(TFileBlockPos file_pos,
 }
 
 
+void CBGZFFile::SetPrefetch(unsigned threads, unsigned prefetch_blocks)
+{
+    x_StopPrefetch();
+    if ( !threads || !prefetch_blocks ) {
+        threads = prefetch_blocks = 0;
+    }
+    m_PrefetchBlocks = prefetch_blocks;
+    // prefetched blocks are not locked until their reader gets to them,
+    // keep them in the cache for a couple of concurrent readers
+    m_BlockCache->set_size_limit(kBlockCacheSize + 2*prefetch_blocks);
+    for ( unsigned i = 0; i < threads; ++i ) {
+        m_PrefetchThreads.emplace_back(&CBGZFFile::x_PrefetchThread, this);
+    }
+}
+
+
+void CBGZFFile::x_StopPrefetch()
+{
+    if ( m_PrefetchThreads.empty() ) {
+        return;
+    }
+    {{
+        lock_guard<mutex> guard(m_PrefetchMutex);
+        m_StopPrefetch = true;
+        m_PrefetchQueue.clear();
+    }}
+    m_PrefetchCond.notify_all();
+    for ( thread& t : m_PrefetchThreads ) {
+        t.join();
+    }
+    m_PrefetchThreads.clear();
+    m_StopPrefetch = false;
+}
+
+
+void CBGZFFile::x_Prefetch(const vector<TFileBlockPos>& file_positions)
+{
+    if ( file_positions.empty() || m_PrefetchThreads.empty() ) {
+        return;
+    }
+    {{
+        lock_guard<mutex> guard(m_PrefetchMutex);
+        m_PrefetchQueue.insert(m_PrefetchQueue.end(),
+                               file_positions.begin(), file_positions.end());
+        // after seeks of several readers the oldest requests are stale
+        size_t max_queue = 4*size_t(m_PrefetchBlocks);
+        while ( m_PrefetchQueue.size() > max_queue ) {
+            m_PrefetchQueue.pop_front();
+        }
+    }}
+    if ( file_positions.size() == 1 ) {
+        m_PrefetchCond.notify_one();
+    }
+    else {
+        m_PrefetchCond.notify_all();
+    }
+}
+
+
+void CBGZFFile::x_PrefetchThread()
+{
+    CPagedFile::TPage page;
+    CSimpleBufferT<char> buffer(CBGZFBlock::kMaxFileBlockSize);
+    for ( ;; ) {
+        TFileBlockPos file_pos;
+        {{
+            unique_lock<mutex> lock(m_PrefetchMutex);
+            m_PrefetchCond.wait(lock, [this] {
+                return m_StopPrefetch || !m_PrefetchQueue.empty();
+            });
+            if ( m_StopPrefetch ) {
+                return;
+            }
+            file_pos = m_PrefetchQueue.front();
+            m_PrefetchQueue.pop_front();
+        }}
+        // The block stays in the cache after the lock is released.
+        // Errors are left to the reader: it will read the block again
+        // and get the exception where it would get it without read-ahead.
+        try {
+            GetBlock(file_pos, page, buffer);
+        }
+        catch ( exception& ) {
+        }
+        page.Reset();
+    }
+}
+
+
 pair<Uint8, double> CBGZFFile::GetUncompressStatistics() const
 {
     CFastMutexGuard guard(m_StatMutex);
@@ -416,7 +549,8 @@ void CBGZFFile::x_AddUncompressStatistics(Uint8 bytes, double seconds)
 
 CBGZFStream::CBGZFStream()
     : m_ReadPos(0),
-      m_EndPos(CBGZFPos::GetInvalid())
+      m_EndPos(CBGZFPos::GetInvalid()),
+      m_PrefetchPos(0)
 {
 }
 
@@ -424,7 +558,8 @@ CBGZFStream::CBGZFStream()
 CBGZFStream::CBGZFStream(CBGZFFile& file)
     : m_ReadPos(0),
       m_InReadBuffer(CBGZFBlock::kMaxFileBlockSize),
-      m_EndPos(CBGZFPos::GetInvalid())
+      m_EndPos(CBGZFPos::GetInvalid()),
+      m_PrefetchPos(0)
 {
     Open(file);
 }
@@ -437,6 +572,8 @@ CBGZFStream::~CBGZFStream()
 
 void CBGZFStream::Close()
 {
+    x_ResetPrefetch();
+    m_PrefetchPage.Reset();
     m_Block.Reset();
     m_Page.Reset();
     m_File.Reset();
@@ -455,10 +592,63 @@ bool CBGZFStream::x_NextBlock()
 {
     m_Block = m_File->GetBlock(GetNextBlockFilePos(), m_Page, m_InReadBuffer);
     m_ReadPos = 0;
+    if ( m_Block ) {
+        x_Prefetch();
+    }
     return m_Block;
 }
 
 
+void CBGZFStream::x_ResetPrefetch()
+{
+    m_PrefetchQueue.clear();
+    m_PrefetchPos = 0;
+}
+
+
+void CBGZFStream::x_Prefetch()
+{
+    size_t prefetch_blocks = m_File->GetPrefetchBlocks();
+    if ( !prefetch_blocks ) {
+        return;
+    }
+    CBGZFBlock::TFileBlockPos next_pos = m_Block->GetNextFileBlockPos();
+    while ( !m_PrefetchQueue.empty() && m_PrefetchQueue.front() < next_pos ) {
+        m_PrefetchQueue.pop_front();
+    }
+    if ( m_PrefetchPos == 0 ||
+         (!m_PrefetchQueue.empty() && m_PrefetchQueue.front() != next_pos) ) {
+        // the reader jumped, start over from the current block
+        x_ResetPrefetch();
+        m_PrefetchPos = next_pos;
+    }
+    // only block headers are parsed here, it's cheap compared to inflate
+    vector<CBGZFBlock::TFileBlockPos> new_blocks;
+    s_Reserve(CBGZFBlock::kMaxFileBlockSize, m_PrefetchBuffer);
+    while ( m_PrefetchQueue.size() < prefetch_blocks &&
+            m_PrefetchPos != CBGZFBlock::TFileBlockPos(-1) &&
+            CBGZFPos(m_PrefetchPos, 0) < m_EndPos ) {
+        size_t header_size;
+        CBGZFBlock::TFileBlockSize size = 0;
+        try {
+            size = m_File->x_ReadBlockHeader(m_PrefetchPos, m_PrefetchPage,
+                                             m_PrefetchBuffer, header_size);
+        }
+        catch ( exception& ) {
+            // the reader will get the error when it gets to the block
+        }
+        if ( !size ) {
+            m_PrefetchPos = CBGZFBlock::TFileBlockPos(-1);
+            break;
+        }
+        m_PrefetchQueue.push_back(m_PrefetchPos);
+        new_blocks.push_back(m_PrefetchPos);
+        m_PrefetchPos += size;
+    }
+    m_File->x_Prefetch(new_blocks);
+}
+
+
 void CBGZFStream::Seek(CBGZFPos pos, CBGZFPos end_pos)
 {
     m_EndPos = end_pos;
@@ -467,6 +657,10 @@ void CBGZFStream::Seek(CBGZFPos pos, CBGZFPos end_pos)
     }
     m_Block = m_File->GetBlock(pos.GetFileBlockPos(), m_Page, m_InReadBuffer);
     m_ReadPos = pos.GetByteOffset();
+    x_ResetPrefetch();
+    if ( m_Block ) {
+        x_Prefetch();
+    }
     if ( m_ReadPos && !HaveBytesInBlock() ) {
         NCBI_THROW_FMT(CBGZFException, eInvalidArg,
                        "Bad BGZF("<<pos.GetFileBlockPos()<<") offset: "<<
@@ -481,21 +675,16 @@ static const size_t kRequiredExtraSize = kExtraHeaderSize + 2; // BSIZE block
 static const size_t kInitialExtraSize = kRequiredExtraSize;
 static const size_t kFooterSize = 8; // CRC & ISIZE
 
-bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
-                            TFileBlockPos file_pos0,
-                            CPagedFile::TPage& page,
-                            CSimpleBufferT<char>& buffer)
+CBGZFBlock::TFileBlockSize
+CBGZFFile::x_ReadBlockHeader(TFileBlockPos file_pos0,
+                             CPagedFile::TPage& page,
+                             CSimpleBufferT<char>& buffer,
+                             size_t& header_size)
 {
-    try {
-        page = m_File->GetPage(file_pos0);
-    }
-    catch ( CBGZFException& exc ) {
-        if ( exc.GetErrCode() == exc.eFormatError &&
-             (page->GetFilePos()+page->GetPageSize() == file_pos0) ) {
-            // read past of the file
-            return false;
-        }
-        throw;
+    page = m_File->GetPageOrEOF(file_pos0);
+    if ( !page ) {
+        // read past of the file
+        return 0;
     }
     
     CBGZFPos::TFileBlockPos file_pos = file_pos0;
@@ -562,6 +751,23 @@ bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
         NCBI_THROW_FMT(CBGZFException, eFormatError,
                        "Bad BGZF("<<file_pos0<<") SIZE: "<<block_size);
     }
+    header_size = real_header_size;
+    return block_size;
+}
+
+
+bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
+                            TFileBlockPos file_pos0,
+                            CPagedFile::TPage& page,
+                            CSimpleBufferT<char>& buffer)
+{
+    size_t real_header_size;
+    CBGZFBlock::TFileBlockSize block_size =
+        x_ReadBlockHeader(file_pos0, page, buffer, real_header_size);
+    if ( !block_size ) {
+        return false;
+    }
+    CBGZFPos::TFileBlockPos file_pos = file_pos0 + real_header_size;
     
     // read compressed data and footer
     _ASSERT(block_size <= CBGZFBlock::kMaxFileBlockSize);
@@ -47,14 +47,19 @@
 #endif
 
 #include <corelib/ncbisys.hpp> // for NcbiSys_write
+#include <corelib/ncbifile.hpp>
+#include <sra/readers/bam/bgzf.hpp>
+#include <sra/readers/bam/bamindex.hpp>
 #include <stdio.h> // for perror
 
 #include <corelib/test_boost.hpp>
+#include <common/test_data_path.h>
 #include <common/test_assert.h>  /* This header must go last */
 
 #define NCBI_FTP "https://ftp-ext.ncbi.nlm.nih.gov"
 
 USING_NCBI_SCOPE;
+USING_SCOPE(objects);
 
 void CheckRc(rc_t rc, const char* code, const char* file, int line)
 {
@@ -206,3 +211,159 @@ BOOST_AUTO_TEST_CASE(OpenMultipleBAMFiles)
     CALL(VFSManagerRelease(mgr));
     BOOST_CHECK_EQUAL(error_count.Get(), 0u);
 }
+
+
+static const char* const kPrefetchBamFile =
+    "traces04/1000genomes3/ftp/data/NA19240/exome_alignment/"
+    "NA19240.mapped.SOLID.bfast.YRI.exome.20111114.bam";
+static const char* const kPrefetchRefName = "GL000207.1";
+// read-ahead configurations compared with no read-ahead: threads, blocks
+static const unsigned kPrefetchModes[][2] = {
+    { 2, 2 },
+    { 4, 32 }
+};
+
+
+static string s_GetPrefetchBamPath(void)
+{
+    return CFile::MakePath(NCBI_GetTestDataPath(), kPrefetchBamFile);
+}
+
+
+// the read-ahead tests need a local BAM file from the test data
+static bool s_HavePrefetchBamFile(void)
+{
+    if ( CFile(s_GetPrefetchBamPath()).Exists() ) {
+        return true;
+    }
+    BOOST_WARN_MESSAGE(false, s_GetPrefetchBamPath()<<" is not found");
+    return false;
+}
+
+
+// read uncompressed data from pos till end_pos (or EOF), up to limit bytes
+static string s_ReadBGZF(unsigned threads, unsigned prefetch_blocks,
+                         CBGZFPos pos = CBGZFPos(0, 0),
+                         CBGZFPos end_pos = CBGZFPos::GetInvalid(),
+                         size_t limit = string::npos)
+{
+    CRef<CBGZFFile> file(new CBGZFFile(s_GetPrefetchBamPath()));
+    file->SetPrefetch(threads, prefetch_blocks);
+    CBGZFStream stream(*file);
+    stream.Seek(pos, end_pos);
+    string data;
+    while ( data.size() < limit && stream.HaveNextAvailableBytes() ) {
+        size_t count = min(stream.GetNextAvailableBytes(), limit-data.size());
+        data.append(stream.Read(count), count);
+    }
+    return data;
+}
+
+
+// file positions of all BGZF blocks, found by their headers
+static vector<CBGZFPos::TFileBlockPos> s_GetBlockPositions(void)
+{
+    vector<CBGZFPos::TFileBlockPos> ret;
+    CFileIO file;
+    file.Open(s_GetPrefetchBamPath(), CFileIO::eOpen, CFileIO::eRead);
+    Uint8 file_size = file.GetFileSize();
+    for ( Uint8 pos = 0; pos < file_size; ) {
+        ret.push_back(pos);
+        unsigned char header[18];
+        file.SetFilePos(pos);
+        BOOST_REQUIRE_EQUAL(file.Read(header, sizeof(header)), sizeof(header));
+        // BSIZE (total block size - 1) of the standard BGZF extra field
+        pos += (header[16] | (header[17] << 8)) + 1;
+    }
+    return ret;
+}
+
+
+static vector<string> s_ReadAlignments(unsigned threads,
+                                       unsigned prefetch_blocks,
+                                       const string& ref_name)
+{
+    string path = s_GetPrefetchBamPath();
+    CBamRawDb bam_db(path, path+".bai");
+    bam_db.GetFile().SetPrefetch(threads, prefetch_blocks);
+    vector<string> ret;
+    for ( CBamRawAlignIterator it(bam_db, ref_name, CRange<TSeqPos>::GetWhole());
+          it; ++it ) {
+        ret.push_back(NStr::NumericToString(it.GetFilePos().GetVirtualPos())+' '+
+                      NStr::NumericToString(it.GetRefSeqPos())+' '+
+                      string(it.GetShortSeqId())+' '+
+                      it.GetShortSequence());
+    }
+    return ret;
+}
+
+
+BOOST_AUTO_TEST_CASE(BGZFPrefetchSequential)
+{
+    if ( !s_HavePrefetchBamFile() ) {
+        return;
+    }
+    // the start of the file
+    const size_t kLimit = 16 << 20;
+    string expected = s_ReadBGZF(0, 0, CBGZFPos(0, 0),
+                                 CBGZFPos::GetInvalid(), kLimit);
+    BOOST_REQUIRE_EQUAL(expected.size(), kLimit);
+    for ( auto& mode : kPrefetchModes ) {
+        LOG_POST("Reading with "<<mode[0]<<" threads, "<<mode[1]<<" blocks");
+        string data = s_ReadBGZF(mode[0], mode[1], CBGZFPos(0, 0),
+                                 CBGZFPos::GetInvalid(), kLimit);
+        BOOST_CHECK(data == expected);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(BGZFPrefetchSeekRange)
+{
+    if ( !s_HavePrefetchBamFile() ) {
+        return;
+    }
+    vector<CBGZFPos::TFileBlockPos> blocks = s_GetBlockPositions();
+    BOOST_REQUIRE(blocks.size() > 200);
+    // a range of blocks ending in the middle of a block
+    CBGZFPos pos(blocks[100], 0);
+    CBGZFPos end_pos(blocks[150], 1000);
+    string expected = s_ReadBGZF(0, 0, pos, end_pos);
+    BOOST_REQUIRE(!expected.empty());
+    for ( auto& mode : kPrefetchModes ) {
+        string data = s_ReadBGZF(mode[0], mode[1], pos, end_pos);
+        BOOST_CHECK(data == expected);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(BGZFPrefetchEOF)
+{
+    if ( !s_HavePrefetchBamFile() ) {
+        return;
+    }
+    vector<CBGZFPos::TFileBlockPos> blocks = s_GetBlockPositions();
+    BOOST_REQUIRE(blocks.size() > 100);
+    // the last blocks, including the empty EOF marker block
+    CBGZFPos pos(blocks[blocks.size()-100], 0);
+    string expected = s_ReadBGZF(0, 0, pos);
+    BOOST_REQUIRE(!expected.empty());
+    for ( auto& mode : kPrefetchModes ) {
+        string data = s_ReadBGZF(mode[0], mode[1], pos);
+        BOOST_CHECK(data == expected);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(BGZFPrefetchAlignments)
+{
+    if ( !s_HavePrefetchBamFile() ) {
+        return;
+    }
+    vector<string> expected = s_ReadAlignments(0, 0, kPrefetchRefName);
+    BOOST_REQUIRE(!expected.empty());
+    for ( auto& mode : kPrefetchModes ) {
+        vector<string> aligns = s_ReadAlignments(mode[0], mode[1], kPrefetchRefName);
+        BOOST_CHECK_EQUAL(aligns.size(), expected.size());
+        BOOST_CHECK(aligns == expected);
+    }
+}
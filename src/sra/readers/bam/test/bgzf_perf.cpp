@@ -0,0 +1,145 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Throughput of sequential BGZF decompression with and without read-ahead
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbitime.hpp>
+#include <sra/readers/bam/bgzf.hpp>
+
+#include "bam_test_common.hpp"
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  CBGZFPerfApp::
+
+
+class CBGZFPerfApp : public CBAMTestCommon
+{
+private:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+    Uint8 x_Scan(unsigned threads, unsigned prefetch_blocks);
+};
+
+
+void CBGZFPerfApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    InitCommonArgs(*arg_desc);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "BGZF decompression throughput test");
+
+    arg_desc->AddDefaultKey("threads", "Threads",
+                            "Comma separated numbers of decompression "
+                            "threads to compare (0 - no read-ahead)",
+                            CArgDescriptions::eString,
+                            "0,2,4,8");
+    arg_desc->AddDefaultKey("prefetch", "PrefetchBlocks",
+                            "Number of blocks to decompress ahead",
+                            CArgDescriptions::eInteger,
+                            "32");
+    arg_desc->SetConstraint("prefetch",
+                            new CArgAllow_Integers(1, 4096));
+    arg_desc->AddDefaultKey("limit_mb", "LimitMB",
+                            "Stop after this many MB of uncompressed data "
+                            "(0 - whole file)",
+                            CArgDescriptions::eInteger,
+                            "0");
+    arg_desc->AddDefaultKey("repeat", "Repeat",
+                            "Number of runs of each configuration",
+                            CArgDescriptions::eInteger,
+                            "1");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+Uint8 CBGZFPerfApp::x_Scan(unsigned threads, unsigned prefetch_blocks)
+{
+    Uint8 limit = Uint8(GetArgs()["limit_mb"].AsInteger()) << 20;
+    CRef<CBGZFFile> file(new CBGZFFile(path));
+    file->SetPrefetch(threads, prefetch_blocks);
+    CBGZFStream stream(*file);
+    Uint8 total = 0;
+    while ( (!limit || total < limit) && stream.HaveNextDataBlock() ) {
+        size_t count = stream.GetNextAvailableBytes();
+        stream.Read(count);
+        total += count;
+    }
+    return total;
+}
+
+
+int CBGZFPerfApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    if ( !ParseCommonArgs(args) ) {
+        return 1;
+    }
+
+    vector<string> threads_list;
+    NStr::Split(args["threads"].AsString(), ",", threads_list,
+                NStr::fSplit_Tokenize);
+    unsigned prefetch_blocks = args["prefetch"].AsInteger();
+    int repeat = args["repeat"].AsInteger();
+
+    for ( const string& s : threads_list ) {
+        unsigned threads = NStr::StringToUInt(s);
+        for ( int i = 0; i < repeat; ++i ) {
+            CStopWatch sw(CStopWatch::eStart);
+            Uint8 bytes = x_Scan(threads, prefetch_blocks);
+            double seconds = sw.Elapsed();
+            out << "threads: " << threads
+                << " prefetch: " << (threads? prefetch_blocks: 0)
+                << " uncompressed: " << bytes/double(1<<20) << " MB"
+                << " time: " << seconds << " s"
+                << " speed: " << bytes/(seconds*(1<<20)) << " MB/s"
+                << NcbiEndl;
+        }
+    }
+    return 0;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+
+int main(int argc, const char* argv[])
+{
+    return CBGZFPerfApp().AppMain(argc, argv);
+}
@@ -51,6 +51,7 @@
 #endif /*_FORTIFY_SOURCE*/
 #define  _FORTIFY_SOURCE 0
 #include <util/compress/tar.hpp>
+#include <util/compress/tar_index.hpp>
 #include <util/error_codes.hpp>
 
 #if !defined(NCBI_OS_UNIX)  &&  !defined(NCBI_OS_MSWIN)
@@ -1647,6 +1648,18 @@ unique_ptr<CTar::TEntries> CTar::Extract(void)
 }
 
 
+void CTar::CreateIndex(const string& index_file, Uint8 checkpoint_span)
+{
+    if (!m_FileStream) {
+        TAR_THROW(this, eUnsupportedSource,
+                  "Cannot index in-stream archive");
+    }
+    // Make sure all pending output is in the file
+    x_Close(x_Flush());
+    CTarIndex::Create(m_FileName, index_file, checkpoint_span, m_Flags);
+}
+
+
 const CTarEntryInfo* CTar::GetNextEntryInfo(void)
 {
     if (m_Bad) {
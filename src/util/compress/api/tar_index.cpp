@@ -0,0 +1,762 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Sidecar index for random access to tar archive members
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbifile.hpp>
+#include <util/compress/tar_index.hpp>
+
+#if defined(HAVE_LIBZ)
+#  include <zlib.h>
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+// Index file layout (native byte order, checked on opening):
+//     SHeader,
+//     SIndexEntry[entry_count]       -- sorted by name,
+//     SCheckpoint[checkpoint_count]  -- sorted by position,
+//     windows[checkpoint_count]      -- kWindowSize bytes each,
+//     names[names_size].
+
+static const char   kIndexMagic[8] = { 'N','C','B','I','T','I','X','1' };
+static const Uint4  kIndexByteOrder = 0x01020304;
+static const Uint4  fIndexGzip      = 1;
+
+// Deflate window, the maximum back-reference distance
+static const size_t kWindowSize     = 32 * 1024;
+// I/O buffer size for compressed archives
+static const size_t kGzipBufSize    = 64 * 1024;
+
+const Uint8 CTarIndex::kDefaultCheckpointSpan = 16 * 1024 * 1024;
+
+
+struct CTarIndex::SHeader {
+    char  magic[8];
+    Uint4 byte_order;
+    Uint4 flags;
+    Uint8 archive_size;
+    Int8  archive_mtime;
+    Uint8 entry_count;
+    Uint8 checkpoint_count;
+    Uint8 names_size;
+};
+
+
+struct CTarIndex::SIndexEntry {
+    Uint8 name_pos;
+    Uint8 header_pos;
+    Uint8 data_pos;
+    Uint8 size;
+    Uint4 name_len;
+    Uint4 type;
+};
+
+
+struct CTarIndex::SCheckpoint {
+    Uint8 in_pos;    // position of the next compressed byte in the file
+    Uint8 out_pos;   // position in uncompressed data
+    Uint4 bits;      // number of bits of the previous byte to use
+    Uint4 reserved;
+};
+
+
+static void s_GetArchiveStamp(const string& archive, Uint8* size, Int8* mtime)
+{
+    CFile file(archive);
+    Int8 length = file.GetLength();
+    time_t modification;
+    if (length < 0  ||  !file.GetTimeT(&modification)) {
+        NCBI_THROW(CTarException, eOpen,
+                   "Cannot get archive file information: " + archive);
+    }
+    *size  = (Uint8) length;
+    *mtime = (Int8)  modification;
+}
+
+
+
+#if defined(HAVE_LIBZ)
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CGzipCheckpointStreambuf -- inflate a gzip file, which can be started
+// at a deflate block boundary saved earlier (like zlib's examples/zran.c).
+// Concatenated gzip members are read through.
+//
+
+class CGzipCheckpointStreambuf : public CNcbiStreambuf
+{
+public:
+    typedef CTarIndex::SCheckpoint SCheckpoint;
+
+    CGzipCheckpointStreambuf(CNcbiIstream& file);
+    ~CGzipCheckpointStreambuf();
+
+    // Read from the beginning, saving checkpoints after each "span"
+    // bytes of uncompressed data
+    void StartCollecting(Uint8 span, vector<SCheckpoint>* checkpoints,
+                         string* windows);
+    // Read from the checkpoint (or from the beginning if NULL) and skip
+    // uncompressed data up to "pos"
+    void Start(const SCheckpoint* checkpoint, const char* window, Uint8 pos);
+
+    // Return TRUE if the file is damaged or cannot be read
+    bool IsBad(void) const { return m_Bad; }
+
+protected:
+    virtual CT_INT_TYPE underflow(void);
+
+private:
+    // Read more compressed data, return FALSE on EOF
+    bool   x_Fill(void);
+    // Inflate the next portion of data into m_Out, return its size
+    size_t x_Inflate(void);
+    // Check for the next gzip member after the end of current one
+    bool   x_NextMember(void);
+    void   x_SaveWindow(const char* data, size_t size);
+    void   x_Error(const char* message);
+
+private:
+    CNcbiIstream&        m_File;
+    z_stream             m_Zip;
+    bool                 m_Init;    // m_Zip is initialized
+    bool                 m_Raw;     // reading raw deflate (after checkpoint)
+    bool                 m_Eof;
+    bool                 m_Bad;
+    Uint8                m_InPos;   // file position after m_In contents
+    Uint8                m_OutPos;  // uncompressed position after m_Out
+    Uint8                m_Skip;    // uncompressed data to skip
+    // Checkpoint collecting
+    Uint8                m_Span;
+    Uint8                m_LastPos;
+    vector<SCheckpoint>* m_Checkpoints;
+    string*              m_Windows;
+    AutoArray<char>      m_Window;  // last kWindowSize bytes of output
+    AutoArray<char>      m_In;
+    AutoArray<char>      m_Out;
+};
+
+
+CGzipCheckpointStreambuf::CGzipCheckpointStreambuf(CNcbiIstream& file)
+    : m_File(file),
+      m_Init(false),
+      m_Raw(false),
+      m_Eof(false),
+      m_Bad(false),
+      m_InPos(0),
+      m_OutPos(0),
+      m_Skip(0),
+      m_Span(0),
+      m_LastPos(0),
+      m_Checkpoints(0),
+      m_Windows(0),
+      m_In(kGzipBufSize),
+      m_Out(kGzipBufSize)
+{
+    memset(&m_Zip, 0, sizeof(m_Zip));
+    setg(0, 0, 0);
+}
+
+
+CGzipCheckpointStreambuf::~CGzipCheckpointStreambuf()
+{
+    if (m_Init) {
+        inflateEnd(&m_Zip);
+    }
+}
+
+
+void CGzipCheckpointStreambuf::StartCollecting(Uint8 span,
+                                               vector<SCheckpoint>* checkpoints,
+                                               string* windows)
+{
+    m_Span        = span;
+    m_Checkpoints = checkpoints;
+    m_Windows     = windows;
+    m_Window.reset(new char[kWindowSize]);
+    memset(m_Window.get(), 0, kWindowSize);
+    Start(0, 0, 0);
+}
+
+
+void CGzipCheckpointStreambuf::Start(const SCheckpoint* checkpoint,
+                                     const char* window, Uint8 pos)
+{
+    _ASSERT(!m_Init);
+    Uint8 in_pos = 0;
+    if (checkpoint) {
+        in_pos = checkpoint->in_pos - (checkpoint->bits ? 1 : 0);
+    }
+    m_File.seekg((CT_OFF_TYPE) in_pos);
+    m_InPos = in_pos;
+    // Raw deflate after a checkpoint, gzip header otherwise
+    m_Raw = checkpoint != 0;
+    if (inflateInit2(&m_Zip, m_Raw ? -MAX_WBITS : MAX_WBITS + 16) != Z_OK) {
+        x_Error("inflateInit2() failed");
+        return;
+    }
+    m_Init = true;
+    if ( !m_File.good() ) {
+        x_Error("Cannot seek in archive file");
+        return;
+    }
+    if (checkpoint) {
+        if (checkpoint->bits) {
+            int c = m_File.get();
+            if (c == EOF) {
+                x_Error("Unexpected end of archive file");
+                return;
+            }
+            m_InPos++;
+            inflatePrime(&m_Zip, (int) checkpoint->bits,
+                         c >> (8 - checkpoint->bits));
+        }
+        // The window contains up to kWindowSize last bytes before checkpoint
+        size_t size = (size_t) min(checkpoint->out_pos, (Uint8) kWindowSize);
+        inflateSetDictionary(&m_Zip,
+                             (const Bytef*) window + kWindowSize - size,
+                             (uInt) size);
+        m_OutPos = checkpoint->out_pos;
+    }
+    _ASSERT(pos >= m_OutPos);
+    m_Skip = pos - m_OutPos;
+}
+
+
+void CGzipCheckpointStreambuf::x_Error(const char* message)
+{
+    ERR_POST(Error << "Gzip archive: " << message);
+    m_Bad = m_Eof = true;
+}
+
+
+bool CGzipCheckpointStreambuf::x_Fill(void)
+{
+    if (m_Zip.avail_in  &&  (char*) m_Zip.next_in != m_In.get()) {
+        memmove(m_In.get(), m_Zip.next_in, m_Zip.avail_in);
+    }
+    m_Zip.next_in = (Bytef*) m_In.get();
+    m_File.read(m_In.get() + m_Zip.avail_in,
+                (streamsize)(kGzipBufSize - m_Zip.avail_in));
+    streamsize n = m_File.gcount();
+    if (n <= 0) {
+        if (m_File.bad()) {
+            x_Error("Read error");
+        }
+        return false;
+    }
+    m_Zip.avail_in += (uInt) n;
+    m_InPos        += (Uint8) n;
+    return true;
+}
+
+
+bool CGzipCheckpointStreambuf::x_NextMember(void)
+{
+    if (m_Raw) {
+        // Skip the gzip trailer (CRC32 and size), raw inflate stops before it
+        for (size_t trailer = 8;  trailer;  ) {
+            if ( !m_Zip.avail_in  &&  !x_Fill() ) {
+                return false;
+            }
+            size_t n = min(trailer, (size_t) m_Zip.avail_in);
+            m_Zip.next_in  += n;
+            m_Zip.avail_in -= (uInt) n;
+            trailer        -= n;
+        }
+    }
+    // Anything but a gzip header is treated as the end of data
+    // (archives are often padded with zeros)
+    while (m_Zip.avail_in < 2) {
+        if ( !x_Fill() ) {
+            return false;
+        }
+    }
+    if (m_Zip.next_in[0] != 0x1f  ||  m_Zip.next_in[1] != 0x8b) {
+        return false;
+    }
+    m_Raw = false;
+    if (inflateReset2(&m_Zip, MAX_WBITS + 16) != Z_OK) {
+        x_Error("inflateReset2() failed");
+        return false;
+    }
+    return true;
+}
+
+
+void CGzipCheckpointStreambuf::x_SaveWindow(const char* data, size_t size)
+{
+    char* window = m_Window.get();
+    if (size >= kWindowSize) {
+        memcpy(window, data + size - kWindowSize, kWindowSize);
+    } else {
+        memmove(window, window + size, kWindowSize - size);
+        memcpy(window + kWindowSize - size, data, size);
+    }
+}
+
+
+size_t CGzipCheckpointStreambuf::x_Inflate(void)
+{
+    while ( !m_Eof ) {
+        if ( !m_Zip.avail_in  &&  !x_Fill() ) {
+            if ( !m_Bad ) {
+                x_Error("Unexpected end of archive file");
+            }
+            break;
+        }
+        m_Zip.next_out  = (Bytef*) m_Out.get();
+        m_Zip.avail_out = (uInt) kGzipBufSize;
+        // Z_BLOCK stops at the end of each deflate block,
+        // so the checkpoints can be saved there
+        int status = inflate(&m_Zip, m_Checkpoints ? Z_BLOCK : Z_NO_FLUSH);
+        if (status != Z_OK  &&  status != Z_STREAM_END  &&  status != Z_BUF_ERROR) {
+            x_Error(m_Zip.msg ? m_Zip.msg : "Decompression error");
+            break;
+        }
+        size_t n = kGzipBufSize - m_Zip.avail_out;
+        m_OutPos += n;
+        if (m_Checkpoints) {
+            x_SaveWindow(m_Out.get(), n);
+            // End of a deflate block, that is not the last one in the member
+            if ((m_Zip.data_type & 128)  &&  !(m_Zip.data_type & 64)  &&
+                m_OutPos - m_LastPos >= m_Span) {
+                SCheckpoint checkpoint;
+                checkpoint.in_pos   = m_InPos - m_Zip.avail_in;
+                checkpoint.out_pos  = m_OutPos;
+                checkpoint.bits     = (Uint4)(m_Zip.data_type & 7);
+                checkpoint.reserved = 0;
+                m_Checkpoints->push_back(checkpoint);
+                m_Windows->append(m_Window.get(), kWindowSize);
+                m_LastPos = m_OutPos;
+            }
+        }
+        if (status == Z_STREAM_END  &&  !x_NextMember()) {
+            m_Eof = true;
+        }
+        if (n) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+
+CT_INT_TYPE CGzipCheckpointStreambuf::underflow(void)
+{
+    for (;;) {
+        size_t n = x_Inflate();
+        if ( !n ) {
+            return CT_EOF;
+        }
+        if (m_Skip >= n) {
+            m_Skip -= n;
+            continue;
+        }
+        setg(m_Out.get(), m_Out.get() + (size_t) m_Skip, m_Out.get() + n);
+        m_Skip = 0;
+        return CT_TO_INT_TYPE(*gptr());
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CGzipCheckpointStream -- the archive file and its decompression
+//
+
+class CGzipCheckpointStream : public CNcbiIstream
+{
+public:
+    CGzipCheckpointStream(const string& archive)
+        : CNcbiIstream(0),
+          m_File(archive.c_str(), IOS_BASE::in | IOS_BASE::binary),
+          m_Buf(m_File)
+    {
+        init(&m_Buf);
+    }
+    CGzipCheckpointStreambuf& GetBuf(void) { return m_Buf; }
+
+private:
+    CNcbiIfstream            m_File;
+    CGzipCheckpointStreambuf m_Buf;
+};
+
+#endif /*HAVE_LIBZ*/
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CTarIndexReader -- extract a member from the archive stream owned
+//
+
+class CTarIndexReader : public IReader
+{
+public:
+    CTarIndexReader(CNcbiIstream* is, IReader* reader)
+        : m_Stream(is), m_Reader(reader)
+    { }
+
+    virtual ERW_Result Read(void* buf, size_t count, size_t* bytes_read = 0)
+    { return m_Reader->Read(buf, count, bytes_read); }
+    virtual ERW_Result PendingCount(size_t* count)
+    { return m_Reader->PendingCount(count); }
+
+private:
+    // NB: the reader must be destroyed before the stream
+    unique_ptr<CNcbiIstream> m_Stream;
+    unique_ptr<IReader>      m_Reader;
+};
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CTarIndex
+//
+
+string CTarIndex::GetDefaultIndexName(const string& archive)
+{
+    return archive + ".idx";
+}
+
+
+void CTarIndex::Create(const string& archive,
+                       const string& index_file,
+                       Uint8         checkpoint_span,
+                       CTar::TFlags  flags)
+{
+    string index_name = index_file.empty()
+        ? GetDefaultIndexName(archive) : index_file;
+    if ( !checkpoint_span ) {
+        checkpoint_span = kDefaultCheckpointSpan;
+    }
+    flags &= ~(CTar::fStreamPipeThrough | CTar::fDumpEntryHeaders);
+
+    SHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.byte_order = kIndexByteOrder;
+    s_GetArchiveStamp(archive, &header.archive_size, &header.archive_mtime);
+
+    // Detect compression by the gzip magic
+    bool gzip = false;
+    {{
+        CNcbiIfstream ifs(archive.c_str(), IOS_BASE::in | IOS_BASE::binary);
+        unsigned char magic[2] = { 0, 0 };
+        ifs.read((char*) magic, sizeof(magic));
+        if ( !ifs.is_open() ) {
+            NCBI_THROW(CTarException, eOpen,
+                       "Cannot open archive: " + archive);
+        }
+        gzip = ifs.gcount() == 2  &&  magic[0] == 0x1f  &&  magic[1] == 0x8b;
+    }}
+
+    // Read the archive
+    unique_ptr<CTar::TEntries> entries;
+    vector<SCheckpoint> checkpoints;
+    string windows;
+    if (gzip) {
+#if defined(HAVE_LIBZ)
+        header.flags |= fIndexGzip;
+        CGzipCheckpointStream is(archive);
+        is.GetBuf().StartCollecting(checkpoint_span, &checkpoints, &windows);
+        CTar tar(is);
+        tar.SetFlags(flags);
+        entries = tar.List();
+        if (is.GetBuf().IsBad()) {
+            NCBI_THROW(CTarException, eRead,
+                       "Cannot decompress archive: " + archive);
+        }
+#else
+        NCBI_THROW(CTarException, eUnsupportedSource,
+                   "Gzip-compressed archives are not supported"
+                   " in this build: " + archive);
+#endif /*HAVE_LIBZ*/
+    } else {
+        CTar tar(archive);
+        tar.SetFlags(flags);
+        entries = tar.List();
+    }
+
+    // Only the last copy of each member is the actual one
+    map<string, const CTarEntryInfo*> members;
+    ITERATE(CTar::TEntries, it, *entries) {
+        members[it->GetName()] = &*it;
+    }
+    vector<SIndexEntry> index;
+    string names;
+    index.reserve(members.size());
+    for (const auto& it : members) {
+        const CTarEntryInfo& info = *it.second;
+        SIndexEntry entry;
+        entry.name_pos   = names.size();
+        entry.name_len   = (Uint4) info.GetName().size();
+        entry.type       = (Uint4) info.GetType();
+        entry.header_pos = info.GetPosition(CTarEntryInfo::ePos_Header);
+        entry.data_pos   = info.GetPosition(CTarEntryInfo::ePos_Data);
+        entry.size       = info.GetSize();
+        index.push_back(entry);
+        names += info.GetName();
+    }
+    header.entry_count      = index.size();
+    header.checkpoint_count = checkpoints.size();
+    header.names_size       = names.size();
+
+    // Write the index
+    CNcbiOfstream ofs(index_name.c_str(),
+                      IOS_BASE::out | IOS_BASE::trunc | IOS_BASE::binary);
+    ofs.write((const char*) &header, sizeof(header));
+    if ( !index.empty() ) {
+        ofs.write((const char*) &index[0], index.size() * sizeof(SIndexEntry));
+    }
+    if ( !checkpoints.empty() ) {
+        ofs.write((const char*) &checkpoints[0],
+                  checkpoints.size() * sizeof(SCheckpoint));
+    }
+    ofs.write(windows.data(), windows.size());
+    ofs.write(names.data(), names.size());
+    ofs.close();
+    if ( !ofs ) {
+        NCBI_THROW(CTarException, eWrite,
+                   "Cannot write archive index: " + index_name);
+    }
+}
+
+
+CTarIndex::CTarIndex(const string& archive, const string& index_file)
+    : m_Archive(archive),
+      m_Header(0),
+      m_Entries(0),
+      m_Checkpoints(0),
+      m_Windows(0),
+      m_Names(0)
+{
+    string index_name = index_file.empty()
+        ? GetDefaultIndexName(archive) : index_file;
+    try {
+        m_File.reset(new CMemoryFile(index_name));
+    }
+    catch (CException& e) {
+        NCBI_RETHROW(e, CTarException, eOpen,
+                     "Cannot open archive index: " + index_name);
+    }
+    const char* ptr = static_cast<const char*>(m_File->GetPtr());
+    size_t size = m_File->GetSize();
+    m_Header = reinterpret_cast<const SHeader*>(ptr);
+    if ( !ptr  ||  size < sizeof(SHeader)  ||
+         memcmp(m_Header->magic, kIndexMagic, sizeof(kIndexMagic)) != 0 ) {
+        NCBI_THROW(CTarException, eOpen,
+                   "Not an archive index file: " + index_name);
+    }
+    if (m_Header->byte_order != kIndexByteOrder) {
+        NCBI_THROW(CTarException, eOpen,
+                   "Archive index file was written with a different"
+                   " byte order: " + index_name);
+    }
+    // Check the counts first, so that the expected size cannot overflow
+    Uint8 expected = sizeof(SHeader);
+    if (m_Header->entry_count      <= size / sizeof(SIndexEntry)  &&
+        m_Header->checkpoint_count <= size / (sizeof(SCheckpoint) + kWindowSize)  &&
+        m_Header->names_size       <= size) {
+        expected +=
+            m_Header->entry_count      * sizeof(SIndexEntry) +
+            m_Header->checkpoint_count * (sizeof(SCheckpoint) + kWindowSize) +
+            m_Header->names_size;
+    } else {
+        expected = 0;
+    }
+    if (expected != size) {
+        NCBI_THROW(CTarException, eOpen,
+                   "Archive index file is truncated or corrupted: "
+                   + index_name);
+    }
+    Uint8 archive_size;
+    Int8  archive_mtime;
+    s_GetArchiveStamp(archive, &archive_size, &archive_mtime);
+    if (archive_size  != m_Header->archive_size  ||
+        archive_mtime != m_Header->archive_mtime) {
+        NCBI_THROW(CTarException, eOpen,
+                   "Archive has been changed since its index was created: "
+                   + index_name);
+    }
+#if !defined(HAVE_LIBZ)
+    if (IsCompressed()) {
+        NCBI_THROW(CTarException, eUnsupportedSource,
+                   "Gzip-compressed archives are not supported"
+                   " in this build: " + archive);
+    }
+#endif /*HAVE_LIBZ*/
+    ptr += sizeof(SHeader);
+    m_Entries = reinterpret_cast<const SIndexEntry*>(ptr);
+    ptr += m_Header->entry_count * sizeof(SIndexEntry);
+    m_Checkpoints = reinterpret_cast<const SCheckpoint*>(ptr);
+    ptr += m_Header->checkpoint_count * sizeof(SCheckpoint);
+    m_Windows = ptr;
+    ptr += m_Header->checkpoint_count * kWindowSize;
+    m_Names = ptr;
+
+    // Names of all entries must be within the name table
+    for (Uint8 i = 0;  i < m_Header->entry_count;  ++i) {
+        const SIndexEntry& entry = m_Entries[i];
+        if (entry.name_pos > m_Header->names_size  ||
+            entry.name_len > m_Header->names_size - entry.name_pos) {
+            NCBI_THROW(CTarException, eOpen,
+                       "Archive index file has a bad name of entry "
+                       + NStr::NumericToString(i) + ": " + index_name);
+        }
+    }
+}
+
+
+CTarIndex::~CTarIndex()
+{
+}
+
+
+bool CTarIndex::IsCompressed(void) const
+{
+    return (m_Header->flags & fIndexGzip) != 0;
+}
+
+
+size_t CTarIndex::GetEntryCount(void) const
+{
+    return (size_t) m_Header->entry_count;
+}
+
+
+CTarIndex::SEntry CTarIndex::GetEntry(size_t n) const
+{
+    _ASSERT(n < GetEntryCount());
+    const SIndexEntry& entry = m_Entries[n];
+    SEntry result;
+    result.name.assign(m_Names + entry.name_pos, entry.name_len);
+    result.type       = (CTarEntryInfo::EType) entry.type;
+    result.header_pos = entry.header_pos;
+    result.data_pos   = entry.data_pos;
+    result.size       = entry.size;
+    return result;
+}
+
+
+// Compare the same way as std::string does (by unsigned char values)
+static int s_CompareName(const char* name, size_t len, const string& key)
+{
+    int res = memcmp(name, key.data(), min(len, key.size()));
+    if (res) {
+        return res;
+    }
+    return len < key.size() ? -1 : len > key.size() ? 1 : 0;
+}
+
+
+bool CTarIndex::Find(const string& name, SEntry* entry) const
+{
+    const SIndexEntry* begin = m_Entries;
+    const SIndexEntry* end   = m_Entries + GetEntryCount();
+    const SIndexEntry* it = lower_bound(begin, end, name,
+        [this](const SIndexEntry& e, const string& key) {
+            return s_CompareName(m_Names + e.name_pos, e.name_len, key) < 0;
+        });
+    if (it == end  ||
+        s_CompareName(m_Names + it->name_pos, it->name_len, name) != 0) {
+        return false;
+    }
+    if (entry) {
+        *entry = GetEntry(it - begin);
+    }
+    return true;
+}
+
+
+CNcbiIstream* CTarIndex::x_OpenArchive(Uint8 pos) const
+{
+#if defined(HAVE_LIBZ)
+    if (IsCompressed()) {
+        // The last checkpoint before the position
+        const SCheckpoint* begin = m_Checkpoints;
+        const SCheckpoint* end   = m_Checkpoints + m_Header->checkpoint_count;
+        const SCheckpoint* it = upper_bound(begin, end, pos,
+            [](Uint8 p, const SCheckpoint& c) { return p < c.out_pos; });
+        const SCheckpoint* checkpoint = it == begin ? 0 : it - 1;
+        const char* window = checkpoint
+            ? m_Windows + (checkpoint - begin) * kWindowSize : 0;
+        unique_ptr<CGzipCheckpointStream> is
+            (new CGzipCheckpointStream(m_Archive));
+        if ( !is->good() ) {
+            NCBI_THROW(CTarException, eOpen,
+                       "Cannot open archive: " + m_Archive);
+        }
+        is->GetBuf().Start(checkpoint, window, pos);
+        if (is->GetBuf().IsBad()) {
+            NCBI_THROW(CTarException, eRead,
+                       "Cannot decompress archive: " + m_Archive);
+        }
+        return is.release();
+    }
+#endif /*HAVE_LIBZ*/
+    unique_ptr<CNcbiIfstream> is
+        (new CNcbiIfstream(m_Archive.c_str(), IOS_BASE::in | IOS_BASE::binary));
+    is->seekg((CT_OFF_TYPE) pos);
+    if ( !is->good() ) {
+        NCBI_THROW(CTarException, eOpen,
+                   "Cannot open archive: " + m_Archive);
+    }
+    return is.release();
+}
+
+
+IReader* CTarIndex::Extract(const string& name, CTar::TFlags flags) const
+{
+    SEntry entry;
+    if ( !Find(name, &entry) ) {
+        return 0;
+    }
+    if (entry.type != CTarEntryInfo::eFile
+        &&  (entry.type != CTarEntryInfo::eUnknown
+             ||  (flags & CTar::fSkipUnsupported))) {
+        return 0;
+    }
+    unique_ptr<CNcbiIstream> is(x_OpenArchive(entry.header_pos));
+    // The stream is positioned at the member header, so CTar reads
+    // just the one entry
+    IReader* reader = CTar::Extract(*is, entry.name, flags);
+    if ( !reader ) {
+        return 0;
+    }
+    return new CTarIndexReader(is.release(), reader);
+}
+
+
+END_NCBI_SCOPE
@@ -1646,6 +1646,470 @@ CCompressionProcessor::EStatus CZipDecompressor::End(int abandon)
 
 
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// CZipBlockCompressor
+//
+
+// Index members, each one is an empty gzip member with an "extra field":
+//     'N','I', LEN (2), and LEN/8 pairs of UI4 values: compressed and
+//     uncompressed size of each block, in order.
+// Index tail, the last member of fixed size:
+//     'N','T', LEN (2) = 20, UI8 offset of the first index member,
+//     UI8 offset of the tail member itself, UI4 number of blocks.
+// The offsets are relative to the beginning of the compressed data.
+// The whole header should fit into kMaxHeaderSize to be skipped by
+// CZipDecompressor, so the index is split into several members.
+
+const unsigned char kBlockIndexId[2] = { 'N', 'I' };
+const unsigned char kBlockTailId[2]  = { 'N', 'T' };
+const size_t kBlockIndexEntries      = 480;  // per member
+const size_t kBlockTailDataSize      = 20;
+// header (10) + XLEN (2) + subfield (4) + data + empty deflate (2) + footer (8)
+const size_t kBlockTailSize          = 10 + 2 + 4 + kBlockTailDataSize + 2 + 8;
+const size_t kMaxBlockSize           = 1024*1024*1024;
+
+
+static void s_StoreUI8(void* buf, Uint8 value)
+{
+    CCompressionUtil::StoreUI4(buf, (unsigned long)(value & 0xFFFFFFFF));
+    CCompressionUtil::StoreUI4((unsigned char*)buf + 4, (unsigned long)(value >> 32));
+}
+
+
+static Uint8 s_GetUI8(const void* buf)
+{
+    return CCompressionUtil::GetUI4(buf) |
+           (Uint8(CCompressionUtil::GetUI4((const unsigned char*)buf + 4)) << 32);
+}
+
+
+// Write empty gzip member with a single extra subfield.
+static void s_WriteExtraMember(string& out, const unsigned char id[2],
+                               const string& data)
+{
+    _ASSERT(data.size() + 4 <= kMaxHeaderSize - 12);
+    unsigned char hdr[16];
+    memset(hdr, 0, 10);
+    hdr[0] = gz_magic[0];
+    hdr[1] = gz_magic[1];
+    hdr[2] = Z_DEFLATED;
+    hdr[3] = EXTRA_FIELD;
+    hdr[9] = OS_CODE;
+    CCompressionUtil::StoreUI2(hdr + 10, (unsigned long)(data.size() + 4));
+    hdr[12] = id[0];
+    hdr[13] = id[1];
+    CCompressionUtil::StoreUI2(hdr + 14, (unsigned long)data.size());
+    out.append((char*)hdr, sizeof(hdr));
+    out.append(data);
+    // Empty final deflate block, CRC32 and size of empty data
+    static const char kEmpty[10] = { 0x03, 0x00, 0, 0, 0, 0, 0, 0, 0, 0 };
+    out.append(kEmpty, sizeof(kEmpty));
+}
+
+
+CZipBlockCompressor::CZipBlockCompressor(ELevel level, unsigned int threads,
+                                         size_t block_size, TZipFlags flags)
+    : CZipCompression(level),
+      m_Threads(threads),
+      m_BlockSize(block_size),
+      m_OutputPos(0),
+      m_RawSize(0),
+      m_Finished(false)
+{
+    if (!m_BlockSize) {
+        m_BlockSize = kDefaultBlockSize;
+    }
+    if (m_BlockSize > kMaxBlockSize) {
+        m_BlockSize = kMaxBlockSize;
+    }
+    SetFlags(flags | fWriteGZipFormat);
+}
+
+
+CZipBlockCompressor::~CZipBlockCompressor()
+{
+    // Pending blocks don't refer to this object, so the futures
+    // just wait for them on destruction
+}
+
+
+CCompressionProcessor::EStatus CZipBlockCompressor::Init(void)
+{
+    if ( IsBusy() ) {
+        // Abnormal previous session termination
+        End();
+    }
+    // Initialize members
+    Reset();
+    SetBusy();
+    m_Block.clear();
+    m_Block.reserve(m_BlockSize);
+    m_Pending.clear();
+    m_Queued.clear();
+    m_Output.clear();
+    m_OutputPos = 0;
+    m_Index.clear();
+    m_RawSize   = 0;
+    m_Finished  = false;
+    SetError(Z_OK);
+    return eStatus_Success;
+}
+
+
+void CZipBlockCompressor::x_StartBlock(void)
+{
+    string block;
+    block.reserve(m_BlockSize);
+    block.swap(m_Block);
+    m_Queued.push_back(std::move(block));
+    x_LaunchBlocks();
+}
+
+
+void CZipBlockCompressor::x_LaunchBlocks(void)
+{
+    // Blocks are compressed by separate CZipCompression objects,
+    // so pass all parameters by value
+    ELevel level       = GetLevel();
+    int    window_bits = GetWindowBits();
+    int    mem_level   = GetMemoryLevel();
+    int    strategy    = GetStrategy();
+
+    auto compress = [level, window_bits, mem_level, strategy](string src) {
+        SBlock result;
+        result.size    = src.size();
+        result.errcode = Z_OK;
+        CZipCompression zip(level);
+        zip.SetFlags(fWriteGZipFormat | fAllowEmptyData);
+        zip.SetWindowBits(window_bits);
+        zip.SetMemoryLevel(mem_level);
+        zip.SetStrategy(strategy);
+        // EstimateCompressionBufferSize() doesn't count gzip footer
+        result.data.resize(zip.EstimateCompressionBufferSize(src.size()) + 8);
+        size_t n = 0;
+        if ( zip.CompressBuffer(src.data(), src.size(),
+                                &result.data[0], result.data.size(), &n) ) {
+            result.data.resize(n);
+        } else {
+            result.data.clear();
+            result.errcode = zip.GetErrorCode();
+            result.message = zip.GetErrorDescription();
+        }
+        return result;
+    };
+    // No more than m_Threads blocks are compressed at once
+    while ( !m_Queued.empty()  &&  m_Pending.size() < max(m_Threads, 1u) ) {
+        m_Pending.push_back(async(m_Threads ? launch::async : launch::deferred,
+                                  compress, std::move(m_Queued.front())));
+        m_Queued.pop_front();
+    }
+}
+
+
+bool CZipBlockCompressor::x_CollectBlocks(bool wait)
+{
+    // Queued blocks keep all threads busy while the output is written,
+    // so wait for a block only if there are two blocks per thread
+    const size_t max_pending = max(m_Threads, 1u) * 2;
+
+    while ( !m_Pending.empty() ) {
+        future<SBlock>& front = m_Pending.front();
+        if ( !wait  &&  m_Pending.size() + m_Queued.size() < max_pending  &&
+             front.wait_for(chrono::seconds(0)) != future_status::ready ) {
+            break;
+        }
+        SBlock block = front.get();
+        m_Pending.pop_front();
+        x_LaunchBlocks();
+        if ( block.errcode != Z_OK ) {
+            SetError(block.errcode, block.message.c_str());
+            ERR_COMPRESS(123, FormatErrorMessage("CZipBlockCompressor::Process",
+                                                 GetProcessedSize()));
+            return false;
+        }
+        if ( m_OutputPos == m_Output.size() ) {
+            m_Output.clear();
+            m_OutputPos = 0;
+        }
+        m_Output.append(block.data);
+        m_RawSize += block.data.size();
+        m_Index.emplace_back((Uint4)block.data.size(), (Uint4)block.size);
+    }
+    return true;
+}
+
+
+size_t CZipBlockCompressor::x_CopyOutput(char* out_buf, size_t out_size)
+{
+    size_t n = min(out_size, m_Output.size() - m_OutputPos);
+    memcpy(out_buf, m_Output.data() + m_OutputPos, n);
+    m_OutputPos += n;
+    IncreaseOutputSize(n);
+    return n;
+}
+
+
+void CZipBlockCompressor::x_WriteIndex(void)
+{
+    Uint8 index_pos = m_RawSize;
+    size_t size = m_Output.size();
+
+    for (size_t i = 0;  i < m_Index.size();  i += kBlockIndexEntries) {
+        size_t count = min(kBlockIndexEntries, m_Index.size() - i);
+        string data(count * 8, '\0');
+        for (size_t j = 0;  j < count;  ++j) {
+            CCompressionUtil::StoreUI4(&data[j*8],     m_Index[i+j].first);
+            CCompressionUtil::StoreUI4(&data[j*8 + 4], m_Index[i+j].second);
+        }
+        s_WriteExtraMember(m_Output, kBlockIndexId, data);
+    }
+    Uint8 tail_pos = index_pos + (m_Output.size() - size);
+
+    string tail(kBlockTailDataSize, '\0');
+    s_StoreUI8(&tail[0], index_pos);
+    s_StoreUI8(&tail[8], tail_pos);
+    CCompressionUtil::StoreUI4(&tail[16], (unsigned long)m_Index.size());
+    s_WriteExtraMember(m_Output, kBlockTailId, tail);
+    m_RawSize = tail_pos + kBlockTailSize;
+}
+
+
+CCompressionProcessor::EStatus CZipBlockCompressor::Process(
+                      const char* in_buf,  size_t  in_len,
+                      char*       out_buf, size_t  out_size,
+                      /* out */            size_t* in_avail,
+                      /* out */            size_t* out_avail)
+{
+    *out_avail = 0;
+    *in_avail  = in_len;
+    if ( !out_size ) {
+        return eStatus_Overflow;
+    }
+    // Don't take new data while a block of compressed data is waiting
+    // for output, this limits the memory usage for slow output streams
+    if (m_Output.size() - m_OutputPos < m_BlockSize) {
+        size_t n = min(in_len, m_BlockSize - m_Block.size());
+        m_Block.append(in_buf, n);
+        *in_avail = in_len - n;
+        IncreaseProcessedSize(n);
+        if (m_Block.size() == m_BlockSize) {
+            x_StartBlock();
+        }
+    }
+    if ( !x_CollectBlocks(false) ) {
+        return eStatus_Error;
+    }
+    *out_avail = x_CopyOutput(out_buf, out_size);
+    return eStatus_Success;
+}
+
+
+CCompressionProcessor::EStatus CZipBlockCompressor::Flush(
+                      char* out_buf, size_t  out_size,
+                      /* out */      size_t* out_avail)
+{
+    *out_avail = 0;
+    if ( !out_size ) {
+        return eStatus_Overflow;
+    }
+    // End current block, so all data written so far can be decompressed
+    if ( !m_Block.empty() ) {
+        x_StartBlock();
+    }
+    if ( !x_CollectBlocks(true) ) {
+        return eStatus_Error;
+    }
+    *out_avail = x_CopyOutput(out_buf, out_size);
+    if (m_OutputPos < m_Output.size()) {
+        return eStatus_Overflow;
+    }
+    return eStatus_Success;
+}
+
+
+CCompressionProcessor::EStatus CZipBlockCompressor::Finish(
+                      char* out_buf, size_t  out_size,
+                      /* out */      size_t* out_avail)
+{
+    *out_avail = 0;
+
+    // Default behavior on empty data -- don't write header/footer
+    if ( !GetProcessedSize()  &&  !F_ISSET(fAllowEmptyData) ) {
+        // This will set a badbit on a stream
+        return eStatus_Error;
+    }
+    if ( !out_size ) {
+        return eStatus_Overflow;
+    }
+    if ( !m_Finished ) {
+        // Empty data still produce a single empty gzip member
+        if ( !m_Block.empty()  ||  (m_Index.empty()  &&  m_Pending.empty()  &&
+                                    m_Queued.empty()) ) {
+            x_StartBlock();
+        }
+        if ( !x_CollectBlocks(true) ) {
+            return eStatus_Error;
+        }
+        if ( F_ISSET(fWriteBlockIndex) ) {
+            x_WriteIndex();
+        }
+        m_Finished = true;
+    }
+    *out_avail = x_CopyOutput(out_buf, out_size);
+    if (m_OutputPos < m_Output.size()) {
+        return eStatus_Overflow;
+    }
+    return eStatus_EndOfData;
+}
+
+
+CCompressionProcessor::EStatus CZipBlockCompressor::End(int abandon)
+{
+    // Wait for the blocks in compression, but ignore the result
+    m_Queued.clear();
+    m_Pending.clear();
+    m_Block.clear();
+    m_Output.clear();
+    m_OutputPos = 0;
+    SetBusy(false);
+    if ( !abandon  &&  !m_Finished  &&  GetProcessedSize() ) {
+        SetError(-1, "CZipBlockCompressor::End: compression is not finished");
+        return eStatus_Error;
+    }
+    return eStatus_Success;
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CZipBlockIndex
+//
+
+bool CZipBlockIndex::Read(CNcbiIstream& is)
+{
+    m_Blocks.clear();
+
+    // Read and check the tail member
+    is.seekg(0, IOS_BASE::end);
+    CT_POS_TYPE end = is.tellg();
+    if ( !is.good()  ||  end - CT_POS_TYPE(0) < (CT_OFF_TYPE)kBlockTailSize ) {
+        return false;
+    }
+    Uint8 tail_stream_pos = (Uint8)(end - CT_POS_TYPE(0)) - kBlockTailSize;
+    unsigned char tail[kBlockTailSize];
+    is.seekg((CT_OFF_TYPE)tail_stream_pos);
+    if ( !is.read((char*)tail, kBlockTailSize) ) {
+        return false;
+    }
+    if (tail[0] != gz_magic[0]  ||  tail[1] != gz_magic[1]  ||
+        tail[3] != EXTRA_FIELD  ||
+        CCompressionUtil::GetUI2(tail + 10) != kBlockTailDataSize + 4  ||
+        tail[12] != kBlockTailId[0]  ||  tail[13] != kBlockTailId[1]  ||
+        CCompressionUtil::GetUI2(tail + 14) != kBlockTailDataSize) {
+        return false;
+    }
+    Uint8  index_pos = s_GetUI8(tail + 16);
+    Uint8  tail_pos  = s_GetUI8(tail + 24);
+    size_t count     = CCompressionUtil::GetUI4(tail + 32);
+    if (index_pos > tail_pos  ||  tail_pos > tail_stream_pos) {
+        return false;
+    }
+    // Compressed data may be preceded by other data in the stream
+    Uint8 base = tail_stream_pos - tail_pos;
+
+    // Read index members
+    string index((size_t)(tail_pos - index_pos), '\0');
+    is.seekg((CT_OFF_TYPE)(base + index_pos));
+    if ( !index.empty()  &&  !is.read(&index[0], index.size()) ) {
+        return false;
+    }
+    m_Blocks.reserve(count);
+    Uint8 raw_pos  = base;
+    Uint8 data_pos = 0;
+    const unsigned char* ptr = (const unsigned char*)index.data();
+    const unsigned char* ptr_end = ptr + index.size();
+
+    while (ptr < ptr_end) {
+        if (ptr_end - ptr < 16  ||
+            ptr[0] != gz_magic[0]  ||  ptr[1] != gz_magic[1]  ||
+            ptr[3] != EXTRA_FIELD  ||
+            ptr[12] != kBlockIndexId[0]  ||  ptr[13] != kBlockIndexId[1]) {
+            m_Blocks.clear();
+            return false;
+        }
+        size_t len = CCompressionUtil::GetUI2(ptr + 14);
+        if ((size_t)(ptr_end - ptr) < 16 + len + 10  ||  len % 8) {
+            m_Blocks.clear();
+            return false;
+        }
+        for (const unsigned char* entry = ptr + 16;  entry < ptr + 16 + len;  entry += 8) {
+            SBlock block;
+            block.raw_pos   = raw_pos;
+            block.raw_size  = CCompressionUtil::GetUI4(entry);
+            block.data_pos  = data_pos;
+            block.data_size = CCompressionUtil::GetUI4(entry + 4);
+            m_Blocks.push_back(block);
+            raw_pos  += block.raw_size;
+            data_pos += block.data_size;
+        }
+        ptr += 16 + len + 10;
+    }
+    if (m_Blocks.size() != count  ||  raw_pos != base + index_pos) {
+        m_Blocks.clear();
+        return false;
+    }
+    return true;
+}
+
+
+Uint8 CZipBlockIndex::GetDataSize(void) const
+{
+    if ( m_Blocks.empty() ) {
+        return 0;
+    }
+    return m_Blocks.back().data_pos + m_Blocks.back().data_size;
+}
+
+
+size_t CZipBlockIndex::FindBlock(Uint8 data_pos) const
+{
+    // First block that ends after the position
+    auto it = upper_bound(m_Blocks.begin(), m_Blocks.end(), data_pos,
+        [](Uint8 pos, const SBlock& block) {
+            return pos < block.data_pos + block.data_size;
+        });
+    return it - m_Blocks.begin();
+}
+
+
+bool CZipBlockIndex::ReadBlock(CNcbiIstream& is, size_t n, string& data) const
+{
+    data.clear();
+    if (n >= m_Blocks.size()) {
+        return false;
+    }
+    const SBlock& block = m_Blocks[n];
+    string raw(block.raw_size, '\0');
+    is.seekg((CT_OFF_TYPE)block.raw_pos);
+    if ( !is.read(&raw[0], raw.size()) ) {
+        return false;
+    }
+    CZipCompression zip;
+    zip.SetFlags(CZipCompression::fCheckFileHeader | CZipCompression::fAllowEmptyData);
+    data.resize(block.data_size);
+    size_t size = 0;
+    if ( !zip.DecompressBuffer(raw.data(), raw.size(),
+                               block.data_size ? &data[0] : &raw[0], block.data_size, &size)  ||
+         size != block.data_size ) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // Global functions
@@ -74,7 +74,7 @@ BEGIN_NCBI_SCOPE
 
 CZstdCompression::CZstdCompression(ELevel level)
     : CCompression(level), 
-      m_c_Strategy(0), m_cd_WindowLog(0), m_c_DictLoaded(false), m_d_DictLoaded(false)
+      m_c_Strategy(0), m_cd_WindowLog(0), m_c_Threads(0), m_c_DictLoaded(false), m_d_DictLoaded(false)
       
 {
     // Initialize compression contexts
@@ -271,6 +271,7 @@ bool CZstdCompression::CompressFile(const string& src_file,
     // Pass advanced parameters from 
     cf.SetStrategy(GetStrategy());
     cf.SetWindowLog(GetWindowLog());
+    cf.SetThreads(GetThreads());
     if (m_Dict) {
         cf.SetDictionary(*m_Dict, eNoOwnership);
     }
@@ -443,6 +444,15 @@ bool CZstdCompression::SetCompressionParameters(void)
     if (!ZSTD_isError(result)) {
         result = ZSTD_CCtx_setParameter(CCTX, ZSTD_c_windowLog, GetWindowLog());
     }
+    if (!ZSTD_isError(result)) {
+        result = ZSTD_CCtx_setParameter(CCTX, ZSTD_c_nbWorkers, GetThreads());
+        if (ZSTD_isError(result)  &&  
+            ZSTD_getErrorCode(result) == ZSTD_error_parameter_unsupported) {
+            // Library is built without multithreading support,
+            // compress in the current thread
+            result = 0;
+        }
+    }
     // Dictionary, setup last, after all other parameters
     if (!ZSTD_isError(result)) {
         if ( m_Dict ) {
@@ -632,6 +642,7 @@ bool CZstdCompressionFile::Open(const string& file_name, EMode mode,
         CZstdCompressor* compressor = new CZstdCompressor(GetLevel(), GetFlags());
         compressor->SetStrategy(GetStrategy());
         compressor->SetWindowLog(GetWindowLog());
+        compressor->SetThreads(GetThreads());
         if (m_Dict) {
             compressor->SetDictionary(*m_Dict, eNoOwnership);
         }
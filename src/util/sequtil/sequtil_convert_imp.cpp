@@ -36,6 +36,7 @@
 
 #include "sequtil_convert_imp.hpp"
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 #include "sequtil_tables.hpp"
 
 #include <stdlib.h>
@@ -267,6 +268,13 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo2na
     const Uint1* table = CIupacnaTo2na::GetTable();
     
     const char* src_i = src + pos;
+
+    // whole vector blocks first
+    TSeqPos done = CSeqUtil_Simd::IupacnaTo2na(src_i, length, dst);
+    src_i += done;
+    dst += done / 4;
+    length -= done;
+
     for ( size_t count = length / 4; count; --count ) {
         *dst = 
             table[*src_i * 4          ] | 
@@ -285,7 +293,7 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo2na
         }
     }
     
-    return length;
+    return done + length;
 }
 
 
@@ -324,6 +332,12 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo4na
     const Uint1* table = CIupacnaTo4na::GetTable();
     
     const char* src_i = src + pos;
+
+    // whole vector blocks first
+    TSeqPos done = CSeqUtil_Simd::IupacnaTo4na(src_i, length, dst);
+    src_i += done;
+    dst += done / 2;
+    length -= done;
     
     for ( size_t count = length / 2; count; --count ) {
         *dst = table[*src_i * 2] | table[*(src_i + 1) * 2 + 1];
@@ -336,7 +350,7 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo4na
         *dst = table[static_cast<Uint1>(*src_i) * 2];
     }
     
-    return length;
+    return done + length;
 }
 
 
@@ -370,7 +384,15 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naToIupacna
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_4(src, pos, length, dst, C2naToIupacna::GetTable());
+    TSeqPos done = 0;
+    if ( pos % 4 == 0 ) {
+        done = CSeqUtil_Simd::Ncbi2naToIupacna(src + pos / 4, length, dst);
+        if ( done == length ) {
+            return length;
+        }
+    }
+    return done + convert_1_to_4(src, pos + done, length - done, dst + done,
+                                 C2naToIupacna::GetTable());
 }
 
 
@@ -654,7 +676,15 @@ SIZE_TYPE CSeqConvert_imp::x_Convert4naToIupacna
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_2(src, pos, length, dst, C4naToIupacna::GetTable());
+    TSeqPos done = 0;
+    if ( pos % 2 == 0 ) {
+        done = CSeqUtil_Simd::Ncbi4naToIupacna(src + pos / 2, length, dst);
+        if ( done == length ) {
+            return length;
+        }
+    }
+    return done + convert_1_to_2(src, pos + done, length - done, dst + done,
+                                 C4naToIupacna::GetTable());
 }
 
 // NCBI4na -> NCBI2na
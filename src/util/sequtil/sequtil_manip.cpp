@@ -39,6 +39,7 @@
 #include <util/sequtil/sequtil_manip.hpp>
 #include <util/sequtil/sequtil_convert.hpp>
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 #include "sequtil_tables.hpp"
 
 
@@ -562,6 +563,29 @@ static SIZE_TYPE s_Ncbi4naRevCmp
 }
 
 
+// IUPACna and NCBI8na are reverse complemented with the vector kernels
+// where possible; whatever they leave is done by the conversion tables.
+
+typedef TSeqPos (*TSimdRevCmp)(const char* src, TSeqPos length, char* dst);
+typedef TSeqPos (*TSimdRevCmpInPlace)(char* buf, TSeqPos length);
+
+
+static SIZE_TYPE s_1to1RevCmp
+(const char* src,
+ TSeqPos pos,
+ TSeqPos length,
+ char* dst,
+ const Uint1* table,
+ TSimdRevCmp simd_revcmp)
+{
+    TSeqPos done = simd_revcmp(src + pos, length, dst);
+    if ( done < length ) {
+        copy_1_to_1_reverse(src, pos, length - done, dst + done, table);
+    }
+    return length;
+}
+
+
 SIZE_TYPE CSeqManip::ReverseComplement
 (const char* src,
  TCoding src_coding,
@@ -573,8 +597,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
-        return copy_1_to_1_reverse(src, pos, length, dst, 
-                                   CIupacnaCmp::GetTable());
+        return s_1to1RevCmp(src, pos, length, dst, CIupacnaCmp::GetTable(),
+                            CSeqUtil_Simd::IupacnaRevCmp);
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naRevCmp(src, pos, length, dst);
@@ -587,8 +611,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     case CSeqUtil::e_Ncbi8na:
     case CSeqUtil::e_Ncbi4na_expand:
-        return copy_1_to_1_reverse(src, pos, length, dst, 
-                                   C8naCmp::GetTable());
+        return s_1to1RevCmp(src, pos, length, dst, C8naCmp::GetTable(),
+                            CSeqUtil_Simd::Ncbi8naRevCmp);
     default:
         break;
     }
@@ -641,6 +665,28 @@ SIZE_TYPE CSeqManip::ReverseComplement
 }
 
 
+static SIZE_TYPE s_1to1RevCmp
+(char* src,
+ TSeqPos pos,
+ TSeqPos length,
+ const Uint1* table,
+ TSimdRevCmpInPlace simd_revcmp)
+{
+    TSeqPos done = simd_revcmp(src + pos, length);
+    if ( done == 0 ) {
+        return revcmp(src, pos, length, table);
+    }
+    // the kernel swapped 'done' residues at both ends, finish the middle
+    if ( length > 2 * done ) {
+        revcmp(src + pos + done, 0, length - 2 * done, table);
+    }
+    if ( pos != 0 ) {
+        copy(src + pos, src + pos + length, src);
+    }
+    return length;
+}
+
+
 static SIZE_TYPE s_Ncbi2naExpandRevCmp
 (char* src,
  TSeqPos pos,
@@ -708,7 +754,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
-        return revcmp(src, pos, length, CIupacnaCmp::GetTable());
+        return s_1to1RevCmp(src, pos, length, CIupacnaCmp::GetTable(),
+                            CSeqUtil_Simd::IupacnaRevCmpInPlace);
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naRevCmp(src, pos, length);
@@ -721,7 +768,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     case CSeqUtil::e_Ncbi8na:
     case CSeqUtil::e_Ncbi4na_expand:
-        return revcmp(src, pos, length, C8naCmp::GetTable());
+        return s_1to1RevCmp(src, pos, length, C8naCmp::GetTable(),
+                            CSeqUtil_Simd::Ncbi8naRevCmpInPlace);
 
     default:
         break;
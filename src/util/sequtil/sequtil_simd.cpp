@@ -0,0 +1,704 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Vectorized (SSSE3 / AVX2) kernels for nucleotide conversions.
+ *
+ *   The per-byte lookups are done with PSHUFB on 16-entry sub-tables built
+ *   from the regular conversion tables on first use.  Each sub-table entry
+ *   holds the converted value with the high bit set, so a single MOVMSK
+ *   tells whether every byte of a block was covered; blocks containing
+ *   anything else (bytes outside of the covered range) are converted with
+ *   the scalar tables, which keeps results identical in all cases.
+ */
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbi_system.hpp>
+
+#include <util/sequtil/sequtil.hpp>
+
+#include "sequtil_simd.hpp"
+#include "sequtil_tables.hpp"
+
+#include <atomic>
+
+#if defined(NCBI_SSE)  &&  NCBI_SSE >= 40
+#  define NCBI_SEQUTIL_SSSE3
+#  include <immintrin.h>
+#  if (defined(__GNUC__)  ||  defined(__clang__))  &&  \
+      (defined(__x86_64__)  ||  defined(__i386__))
+#    define NCBI_SEQUTIL_AVX2
+#    define SEQUTIL_AVX2_TARGET __attribute__((target("avx2")))
+#  endif
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Kernel level selection
+
+
+static std::atomic<int> s_SimdLevel(-1);
+
+
+static CSeqUtil::ESimdLevel s_GetBestSimdLevel(void)
+{
+#ifdef NCBI_SEQUTIL_AVX2
+    if ( CCpuFeatures::AVX2()  &&  CCpuFeatures::AVX()  &&
+         CCpuFeatures::OSXSAVE() ) {
+        return CSeqUtil::eSimd_AVX2;
+    }
+#endif
+#ifdef NCBI_SEQUTIL_SSSE3
+    if ( CCpuFeatures::SSSE3() ) {
+        return CSeqUtil::eSimd_SSSE3;
+    }
+#endif
+    return CSeqUtil::eSimd_None;
+}
+
+
+static inline int s_GetSimdLevel(void)
+{
+    int level = s_SimdLevel.load(std::memory_order_relaxed);
+    if ( level < 0 ) {
+        level = s_GetBestSimdLevel();
+        s_SimdLevel.store(level, std::memory_order_relaxed);
+    }
+    return level;
+}
+
+
+CSeqUtil::ESimdLevel CSeqUtil::GetSimdLevel(void)
+{
+    return ESimdLevel(s_GetSimdLevel());
+}
+
+
+CSeqUtil::ESimdLevel CSeqUtil::SetSimdLevel(ESimdLevel level)
+{
+    ESimdLevel best = s_GetBestSimdLevel();
+    if ( level > best ) {
+        level = best;
+    }
+    s_SimdLevel.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+
+#ifdef NCBI_SEQUTIL_SSSE3
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Lookup tables
+
+// Byte-to-byte lookup for the byte values [first, first + 16 * N).
+// Entries hold (value | 0x80), or 0 if the byte has to be converted
+// by the scalar code.
+struct SByteLut
+{
+    Uint1 first;
+    alignas(16) Uint1 tab[4][16];
+};
+
+
+struct SSeqUtilLuts
+{
+    SSeqUtilLuts(void);
+
+    SByteLut iupacna_to_2na;
+    SByteLut iupacna_to_4na;
+    SByteLut iupacna_cmp;
+    SByteLut ncbi8na_cmp;
+
+    // nibble (or 2-bit value) to IUPACna character
+    alignas(16) Uint1 ncbi2na_to_iupacna[16];
+    alignas(16) Uint1 ncbi4na_to_iupacna[16];
+    bool ncbi2na_unpack_ok;
+    bool ncbi4na_unpack_ok;
+};
+
+
+static void s_InitLut(SByteLut& lut, Uint1 first, size_t count,
+                      const Uint1* table, size_t stride, size_t column)
+{
+    memset(lut.tab, 0, sizeof(lut.tab));
+    lut.first = first;
+    for ( size_t i = 0;  i < count * 16;  ++i ) {
+        Uint1 value = table[(first + i) * stride + column];
+        if ( value < 0x80 ) {
+            lut.tab[i / 16][i % 16] = Uint1(value | 0x80);
+        }
+    }
+}
+
+
+// Drop packed-table entries whose columns are not all shifts of
+// the last one, so that the vector code never disagrees with the table.
+static void s_VerifyPackLut(SByteLut& lut, size_t count, const Uint1* table,
+                            size_t per_byte, unsigned bits)
+{
+    for ( size_t i = 0;  i < count * 16;  ++i ) {
+        Uint1& entry = lut.tab[i / 16][i % 16];
+        const Uint1* row = table + (lut.first + i) * per_byte;
+        unsigned value = row[per_byte - 1];
+        for ( size_t k = 0;  k < per_byte;  ++k ) {
+            if ( row[k] != Uint1(value << (bits * (per_byte - 1 - k))) ) {
+                entry = 0;
+            }
+        }
+    }
+}
+
+
+SSeqUtilLuts::SSeqUtilLuts(void)
+{
+    s_InitLut(iupacna_to_2na, 0x40, 4, CIupacnaTo2na::GetTable(), 4, 3);
+    s_VerifyPackLut(iupacna_to_2na, 4, CIupacnaTo2na::GetTable(), 4, 2);
+    s_InitLut(iupacna_to_4na, 0x40, 4, CIupacnaTo4na::GetTable(), 2, 1);
+    s_VerifyPackLut(iupacna_to_4na, 4, CIupacnaTo4na::GetTable(), 2, 4);
+    s_InitLut(iupacna_cmp, 0x40, 4, CIupacnaCmp::GetTable(), 1, 0);
+    s_InitLut(ncbi8na_cmp, 0x00, 1, C8naCmp::GetTable(), 1, 0);
+
+    memset(ncbi2na_to_iupacna, 0, sizeof(ncbi2na_to_iupacna));
+    memset(ncbi4na_to_iupacna, 0, sizeof(ncbi4na_to_iupacna));
+    const Uint1* t2 = C2naToIupacna::GetTable();
+    const Uint1* t4 = C4naToIupacna::GetTable();
+    for ( unsigned v = 0;  v < 4;  ++v ) {
+        ncbi2na_to_iupacna[v] = t2[(v << 6) * 4];
+    }
+    for ( unsigned v = 0;  v < 16;  ++v ) {
+        ncbi4na_to_iupacna[v] = t4[(v << 4) * 2];
+    }
+    ncbi2na_unpack_ok = ncbi4na_unpack_ok = true;
+    for ( unsigned b = 0;  b < 256;  ++b ) {
+        for ( unsigned k = 0;  k < 4;  ++k ) {
+            if ( t2[b * 4 + k] != ncbi2na_to_iupacna[(b >> (6 - 2*k)) & 3] ) {
+                ncbi2na_unpack_ok = false;
+            }
+        }
+        if ( t4[b * 2]     != ncbi4na_to_iupacna[b >> 4]  ||
+             t4[b * 2 + 1] != ncbi4na_to_iupacna[b & 15] ) {
+            ncbi4na_unpack_ok = false;
+        }
+    }
+}
+
+
+static const SSeqUtilLuts& s_GetLuts(void)
+{
+    static const SSeqUtilLuts* luts = new SSeqUtilLuts();
+    return *luts;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Scalar block fallbacks (bytes outside of the vector tables)
+
+static inline void s_Pack2naBlock(const char* src, size_t length, char* dst)
+{
+    const Uint1* table = CIupacnaTo2na::GetTable();
+    for ( size_t i = 0;  i < length;  i += 4, ++dst ) {
+        *dst = char(table[Uint1(src[i    ]) * 4    ] |
+                    table[Uint1(src[i + 1]) * 4 + 1] |
+                    table[Uint1(src[i + 2]) * 4 + 2] |
+                    table[Uint1(src[i + 3]) * 4 + 3]);
+    }
+}
+
+
+static inline void s_Pack4naBlock(const char* src, size_t length, char* dst)
+{
+    const Uint1* table = CIupacnaTo4na::GetTable();
+    for ( size_t i = 0;  i < length;  i += 2, ++dst ) {
+        *dst = char(table[Uint1(src[i]) * 2] | table[Uint1(src[i + 1]) * 2 + 1]);
+    }
+}
+
+
+// dst[i] = table[src_end[-1 - i]]
+static inline void s_RevCmpBlock(const char* src_end, size_t length,
+                                 char* dst, const Uint1* table)
+{
+    for ( size_t i = 0;  i < length;  ++i ) {
+        dst[i] = char(table[Uint1(src_end[-1 - ptrdiff_t(i)])]);
+    }
+}
+
+
+// swap-and-complement 'length' residues at the front and back ends
+static inline void s_RevCmpSwapBlock(char* front, char* back_end,
+                                     size_t length, const Uint1* table)
+{
+    for ( size_t i = 0;  i < length;  ++i ) {
+        char tmp = char(table[Uint1(front[i])]);
+        front[i] = char(table[Uint1(back_end[-1 - ptrdiff_t(i)])]);
+        back_end[-1 - ptrdiff_t(i)] = tmp;
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SSSE3 kernels
+
+template<size_t N>
+static inline __m128i s_Lookup_SSE(const SByteLut& lut, __m128i v)
+{
+    const __m128i kSat  = _mm_set1_epi8(0x70);
+    const __m128i kStep = _mm_set1_epi8(16);
+    __m128i t = _mm_sub_epi8(v, _mm_set1_epi8(char(lut.first)));
+    __m128i r = _mm_setzero_si128();
+    for ( size_t k = 0;  k < N;  ++k ) {
+        __m128i tab = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.tab[k]));
+        r = _mm_or_si128(r, _mm_shuffle_epi8(tab, _mm_adds_epu8(t, kSat)));
+        t = _mm_sub_epi8(t, kStep);
+    }
+    return r;
+}
+
+
+static inline __m128i s_Reverse_SSE(__m128i v)
+{
+    return _mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+
+static TSeqPos s_IupacnaTo2na_SSE(const char* src, TSeqPos length, char* dst)
+{
+    const SByteLut& lut = s_GetLuts().iupacna_to_2na;
+    const __m128i kMask = _mm_set1_epi8(0x7f);
+    const __m128i kMul1 = _mm_set1_epi16(0x0104);
+    const __m128i kMul2 = _mm_set1_epi32(0x00010010);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 64, dst += 16 ) {
+        __m128i p[4];
+        int valid = 0xffff;
+        for ( int k = 0;  k < 4;  ++k ) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16*k));
+            __m128i r = s_Lookup_SSE<4>(lut, v);
+            valid &= _mm_movemask_epi8(r);
+            r = _mm_and_si128(r, kMask);
+            p[k] = _mm_madd_epi16(_mm_maddubs_epi16(r, kMul1), kMul2);
+        }
+        if ( valid != 0xffff ) {
+            s_Pack2naBlock(src, 64, dst);
+            continue;
+        }
+        __m128i lo = _mm_packs_epi32(p[0], p[1]);
+        __m128i hi = _mm_packs_epi32(p[2], p[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(lo, hi));
+    }
+    return done;
+}
+
+
+static TSeqPos s_IupacnaTo4na_SSE(const char* src, TSeqPos length, char* dst)
+{
+    const SByteLut& lut = s_GetLuts().iupacna_to_4na;
+    const __m128i kMask = _mm_set1_epi8(0x7f);
+    const __m128i kMul  = _mm_set1_epi16(0x0110);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 32;  done += 32, src += 32, dst += 16 ) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        __m128i r0 = s_Lookup_SSE<4>(lut, v0);
+        __m128i r1 = s_Lookup_SSE<4>(lut, v1);
+        if ( (_mm_movemask_epi8(r0) & _mm_movemask_epi8(r1)) != 0xffff ) {
+            s_Pack4naBlock(src, 32, dst);
+            continue;
+        }
+        r0 = _mm_maddubs_epi16(_mm_and_si128(r0, kMask), kMul);
+        r1 = _mm_maddubs_epi16(_mm_and_si128(r1, kMask), kMul);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(r0, r1));
+    }
+    return done;
+}
+
+
+static TSeqPos s_Ncbi2naToIupacna_SSE(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilLuts& luts = s_GetLuts();
+    if ( !luts.ncbi2na_unpack_ok ) {
+        return 0;
+    }
+    const __m128i lut  = _mm_load_si128(reinterpret_cast<const __m128i*>(luts.ncbi2na_to_iupacna));
+    const __m128i kTwo = _mm_set1_epi8(0x03);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 16, dst += 64 ) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i c0 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 6), kTwo));
+        __m128i c1 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), kTwo));
+        __m128i c2 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 2), kTwo));
+        __m128i c3 = _mm_shuffle_epi8(lut, _mm_and_si128(x, kTwo));
+        __m128i lo01 = _mm_unpacklo_epi8(c0, c1);
+        __m128i hi01 = _mm_unpackhi_epi8(c0, c1);
+        __m128i lo23 = _mm_unpacklo_epi8(c2, c3);
+        __m128i hi23 = _mm_unpackhi_epi8(c2, c3);
+        __m128i* out = reinterpret_cast<__m128i*>(dst);
+        _mm_storeu_si128(out,     _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+    }
+    return done;
+}
+
+
+static TSeqPos s_Ncbi4naToIupacna_SSE(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilLuts& luts = s_GetLuts();
+    if ( !luts.ncbi4na_unpack_ok ) {
+        return 0;
+    }
+    const __m128i lut   = _mm_load_si128(reinterpret_cast<const __m128i*>(luts.ncbi4na_to_iupacna));
+    const __m128i kFour = _mm_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 32;  done += 32, src += 16, dst += 32 ) {
+        __m128i x  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), kFour));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(x, kFour));
+        __m128i* out = reinterpret_cast<__m128i*>(dst);
+        _mm_storeu_si128(out,     _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(hi, lo));
+    }
+    return done;
+}
+
+
+template<size_t N>
+static TSeqPos s_RevCmp_SSE(const SByteLut& lut, const Uint1* table,
+                            const char* src, TSeqPos length, char* dst)
+{
+    const __m128i kMask = _mm_set1_epi8(0x7f);
+    const char* src_end = src + length;
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 16;  done += 16, src_end -= 16, dst += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_end - 16));
+        __m128i r = s_Lookup_SSE<N>(lut, v);
+        if ( _mm_movemask_epi8(r) != 0xffff ) {
+            s_RevCmpBlock(src_end, 16, dst, table);
+            continue;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         s_Reverse_SSE(_mm_and_si128(r, kMask)));
+    }
+    return done;
+}
+
+
+template<size_t N>
+static TSeqPos s_RevCmpInPlace_SSE(const SByteLut& lut, const Uint1* table,
+                                   char* buf, TSeqPos length)
+{
+    const __m128i kMask = _mm_set1_epi8(0x7f);
+    char* front = buf;
+    char* back_end = buf + length;
+
+    TSeqPos done = 0;
+    for ( ;  length - 2*done >= 32;  done += 16, front += 16, back_end -= 16 ) {
+        __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(front));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(back_end - 16));
+        __m128i rf = s_Lookup_SSE<N>(lut, f);
+        __m128i rb = s_Lookup_SSE<N>(lut, b);
+        if ( (_mm_movemask_epi8(rf) & _mm_movemask_epi8(rb)) != 0xffff ) {
+            s_RevCmpSwapBlock(front, back_end, 16, table);
+            continue;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(front),
+                         s_Reverse_SSE(_mm_and_si128(rb, kMask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(back_end - 16),
+                         s_Reverse_SSE(_mm_and_si128(rf, kMask)));
+    }
+    return done;
+}
+
+
+#ifdef NCBI_SEQUTIL_AVX2
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// AVX2 kernels
+//
+// VPSHUFB and the pack instructions work within 128-bit lanes, so the
+// sub-tables are broadcast to both lanes and packed results are permuted
+// back into sequence order.  Unpacking is store-bound and uses the SSSE3
+// kernels.
+
+template<size_t N>
+SEQUTIL_AVX2_TARGET
+static inline __m256i s_Lookup_AVX2(const SByteLut& lut, __m256i v)
+{
+    const __m256i kSat  = _mm256_set1_epi8(0x70);
+    const __m256i kStep = _mm256_set1_epi8(16);
+    __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8(char(lut.first)));
+    __m256i r = _mm256_setzero_si256();
+    for ( size_t k = 0;  k < N;  ++k ) {
+        __m256i tab = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(lut.tab[k])));
+        r = _mm256_or_si256(r, _mm256_shuffle_epi8(tab, _mm256_adds_epu8(t, kSat)));
+        t = _mm256_sub_epi8(t, kStep);
+    }
+    return r;
+}
+
+
+SEQUTIL_AVX2_TARGET
+static inline __m256i s_Reverse_AVX2(__m256i v)
+{
+    const __m256i kRev = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0,
+                                          15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0);
+    v = _mm256_shuffle_epi8(v, kRev);
+    return _mm256_permute2x128_si256(v, v, 0x01);
+}
+
+
+SEQUTIL_AVX2_TARGET
+static TSeqPos s_IupacnaTo2na_AVX2(const char* src, TSeqPos length, char* dst)
+{
+    const SByteLut& lut = s_GetLuts().iupacna_to_2na;
+    const __m256i kMask = _mm256_set1_epi8(0x7f);
+    const __m256i kMul1 = _mm256_set1_epi16(0x0104);
+    const __m256i kMul2 = _mm256_set1_epi32(0x00010010);
+    const __m256i kOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 128;  done += 128, src += 128, dst += 32 ) {
+        __m256i p[4];
+        unsigned valid = ~0u;
+        for ( int k = 0;  k < 4;  ++k ) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32*k));
+            __m256i r = s_Lookup_AVX2<4>(lut, v);
+            valid &= unsigned(_mm256_movemask_epi8(r));
+            r = _mm256_and_si256(r, kMask);
+            p[k] = _mm256_madd_epi16(_mm256_maddubs_epi16(r, kMul1), kMul2);
+        }
+        if ( valid != ~0u ) {
+            s_Pack2naBlock(src, 128, dst);
+            continue;
+        }
+        __m256i lo = _mm256_packs_epi32(p[0], p[1]);
+        __m256i hi = _mm256_packs_epi32(p[2], p[3]);
+        __m256i r  = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), kOrder);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), r);
+    }
+    return done + s_IupacnaTo2na_SSE(src, length - done, dst);
+}
+
+
+SEQUTIL_AVX2_TARGET
+static TSeqPos s_IupacnaTo4na_AVX2(const char* src, TSeqPos length, char* dst)
+{
+    const SByteLut& lut = s_GetLuts().iupacna_to_4na;
+    const __m256i kMask = _mm256_set1_epi8(0x7f);
+    const __m256i kMul  = _mm256_set1_epi16(0x0110);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 64, dst += 32 ) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        __m256i r0 = s_Lookup_AVX2<4>(lut, v0);
+        __m256i r1 = s_Lookup_AVX2<4>(lut, v1);
+        if ( (unsigned(_mm256_movemask_epi8(r0)) &
+              unsigned(_mm256_movemask_epi8(r1))) != ~0u ) {
+            s_Pack4naBlock(src, 64, dst);
+            continue;
+        }
+        r0 = _mm256_maddubs_epi16(_mm256_and_si256(r0, kMask), kMul);
+        r1 = _mm256_maddubs_epi16(_mm256_and_si256(r1, kMask), kMul);
+        __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi16(r0, r1), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), r);
+    }
+    return done + s_IupacnaTo4na_SSE(src, length - done, dst);
+}
+
+
+template<size_t N>
+SEQUTIL_AVX2_TARGET
+static TSeqPos s_RevCmp_AVX2(const SByteLut& lut, const Uint1* table,
+                             const char* src, TSeqPos length, char* dst)
+{
+    const __m256i kMask = _mm256_set1_epi8(0x7f);
+    const char* src_end = src + length;
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 32;  done += 32, src_end -= 32, dst += 32 ) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_end - 32));
+        __m256i r = s_Lookup_AVX2<N>(lut, v);
+        if ( unsigned(_mm256_movemask_epi8(r)) != ~0u ) {
+            s_RevCmpBlock(src_end, 32, dst, table);
+            continue;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                            s_Reverse_AVX2(_mm256_and_si256(r, kMask)));
+    }
+    return done;
+}
+
+
+template<size_t N>
+SEQUTIL_AVX2_TARGET
+static TSeqPos s_RevCmpInPlace_AVX2(const SByteLut& lut, const Uint1* table,
+                                    char* buf, TSeqPos length)
+{
+    const __m256i kMask = _mm256_set1_epi8(0x7f);
+    char* front = buf;
+    char* back_end = buf + length;
+
+    TSeqPos done = 0;
+    for ( ;  length - 2*done >= 64;  done += 32, front += 32, back_end -= 32 ) {
+        __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(front));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(back_end - 32));
+        __m256i rf = s_Lookup_AVX2<N>(lut, f);
+        __m256i rb = s_Lookup_AVX2<N>(lut, b);
+        if ( (unsigned(_mm256_movemask_epi8(rf)) &
+              unsigned(_mm256_movemask_epi8(rb))) != ~0u ) {
+            s_RevCmpSwapBlock(front, back_end, 32, table);
+            continue;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(front),
+                            s_Reverse_AVX2(_mm256_and_si256(rb, kMask)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(back_end - 32),
+                            s_Reverse_AVX2(_mm256_and_si256(rf, kMask)));
+    }
+    return done;
+}
+
+#endif  /* NCBI_SEQUTIL_AVX2 */
+
+#endif  /* NCBI_SEQUTIL_SSSE3 */
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Dispatch
+
+#if defined(NCBI_SEQUTIL_AVX2)
+#  define SEQUTIL_DISPATCH(avx2_call, sse_call)                           \
+    switch ( s_GetSimdLevel() ) {                                         \
+    case CSeqUtil::eSimd_AVX2:   return avx2_call;                        \
+    case CSeqUtil::eSimd_SSSE3:  return sse_call;                         \
+    default:                     break;                                   \
+    }                                                                     \
+    return 0
+#elif defined(NCBI_SEQUTIL_SSSE3)
+#  define SEQUTIL_DISPATCH(avx2_call, sse_call)                           \
+    if ( s_GetSimdLevel() >= CSeqUtil::eSimd_SSSE3 ) {                    \
+        return sse_call;                                                  \
+    }                                                                     \
+    return 0
+#else
+#  define SEQUTIL_DISPATCH(avx2_call, sse_call)                           \
+    return 0
+#endif
+
+
+TSeqPos CSeqUtil_Simd::IupacnaTo2na(const char* src, TSeqPos length, char* dst)
+{
+    SEQUTIL_DISPATCH(s_IupacnaTo2na_AVX2(src, length, dst),
+                     s_IupacnaTo2na_SSE(src, length, dst));
+}
+
+
+TSeqPos CSeqUtil_Simd::IupacnaTo4na(const char* src, TSeqPos length, char* dst)
+{
+    SEQUTIL_DISPATCH(s_IupacnaTo4na_AVX2(src, length, dst),
+                     s_IupacnaTo4na_SSE(src, length, dst));
+}
+
+
+TSeqPos CSeqUtil_Simd::Ncbi2naToIupacna(const char* src, TSeqPos length,
+                                        char* dst)
+{
+    SEQUTIL_DISPATCH(s_Ncbi2naToIupacna_SSE(src, length, dst),
+                     s_Ncbi2naToIupacna_SSE(src, length, dst));
+}
+
+
+TSeqPos CSeqUtil_Simd::Ncbi4naToIupacna(const char* src, TSeqPos length,
+                                        char* dst)
+{
+    SEQUTIL_DISPATCH(s_Ncbi4naToIupacna_SSE(src, length, dst),
+                     s_Ncbi4naToIupacna_SSE(src, length, dst));
+}
+
+
+TSeqPos CSeqUtil_Simd::IupacnaRevCmp(const char* src, TSeqPos length, char* dst)
+{
+    SEQUTIL_DISPATCH(s_RevCmp_AVX2<4>(s_GetLuts().iupacna_cmp,
+                                      CIupacnaCmp::GetTable(),
+                                      src, length, dst),
+                     s_RevCmp_SSE<4>(s_GetLuts().iupacna_cmp,
+                                     CIupacnaCmp::GetTable(),
+                                     src, length, dst));
+}
+
+
+TSeqPos CSeqUtil_Simd::Ncbi8naRevCmp(const char* src, TSeqPos length, char* dst)
+{
+    SEQUTIL_DISPATCH(s_RevCmp_AVX2<1>(s_GetLuts().ncbi8na_cmp,
+                                      C8naCmp::GetTable(),
+                                      src, length, dst),
+                     s_RevCmp_SSE<1>(s_GetLuts().ncbi8na_cmp,
+                                     C8naCmp::GetTable(),
+                                     src, length, dst));
+}
+
+
+TSeqPos CSeqUtil_Simd::IupacnaRevCmpInPlace(char* buf, TSeqPos length)
+{
+    SEQUTIL_DISPATCH(s_RevCmpInPlace_AVX2<4>(s_GetLuts().iupacna_cmp,
+                                             CIupacnaCmp::GetTable(),
+                                             buf, length),
+                     s_RevCmpInPlace_SSE<4>(s_GetLuts().iupacna_cmp,
+                                            CIupacnaCmp::GetTable(),
+                                            buf, length));
+}
+
+
+TSeqPos CSeqUtil_Simd::Ncbi8naRevCmpInPlace(char* buf, TSeqPos length)
+{
+    SEQUTIL_DISPATCH(s_RevCmpInPlace_AVX2<1>(s_GetLuts().ncbi8na_cmp,
+                                             C8naCmp::GetTable(),
+                                             buf, length),
+                     s_RevCmpInPlace_SSE<1>(s_GetLuts().ncbi8na_cmp,
+                                            C8naCmp::GetTable(),
+                                            buf, length));
+}
+
+
+END_NCBI_SCOPE
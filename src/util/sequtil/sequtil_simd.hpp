@@ -0,0 +1,83 @@
+#ifndef UTIL_SEQUTIL___SEQUTIL_SIMD__HPP
+#define UTIL_SEQUTIL___SEQUTIL_SIMD__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Vectorized kernels for the most common nucleotide conversions.
+ *
+ *   Every kernel processes the longest prefix of the input it can handle
+ *   in whole vector blocks and returns its length in residues; the caller
+ *   finishes the rest with the regular conversion tables.  The kernels are
+ *   derived from those same tables, so results are always identical to the
+ *   scalar code.  A return value of 0 means no vector code is available.
+ */
+
+#include <corelib/ncbistd.hpp>
+
+#include <util/sequtil/sequtil.hpp>
+
+
+BEGIN_NCBI_SCOPE
+
+
+class CSeqUtil_Simd
+{
+public:
+    // IUPACna -> NCBI2na; the result is a multiple of 4 residues
+    static TSeqPos IupacnaTo2na(const char* src, TSeqPos length, char* dst);
+
+    // IUPACna -> NCBI4na; the result is a multiple of 2 residues
+    static TSeqPos IupacnaTo4na(const char* src, TSeqPos length, char* dst);
+
+    // NCBI2na -> IUPACna; 'src' must point to the byte with the first
+    // residue in its highest bits
+    static TSeqPos Ncbi2naToIupacna(const char* src, TSeqPos length,
+                                    char* dst);
+
+    // NCBI4na -> IUPACna; 'src' must point to the byte with the first
+    // residue in its highest bits
+    static TSeqPos Ncbi4naToIupacna(const char* src, TSeqPos length,
+                                    char* dst);
+
+    // Reverse complement of IUPACna / NCBI8na residues into 'dst'.
+    // 'src' points to the first residue of the interval; the kernel fills
+    // dst[0 .. result) from the END of the interval backwards.
+    static TSeqPos IupacnaRevCmp(const char* src, TSeqPos length, char* dst);
+    static TSeqPos Ncbi8naRevCmp(const char* src, TSeqPos length, char* dst);
+
+    // In-place reverse complement of IUPACna / NCBI8na residues.
+    // The kernel swaps the returned number of residues at each end of
+    // 'buf'; the middle [result, length - result) is left to the caller.
+    static TSeqPos IupacnaRevCmpInPlace(char* buf, TSeqPos length);
+    static TSeqPos Ncbi8naRevCmpInPlace(char* buf, TSeqPos length);
+};
+
+
+END_NCBI_SCOPE
+
+
+#endif  /* UTIL_SEQUTIL___SEQUTIL_SIMD__HPP */
@@ -523,6 +523,28 @@ void CIStreamBuffer::GetChars(string& str, size_t count)
 }
 
 
+size_t CIStreamBuffer::GetCharsInPlace(const char*& data, size_t count)
+    THROWS1((CIOException))
+{
+    const char* pos = m_CurrentPos;
+    if ( count == 0 ) {
+        data = pos;
+        return 0;
+    }
+    if ( pos >= m_DataEndPos ) {
+        // nothing left in the buffer, fetch the next part
+        pos = FillBuffer(pos);
+    }
+    size_t in_buffer = m_DataEndPos - pos;
+    if ( count > in_buffer ) {
+        count = in_buffer;
+    }
+    data = pos;
+    m_CurrentPos = pos + count;
+    return count;
+}
+
+
 void CIStreamBuffer::SkipEndOfLine(char lastChar)
     THROWS1((CIOException))
 {
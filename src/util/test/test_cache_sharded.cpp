@@ -0,0 +1,342 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Check CShardedCache and compare its multi-threaded throughput
+ *   with CCache.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/ncbi_cache.hpp>
+#include <util/ncbi_cache_sharded.hpp>
+#include <util/random_gen.hpp>
+
+#include <thread>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+/// Handler creating value from the key, so any value can be verified
+class CTestHandler : public CCacheElement_Handler<Uint8, Uint8>
+{
+public:
+    Uint8 CreateValue(const Uint8& key) { return key * 3 + 1; }
+};
+
+typedef CCache<Uint8, Uint8, CTestHandler, CMutex, Uint8> TCache;
+typedef CShardedCache<Uint8, Uint8, CTestHandler>          TShardedCache;
+
+
+/// Handler counting the cached values and refusing to cache odd keys
+class CCountingHandler : public CTestHandler
+{
+public:
+    void InsertElement(const Uint8& /*key*/, const Uint8& /*value*/)
+    {
+        ++m_Inserted;
+    }
+    void RemoveElement(const Uint8& /*key*/, Uint8& /*value*/)
+    {
+        ++m_Removed;
+    }
+    ECache_InsertFlag CanInsertElement(const Uint8& key, const Uint8& /*value*/)
+    {
+        return (key & 1) ? eCache_DoNotCache : eCache_CheckSize;
+    }
+
+    atomic<size_t> m_Inserted{0};
+    atomic<size_t> m_Removed{0};
+};
+
+typedef CShardedCache<Uint8, Uint8, CCountingHandler> TCountingCache;
+
+
+class CCacheShardedTest : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    bool x_TestBasic(void);
+    bool x_TestLimits(void);
+    bool x_TestClock(void);
+    bool x_TestHandler(void);
+
+    // Run 'threads' threads doing Get() with random keys; returns false
+    // if a wrong value was returned
+    template<class TTestCache>
+    bool x_Benchmark(const string& title, TTestCache& cache,
+                     unsigned int threads);
+
+    size_t       m_Capacity;
+    size_t       m_Keys;
+    size_t       m_Ops;
+};
+
+
+#define CHECK(expr)                                                 \
+    if ( !(expr) ) {                                                \
+        NcbiCout << "Check failed: " #expr " at line " << __LINE__  \
+                 << NcbiEndl;                                       \
+        return false;                                               \
+    }
+
+
+void CCacheShardedTest::Init(void)
+{
+    SetDiagPostLevel(eDiag_Error);
+
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+    d->SetUsageContext(GetArguments().GetProgramBasename(),
+                       "CShardedCache checks and CCache comparison");
+    d->AddDefaultKey("threads", "list",
+                     "comma separated numbers of threads",
+                     CArgDescriptions::eString, "1,2,4,8,16,32");
+    d->AddDefaultKey("capacity", "count",
+                     "cache capacity",
+                     CArgDescriptions::eInteger, "100000");
+    d->AddDefaultKey("keys", "count",
+                     "number of distinct keys",
+                     CArgDescriptions::eInteger, "150000");
+    d->AddDefaultKey("ops", "count",
+                     "number of Get() calls per thread",
+                     CArgDescriptions::eInteger, "1000000");
+    SetupArgDescriptions(d.release());
+}
+
+
+bool CCacheShardedTest::x_TestBasic(void)
+{
+    TShardedCache cache(100, 4);
+    CHECK(cache.GetShardCount() == 4);
+    CHECK(cache.Add(1, 10) == TShardedCache::eAdd_Inserted);
+    CHECK(cache.Add(1, 11) == TShardedCache::eAdd_Replaced);
+    CHECK(cache.Add(1, 12, 0, TShardedCache::fAdd_NoReplace)
+          == TShardedCache::eAdd_NotInserted);
+
+    TShardedCache::EGetResult result;
+    CHECK(cache.Get(1, 0, &result) == 11);
+    CHECK(result == TShardedCache::eGet_Found);
+    CHECK(cache.Get(2, 0, &result) == 7);
+    CHECK(result == TShardedCache::eGet_CreatedAndAdded);
+    CHECK(cache.Get(3, TShardedCache::fGet_NoInsert, &result) == 10);
+    CHECK(result == TShardedCache::eGet_CreatedNotAdded);
+    CHECK(cache.GetSize() == 2);
+
+    bool thrown = false;
+    try {
+        cache.Get(3, TShardedCache::fGet_NoCreate);
+    }
+    catch (CCacheException&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    Uint8 value = 0;
+    CHECK(cache.Find(2, value)  &&  value == 7);
+    CHECK(cache.Remove(2));
+    CHECK( !cache.Remove(2) );
+    CHECK( !cache.Find(2, value) );
+
+    TShardedCache::SStatistics stat = cache.GetStatistics();
+    CHECK(stat.m_Hits == 2);
+    CHECK(stat.m_Misses == 4);
+    CHECK(stat.m_Size == 1);
+
+    cache.Clear();
+    CHECK(cache.GetSize() == 0);
+    return true;
+}
+
+
+bool CCacheShardedTest::x_TestLimits(void)
+{
+    {{
+        TShardedCache cache(64, 8);
+        for (Uint8 key = 0;  key < 1000;  ++key) {
+            cache.Get(key);
+            CHECK(cache.GetSize() <= 64);
+        }
+        TShardedCache::SStatistics stat = cache.GetStatistics();
+        CHECK(stat.m_Evictions == 1000 - stat.m_Size);
+    }}
+    {{
+        // byte budget of 8 shards * 100 bytes
+        TShardedCache cache(1000, 8, 800);
+        for (Uint8 key = 0;  key < 1000;  ++key) {
+            cache.Add(key, key, 30);
+            CHECK(cache.GetStatistics().m_Bytes <= 800);
+        }
+        CHECK(cache.Add(1000, 1000, 101) == TShardedCache::eAdd_NotInserted);
+        // no more than 3 elements of 30 bytes fit into every shard
+        CHECK(cache.GetSize() <= 3 * 8);
+    }}
+    return true;
+}
+
+
+bool CCacheShardedTest::x_TestClock(void)
+{
+    // single shard: referenced elements survive one pass of the hand
+    TShardedCache cache(4, 1);
+    for (Uint8 key = 0;  key < 4;  ++key) {
+        cache.Add(key, key);
+    }
+    Uint8 value;
+    cache.Find(0, value);
+    cache.Find(2, value);
+    cache.Add(4, 4);
+    cache.Add(5, 5);
+    CHECK(cache.Find(0, value, TShardedCache::fGet_NoTouch));
+    CHECK(cache.Find(2, value, TShardedCache::fGet_NoTouch));
+    CHECK( !cache.Find(1, value, TShardedCache::fGet_NoTouch) );
+    CHECK( !cache.Find(3, value, TShardedCache::fGet_NoTouch) );
+    return true;
+}
+
+
+bool CCacheShardedTest::x_TestHandler(void)
+{
+    CCountingHandler* handler = new CCountingHandler;
+    TCountingCache cache(100, 4, 0, handler);
+
+    // a value the handler does not let in is not reported as cached
+    TCountingCache::EGetResult result;
+    CHECK(cache.Get(1, 0, &result) == 4);
+    CHECK(result == TCountingCache::eGet_CreatedNotAdded);
+    CHECK(cache.GetSize() == 0);
+    CHECK(cache.Get(2, 0, &result) == 7);
+    CHECK(result == TCountingCache::eGet_CreatedAndAdded);
+    CHECK(cache.Get(2, 0, &result) == 7);
+    CHECK(result == TCountingCache::eGet_Found);
+
+    // threads racing to create the same keys: the values which lost the
+    // race were never inserted, so they are not removed either
+    atomic<bool> ok{true};
+    for (Uint8 key = 10;  key < 1010;  key += 2) {
+        vector<thread> workers;
+        for (int t = 0;  t < 8;  ++t) {
+            workers.emplace_back([&cache, &ok, key]() {
+                if (cache.Get(key) != key * 3 + 1) {
+                    ok = false;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    CHECK(ok);
+    CHECK(handler->m_Removed + cache.GetSize() == handler->m_Inserted);
+    cache.Clear();
+    CHECK(handler->m_Removed == handler->m_Inserted);
+    return true;
+}
+
+
+template<class TTestCache>
+bool CCacheShardedTest::x_Benchmark(const string& title, TTestCache& cache,
+                                    unsigned int threads)
+{
+    atomic<bool> ok{true};
+    vector<thread> workers;
+    CStopWatch sw(CStopWatch::eStart);
+    for (unsigned int t = 0;  t < threads;  ++t) {
+        workers.emplace_back([this, &cache, &ok, t]() {
+            CRandom rnd(t + 1);
+            for (size_t i = 0;  i < m_Ops;  ++i) {
+                // square of uniform gives some skew towards small keys
+                Uint8 r = rnd.GetRand();
+                Uint8 key = r * r / CRandom::GetMax() * m_Keys
+                            / CRandom::GetMax();
+                if (cache.Get(key) != key * 3 + 1) {
+                    ok = false;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double elapsed = sw.Elapsed();
+
+    NcbiCout << setw(8) << left << title
+             << setw(3) << right << threads << " threads  "
+             << fixed << setprecision(0)
+             << (elapsed > 0 ? double(m_Ops) * threads / elapsed : 0)
+             << " ops/s" << NcbiEndl;
+    return ok;
+}
+
+
+int CCacheShardedTest::Run(void)
+{
+    const CArgs& args = GetArgs();
+    m_Capacity = size_t(args["capacity"].AsInteger());
+    m_Keys     = size_t(args["keys"].AsInteger());
+    m_Ops      = size_t(args["ops"].AsInteger());
+
+    bool ok = x_TestBasic()  &&  x_TestLimits()  &&  x_TestClock()  &&
+              x_TestHandler();
+
+    list<string> threads_list;
+    NStr::Split(args["threads"].AsString(), ",", threads_list,
+                NStr::fSplit_Tokenize);
+    for (const string& str : threads_list) {
+        unsigned int threads = NStr::StringToUInt(str);
+        {{
+            TCache cache(m_Capacity);
+            ok &= x_Benchmark("CCache", cache, threads);
+        }}
+        {{
+            TShardedCache cache(m_Capacity);
+            ok &= x_Benchmark("sharded", cache, threads);
+            TShardedCache::SStatistics stat = cache.GetStatistics();
+            NcbiCout << "    hits: " << stat.m_Hits
+                     << ", misses: " << stat.m_Misses
+                     << ", evictions: " << stat.m_Evictions << NcbiEndl;
+            ok &= stat.m_Hits + stat.m_Misses == m_Ops * threads;
+        }}
+    }
+
+    if ( !ok ) {
+        NcbiCout << "FAILED" << NcbiEndl;
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CCacheShardedTest().AppMain(argc, argv);
+}
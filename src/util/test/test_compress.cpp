@@ -92,6 +92,7 @@ public:
     // Additional tests
     void TestEmptyInputData(CCompressStream::EMethod);
     void TestTransparentCopy(const char* src_buf, size_t src_len, size_t buf_len);
+    void TestParallelCompression(CCompressStream::EMethod, const char* src_buf, size_t src_len);
 
 private:
     // Auxiliary methods
@@ -327,6 +328,18 @@ int CTest::Run(void)
         }
 #endif
 
+        // Test for multi-threaded compression
+#if defined(HAVE_LIBZ)
+        if ( z ) {
+            TestParallelCompression(M::eZip, src_buf, len);
+        }
+#endif
+#if defined(HAVE_LIBZSTD)
+        if ( zstd ) {
+            TestParallelCompression(M::eZstd, src_buf, len);
+        }
+#endif
+
         // Test for (de)compressor's transparent copy (don't use any algorithm)
         TestTransparentCopy(src_buf, len, kBufLen);
 
@@ -734,6 +747,94 @@ void CTest::TestTransparentCopy(const char* src_buf, size_t src_len, size_t buf_
 
 
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// Tests for multi-threaded compression streams
+//
+
+void CTest::TestParallelCompression(M::EMethod method, const char* src_buf, size_t src_len)
+{
+    // Small blocks to get several blocks for each data size
+    const size_t kBlockSize = 16 KB;
+    const string src(src_buf, src_len);
+    string dst, cmp;
+
+#if defined(HAVE_LIBZ)
+    if (method == M::eZip) {
+        // Block compression into concatenated gzip members with index
+        {{
+            CNcbiOstrstream os_str;
+            CCompressionOStream os(os_str,
+                new CZipBlockStreamCompressor(CZipCompression::eLevel_Default, 4, kBlockSize,
+                                              kCompressionDefaultBufSize, kCompressionDefaultBufSize,
+                                              CZipCompression::fWriteBlockIndex),
+                CCompressionStream::fOwnWriter);
+            assert(os.good());
+            os.write(src.data(), src.size());
+            // Flush ends current block in the middle of data
+            os.flush();
+            os.write(src.data(), src.size());
+            os.Finalize();
+            assert(os.good());
+            assert(os.GetProcessedSize() == src_len * 2);
+            dst = CNcbiOstrstreamToString(os_str);
+            assert(os.GetOutputSize() == dst.size());
+        }}
+        // Decompress as usual gzip file
+        {{
+            CNcbiIstrstream is_str(dst);
+            CDecompressIStream is(is_str, CCompressStream::eGZipFile);
+            NcbiStreamToString(&cmp, is);
+            assert(cmp == src + src);
+        }}
+        // Random access to the blocks using index
+        {{
+            CNcbiIstrstream is_str(dst);
+            CZipBlockIndex index;
+            assert(index.Read(is_str));
+            assert(index.GetDataSize() == src_len * 2);
+            size_t blocks = (src_len + kBlockSize - 1) / kBlockSize * 2;
+            assert(index.GetBlockCount() == blocks);
+            assert(index.FindBlock(src_len * 2) == blocks);
+            for (size_t pos = 0;  pos < src_len * 2;  pos += src_len / 3 + 1) {
+                size_t n = index.FindBlock(pos);
+                assert(n < blocks);
+                const CZipBlockIndex::SBlock& block = index.GetBlock(n);
+                assert(block.data_pos <= pos  &&  pos < block.data_pos + block.data_size);
+                is_str.clear();
+                assert(index.ReadBlock(is_str, n, cmp));
+                assert(cmp == (src + src).substr((size_t)block.data_pos, block.data_size));
+            }
+        }}
+        OK_MSG("Zlib block compression");
+    }
+#endif
+#if defined(HAVE_LIBZSTD)
+    if (method == M::eZstd) {
+        {{
+            CNcbiOstrstream os_str;
+            CZstdStreamCompressor* compressor = new CZstdStreamCompressor();
+            compressor->GetCompressor()->SetThreads(4);
+            CCompressionOStream os(os_str, compressor, CCompressionStream::fOwnWriter);
+            assert(os.good());
+            os.write(src.data(), src.size());
+            os.Finalize();
+            assert(os.good());
+            dst = CNcbiOstrstreamToString(os_str);
+        }}
+        {{
+            CNcbiIstrstream is_str(dst);
+            CDecompressIStream is(is_str, CCompressStream::eZstd);
+            NcbiStreamToString(&cmp, is);
+            assert(cmp == src);
+        }}
+        OK_MSG("Zstd multi-threaded compression");
+    }
+#endif
+}
+
+
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // MAIN
@@ -0,0 +1,249 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Throughput of CSeqConvert / CSeqManip for every available vector
+ *   level, and check that all levels produce identical results.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <util/random_gen.hpp>
+#include <util/sequtil/sequtil_convert.hpp>
+#include <util/sequtil/sequtil_manip.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+class CSeqUtilPerfTest : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    typedef CSeqUtil::ESimdLevel TLevel;
+
+    // Run one conversion at every level; returns false on mismatch
+    bool x_Convert(const string& title,
+                   const vector<char>& src, CSeqUtil::ECoding src_coding,
+                   CSeqUtil::ECoding dst_coding, TSeqPos pos);
+    bool x_RevCmp(const string& title,
+                  const vector<char>& src, CSeqUtil::ECoding coding,
+                  bool in_place);
+    void x_Report(const string& title, TLevel level,
+                  size_t bytes, double seconds);
+
+    vector<TLevel> m_Levels;
+    TSeqPos        m_Length;
+    int            m_Iterations;
+};
+
+
+static const char* s_LevelName(CSeqUtil::ESimdLevel level)
+{
+    switch ( level ) {
+    case CSeqUtil::eSimd_None:   return "scalar";
+    case CSeqUtil::eSimd_SSSE3:  return "ssse3";
+    case CSeqUtil::eSimd_AVX2:   return "avx2";
+    }
+    return "?";
+}
+
+
+void CSeqUtilPerfTest::Init(void)
+{
+    SetDiagPostLevel(eDiag_Error);
+
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+    d->SetUsageContext(GetArguments().GetProgramBasename(),
+                       "CSeqConvert/CSeqManip throughput (GB/s)");
+    d->AddDefaultKey("length", "residues",
+                     "sequence length",
+                     CArgDescriptions::eInteger, "10000000");
+    d->AddDefaultKey("iterations", "count",
+                     "number of passes over the sequence",
+                     CArgDescriptions::eInteger, "10");
+    d->AddDefaultKey("ambig", "percent",
+                     "percentage of ambiguous / lower case residues",
+                     CArgDescriptions::eDouble, "0.1");
+    d->AddDefaultKey("seed", "value",
+                     "random generator seed",
+                     CArgDescriptions::eInteger, "1");
+    SetupArgDescriptions(d.release());
+}
+
+
+int CSeqUtilPerfTest::Run(void)
+{
+    const CArgs& args = GetArgs();
+    m_Length     = TSeqPos(args["length"].AsInteger());
+    m_Iterations = args["iterations"].AsInteger();
+    double ambig = args["ambig"].AsDouble() / 100;
+
+    TLevel best = CSeqUtil::GetSimdLevel();
+    for ( int level = CSeqUtil::eSimd_None;  level <= best;  ++level ) {
+        m_Levels.push_back(TLevel(level));
+    }
+    NcbiCout << "CPU: " << CCpuFeatures::BrandStr()
+             << ", best level: " << s_LevelName(best) << NcbiEndl;
+
+    // random IUPACna with a sprinkle of ambiguities and lower case
+    CRandom rnd(CRandom::TValue(args["seed"].AsInteger()));
+    static const char kBases[] = "ACGT";
+    static const char kOther[] = "NRYKMSWBDHVacgtnu";
+    vector<char> iupacna(m_Length);
+    for ( auto& c : iupacna ) {
+        if ( rnd.GetRand(0, 1000000) < ambig * 1000000 ) {
+            c = kOther[rnd.GetRand(0, sizeof(kOther) - 2)];
+        } else {
+            c = kBases[rnd.GetRand(0, 3)];
+        }
+    }
+    vector<char> ncbi2na, ncbi4na, ncbi8na;
+    CSeqConvert::Convert(iupacna, CSeqUtil::e_Iupacna, 0, m_Length,
+                         ncbi2na, CSeqUtil::e_Ncbi2na);
+    CSeqConvert::Convert(iupacna, CSeqUtil::e_Iupacna, 0, m_Length,
+                         ncbi4na, CSeqUtil::e_Ncbi4na);
+    CSeqConvert::Convert(iupacna, CSeqUtil::e_Iupacna, 0, m_Length,
+                         ncbi8na, CSeqUtil::e_Ncbi8na);
+
+    bool ok = true;
+    ok &= x_Convert("iupacna -> ncbi2na", iupacna,
+                    CSeqUtil::e_Iupacna, CSeqUtil::e_Ncbi2na, 0);
+    ok &= x_Convert("iupacna -> ncbi4na", iupacna,
+                    CSeqUtil::e_Iupacna, CSeqUtil::e_Ncbi4na, 0);
+    ok &= x_Convert("ncbi2na -> iupacna", ncbi2na,
+                    CSeqUtil::e_Ncbi2na, CSeqUtil::e_Iupacna, 0);
+    ok &= x_Convert("ncbi4na -> iupacna", ncbi4na,
+                    CSeqUtil::e_Ncbi4na, CSeqUtil::e_Iupacna, 0);
+    // unaligned starts
+    ok &= x_Convert("iupacna -> ncbi2na (pos 3)", iupacna,
+                    CSeqUtil::e_Iupacna, CSeqUtil::e_Ncbi2na, 3);
+    ok &= x_Convert("ncbi4na -> iupacna (pos 1)", ncbi4na,
+                    CSeqUtil::e_Ncbi4na, CSeqUtil::e_Iupacna, 1);
+    ok &= x_RevCmp("iupacna revcomp", iupacna, CSeqUtil::e_Iupacna, false);
+    ok &= x_RevCmp("iupacna revcomp in place", iupacna,
+                   CSeqUtil::e_Iupacna, true);
+    ok &= x_RevCmp("ncbi8na revcomp", ncbi8na, CSeqUtil::e_Ncbi8na, false);
+    ok &= x_RevCmp("ncbi8na revcomp in place", ncbi8na,
+                   CSeqUtil::e_Ncbi8na, true);
+
+    CSeqUtil::SetSimdLevel(best);
+    if ( !ok ) {
+        NcbiCout << "FAILED: vector and scalar results differ" << NcbiEndl;
+        return 1;
+    }
+    return 0;
+}
+
+
+void CSeqUtilPerfTest::x_Report(const string& title, TLevel level,
+                                size_t bytes, double seconds)
+{
+    double gbps = seconds > 0 ? double(bytes) * m_Iterations / seconds / 1e9
+                              : 0;
+    NcbiCout << setw(30) << left << title << " "
+             << setw(7) << s_LevelName(level) << " "
+             << fixed << setprecision(3) << gbps << " GB/s" << NcbiEndl;
+}
+
+
+bool CSeqUtilPerfTest::x_Convert(const string& title,
+                                 const vector<char>& src,
+                                 CSeqUtil::ECoding src_coding,
+                                 CSeqUtil::ECoding dst_coding,
+                                 TSeqPos pos)
+{
+    TSeqPos length = m_Length - pos;
+    vector<char> expected;
+    bool ok = true;
+    for ( TLevel level : m_Levels ) {
+        CSeqUtil::SetSimdLevel(level);
+        vector<char> dst;
+        CStopWatch sw(CStopWatch::eStart);
+        for ( int i = 0;  i < m_Iterations;  ++i ) {
+            CSeqConvert::Convert(src, src_coding, pos, length,
+                                 dst, dst_coding);
+        }
+        // throughput in residues (IUPACna bytes) per second
+        x_Report(title, level, length, sw.Elapsed());
+        if ( level == CSeqUtil::eSimd_None ) {
+            expected.swap(dst);
+        } else if ( dst != expected ) {
+            NcbiCout << title << ": " << s_LevelName(level)
+                     << " result differs from scalar" << NcbiEndl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+
+bool CSeqUtilPerfTest::x_RevCmp(const string& title,
+                                const vector<char>& src,
+                                CSeqUtil::ECoding coding,
+                                bool in_place)
+{
+    vector<char> expected;
+    bool ok = true;
+    for ( TLevel level : m_Levels ) {
+        CSeqUtil::SetSimdLevel(level);
+        vector<char> dst(src.size());
+        vector<char> buf(src);
+        CStopWatch sw(CStopWatch::eStart);
+        for ( int i = 0;  i < m_Iterations;  ++i ) {
+            if ( in_place ) {
+                CSeqManip::ReverseComplement(buf, coding, 0, m_Length);
+            } else {
+                CSeqManip::ReverseComplement(src, coding, 0, m_Length, dst);
+            }
+        }
+        x_Report(title, level, m_Length, sw.Elapsed());
+        if ( in_place ) {
+            dst.swap(buf);
+        }
+        if ( level == CSeqUtil::eSimd_None ) {
+            expected.swap(dst);
+        } else if ( dst != expected ) {
+            NcbiCout << title << ": " << s_LevelName(level)
+                     << " result differs from scalar" << NcbiEndl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CSeqUtilPerfTest().AppMain(argc, argv);
+}
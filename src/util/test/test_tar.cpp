@@ -35,6 +35,7 @@
 #include <corelib/rwstream.hpp>
 #include <corelib/stream_utils.hpp>
 #include <util/compress/tar.hpp>
+#include <util/compress/tar_index.hpp>
 #include <util/compress/stream_util.hpp>
 #ifdef TEST_CONN_TAR
 #  include <connect/ncbi_conn_stream.hpp>
@@ -241,6 +242,14 @@ void CTarTest::Init(void)
                   " [non-standard]");
     args->AddFlag("s", "Use stream operations with archive"
                   " [non-standard]");
+    args->AddFlag("n", "Use sidecar index (create if missing) to stream"
+                  " single entry [non-standard]");
+    args->AddDefaultKey ("K", "checkpoint_span",
+                         "Distance between deflate checkpoints (in bytes of"
+                         " uncompressed data)\nfor the sidecar index (-n)"
+                         " of gzipped archive, 0 for default [non-standard]",
+                         CArgDescriptions::eInteger, "0");
+    args->SetConstraint ("K", new CArgAllow_Integers(0, kMax_Int));
     args->AddFlag("N", "Allow case-blind entry names while extracting"
                   " [non-stdandard]");
     args->AddFlag("R", "Allow overwrite[Replace!] conflict entries while extracting"
@@ -454,6 +463,7 @@ int CTarTest::Run(void)
     bool   stream   = args["s"].HasValue();
     bool   tocout   = args["O"].HasValue();
     bool   zip      = args["z"].HasValue();
+    bool   indexed  = args["n"].HasValue();
     size_t n        = args.GetNExtra();
 
     if (verbose) {
@@ -475,6 +485,11 @@ int CTarTest::Run(void)
         NCBI_THROW(CArgException, eInvalidArg,
                    "Sorry, -z not supported with either -r or -u");
     }
+    if (indexed  &&  (action != eExtract  ||  !stream  ||  n != 1
+                      ||  file.empty()  ||  pipethru)) {
+        NCBI_THROW(CArgException, eInvalidArg,
+                   "-n requires -x -s of a single entry from archive file");
+    }
     if ((action == eAppend || action == eUpdate || action == eCreate) && !n) {
         NCBI_THROW(CArgException, eInvalidArg,
                    "Must specify file(s)");
@@ -691,7 +706,7 @@ int CTarTest::Run(void)
     CStopWatch sw(CStopWatch::eStart);
     if (!tar) {
         _ASSERT(action == eExtract  &&  stream  &&  n == 1);
-        if (!io) {
+        if (!io  &&  !indexed) {
             _ASSERT(!file.empty()  &&  !zip  &&  !ifs.is_open());
             ifs.open(file.c_str(), IOS_BASE::in | IOS_BASE::binary);
             if (ioexcpts) {
@@ -701,8 +716,18 @@ int CTarTest::Run(void)
                 NCBI_THROW(CTarException, eOpen, "Archive not found");
             }
         }
-        CNcbiIstream& is = io ? dynamic_cast<CNcbiIstream&>(*io) : ifs;
-        IReader* ir = CTar::Extract(is, args[1].AsString(), m_Flags);
+        IReader* ir;
+        if (indexed) {
+            // Build the index once, then seek to the entry with it
+            if (!CFile(CTarIndex::GetDefaultIndexName(file)).Exists()) {
+                CTar(file).CreateIndex(kEmptyStr,
+                                       (Uint8) args["K"].AsInteger());
+            }
+            ir = CTarIndex(file).Extract(args[1].AsString(), m_Flags);
+        } else {
+            CNcbiIstream& is = io ? dynamic_cast<CNcbiIstream&>(*io) : ifs;
+            ir = CTar::Extract(is, args[1].AsString(), m_Flags);
+        }
         if (!ir) {
             NCBI_THROW(CTarException, eBadName,
                        "Entry either not found or has a non-file type");
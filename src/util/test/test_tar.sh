@@ -203,6 +203,54 @@ echo
 $test_tar -x -s -v -O -f $test_base.tar "*test_tar${exe}" | cmp -l - $test_tar_file | head -n 100 >$test_base.cmp  ||  exit 1
 cat $test_base.cmp  &&  test -s $test_base.cmp                                                                     &&  exit 1
 
+echo
+echo "`date` *** Checking indexed single entry streaming feature"
+echo
+
+rm -f $test_base.tar.idx
+$test_tar -x -s -n -O -f $test_base.tar newdir/datefile | cmp -l - $test_base.2/newdir/datefile | head -n 100 >$test_base.cmp  ||  exit 1
+cat $test_base.cmp  &&  test -s $test_base.cmp                                                                         &&  exit 1
+test -s $test_base.tar.idx                                                                                             ||  exit 1
+gzip -c $test_base.tar >$test_base.tgz 2>/dev/null  &&  {
+  $test_tar -x -s -n -O -f $test_base.tgz newdir/datefile | cmp -l - $test_base.2/newdir/datefile | head -n 100 >$test_base.cmp  ||  exit 1
+  cat $test_base.cmp  &&  test -s $test_base.cmp                                                                       &&  exit 1
+}
+
+echo
+echo "`date` *** Checking indexed streaming from multi-member gzipped archive"
+echo
+
+# Several MB of data, indexed with small checkpoint span, so that the members
+# are past many checkpoints;  the archive is split in two gzip members inside
+# big.2, so big.3 and small are both in the second gzip member
+gzip -c /dev/null >/dev/null 2>&1  &&  {
+  mkdir $test_base.big                                                                   ||  exit 1
+  dd if=/dev/urandom of=$test_base.big/big.1 bs=1024 count=1536 2>/dev/null              ||  exit 1
+  dd if=/dev/urandom of=$test_base.big/big.2 bs=1024 count=1024 2>/dev/null              ||  exit 1
+  cp -p $test_tar_file $test_base.big/big.3                                              ||  exit 1
+  cp -p $test_base.2/newdir/datefile $test_base.big/small                                ||  exit 1
+  ( cd $test_base.big  &&  $tar cf $test_base.big.tar big.1 big.2 big.3 small )         ||  exit 1
+  dd if=$test_base.big.tar bs=1024 count=2048 2>/dev/null | gzip -c  >$test_base.big.tgz  ||  exit 1
+  dd if=$test_base.big.tar bs=1024 skip=2048  2>/dev/null | gzip -c >>$test_base.big.tgz  ||  exit 1
+  rm -f $test_base.big.tgz.idx
+  for f in big.2 big.3 small big.1 ; do
+    $test_tar -x -s -n -K 65536 -O -f $test_base.big.tgz $f | cmp -l - $test_base.big/$f | head -n 100 >$test_base.cmp  ||  exit 1
+    cat $test_base.cmp  &&  test -s $test_base.cmp                                                                     &&  exit 1
+  done
+  # Each checkpoint takes 32KB in the index, there must be at least 20 of them
+  test "`cat $test_base.big.tgz.idx | wc -c`" -gt 655360                                 ||  exit 1
+
+  # The index of a modified archive is refused (by time, then by size)
+  touch -t 200001010000 $test_base.big.tgz                                               ||  exit 1
+  $test_tar -x -s -n -O -f $test_base.big.tgz small >/dev/null 2>&1                      &&  exit 1
+  rm -f $test_base.big.tgz.idx
+  $test_tar -x -s -n -K 65536 -O -f $test_base.big.tgz small | cmp -s - $test_base.big/small  ||  exit 1
+  dd if=/dev/zero bs=512 count=2 2>/dev/null | gzip -c >>$test_base.big.tgz              ||  exit 1
+  $test_tar -x -s -n -O -f $test_base.big.tgz small >/dev/null 2>&1                      &&  exit 1
+  rm -f $test_base.big.tgz.idx
+  $test_tar -x -s -n -K 65536 -O -f $test_base.big.tgz big.3 | cmp -s - $test_base.big/big.3  ||  exit 1
+}
+
 echo
 echo "`date` *** Checking multiple entry streaming feature"
 echo
@@ -0,0 +1,355 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Throughput of CThreadPool and CStealingThreadPool with many tiny tasks,
+ *   and check that every task is executed exactly once.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <util/thread_pool.hpp>
+#include <util/thread_pool_stealing.hpp>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+typedef function<void(CThreadPool_Task*)> TAddTask;
+
+/// Shared state of one benchmark run
+struct SRunState
+{
+    TAddTask       add_task;
+    unsigned int   work = 0;
+    atomic<size_t> executed{0};
+    atomic<size_t> checksum{0};
+};
+
+
+/// Task doing some busy work; if 'count' is greater than 1 it splits itself
+/// into two tasks first (fork-join style load, tasks added from the pool)
+class CPerfTask : public CThreadPool_Task
+{
+public:
+    CPerfTask(SRunState& state, size_t first, size_t count)
+        : m_State(state), m_First(first), m_Count(count)
+    {}
+
+    virtual EStatus Execute(void) override
+    {
+        while (m_Count > 1) {
+            size_t half = m_Count / 2;
+            m_State.add_task(new CPerfTask(m_State, m_First + half,
+                                           m_Count - half));
+            m_Count = half;
+        }
+        volatile unsigned int sink = 0;
+        for (unsigned int i = 0;  i < m_State.work;  ++i) {
+            sink = sink + i;
+        }
+        m_State.checksum.fetch_add(m_First, memory_order_relaxed);
+        m_State.executed.fetch_add(1, memory_order_relaxed);
+        return eCompleted;
+    }
+
+private:
+    SRunState& m_State;
+    size_t     m_First;
+    size_t     m_Count;
+};
+
+
+/// Task recording the order of execution; the first one can hold
+/// the thread until released
+class COrderTask : public CThreadPool_Task
+{
+public:
+    COrderTask(vector<int>& order, mutex& order_mutex, int id,
+               unsigned int priority, atomic<bool>* gate = NULL)
+        : CThreadPool_Task(priority),
+          m_Order(order), m_OrderMutex(order_mutex), m_Id(id), m_Gate(gate)
+    {}
+
+    virtual EStatus Execute(void) override
+    {
+        while (m_Gate  &&  !m_Gate->load()) {
+            SleepMicroSec(100);
+        }
+        lock_guard<mutex> guard(m_OrderMutex);
+        m_Order.push_back(m_Id);
+        return eCompleted;
+    }
+
+private:
+    vector<int>&  m_Order;
+    mutex&        m_OrderMutex;
+    int           m_Id;
+    atomic<bool>* m_Gate;
+};
+
+
+/// Task aborting and then destroying the pool it runs in
+class CDestroyPoolTask : public CThreadPool_Task
+{
+public:
+    CDestroyPoolTask(CStealingThreadPool* pool)
+        : m_Pool(pool), m_AbortRefused(false), m_Destroyed(false)
+    {}
+
+    virtual EStatus Execute(void) override
+    {
+        try {
+            m_Pool->Abort();
+        }
+        catch (CThreadPoolException& e) {
+            m_AbortRefused = e.GetErrCode() == CThreadPoolException::eProhibited;
+        }
+        delete m_Pool;
+        m_Destroyed = true;
+        return eCompleted;
+    }
+
+    CStealingThreadPool* m_Pool;
+    atomic<bool>         m_AbortRefused;
+    atomic<bool>         m_Destroyed;
+};
+
+
+class CThreadPoolPerfTest : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    enum EPool {
+        ePool_Classic,
+        ePool_Stealing
+    };
+
+    // Run 'm_Tasks' tasks in the pool; returns false if some task was lost
+    bool x_Run(EPool pool_type, unsigned int threads, bool spawn);
+    // Check that CStealingThreadPool starts tasks in the order of priority
+    bool x_TestPriorities(void);
+    // Check that CStealingThreadPool can be destroyed by its own task
+    bool x_TestDestroyFromTask(void);
+
+    size_t       m_Tasks;
+    unsigned int m_Work;
+    unsigned int m_QueueSize;
+};
+
+
+void CThreadPoolPerfTest::Init(void)
+{
+    SetDiagPostLevel(eDiag_Error);
+
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+    d->SetUsageContext(GetArguments().GetProgramBasename(),
+                       "CThreadPool vs CStealingThreadPool throughput");
+    d->AddDefaultKey("threads", "list",
+                     "comma separated numbers of threads",
+                     CArgDescriptions::eString, "1,2,4,8,16,32,64");
+    d->AddDefaultKey("tasks", "count",
+                     "number of tasks per run",
+                     CArgDescriptions::eInteger, "200000");
+    d->AddDefaultKey("work", "iterations",
+                     "busy loop iterations in each task",
+                     CArgDescriptions::eInteger, "100");
+    d->AddDefaultKey("queue", "size",
+                     "maximum number of queued tasks",
+                     CArgDescriptions::eInteger, "10000");
+    SetupArgDescriptions(d.release());
+}
+
+
+int CThreadPoolPerfTest::Run(void)
+{
+    const CArgs& args = GetArgs();
+    m_Tasks     = size_t(args["tasks"].AsInteger());
+    m_Work      = (unsigned int)args["work"].AsInteger();
+    m_QueueSize = (unsigned int)args["queue"].AsInteger();
+
+    list<string> threads_list;
+    NStr::Split(args["threads"].AsString(), ",", threads_list,
+                NStr::fSplit_Tokenize);
+
+    NcbiCout << "CPU count: " << CSystemInfo::GetCpuCount()
+             << ", tasks: " << m_Tasks << ", work: " << m_Work << NcbiEndl;
+
+    if ( !x_TestPriorities() ) {
+        NcbiCout << "FAILED: tasks were not executed in priority order"
+                 << NcbiEndl;
+        return 1;
+    }
+    if ( !x_TestDestroyFromTask() ) {
+        NcbiCout << "FAILED: pool was not destroyed by its task"
+                 << NcbiEndl;
+        return 1;
+    }
+
+    bool ok = true;
+    for (const string& str : threads_list) {
+        unsigned int threads = NStr::StringToUInt(str);
+        for (bool spawn : { false, true }) {
+            ok &= x_Run(ePool_Classic,  threads, spawn);
+            ok &= x_Run(ePool_Stealing, threads, spawn);
+        }
+    }
+
+    if ( !ok ) {
+        NcbiCout << "FAILED: not all tasks were executed exactly once"
+                 << NcbiEndl;
+        return 1;
+    }
+    return 0;
+}
+
+
+bool CThreadPoolPerfTest::x_Run(EPool pool_type, unsigned int threads,
+                                bool spawn)
+{
+    SRunState state;
+    state.work = m_Work;
+
+    unique_ptr<CThreadPool>         classic;
+    unique_ptr<CStealingThreadPool> stealing;
+    if (pool_type == ePool_Classic) {
+        // tasks added from the pool threads must never wait for room,
+        // the classic pool can't tell them apart from the others
+        unsigned int queue_size = spawn ? (unsigned int)m_Tasks : m_QueueSize;
+        classic.reset(new CThreadPool(queue_size, threads, threads));
+        state.add_task = [&classic](CThreadPool_Task* task) {
+            classic->AddTask(task);
+        };
+    }
+    else {
+        stealing.reset(new CStealingThreadPool(m_QueueSize, threads));
+        state.add_task = [&stealing](CThreadPool_Task* task) {
+            stealing->AddTask(task);
+        };
+    }
+
+    CStopWatch sw(CStopWatch::eStart);
+    if (spawn) {
+        // one root task per thread, the rest is added from the pool
+        size_t roots = min(size_t(threads), m_Tasks);
+        for (size_t i = 0;  i < roots;  ++i) {
+            size_t first = m_Tasks * i / roots;
+            size_t last  = m_Tasks * (i + 1) / roots;
+            state.add_task(new CPerfTask(state, first, last - first));
+        }
+    }
+    else {
+        for (size_t i = 0;  i < m_Tasks;  ++i) {
+            state.add_task(new CPerfTask(state, i, 1));
+        }
+    }
+    while (state.executed.load() < m_Tasks) {
+        SleepMicroSec(100);
+    }
+    double elapsed = sw.Elapsed();
+
+    // let the pool finish before 'state' goes away
+    if (classic) {
+        classic->Abort();
+    }
+    if (stealing) {
+        stealing->Abort();
+    }
+
+    NcbiCout << setw(9) << left
+             << (pool_type == ePool_Classic ? "classic" : "stealing")
+             << setw(7) << (spawn ? "spawn" : "flat")
+             << setw(3) << right << threads << " threads  "
+             << fixed << setprecision(0)
+             << (elapsed > 0 ? double(m_Tasks) / elapsed : 0)
+             << " tasks/s" << NcbiEndl;
+
+    return state.executed.load() == m_Tasks
+        &&  state.checksum.load() == m_Tasks * (m_Tasks - 1) / 2;
+}
+
+
+bool CThreadPoolPerfTest::x_TestPriorities(void)
+{
+    vector<int>  order;
+    mutex        order_mutex;
+    atomic<bool> gate(false);
+
+    CStealingThreadPool pool(m_QueueSize, 1);
+    // keep the only thread busy until all tasks are queued
+    pool.AddTask(new COrderTask(order, order_mutex, 0, 0, &gate));
+    while (pool.GetExecutingTasksCount() == 0) {
+        SleepMicroSec(100);
+    }
+    pool.AddTask(new COrderTask(order, order_mutex, 5, 3));
+    pool.AddTask(new COrderTask(order, order_mutex, 3, 1));
+    pool.AddTask(new COrderTask(order, order_mutex, 4, 2));
+    pool.AddTask(new COrderTask(order, order_mutex, 1, 0));
+    pool.AddTask(new COrderTask(order, order_mutex, 2, 0));
+    gate = true;
+
+    for (;;) {
+        {{
+            lock_guard<mutex> guard(order_mutex);
+            if (order.size() == 6) {
+                break;
+            }
+        }}
+        SleepMicroSec(100);
+    }
+    pool.Abort();
+    return order == vector<int>({ 0, 1, 2, 3, 4, 5 });
+}
+
+
+bool CThreadPoolPerfTest::x_TestDestroyFromTask(void)
+{
+    CStealingThreadPool* pool = new CStealingThreadPool(m_QueueSize, 2);
+    CRef<CDestroyPoolTask> task(new CDestroyPoolTask(pool));
+    pool->AddTask(task);
+    while ( !task->IsFinished() ) {
+        SleepMicroSec(100);
+    }
+    return task->m_AbortRefused  &&  task->m_Destroyed
+        &&  task->GetStatus() == CThreadPool_Task::eCompleted;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CThreadPoolPerfTest().AppMain(argc, argv);
+}
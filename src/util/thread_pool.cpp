@@ -987,7 +987,7 @@ void
 CThreadPool_Task::OnCancelRequested(void)
 {}
 
-inline void
+void
 CThreadPool_Task::x_SetOwner(CThreadPool_Impl* pool)
 {
     if (m_IsBusy.Add(1) != 1) {
@@ -1003,7 +1003,7 @@ CThreadPool_Task::x_SetOwner(CThreadPool_Impl* pool)
     m_Pool = pool;
 }
 
-inline void
+void
 CThreadPool_Task::x_ResetOwner(void)
 {
     m_Pool = NULL;
@@ -0,0 +1,863 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Pool of threads with a work-stealing scheduler.
+ */
+
+#include <ncbi_pch.hpp>
+#include <util/thread_pool_stealing.hpp>
+#include <util/sync_queue.hpp>
+#include <util/error_codes.hpp>
+#include <corelib/ncbi_system.hpp>
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+#define NCBI_USE_ERRCODE_X  Util_Thread
+
+BEGIN_NCBI_SCOPE
+
+
+/// Number of unsuccessful attempts to find a task before a thread goes
+/// to sleep
+static const unsigned int kIdleSpinCount = 64;
+
+
+/// Double-ended queue of tasks owned by one thread of the pool
+/// (D.Chase, Y.Lev "Dynamic circular work-stealing deque", with memory
+/// ordering from N.M.Le et al. "Correct and efficient work-stealing for
+/// weak memory models").
+/// Only the owning thread can call Push() and Pop(), any thread can call
+/// Steal(). The queue grows as needed and never shrinks.
+class CStealingThreadPool_Deque
+{
+public:
+    CStealingThreadPool_Deque(void);
+    ~CStealingThreadPool_Deque(void);
+
+    /// Add task to the bottom of the queue
+    void Push(CThreadPool_Task* task);
+    /// Take task from the bottom of the queue
+    CThreadPool_Task* Pop(void);
+    /// Take task from the top of the queue; NULL if the queue is empty
+    /// or if another thread took this task first
+    CThreadPool_Task* Steal(void);
+
+    /// Check if the queue looks empty from some other thread
+    bool IsEmpty(void) const;
+
+private:
+    struct SArray
+    {
+        explicit SArray(size_t size)
+            : m_Mask(size - 1),
+              m_Tasks(new atomic<CThreadPool_Task*>[size])
+        {}
+
+        size_t GetSize(void) const
+        {
+            return m_Mask + 1;
+        }
+        CThreadPool_Task* Get(Int8 index) const
+        {
+            return m_Tasks[size_t(index) & m_Mask].load(memory_order_relaxed);
+        }
+        void Put(Int8 index, CThreadPool_Task* task)
+        {
+            m_Tasks[size_t(index) & m_Mask].store(task, memory_order_relaxed);
+        }
+
+        size_t                              m_Mask;
+        unique_ptr<atomic<CThreadPool_Task*>[]> m_Tasks;
+    };
+
+    SArray* x_Grow(SArray* array, Int8 top, Int8 bottom);
+
+    alignas(64) atomic<Int8> m_Top;
+    alignas(64) atomic<Int8> m_Bottom;
+    atomic<SArray*>          m_Array;
+    /// Arrays replaced by x_Grow(); other threads can still read them
+    vector<unique_ptr<SArray>> m_OldArrays;
+};
+
+
+CStealingThreadPool_Deque::CStealingThreadPool_Deque(void)
+    : m_Top(0),
+      m_Bottom(0),
+      m_Array(new SArray(64))
+{}
+
+CStealingThreadPool_Deque::~CStealingThreadPool_Deque(void)
+{
+    delete m_Array.load();
+}
+
+CStealingThreadPool_Deque::SArray*
+CStealingThreadPool_Deque::x_Grow(SArray* array, Int8 top, Int8 bottom)
+{
+    SArray* new_array = new SArray(array->GetSize() * 2);
+    for (Int8 i = top;  i < bottom;  ++i) {
+        new_array->Put(i, array->Get(i));
+    }
+    m_OldArrays.emplace_back(array);
+    m_Array.store(new_array, memory_order_release);
+    return new_array;
+}
+
+void
+CStealingThreadPool_Deque::Push(CThreadPool_Task* task)
+{
+    Int8 bottom = m_Bottom.load(memory_order_relaxed);
+    Int8 top = m_Top.load(memory_order_acquire);
+    SArray* array = m_Array.load(memory_order_relaxed);
+    if (bottom - top > Int8(array->GetSize()) - 1) {
+        array = x_Grow(array, top, bottom);
+    }
+    array->Put(bottom, task);
+    atomic_thread_fence(memory_order_release);
+    m_Bottom.store(bottom + 1, memory_order_relaxed);
+}
+
+CThreadPool_Task*
+CStealingThreadPool_Deque::Pop(void)
+{
+    Int8 bottom = m_Bottom.load(memory_order_relaxed) - 1;
+    SArray* array = m_Array.load(memory_order_relaxed);
+    m_Bottom.store(bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    Int8 top = m_Top.load(memory_order_relaxed);
+
+    CThreadPool_Task* task = NULL;
+    if (top <= bottom) {
+        task = array->Get(bottom);
+        if (top == bottom) {
+            // The last task -- race with Steal()
+            if ( !m_Top.compare_exchange_strong(top, top + 1,
+                                                memory_order_seq_cst,
+                                                memory_order_relaxed) ) {
+                task = NULL;
+            }
+            m_Bottom.store(bottom + 1, memory_order_relaxed);
+        }
+    }
+    else {
+        m_Bottom.store(bottom + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+CThreadPool_Task*
+CStealingThreadPool_Deque::Steal(void)
+{
+    Int8 top = m_Top.load(memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    Int8 bottom = m_Bottom.load(memory_order_acquire);
+    if (top >= bottom) {
+        return NULL;
+    }
+
+    SArray* array = m_Array.load(memory_order_acquire);
+    CThreadPool_Task* task = array->Get(top);
+    if ( !m_Top.compare_exchange_strong(top, top + 1,
+                                        memory_order_seq_cst,
+                                        memory_order_relaxed) ) {
+        return NULL;
+    }
+    return task;
+}
+
+inline bool
+CStealingThreadPool_Deque::IsEmpty(void) const
+{
+    return m_Bottom.load(memory_order_relaxed)
+           <= m_Top.load(memory_order_relaxed);
+}
+
+
+
+/// Bounded multi-producer multi-consumer queue for tasks added from outside
+/// of the pool (D.Vyukov's array-based queue). Every cell carries a sequence
+/// number telling whether it is ready to be written or read at the given
+/// position, so neither Push() nor Pop() takes any lock.
+class CStealingThreadPool_Queue
+{
+public:
+    explicit CStealingThreadPool_Queue(size_t size);
+
+    /// Add task to the queue; FALSE if the queue is full
+    bool Push(CThreadPool_Task* task);
+    /// Take the oldest task from the queue; NULL if the queue is empty
+    CThreadPool_Task* Pop(void);
+
+    /// Check if the queue looks empty from some other thread
+    bool IsEmpty(void) const;
+
+private:
+    struct SCell
+    {
+        atomic<size_t>    m_Sequence;
+        CThreadPool_Task* m_Task;
+    };
+
+    size_t                   m_Mask;
+    unique_ptr<SCell[]>      m_Cells;
+    alignas(64) atomic<size_t> m_PushPos;
+    alignas(64) atomic<size_t> m_PopPos;
+};
+
+
+CStealingThreadPool_Queue::CStealingThreadPool_Queue(size_t size)
+    : m_PushPos(0),
+      m_PopPos(0)
+{
+    size_t capacity = 2;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    m_Mask = capacity - 1;
+    m_Cells.reset(new SCell[capacity]);
+    for (size_t i = 0;  i < capacity;  ++i) {
+        m_Cells[i].m_Sequence.store(i, memory_order_relaxed);
+        m_Cells[i].m_Task = NULL;
+    }
+}
+
+bool
+CStealingThreadPool_Queue::Push(CThreadPool_Task* task)
+{
+    size_t pos = m_PushPos.load(memory_order_relaxed);
+    SCell* cell;
+    for (;;) {
+        cell = &m_Cells[pos & m_Mask];
+        size_t seq = cell->m_Sequence.load(memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+            if (m_PushPos.compare_exchange_weak(pos, pos + 1,
+                                                memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false;
+        }
+        else {
+            pos = m_PushPos.load(memory_order_relaxed);
+        }
+    }
+    cell->m_Task = task;
+    cell->m_Sequence.store(pos + 1, memory_order_release);
+    return true;
+}
+
+CThreadPool_Task*
+CStealingThreadPool_Queue::Pop(void)
+{
+    size_t pos = m_PopPos.load(memory_order_relaxed);
+    SCell* cell;
+    for (;;) {
+        cell = &m_Cells[pos & m_Mask];
+        size_t seq = cell->m_Sequence.load(memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+        if (diff == 0) {
+            if (m_PopPos.compare_exchange_weak(pos, pos + 1,
+                                               memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return NULL;
+        }
+        else {
+            pos = m_PopPos.load(memory_order_relaxed);
+        }
+    }
+    CThreadPool_Task* task = cell->m_Task;
+    cell->m_Sequence.store(pos + m_Mask + 1, memory_order_release);
+    return task;
+}
+
+inline bool
+CStealingThreadPool_Queue::IsEmpty(void) const
+{
+    return m_PopPos.load(memory_order_relaxed)
+           >= m_PushPos.load(memory_order_relaxed);
+}
+
+
+
+/// Real implementation of all CStealingThreadPool functions
+class CStealingThreadPool_Impl
+{
+public:
+    CStealingThreadPool_Impl(unsigned int      queue_size,
+                             unsigned int      threads,
+                             CThread::TRunMode threads_mode);
+    ~CStealingThreadPool_Impl(void);
+
+    void AddTask(CThreadPool_Task* task, const CTimeSpan* timeout);
+    void CancelTask(CThreadPool_Task* task);
+    void Abort(void);
+    /// Abort the pool from a task running in it: stop and join all other
+    /// threads, and delete the pool when the current thread exits
+    void AbortAndDetach(void);
+
+    /// Check if the calling thread is one of the pool threads
+    bool IsPoolThread(void) const
+    {
+        return sm_CurrentWorker  &&  sm_CurrentWorker->m_Pool == this;
+    }
+
+    bool IsAborted(void) const
+    {
+        return m_Aborted.load(memory_order_relaxed);
+    }
+    unsigned int GetThreadsCount(void) const
+    {
+        return (unsigned int)m_Workers.size();
+    }
+    unsigned int GetQueuedTasksCount(void) const
+    {
+        int count = m_QueuedTasks.load(memory_order_relaxed);
+        return count > 0 ? (unsigned int)count : 0;
+    }
+    unsigned int GetExecutingTasksCount(void) const
+    {
+        return (unsigned int)m_ExecutingTasks.load(memory_order_relaxed);
+    }
+
+    /// Main loop of the pool thread with the given index
+    void Main(size_t index);
+
+private:
+    struct SWorker
+    {
+        CStealingThreadPool_Impl*  m_Pool;
+        CStealingThreadPool_Deque  m_Deque;
+        CRef<CThread>              m_Thread;
+        /// Where to start looking for tasks to steal
+        size_t                     m_NextVictim;
+    };
+
+    /// Pool thread the calling thread is, if any
+    static thread_local SWorker* sm_CurrentWorker;
+
+    /// Find task in own queue, in the common queue or in other threads'
+    /// queues, in this order
+    CThreadPool_Task* x_FindTask(SWorker& worker);
+    /// Execute task or cancel it if the pool is aborted
+    void x_ExecuteTask(CThreadPool_Task* task);
+    /// Take the first task of the priority queue, if any
+    CThreadPool_Task* x_PopPriorityTask(void);
+    /// Add task to the priority queue; FALSE if it is full
+    bool x_PushPriorityTask(CThreadPool_Task* task, bool limited);
+    /// Check if there is anything in any queue
+    bool x_HasTasks(void) const;
+    /// Wait until some task is added or the pool is aborted
+    void x_Sleep(void);
+    /// Wake up one of the sleeping threads, if any
+    void x_WakeUp(void);
+
+    vector<unique_ptr<SWorker>> m_Workers;
+    CStealingThreadPool_Queue   m_Queue;
+    size_t                      m_QueueSize;
+
+    /// Tasks with non-zero priority in the order of priority, tasks with
+    /// equal priority in the order of addition
+    typedef multimap<unsigned int, CThreadPool_Task*> TPriorityQueue;
+    TPriorityQueue              m_PriorityQueue;
+    CFastMutex                  m_PriorityMutex;
+    atomic<size_t>              m_PriorityTasks;
+    atomic<int>                 m_QueuedTasks;
+    atomic<int>                 m_ExecutingTasks;
+    atomic<bool>                m_Aborted;
+    /// Set by AbortAndDetach(), the thread which called it deletes the pool
+    bool                        m_DeleteOnExit;
+
+    /// Idle threads sleep on m_SleepCond; the mutex is taken only when
+    /// somebody sleeps
+    atomic<int>                 m_Sleeping;
+    int                         m_Wakeups;
+    CFastMutex                  m_SleepMutex;
+    CConditionVariable          m_SleepCond;
+};
+
+
+/// Thread of CStealingThreadPool
+class CStealingThreadPool_Thread : public CThread
+{
+public:
+    CStealingThreadPool_Thread(CStealingThreadPool_Impl* pool, size_t index)
+        : m_Pool(pool),
+          m_Index(index)
+    {}
+
+protected:
+    virtual void* Main(void) override
+    {
+        m_Pool->Main(m_Index);
+        return NULL;
+    }
+
+private:
+    CStealingThreadPool_Impl* m_Pool;
+    size_t                    m_Index;
+};
+
+
+thread_local CStealingThreadPool_Impl::SWorker*
+CStealingThreadPool_Impl::sm_CurrentWorker = NULL;
+
+
+/// Check if status returned from CThreadPool_Task::Execute() is allowed
+/// and change it to eCompleted value if it is invalid
+static inline CThreadPool_Task::EStatus
+s_ConvertTaskResult(CThreadPool_Task::EStatus status)
+{
+    _ASSERT(status == CThreadPool_Task::eCompleted
+            ||  status == CThreadPool_Task::eFailed
+            ||  status == CThreadPool_Task::eCanceled);
+
+    if (status != CThreadPool_Task::eCompleted
+        &&  status != CThreadPool_Task::eFailed
+        &&  status != CThreadPool_Task::eCanceled)
+    {
+        ERR_POST_X(9, Critical
+                      << "Wrong status returned from "
+                         "CThreadPool_Task::Execute(): "
+                      << status);
+        status = CThreadPool_Task::eCompleted;
+    }
+
+    return status;
+}
+
+
+CStealingThreadPool_Impl::CStealingThreadPool_Impl
+                                    (unsigned int      queue_size,
+                                     unsigned int      threads,
+                                     CThread::TRunMode threads_mode)
+    : m_Queue(queue_size),
+      m_QueueSize(queue_size),
+      m_PriorityTasks(0),
+      m_QueuedTasks(0),
+      m_ExecutingTasks(0),
+      m_Aborted(false),
+      m_DeleteOnExit(false),
+      m_Sleeping(0),
+      m_Wakeups(0)
+{
+    if (threads == 0) {
+        NCBI_THROW(CThreadPoolException, eInvalid,
+                   "Number of threads in the pool cannot be 0");
+    }
+
+    m_Workers.reserve(threads);
+    for (unsigned int i = 0;  i < threads;  ++i) {
+        SWorker* worker = new SWorker;
+        worker->m_Pool = this;
+        worker->m_NextVictim = i + 1;
+        worker->m_Thread.Reset(new CStealingThreadPool_Thread(this, i));
+        m_Workers.emplace_back(worker);
+    }
+
+    threads_mode &= ~(CThread::fRunDetached | CThread::fRunAllowST);
+    for (auto& worker : m_Workers) {
+        worker->m_Thread->Run(threads_mode);
+    }
+}
+
+CStealingThreadPool_Impl::~CStealingThreadPool_Impl(void)
+{
+    Abort();
+}
+
+inline bool
+CStealingThreadPool_Impl::x_HasTasks(void) const
+{
+    if ( !m_Queue.IsEmpty()
+         ||  m_PriorityTasks.load(memory_order_relaxed) != 0 ) {
+        return true;
+    }
+    for (auto& worker : m_Workers) {
+        if ( !worker->m_Deque.IsEmpty() ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void
+CStealingThreadPool_Impl::x_WakeUp(void)
+{
+    // Pairs with the fence in x_Sleep(): either the sleeping thread sees
+    // the new task or we see the sleeping thread.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (m_Sleeping.load(memory_order_relaxed) == 0) {
+        return;
+    }
+
+    CFastMutexGuard guard(m_SleepMutex);
+    if (m_Wakeups < m_Sleeping.load(memory_order_relaxed)) {
+        ++m_Wakeups;
+        m_SleepCond.SignalSome();
+    }
+}
+
+void
+CStealingThreadPool_Impl::x_Sleep(void)
+{
+    CFastMutexGuard guard(m_SleepMutex);
+    m_Sleeping.fetch_add(1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    while (m_Wakeups == 0  &&  !IsAborted()  &&  !x_HasTasks()) {
+        m_SleepCond.WaitForSignal(m_SleepMutex);
+    }
+    if (m_Wakeups != 0) {
+        --m_Wakeups;
+    }
+    m_Sleeping.fetch_sub(1, memory_order_relaxed);
+}
+
+CThreadPool_Task*
+CStealingThreadPool_Impl::x_PopPriorityTask(void)
+{
+    if (m_PriorityTasks.load(memory_order_acquire) == 0) {
+        return NULL;
+    }
+    CFastMutexGuard guard(m_PriorityMutex);
+    if (m_PriorityQueue.empty()) {
+        return NULL;
+    }
+    CThreadPool_Task* task = m_PriorityQueue.begin()->second;
+    m_PriorityQueue.erase(m_PriorityQueue.begin());
+    m_PriorityTasks.store(m_PriorityQueue.size(), memory_order_release);
+    return task;
+}
+
+bool
+CStealingThreadPool_Impl::x_PushPriorityTask(CThreadPool_Task* task,
+                                             bool              limited)
+{
+    CFastMutexGuard guard(m_PriorityMutex);
+    if (limited  &&  m_PriorityQueue.size() >= m_QueueSize) {
+        return false;
+    }
+    m_PriorityQueue.emplace(task->GetPriority(), task);
+    m_PriorityTasks.store(m_PriorityQueue.size(), memory_order_release);
+    return true;
+}
+
+inline CThreadPool_Task*
+CStealingThreadPool_Impl::x_FindTask(SWorker& worker)
+{
+    CThreadPool_Task* task = worker.m_Deque.Pop();
+    if ( !task ) {
+        task = m_Queue.Pop();
+    }
+    if ( !task ) {
+        size_t count = m_Workers.size();
+        for (size_t i = 0;  i < count  &&  !task;  ++i) {
+            SWorker& victim = *m_Workers[worker.m_NextVictim++ % count];
+            if (&victim != &worker) {
+                task = victim.m_Deque.Steal();
+            }
+        }
+    }
+    if ( !task ) {
+        task = x_PopPriorityTask();
+    }
+    if (task) {
+        m_QueuedTasks.fetch_sub(1, memory_order_relaxed);
+    }
+    return task;
+}
+
+void
+CStealingThreadPool_Impl::x_ExecuteTask(CThreadPool_Task* task)
+{
+    // Take over the reference added in AddTask()
+    CRef<CThreadPool_Task> task_ref(task);
+    task->RemoveReference();
+
+    if (task->IsCancelRequested()  ||  IsAborted()) {
+        if ( !task->IsCancelRequested() ) {
+            task->RequestToCancel();
+        }
+        task->x_SetStatus(CThreadPool_Task::eCanceled);
+        return;
+    }
+
+    m_ExecutingTasks.fetch_add(1, memory_order_relaxed);
+    // Races with canceling of the task the same way as in CThreadPool
+    task->x_SetStatus(CThreadPool_Task::eExecuting);
+
+    CThreadPool_Task::EStatus status;
+    try {
+        status = s_ConvertTaskResult(task->Execute());
+    }
+    catch (exception& e) {
+        ERR_POST_X(7, "Exception from task in ThreadPool: " << e);
+        status = CThreadPool_Task::eFailed;
+    }
+    catch (...) {
+        ERR_POST_X(7, "Non-standard exception from task in ThreadPool");
+        status = CThreadPool_Task::eFailed;
+    }
+    task->x_SetStatus(status);
+    m_ExecutingTasks.fetch_sub(1, memory_order_relaxed);
+}
+
+void
+CStealingThreadPool_Impl::Main(size_t index)
+{
+    SWorker& worker = *m_Workers[index];
+    sm_CurrentWorker = &worker;
+
+    unsigned int idle_count = 0;
+    for (;;) {
+        CThreadPool_Task* task = x_FindTask(worker);
+        if (task) {
+            x_ExecuteTask(task);
+            idle_count = 0;
+        }
+        else if ( IsAborted() ) {
+            break;
+        }
+        else if (++idle_count < kIdleSpinCount) {
+            std::this_thread::yield();
+        }
+        else {
+            x_Sleep();
+            idle_count = 0;
+        }
+    }
+
+    sm_CurrentWorker = NULL;
+
+    if (m_DeleteOnExit) {
+        // Nobody else refers to the pool anymore
+        delete this;
+    }
+}
+
+NCBI_NORETURN
+static inline void
+s_ThrowAddProhibited(void)
+{
+    NCBI_THROW(CThreadPoolException, eProhibited,
+               "Adding of new tasks is prohibited");
+}
+
+void
+CStealingThreadPool_Impl::AddTask(CThreadPool_Task* task,
+                                  const CTimeSpan*  timeout)
+{
+    _ASSERT(task);
+
+    // To be sure that if simple new operator was passed as argument the task
+    // will still be referenced even if some exception happen in this method
+    CRef<CThreadPool_Task> task_ref(task);
+
+    if ( IsAborted() ) {
+        s_ThrowAddProhibited();
+    }
+
+    task->x_SetOwner(NULL);
+    task->x_SetStatus(CThreadPool_Task::eQueued);
+    // Released in x_ExecuteTask()
+    task->AddReference();
+    m_QueuedTasks.fetch_add(1, memory_order_relaxed);
+
+    // Tasks with non-zero priority wait until there are no tasks of
+    // the default (highest) priority and start in the order of priority
+    bool from_pool = IsPoolThread();
+    auto push = [&]() {
+        return task->GetPriority() != 0
+            ? x_PushPriorityTask(task, !from_pool)
+            : m_Queue.Push(task);
+    };
+    if (from_pool  &&  task->GetPriority() == 0) {
+        sm_CurrentWorker->m_Deque.Push(task);
+    }
+    else if ( !push() ) {
+        CStopWatch timer(CStopWatch::eStart);
+        unsigned int attempts = 0;
+        while ( !push() ) {
+            bool aborted = IsAborted();
+            if (aborted
+                ||  (timeout  &&  timer.Elapsed() >= timeout->GetAsDouble()))
+            {
+                m_QueuedTasks.fetch_sub(1, memory_order_relaxed);
+                task->RemoveReference();
+                task->x_SetStatus(CThreadPool_Task::eIdle);
+                task->x_ResetOwner();
+                if (aborted) {
+                    s_ThrowAddProhibited();
+                }
+                NCBI_THROW(CSyncQueueException, eNoRoom,
+                           "Cannot add task - the queue is full");
+            }
+            if (++attempts < kIdleSpinCount) {
+                std::this_thread::yield();
+            }
+            else {
+                SleepMicroSec(100);
+            }
+        }
+    }
+
+    x_WakeUp();
+}
+
+void
+CStealingThreadPool_Impl::CancelTask(CThreadPool_Task* task)
+{
+    _ASSERT(task);
+    // The task stays in the queue; the thread taking it will just set
+    // the status.
+    task->RequestToCancel();
+}
+
+void
+CStealingThreadPool_Impl::Abort(void)
+{
+    if ( IsPoolThread() ) {
+        // The thread cannot wait for itself
+        NCBI_THROW(CThreadPoolException, eProhibited,
+                   "CStealingThreadPool::Abort() cannot be called "
+                   "from a thread of the pool");
+    }
+    if (m_Aborted.exchange(true)) {
+        return;
+    }
+
+    {{
+        CFastMutexGuard guard(m_SleepMutex);
+        m_SleepCond.SignalAll();
+    }}
+
+    // Threads cancel all tasks remaining in their own queues before exiting
+    for (auto& worker : m_Workers) {
+        worker->m_Thread->Join();
+    }
+
+    // Tasks added to the common queues after the last thread has exited
+    while (CThreadPool_Task* task = m_Queue.Pop()) {
+        m_QueuedTasks.fetch_sub(1, memory_order_relaxed);
+        x_ExecuteTask(task);
+    }
+    while (CThreadPool_Task* task = x_PopPriorityTask()) {
+        m_QueuedTasks.fetch_sub(1, memory_order_relaxed);
+        x_ExecuteTask(task);
+    }
+}
+
+void
+CStealingThreadPool_Impl::AbortAndDetach(void)
+{
+    _ASSERT(IsPoolThread());
+    m_Aborted.store(true);
+
+    {{
+        CFastMutexGuard guard(m_SleepMutex);
+        m_SleepCond.SignalAll();
+    }}
+
+    for (auto& worker : m_Workers) {
+        if (worker.get() == sm_CurrentWorker) {
+            worker->m_Thread->Detach();
+        }
+        else {
+            worker->m_Thread->Join();
+        }
+    }
+    // The current thread cancels the remaining tasks when the task calling
+    // this returns, then deletes the pool
+    m_DeleteOnExit = true;
+}
+
+
+
+CStealingThreadPool::CStealingThreadPool(unsigned int      queue_size,
+                                         unsigned int      threads,
+                                         CThread::TRunMode threads_mode)
+    : m_Impl(new CStealingThreadPool_Impl(queue_size, threads, threads_mode))
+{}
+
+CStealingThreadPool::~CStealingThreadPool(void)
+{
+    if ( m_Impl->IsPoolThread() ) {
+        // Destroyed by a task running in the pool
+        m_Impl.release()->AbortAndDetach();
+    }
+}
+
+void
+CStealingThreadPool::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
+{
+    m_Impl->AddTask(task, timeout);
+}
+
+void
+CStealingThreadPool::CancelTask(CThreadPool_Task* task)
+{
+    m_Impl->CancelTask(task);
+}
+
+void
+CStealingThreadPool::Abort(void)
+{
+    m_Impl->Abort();
+}
+
+bool
+CStealingThreadPool::IsAborted(void) const
+{
+    return m_Impl->IsAborted();
+}
+
+unsigned int
+CStealingThreadPool::GetThreadsCount(void) const
+{
+    return m_Impl->GetThreadsCount();
+}
+
+unsigned int
+CStealingThreadPool::GetQueuedTasksCount(void) const
+{
+    return m_Impl->GetQueuedTasksCount();
+}
+
+unsigned int
+CStealingThreadPool::GetExecutingTasksCount(void) const
+{
+    return m_Impl->GetExecutingTasksCount();
+}
+
+
+END_NCBI_SCOPE